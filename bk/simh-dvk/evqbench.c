@@ -0,0 +1,161 @@
+/* evqbench.c: event queue microbenchmark
+
+   A stand-in simulator, linked against the common SCP modules, that does
+   nothing but drive the event queue.  Each of the EVQ units reschedules itself
+   at a pseudo-random delay when its event fires; every fourth event also
+   cancels and requeues some other unit, the way controllers retime their
+   drives.  The run stops when the requested number of events has been
+   processed, and prints the host time taken.
+
+        sim> dep units 500
+        sim> dep events 1000000
+        sim> run
+
+   Build with "make evqbench".
+*/
+
+#include "sim_defs.h"
+
+#define EVQ_MAXUNITS    4096                            /* max units */
+#define EVQ_MAXDLY      4096                            /* max delay */
+#define STOP_DONE       1                               /* all events done */
+
+extern int32 sim_interval;
+
+int32 saved_PC = 0;
+int32 evq_units = 500;                                  /* active units */
+int32 evq_events = 1000000;                             /* events to run */
+int32 evq_count = 0;                                    /* events done */
+uint32 evq_seed = 1;                                    /* LCG state */
+
+t_stat evq_svc (UNIT *uptr);
+t_stat evq_reset (DEVICE *dptr);
+
+/* EVQ data structures
+
+   evq_dev      EVQ device descriptor
+   evq_unit     EVQ unit list
+   evq_reg      EVQ register list
+*/
+
+UNIT evq_unit[EVQ_MAXUNITS];
+
+REG evq_reg[] = {
+    { DRDATA (PC, saved_PC, 32) },
+    { DRDATA (UNITS, evq_units, 16) },
+    { DRDATA (EVENTS, evq_events, 31) },
+    { DRDATA (COUNT, evq_count, 31), REG_RO },
+    { NULL }
+    };
+
+DEVICE evq_dev = {
+    "EVQ", evq_unit, evq_reg, NULL,
+    EVQ_MAXUNITS, 10, 16, 1, 8, 16,
+    NULL, NULL, &evq_reset,
+    NULL, NULL, NULL
+    };
+
+/* SCP data structures */
+
+char sim_name[] = "EVQBENCH";
+
+REG *sim_PC = &evq_reg[0];
+
+int32 sim_emax = 1;
+
+DEVICE *sim_devices[] = {
+    &evq_dev,
+    NULL
+    };
+
+const char *sim_stop_messages[] = {
+    "Unknown error",
+    "Event count reached"
+    };
+
+/* Pseudo-random delay in 1..EVQ_MAXDLY */
+
+static int32 evq_delay (void)
+{
+evq_seed = evq_seed * 1103515245 + 12345;
+return ((evq_seed >> 16) % EVQ_MAXDLY) + 1;
+}
+
+/* Unit service: requeue self, and now and then retime a neighbour */
+
+t_stat evq_svc (UNIT *uptr)
+{
+UNIT *optr;
+
+if (++evq_count >= evq_events)
+    return STOP_DONE;
+sim_activate (uptr, evq_delay ());
+if ((evq_count & 3) == 0) {
+    optr = &evq_unit[evq_seed % evq_units];
+    sim_activate_abs (optr, evq_delay ());
+    }
+return SCPE_OK;
+}
+
+t_stat evq_reset (DEVICE *dptr)
+{
+int32 i;
+
+for (i = 0; i < EVQ_MAXUNITS; i++) {
+    sim_cancel (&evq_unit[i]);
+    evq_unit[i].action = &evq_svc;
+    }
+evq_count = 0;
+evq_seed = 1;
+return SCPE_OK;
+}
+
+/* Instruction loop: one tick per "instruction" */
+
+t_stat sim_instr (void)
+{
+t_stat reason;
+uint32 msec;
+int32 i;
+
+if ((evq_units < 1) || (evq_units > EVQ_MAXUNITS))
+    return SCPE_ARG;
+if (sim_qcount () == 0) {                               /* fresh start? */
+    evq_count = 0;
+    for (i = 0; i < evq_units; i++)
+        sim_activate (&evq_unit[i], evq_delay ());
+    }
+msec = sim_os_msec ();
+reason = SCPE_OK;
+while (reason == SCPE_OK) {
+    if (sim_interval <= 0) {
+        reason = sim_process_event ();
+        continue;
+        }
+    sim_interval--;
+    saved_PC++;
+    }
+msec = sim_os_msec () - msec;
+printf ("%d events, %d units, %d queued: %u msec\n",
+    evq_count, evq_units, sim_qcount (), msec);
+return reason;
+}
+
+/* Unused hooks */
+
+t_stat sim_load (FILE *fileref, char *cptr, char *fnam, int32 flag)
+{
+return SCPE_NOFNC;
+}
+
+t_stat fprint_sym (FILE *of, t_addr addr, t_value *val,
+    UNIT *uptr, int32 sw)
+{
+fprintf (of, "%o", (int32) val[0]);
+return SCPE_OK;
+}
+
+t_stat parse_sym (char *cptr, t_addr addr, UNIT *uptr, t_value *val, int32 sw)
+{
+return SCPE_ARG;
+}
@@ -249,6 +249,32 @@ typedef struct {
     uint16              inst[HIST_ILNT];
     } InstHistory;
 
+#define IC_SIZE         4096                            /* icache entries, 2**n */
+#define IC_MASK         (IC_SIZE - 1)
+#define IC_V_PG         9                               /* code map page, bytes */
+#define IC_INVAL(x)     if (ic_tab[((x) >> 1) & IC_MASK].pa == ((x) & ~1)) \
+                            ic_tab[((x) >> 1) & IC_MASK].pa = -1
+
+typedef void (*IC_OP) (int32 IR, int32 srcspec, int32 dstspec);
+
+typedef struct {
+    int32               pa;                             /* phys addr, -1 = empty */
+    int32               IR;                             /* instruction */
+    int32               srcspec;                        /* src specifier */
+    int32               dstspec;                        /* dst specifier */
+    IC_OP               op;                             /* handler, NULL = decode */
+    } ICacheEntry;
+
+#define TLB_RD          1                               /* read ok */
+#define TLB_WR          2                               /* write ok */
+
+typedef struct {
+    int32               acc;                            /* TLB_RD, TLB_WR, 0 = empty */
+    int32               base;                           /* phys base of page */
+    int32               lo;                             /* valid blocks, va<12:6> */
+    int32               hi;
+    } TLBEntry;
+
 /* Global state */
 
 extern FILE *sim_log;
@@ -298,6 +324,12 @@ jmp_buf save_env;                                       /* abort handler */
 int32 hst_p = 0;                                        /* history pointer */
 int32 hst_lnt = 0;                                      /* history length */
 InstHistory *hst = NULL;                                /* instruction history */
+ICacheEntry ic_tab[IC_SIZE];                            /* decoded inst cache */
+ICacheEntry ic_io;                                      /* uncached (I/O page) */
+uint8 ic_pg[MAXMEMSIZE >> IC_V_PG];                     /* pages with cached code */
+TLBEntry tlb[64];                                       /* xlate cache, by APR */
+t_uint64 tlb_hit = 0;                                   /* TLB hits */
+t_uint64 tlb_miss = 0;                                  /* TLB misses */
 int32 dsmask[4] = { MMR3_KDS, MMR3_SDS, 0, MMR3_UDS };  /* dspace enables */
 t_addr cpu_memsize = INIMEMSIZE;                        /* last mem addr */
 
@@ -319,6 +351,7 @@ t_stat cpu_reset (DEVICE *dptr);
 t_stat cpu_set_hist (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat cpu_show_hist (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat cpu_show_virt (FILE *st, UNIT *uptr, int32 val, void *desc);
+t_stat cpu_show_tlb (FILE *st, UNIT *uptr, int32 val, void *desc);
 int32 GeteaB (int32 spec);
 int32 GeteaW (int32 spec);
 int32 relocR (int32 addr);
@@ -327,6 +360,8 @@ void relocR_test (int32 va, int32 apridx);
 void relocW_test (int32 va, int32 apridx);
 t_bool PLF_test (int32 va, int32 apr);
 void reloc_abort (int32 err, int32 apridx);
+void tlb_fill (int32 apridx);
+void tlb_flush (void);
 int32 ReadE (int32 addr);
 int32 ReadW (int32 addr);
 int32 ReadB (int32 addr);
@@ -342,6 +377,26 @@ void set_stack_trap (int32 adr);
 int32 get_PSW (void);
 void put_PSW (int32 val, t_bool prot);
 void put_PIRQ (int32 val);
+ICacheEntry *ic_fetch (int32 va);
+void ic_decode (ICacheEntry *ic, int32 IR);
+void ic_flush (void);
+void ic_inval (uint32 pa, int32 bc);
+void op_MOV (int32 IR, int32 srcspec, int32 dstspec);
+void op_CMP (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIT (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIC (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIS (int32 IR, int32 srcspec, int32 dstspec);
+void op_ADD (int32 IR, int32 srcspec, int32 dstspec);
+void op_SUB (int32 IR, int32 srcspec, int32 dstspec);
+void op_SOB (int32 IR, int32 srcspec, int32 dstspec);
+void op_MOV_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_CMP_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIT_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIC_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_BIS_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_ADD_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_SUB_RR (int32 IR, int32 srcspec, int32 dstspec);
+void op_BR (int32 IR, int32 srcspec, int32 dstspec);
 
 extern void fp11 (int32 IR);
 extern t_stat cis11 (int32 IR);
@@ -624,6 +679,8 @@ MTAB cpu_mod[] = {
       &cpu_set_hist, &cpu_show_hist },
     { MTAB_XTD|MTAB_VDV|MTAB_NMO|MTAB_SHP, 0, "VIRTUAL", NULL,
       NULL, &cpu_show_virt },
+    { MTAB_XTD|MTAB_VDV|MTAB_NMO, 0, "TLB", NULL,
+      NULL, &cpu_show_tlb },
     { 0 }
     };
 
@@ -671,6 +728,8 @@ STKLIM = STKLIM & STKLIM_RW;                            /* clean up STKLIM */
 MMR0 = MMR0 | MMR0_IC;                                  /* usually on */
 
 trap_req = calc_ints (ipl, trap_req);                   /* upd int req */
+ic_flush ();                                            /* mem may have chg */
+tlb_flush ();                                           /* so may APRs */
 trapea = 0;
 reason = 0;
 
@@ -718,6 +777,7 @@ while (reason == 0)  {
     int32 IR, srcspec, srcreg, dstspec, dstreg;
     int32 src, src2, dst, ea;
     int32 i, t, sign, oldrs, trapnum;
+    ICacheEntry *ic;
 
     if (cpu_astop) {
         cpu_astop = 0;
@@ -823,10 +883,11 @@ while (reason == 0)  {
         MMR1 = 0;
         MMR2 = PC;
         }
-    IR = ReadE (PC | isenable);                         /* fetch instruction */
+    ic = ic_fetch (PC | isenable);                      /* fetch instruction */
+    IR = ic->IR;
     sim_interval = sim_interval - 1;
-    srcspec = (IR >> 6) & 077;                          /* src, dst specs */
-    dstspec = IR & 077;
+    srcspec = ic->srcspec;                              /* src, dst specs */
+    dstspec = ic->dstspec;
     srcreg = (srcspec <= 07);                           /* src, dst = rmode? */
     dstreg = (dstspec <= 07);
     if (hst_lnt) {                                      /* record history? */
@@ -891,6 +952,10 @@ while (reason == 0)  {
 	fprintf (sim_deb, "\n");
         }
     PC = (PC + 2) & 0177777;                            /* incr PC, mod 65k */
+    if (ic->op) {                                       /* predecoded? */
+        ic->op (IR, srcspec, dstspec);                  /* execute directly */
+        continue;
+        }
     switch ((IR >> 12) & 017) {                         /* decode IR<15:12> */
 
 /* Opcode 0: no operands, specials, branches, JSR, SOPs */
@@ -929,6 +994,7 @@ while (reason == 0)  {
                     STKLIM = 0;                         /* clear STKLIM */
                     MMR0 = 0;                           /* clear MMR0 */
                     MMR3 = 0;                           /* clear MMR3 */
+                    tlb_flush ();
                     cpu_bme = 0;                        /* (also clear bme) */
                     for (i = 0; i < IPL_HLVL; i++)
                         int_req[i] = 0;
@@ -1037,82 +1103,14 @@ while (reason == 0)  {
             else PWriteW (dst, last_pa);
             break;                                      /* end SWAB */
 
-        case 004: case 005:                             /* BR */
-            BRANCH_F (IR);
-            break;
-
-        case 006: case 007:                             /* BR */
-            BRANCH_B (IR);
-            break;
-
-        case 010: case 011:                             /* BNE */
-            if (Z == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 012: case 013:                             /* BNE */
-            if (Z == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 014: case 015:                             /* BEQ */
-            if (Z) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 016: case 017:                             /* BEQ */
-            if (Z) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 020: case 021:                             /* BGE */
-            if ((N ^ V) == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 022: case 023:                             /* BGE */
-            if ((N ^ V) == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 024: case 025:                             /* BLT */
-            if (N ^ V) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 026: case 027:                             /* BLT */
-            if (N ^ V) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 030: case 031:                             /* BGT */
-            if ((Z | (N ^ V)) == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 032: case 033:                             /* BGT */
-            if ((Z | (N ^ V)) == 0) { BRANCH_B (IR); }
-            break;
-
-        case 034: case 035:                             /* BLE */
-            if (Z | (N ^ V)) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 036: case 037:                             /* BLE */
-            if (Z | (N ^ V)) {
-                BRANCH_B (IR);
-                }
+        case 004: case 005: case 006: case 007:         /* BR, BNE, BEQ, */
+        case 010: case 011: case 012: case 013:         /* BGE, BLT, BGT, BLE */
+        case 014: case 015: case 016: case 017:
+        case 020: case 021: case 022: case 023:
+        case 024: case 025: case 026: case 027:
+        case 030: case 031: case 032: case 033:
+        case 034: case 035: case 036: case 037:
+            op_BR (IR, srcspec, dstspec);
             break;
 
         case 040: case 041: case 042: case 043:         /* JSR */
@@ -1398,106 +1396,27 @@ while (reason == 0)  {
 */
 
     case 001:                                           /* MOV */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            ea = GeteaW (dstspec);
-            dst = R[srcspec];
-            }
-        else {
-            dst = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            if (!dstreg) ea = GeteaW (dstspec);
-            }
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else WriteW (dst, ea);
+        op_MOV (IR, srcspec, dstspec);
         break;
 
     case 002:                                           /* CMP */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            }
-        dst = (src - src2) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((src ^ src2) & (~src2 ^ dst));
-        C = (src < src2);
+        op_CMP (IR, srcspec, dstspec);
         break;
 
     case 003:                                           /* BIT */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
-            }
-        dst = src2 & src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
+        op_BIT (IR, srcspec, dstspec);
         break;
 
     case 004:                                           /* BIC */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = src2 & ~src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
+        op_BIC (IR, srcspec, dstspec);
         break;
 
     case 005:                                           /* BIS */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = src2 | src;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = 0;
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
+        op_BIS (IR, srcspec, dstspec);
         break;
 
     case 006:                                           /* ADD */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = (src2 + src) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((~src ^ src2) & (src ^ dst));
-        C = (dst < src);
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
+        op_ADD (IR, srcspec, dstspec);
         break;
 
 /* Opcode 07: EIS, FIS, CIS
@@ -1688,13 +1607,7 @@ while (reason == 0)  {
             break;
 
         case 7:                                         /* SOB */
-            if (CPUT (HAS_SXS)) {
-                R[srcspec] = (R[srcspec] - 1) & 0177777;
-                if (R[srcspec]) {
-                    JMP_PC ((PC - dstspec - dstspec) & 0177777);
-                    }
-                }
-            else setTRAP (TRAP_ILL);
+            op_SOB (IR, srcspec, dstspec);
             break;
             }                                           /* end switch EIS */
         break;                                          /* end case 007 */
@@ -1704,100 +1617,15 @@ while (reason == 0)  {
     case 010:
         switch ((IR >> 6) & 077) {                      /* decode IR<11:6> */
 
-        case 000: case 001:                             /* BPL */
-            if (N == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 002: case 003:                             /* BPL */
-            if (N == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 004: case 005:                             /* BMI */
-            if (N) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 006: case 007:                             /* BMI */
-            if (N) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 010: case 011:                             /* BHI */
-            if ((C | Z) == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 012: case 013:                             /* BHI */
-            if ((C | Z) == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 014: case 015:                             /* BLOS */
-            if (C | Z) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 016: case 017:                             /* BLOS */
-            if (C | Z) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 020: case 021:                             /* BVC */
-            if (V == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 022: case 023:                             /* BVC */
-            if (V == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 024: case 025:                             /* BVS */
-            if (V) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 026: case 027:                             /* BVS */
-            if (V) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 030: case 031:                             /* BCC */
-            if (C == 0) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 032: case 033:                             /* BCC */
-            if (C == 0) {
-                BRANCH_B (IR);
-                }
-            break;
-
-        case 034: case 035:                             /* BCS */
-            if (C) {
-                BRANCH_F (IR);
-                }
-            break;
-
-        case 036: case 037:                             /* BCS */
-            if (C) {
-                BRANCH_B (IR);
-                }
+        case 000: case 001: case 002: case 003:         /* BPL, BMI, BHI, */
+        case 004: case 005: case 006: case 007:         /* BLOS, BVC, BVS, */
+        case 010: case 011: case 012: case 013:         /* BCC, BCS */
+        case 014: case 015: case 016: case 017:
+        case 020: case 021: case 022: case 023:
+        case 024: case 025: case 026: case 027:
+        case 030: case 031: case 032: case 033:
+        case 034: case 035: case 036: case 037:
+            op_BR (IR, srcspec, dstspec);
             break;
 
         case 040: case 041: case 042: case 043:         /* EMT */
@@ -2111,22 +1939,7 @@ while (reason == 0)  {
         break;
 
     case 016:                                           /* SUB */
-        if (CPUT (IS_SDSD) && srcreg && !dstreg) {      /* R,not R */
-            src2 = ReadMW (GeteaW (dstspec));
-            src = R[srcspec];
-            }
-        else {
-            src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
-            src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
-            }
-        dst = (src2 - src) & 0177777;
-        N = GET_SIGN_W (dst);
-        Z = GET_Z (dst);
-        V = GET_SIGN_W ((src ^ src2) & (~src ^ dst));
-        C = (src2 < src);
-        if (dstreg)
-            R[dstspec] = dst;
-        else PWriteW (dst, last_pa);
+        op_SUB (IR, srcspec, dstspec);
         break;
 
 /* Opcode 17: floating point */
@@ -2151,6 +1964,523 @@ set_r_display (rs, cm);
 return reason;
 }
 
+/* Instruction routines
+
+   The most frequently executed instructions are implemented as separate
+   routines, so that the decoded instruction cache can dispatch to them
+   directly, bypassing the opcode switch in sim_instr.  The switch calls
+   the same routines, so there is only one implementation of each.
+
+   Inputs:
+        IR      =       instruction
+        srcspec =       source specifier <11:6>
+        dstspec =       destination specifier <5:0>
+*/
+
+void op_MOV (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 dst, ea;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    ea = GeteaW (dstspec);
+    dst = R[srcspec];
+    }
+else {
+    dst = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    if (!dstreg) ea = GeteaW (dstspec);
+    }
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+if (dstreg)
+    R[dstspec] = dst;
+else WriteW (dst, ea);
+return;
+}
+
+void op_CMP (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+    }
+dst = (src - src2) & 0177777;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((src ^ src2) & (~src2 ^ dst));
+C = (src < src2);
+return;
+}
+
+void op_BIT (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadW (GeteaW (dstspec));
+    }
+dst = src2 & src;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+return;
+}
+
+void op_BIC (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadMW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+    }
+dst = src2 & ~src;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+if (dstreg)
+    R[dstspec] = dst;
+else PWriteW (dst, last_pa);
+return;
+}
+
+void op_BIS (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadMW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+    }
+dst = src2 | src;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+if (dstreg)
+    R[dstspec] = dst;
+else PWriteW (dst, last_pa);
+return;
+}
+
+void op_ADD (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadMW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+    }
+dst = (src2 + src) & 0177777;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((~src ^ src2) & (src ^ dst));
+C = (dst < src);
+if (dstreg)
+    R[dstspec] = dst;
+else PWriteW (dst, last_pa);
+return;
+}
+
+void op_SUB (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src, src2, dst;
+int32 srcreg = (srcspec <= 07);
+int32 dstreg = (dstspec <= 07);
+
+if (CPUT (IS_SDSD) && srcreg && !dstreg) {              /* R,not R */
+    src2 = ReadMW (GeteaW (dstspec));
+    src = R[srcspec];
+    }
+else {
+    src = srcreg? R[srcspec]: ReadW (GeteaW (srcspec));
+    src2 = dstreg? R[dstspec]: ReadMW (GeteaW (dstspec));
+    }
+dst = (src2 - src) & 0177777;
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((src ^ src2) & (~src ^ dst));
+C = (src2 < src);
+if (dstreg)
+    R[dstspec] = dst;
+else PWriteW (dst, last_pa);
+return;
+}
+
+void op_SOB (int32 IR, int32 srcspec, int32 dstspec)
+{
+if (CPUT (HAS_SXS)) {
+    srcspec = srcspec & 07;
+    R[srcspec] = (R[srcspec] - 1) & 0177777;
+    if (R[srcspec]) {
+        JMP_PC ((PC - dstspec - dstspec) & 0177777);
+        }
+    }
+else setTRAP (TRAP_ILL);
+return;
+}
+
+/* Register to register forms of the double operand word instructions;
+   only selected by the decoded instruction cache.  With both operands
+   in registers, the source/destination evaluation order of the
+   different models does not matter.
+*/
+
+void op_MOV_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 dst = R[srcspec];
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+R[dstspec] = dst;
+return;
+}
+
+void op_CMP_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src = R[srcspec];
+int32 src2 = R[dstspec];
+int32 dst = (src - src2) & 0177777;
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((src ^ src2) & (~src2 ^ dst));
+C = (src < src2);
+return;
+}
+
+void op_BIT_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 dst = R[dstspec] & R[srcspec];
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+return;
+}
+
+void op_BIC_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 dst = R[dstspec] & ~R[srcspec];
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+R[dstspec] = dst;
+return;
+}
+
+void op_BIS_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 dst = R[dstspec] | R[srcspec];
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = 0;
+R[dstspec] = dst;
+return;
+}
+
+void op_ADD_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src = R[srcspec];
+int32 src2 = R[dstspec];
+int32 dst = (src2 + src) & 0177777;
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((~src ^ src2) & (src ^ dst));
+C = (dst < src);
+R[dstspec] = dst;
+return;
+}
+
+void op_SUB_RR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 src = R[srcspec];
+int32 src2 = R[dstspec];
+int32 dst = (src2 - src) & 0177777;
+
+N = GET_SIGN_W (dst);
+Z = GET_Z (dst);
+V = GET_SIGN_W ((src ^ src2) & (~src ^ dst));
+C = (src2 < src);
+R[dstspec] = dst;
+return;
+}
+
+/* Conditional branches, 000400 - 003777 and 100000 - 103777 */
+
+void op_BR (int32 IR, int32 srcspec, int32 dstspec)
+{
+int32 t;
+
+switch (((IR >> 12) & 010) | ((IR >> 8) & 07)) {       /* IR<15,10:8> */
+
+    case 001:                                           /* BR */
+        t = 1;
+        break;
+
+    case 002:                                           /* BNE */
+        t = (Z == 0);
+        break;
+
+    case 003:                                           /* BEQ */
+        t = Z;
+        break;
+
+    case 004:                                           /* BGE */
+        t = ((N ^ V) == 0);
+        break;
+
+    case 005:                                           /* BLT */
+        t = N ^ V;
+        break;
+
+    case 006:                                           /* BGT */
+        t = ((Z | (N ^ V)) == 0);
+        break;
+
+    case 007:                                           /* BLE */
+        t = Z | (N ^ V);
+        break;
+
+    case 010:                                           /* BPL */
+        t = (N == 0);
+        break;
+
+    case 011:                                           /* BMI */
+        t = N;
+        break;
+
+    case 012:                                           /* BHI */
+        t = ((C | Z) == 0);
+        break;
+
+    case 013:                                           /* BLOS */
+        t = C | Z;
+        break;
+
+    case 014:                                           /* BVC */
+        t = (V == 0);
+        break;
+
+    case 015:                                           /* BVS */
+        t = V;
+        break;
+
+    case 016:                                           /* BCC */
+        t = (C == 0);
+        break;
+
+    case 017:                                           /* BCS */
+        t = C;
+        break;
+
+    default:                                            /* not a branch */
+        t = 0;
+        break;
+        }
+
+if (t) {                                                /* taken? */
+    if (IR & 0200) {                                    /* backward */
+        BRANCH_B (IR);
+        }
+    else {                                              /* forward */
+        BRANCH_F (IR);
+        }
+    }
+return;
+}
+
+/* Decoded instruction cache
+
+   Instructions are cached by physical address, together with their
+   source and destination specifiers and, for the opcodes implemented
+   by the routines above, the routine that executes them.  The cache is
+   direct mapped on physical word address.
+
+   Every path that modifies memory while the simulator is running must
+   invalidate the cache: WriteW, WriteB, PWriteW, PWriteB and DMA
+   through Map_WriteB, Map_WriteW (ic_inval).  Memory changed while the
+   simulator is stopped (examine/deposit, load, boot, memory size) is
+   covered by flushing the whole cache on entry to sim_instr.  The I/O
+   page is never cached.
+
+   Inputs:
+        va      =       virtual address, <18:16> = mode, I/D space
+   Outputs:
+        ic      =       cache entry with decoded instruction
+*/
+
+ICacheEntry *ic_fetch (int32 va)
+{
+int32 pa, data;
+ICacheEntry *ic;
+
+if ((va & 1) && CPUT (HAS_ODD)) {                       /* odd address? */
+    setCPUERR (CPUE_ODD);
+    ABORT (TRAP_ODD);
+    }
+if (MMR0 & MMR0_MME)                                    /* if mmgt */
+    pa = relocR (va);                                   /* relocate */
+else {
+    pa = va & 0177777;                                  /* mmgt off */
+    if (pa >= 0160000)
+        pa = 017600000 | pa;
+    }
+ic = &ic_tab[(pa >> 1) & IC_MASK];
+if (ic->pa == (pa & ~1))                                /* hit? */
+    return ic;
+if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
+    ic->pa = pa & ~1;                                   /* fill entry */
+    ic_pg[pa >> IC_V_PG] = 1;
+    ic_decode (ic, M[pa >> 1]);
+    return ic;
+    }
+if ((pa < IOPAGEBASE) ||                                /* not I/O address */
+    (CPUT (CPUT_J) && (pa >= IOBA_CPU))) {              /* or J11 int reg? */
+        setCPUERR (CPUE_NXM);
+        ABORT (TRAP_NXM);
+        }
+if (iopageR (&data, pa, READ) != SCPE_OK) {             /* invalid I/O addr? */
+    setCPUERR (CPUE_TMO);
+    ABORT (TRAP_NXM);
+    }
+ic_decode (&ic_io, data);                               /* don't cache */
+return &ic_io;
+}
+
+void ic_decode (ICacheEntry *ic, int32 IR)
+{
+t_bool rr;
+
+ic->IR = IR;
+ic->srcspec = (IR >> 6) & 077;
+ic->dstspec = IR & 077;
+rr = (ic->srcspec <= 07) && (ic->dstspec <= 07);        /* R,R? */
+switch ((IR >> 12) & 017) {                             /* decode IR<15:12> */
+
+    case 000:                                           /* branches */
+        ic->op = ((IR >= 000400) && (IR < 004000))? &op_BR: NULL;
+        break;
+
+    case 001:                                           /* MOV */
+        ic->op = rr? &op_MOV_RR: &op_MOV;
+        break;
+
+    case 002:                                           /* CMP */
+        ic->op = rr? &op_CMP_RR: &op_CMP;
+        break;
+
+    case 003:                                           /* BIT */
+        ic->op = rr? &op_BIT_RR: &op_BIT;
+        break;
+
+    case 004:                                           /* BIC */
+        ic->op = rr? &op_BIC_RR: &op_BIC;
+        break;
+
+    case 005:                                           /* BIS */
+        ic->op = rr? &op_BIS_RR: &op_BIS;
+        break;
+
+    case 006:                                           /* ADD */
+        ic->op = rr? &op_ADD_RR: &op_ADD;
+        break;
+
+    case 007:                                           /* SOB */
+        ic->op = (((IR >> 9) & 07) == 7)? &op_SOB: NULL;
+        break;
+
+    case 010:                                           /* branches */
+        ic->op = (IR < 0104000)? &op_BR: NULL;
+        break;
+
+    case 016:                                           /* SUB */
+        ic->op = rr? &op_SUB_RR: &op_SUB;
+        break;
+
+    default:                                            /* all others */
+        ic->op = NULL;
+        break;
+        }
+return;
+}
+
+void ic_flush (void)
+{
+int32 i;
+
+for (i = 0; i < IC_SIZE; i++)
+    ic_tab[i].pa = -1;
+memset (ic_pg, 0, sizeof (ic_pg));
+return;
+}
+
+/* Invalidate cached instructions in physical range pa .. pa + bc - 1
+
+   Only pages that have had code cached since the last flush are
+   scanned, so DMA into data buffers costs a table lookup per page.
+*/
+
+void ic_inval (uint32 pa, int32 bc)
+{
+uint32 lim, plim;
+
+if (bc <= 0)
+    return;
+lim = (pa + bc + 1) & ~1;
+for (pa = pa & ~1; pa < lim; pa = plim) {
+    plim = ((pa >> IC_V_PG) + 1) << IC_V_PG;            /* end of page */
+    if (plim > lim)
+        plim = lim;
+    if (ic_pg[pa >> IC_V_PG] == 0)                      /* no code here? */
+        continue;
+    for ( ; pa < plim; pa = pa + 2) {
+        if (ic_tab[(pa >> 1) & IC_MASK].pa == (int32) pa)
+            ic_tab[(pa >> 1) & IC_MASK].pa = -1;
+        }
+    }
+return;
+}
+
+
 /* Effective address calculations
 
    Inputs:
@@ -2448,6 +2778,7 @@ if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     if (sim_log && sys_dev.dctrl)
         fprintf (sim_log, "    write %06o := %06o\n", pa, data);
 #endif
+    IC_INVAL (pa);                                      /* inval icache */
     M[pa >> 1] = data;
     return;
     }
@@ -2476,6 +2807,7 @@ if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     if (sim_log && sys_dev.dctrl)
         fprintf (sim_log, "    write %06o := %06o\n", pa, data);
 #endif
+    IC_INVAL (pa);                                      /* inval icache */
     M[pa >> 1] = data;
     return;
     }
@@ -2498,6 +2830,7 @@ if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     if (sim_log && sys_dev.dctrl)
         fprintf (sim_log, "    write %06o := %06o\n", pa, data);
 #endif
+    IC_INVAL (pa);                                      /* inval icache */
     M[pa >> 1] = data;
     return;
     }
@@ -2523,6 +2856,7 @@ if (ADDR_IS_MEM (pa)) {                                 /* memory address? */
     if (sim_log && sys_dev.dctrl)
         fprintf (sim_log, "    write %06o := %06o\n", pa, data);
 #endif
+    IC_INVAL (pa);                                      /* inval icache */
     M[pa >> 1] = data;
     return;
     }
@@ -2555,10 +2889,19 @@ return;
 
 int32 relocR (int32 va)
 {
-int32 apridx, apr, pa;
+int32 apridx, apr, pa, dbn;
+TLBEntry *tp;
 
 if (MMR0 & MMR0_MME) {                                  /* if mmgt */
     apridx = (va >> VA_V_APF) & 077;                    /* index into APR */
+    tp = &tlb[apridx];
+    dbn = va & VA_BN;
+    if ((tp->acc & TLB_RD) &&                           /* TLB hit? */
+        (dbn >= tp->lo) && (dbn <= tp->hi)) {
+        tlb_hit++;
+        return (va & VA_DF) + tp->base;
+        }
+    tlb_miss++;
     apr = APRFILE[apridx];                              /* with va<18:13> */
     if ((apr & PDR_PRD) != 2)                           /* not 2, 6? */
          relocR_test (va, apridx);                      /* long test */
@@ -2570,6 +2913,7 @@ if (MMR0 & MMR0_MME) {                                  /* if mmgt */
         if (pa >= 0760000)
             pa = 017000000 | pa;
         }
+    tlb_fill (apridx);
     }
 else {
     pa = va & 0177777;                                  /* mmgt off */
@@ -2662,10 +3006,19 @@ return;
 
 int32 relocW (int32 va)
 {
-int32 apridx, apr, pa;
+int32 apridx, apr, pa, dbn;
+TLBEntry *tp;
 
 if (MMR0 & MMR0_MME) {                                  /* if mmgt */
     apridx = (va >> VA_V_APF) & 077;                    /* index into APR */
+    tp = &tlb[apridx];
+    dbn = va & VA_BN;
+    if ((tp->acc & TLB_WR) &&                           /* TLB hit? */
+        (dbn >= tp->lo) && (dbn <= tp->hi)) {
+        tlb_hit++;
+        return (va & VA_DF) + tp->base;
+        }
+    tlb_miss++;
     apr = APRFILE[apridx];                              /* with va<18:13> */
     if ((apr & PDR_ACF) != 6)                           /* not writeable? */
         relocW_test (va, apridx);                       /* long test */
@@ -2678,6 +3031,7 @@ if (MMR0 & MMR0_MME) {                                  /* if mmgt */
         if (pa >= 0760000)
             pa = 017000000 | pa;
         }
+    tlb_fill (apridx);
     }
 else {
     pa = va & 0177777;                                  /* mmgt off */
@@ -2737,6 +3091,58 @@ reloc_abort (err, apridx);
 return;
 }
 
+/* Translation lookaside buffer
+
+   relocR and relocW cache the outcome of their checks per APR, that is,
+   per mode, I/D space and page.  An entry records the physical base of
+   the page, the range of blocks that pass the page length test, and
+   whether the page may be read, and written without setting W, with
+   no further action.  Pages with trapping access codes, or that wrap
+   or run into the I/O page, are never cached, so a hit always yields
+   the same physical address as the full relocation.
+
+   Because the TLB is indexed by APR, a change of the current mode does
+   not need a flush.  Changes to a PAR or PDR, MMR0 or MMR3 do (as does
+   entry to the simulator, as the console can change any of them).
+*/
+
+void tlb_fill (int32 apridx)
+{
+int32 apr = APRFILE[apridx];
+int32 plf = (apr & PDR_PLF) >> 2;                       /* align with va<12:6> */
+int32 base = (apr >> 10) & 017777700;
+TLBEntry *tp = &tlb[apridx];
+
+tp->acc = 0;
+if ((MMR3 & MMR3_M22E)?                                 /* page end wraps */
+    ((base + VA_DF) > PAMASK):                          /* or reaches I/O? */
+    ((base + VA_DF) >= 0760000))
+    return;                                             /* then don't cache */
+if ((apr & PDR_PRD) == 2)                               /* 2, 6: readable */
+    tp->acc = TLB_RD;
+if (((apr & PDR_ACF) == 6) && (apr & PDR_W))            /* 6, W set: writeable */
+    tp->acc = tp->acc | TLB_WR;
+tp->base = base;
+if (apr & PDR_ED) {                                     /* expand down? */
+    tp->lo = plf;
+    tp->hi = VA_BN;
+    }
+else {
+    tp->lo = 0;
+    tp->hi = plf;
+    }
+return;
+}
+
+void tlb_flush (void)
+{
+int32 i;
+
+for (i = 0; i < 64; i++)
+    tlb[i].acc = 0;
+return;
+}
+
 /* Relocate virtual address, console access
 
    Inputs:
@@ -2828,6 +3234,7 @@ switch ((pa >> 1) & 3) {                                /* decode pa<2:1> */
             data = (pa & 1)? (MMR0 & 0377) | (data << 8): (MMR0 & ~0377) | data;
         data = data & cpu_tab[cpu_model].mm0;
         MMR0 = (MMR0 & ~MMR0_WR) | (data & MMR0_WR);
+        tlb_flush ();
         return SCPE_OK;
 
     default:                                            /* MMR1, MMR2 */
@@ -2848,6 +3255,7 @@ if (pa & 1)
 MMR3 = data & cpu_tab[cpu_model].mm3;
 cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);
 dsenable = calc_ds (cm);
+tlb_flush ();
 return SCPE_OK;
 }
 
@@ -2905,6 +3313,7 @@ if (left)
         (((uint32) (data & cpu_tab[cpu_model].par)) << 16)) & ~(PDR_A|PDR_W);
 else APRFILE[idx] = ((APRFILE[idx] & ~0177777) |
     (data & cpu_tab[cpu_model].pdr)) & ~(PDR_A|PDR_W);
+tlb[idx].acc = 0;                                       /* drop xlate */
 return SCPE_OK;
 }
 
@@ -3067,6 +3476,8 @@ MMR2 = 0;
 MMR3 = 0;
 trap_req = 0;
 wait_state = 0;
+tlb_flush ();
+tlb_hit = tlb_miss = 0;
 if (M == NULL)
     M = (uint16 *) calloc (MEMSIZE >> 1, sizeof (uint16));
 if (M == NULL)
@@ -3220,6 +3631,24 @@ for (k = 0; k < lnt; k++) {                             /* print specified */
 return SCPE_OK;
 }
 
+/* TLB statistics */
+
+t_stat cpu_show_tlb (FILE *st, UNIT *uptr, int32 val, void *desc)
+{
+int32 i, n;
+double tot = (double) tlb_hit + (double) tlb_miss;
+
+for (i = n = 0; i < 64; i++) {
+    if (tlb[i].acc)
+        n++;
+    }
+fprintf (st, "TLB hits %.0f, misses %.0f", (double) tlb_hit, (double) tlb_miss);
+if (tot > 0)
+    fprintf (st, " (%.2f%% hits)", ((double) tlb_hit * 100.0) / tot);
+fprintf (st, ", %d of 64 entries valid\n", n);
+return SCPE_OK;
+}
+
 /* Virtual address translation */
 
 t_stat cpu_show_virt (FILE *of, UNIT *uptr, int32 val, void *desc)
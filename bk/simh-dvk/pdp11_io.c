@@ -329,9 +329,8 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = cpu_memsize;
     else return bc;                                     /* no, err */
-    for ( ; ba < alim; ba = ba + 2) {                   /* by words */
-        *buf++ = M[ba >> 1];
-        }
+    if (alim > ba)                                      /* by words */
+        memcpy (buf, &M[ba >> 1], alim - ba);
     return (lim - alim);
     }
 }
@@ -347,6 +346,7 @@ if (cpu_bme) {                                          /* map enabled? */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
             return (lim - ba);
+        ic_inval (ma, 1);                               /* inval icache */
         if (ma & 1) M[ma >> 1] = (M[ma >> 1] & 0377) |
             ((uint16) *buf++ << 8);
         else M[ma >> 1] = (M[ma >> 1] & ~0377) | *buf++;
@@ -359,6 +359,7 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = cpu_memsize;
     else return bc;                                     /* no, err */
+    ic_inval (ba, alim - ba);                           /* inval icache */
     for ( ; ba < alim; ba++) {                          /* by bytes */
         if (ba & 1)
             M[ba >> 1] = (M[ba >> 1] & 0377) | ((uint16) *buf++ << 8);
@@ -379,6 +380,7 @@ if (cpu_bme) {                                          /* map enabled? */
         ma = Map_Addr (ba);                             /* map addr */
         if (!ADDR_IS_MEM (ma))                          /* NXM? err */
             return (lim - ba);
+        ic_inval (ma, 2);                               /* inval icache */
         M[ma >> 1] = *buf++;
         }
     return 0;
@@ -389,9 +391,9 @@ else {                                                  /* physical */
     else if (ADDR_IS_MEM (ba))                          /* no, strt ok? */
         alim = cpu_memsize;
     else return bc;                                     /* no, err */
-    for ( ; ba < alim; ba = ba + 2) {                   /* by words */
-        M[ba >> 1] = *buf++;
-        }
+    ic_inval (ba, alim - ba);                           /* inval icache */
+    if (alim > ba)                                      /* by words */
+        memcpy (&M[ba >> 1], buf, alim - ba);
     return (lim - alim);
     }
 }
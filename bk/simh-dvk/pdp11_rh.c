@@ -556,6 +556,7 @@ for (i = 0; i < bc; i = i + pbc) {                      /* loop by pages */
     pbc = UBM_PAGSIZE - UBM_GETOFF (pa);                /* left in page */
     if (pbc > (bc - i))                                 /* limit to rem xfr */
         pbc = bc - i;
+    ic_inval (pa, pbc);                                 /* inval icache */
     for (j = 0; j < pbc; j = j + 2) {                   /* loop by words */
         M[pa >> 1] = *buf++;                            /* put word */
         if (!(massbus[mb].cs2 & CS2_UAI)) {             /* if not inhb */
@@ -202,6 +202,7 @@ void rk_go (void);
 void rk_set_done (int32 error);
 void rk_clr_done (void);
 t_stat rk_boot (int32 unitno, DEVICE *dptr);
+t_stat rk_attach (UNIT *uptr, char *cptr);
 
 /* RK11 data structures
 
@@ -270,7 +271,7 @@ DEVICE rk_dev = {
     "RK", rk_unit, rk_reg, rk_mod,
     RK_NUMDR, 8, 24, 1, 8, 16,
     NULL, NULL, &rk_reset,
-    &rk_boot, NULL, NULL,
+    &rk_boot, &rk_attach, NULL,
     &rk_dib, DEV_DISABLE | DEV_UBUS | DEV_Q18
     };
 
@@ -396,7 +397,7 @@ switch ((PA >> 1) & 07) {                               /* decode PA<3:1> */
 
 void rk_go (void)
 {
-int32 i, sect, cyl, func;
+int32 i, sect, cyl, func, da, wc;
 UNIT *uptr;
 
 func = GET_FUNC (rkcs);                                 /* get function */
@@ -462,7 +463,17 @@ if (func == RKCS_SEEK) {                                /* seek? */
     rk_set_done (0);                                    /* set done */
     sim_activate (uptr, MAX (RK_MIN, i));               /* schedule */
     }
-else sim_activate (uptr, i + rk_rwait);
+else {
+    if ((func == RKCS_READ) && !(rkcs & RKCS_FMT) &&    /* async read? */
+        uptr->aio) {
+        da = GET_DA (rkda) * RK_NUMWD;                  /* start host read */
+        wc = 0200000 - rkwc;
+        if ((da + wc) > (int32) uptr->capac)
+            wc = uptr->capac - da;
+        sim_aio_prefetch (uptr, da * sizeof (int16), sizeof (int16), wc);
+        }
+    sim_activate (uptr, i + rk_rwait);
+    }
 uptr->FUNC = func;                                      /* save func */
 uptr->CYL = cyl;                                        /* put on cylinder */
 return;
@@ -482,7 +493,7 @@ t_stat rk_svc (UNIT *uptr)
 int32 i, drv, err, awc, wc, cma, cda, t;
 int32 da, cyl, track, sect;
 uint32 ma;
-uint16 comp;
+uint16 comp, *xb;
 
 drv = (int32) (uptr - rk_dev.units);                    /* get drv number */
 if (uptr->FUNC == RKCS_SEEK) {                          /* seek */
@@ -521,8 +532,9 @@ if ((da + wc) > (int32) uptr->capac) {                  /* overrun? */
     rker = rker | RKER_OVR;                             /* set overrun err */
     }
 
-err = fseek (uptr->fileref, da * sizeof (int16), SEEK_SET);
-if (wc && (err == 0)) {                                 /* seek ok? */
+err = 0;
+xb = rkxb;
+if (wc) {                                               /* any xfer? */
     switch (uptr->FUNC) {                               /* case on function */
 
     case RKCS_READ:                                     /* read */
@@ -537,20 +549,22 @@ if (wc && (err == 0)) {                                 /* seek ok? */
                 cda = cda + RK_NUMWD;                   /* next sector */
                 }                                       /* end for wc */
             }                                           /* end if format */
-        else {                                          /* normal read */
-            i = fxread (rkxb, sizeof (int16), wc, uptr->fileref);
-            err = ferror (uptr->fileref);               /* read file */
+        else if ((xb = (uint16 *) sim_fmap_ptr (uptr,   /* mapped? */
+            da * sizeof (int16), wc * sizeof (int16))) == NULL) {
+            xb = rkxb;                                  /* normal read */
+            i = sim_uread (uptr, da * sizeof (int16), rkxb, sizeof (int16), wc);
+            err = sim_uerror (uptr);                    /* read file */
             for ( ; i < wc; i++)                        /* fill buf */
                 rkxb[i] = 0;
             }
         if (rkcs & RKCS_INH) {                          /* incr inhibit? */
-            if (t = Map_WriteW (ma, 2, &rkxb[wc - 1])) { /* store last */
+            if (t = Map_WriteW (ma, 2, &xb[wc - 1])) {  /* store last */
                 rker = rker | RKER_NXM;                 /* NXM? set flag */
                 wc = 0;                                 /* no transfer */
                 }
             }
         else {                                          /* normal store */
-            if (t = Map_WriteW (ma, wc << 1, rkxb)) {   /* store buf */
+            if (t = Map_WriteW (ma, wc << 1, xb)) {     /* store buf */
                 rker = rker | RKER_NXM;                 /* NXM? set flag */
                 wc = wc - t;                            /* adj wd cnt */
                 }
@@ -558,16 +572,21 @@ if (wc && (err == 0)) {                                 /* seek ok? */
         break;                                          /* end read */
 
     case RKCS_WRITE:                                    /* write */
+        awc = (wc + (RK_NUMWD - 1)) & ~(RK_NUMWD - 1);  /* mapped? */
+        xb = (uint16 *) sim_fmap_ptr (uptr, da * sizeof (int16),
+            awc * sizeof (int16));
+        if (xb == NULL)
+            xb = rkxb;
         if (rkcs & RKCS_INH) {                          /* incr inhibit? */
             if (t = Map_ReadW (ma, 2, &comp)) {         /* get 1st word */
                 rker = rker | RKER_NXM;                 /* NXM? set flag */
                 wc = 0;                                 /* no transfer */
                 }
             for (i = 0; i < wc; i++)                    /* all words same */
-                rkxb[i] = comp;
+                xb[i] = comp;
             }
         else {                                          /* normal fetch */
-            if (t = Map_ReadW (ma, wc << 1, rkxb)) {    /* get buf */
+            if (t = Map_ReadW (ma, wc << 1, xb)) {      /* get buf */
                 rker = rker | RKER_NXM;                 /* NXM? set flg */
                 wc = wc - t;                            /* adj wd cnt */
                 }
@@ -575,15 +594,16 @@ if (wc && (err == 0)) {                                 /* seek ok? */
         if (wc) {                                       /* any xfer? */
             awc = (wc + (RK_NUMWD - 1)) & ~(RK_NUMWD - 1); /* clr to */
             for (i = wc; i < awc; i++)                  /* end of blk */
-                rkxb[i] = 0;
-            fxwrite (rkxb, sizeof (int16), awc, uptr->fileref);
-            err = ferror (uptr->fileref);
+                xb[i] = 0;
+            if (xb == rkxb)
+                sim_uwrite (uptr, da * sizeof (int16), rkxb, sizeof (int16), awc);
+            err = sim_uerror (uptr);
             }
         break;                                          /* end write */
 
     case RKCS_WCHK:                                     /* write check */
-        i = fxread (rkxb, sizeof (int16), wc, uptr->fileref);
-        if (err = ferror (uptr->fileref)) {             /* read error? */
+        i = sim_uread (uptr, da * sizeof (int16), rkxb, sizeof (int16), wc);
+        if (err = sim_uerror (uptr)) {                  /* read error? */
             wc = 0;                                     /* no transfer */
             break;
             }
@@ -709,6 +729,22 @@ if (rkxb == NULL)
 return SCPE_OK;
 }
 
+/* Attach routine */
+
+t_stat rk_attach (UNIT *uptr, char *cptr)
+{
+t_stat r;
+
+r = attach_unit (uptr, cptr);                           /* attach unit */
+if (r != SCPE_OK)
+    return r;
+r = sim_fattach_opt (uptr, uptr->capac * sizeof (int16), /* -M or -A? */
+    RK_MAXFR * sizeof (int16));
+if (r != SCPE_OK)
+    detach_unit (uptr);
+return r;
+}
+
 /* Device bootstrap */
 
 #define BOOT_START      02000                           /* start */
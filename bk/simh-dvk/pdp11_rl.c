@@ -338,7 +338,7 @@ return SCPE_OK;
 
 t_stat rl_wr (int32 data, int32 PA, int32 access)
 {
-int32 curr, offs, newc, maxc;
+int32 curr, offs, newc, maxc, da, wc, maxwc;
 UNIT *uptr;
 
 switch ((PA >> 1) & 07) {                               /* decode PA<2:1> */
@@ -390,6 +390,14 @@ switch ((PA >> 1) & 07) {                               /* decode PA<2:1> */
             sim_activate (uptr, rl_swait * abs (newc - curr));
             break;
         default:                                        /* data transfer */
+            if (uptr->aio && (GET_FUNC (rlcs) >= RLCS_READ)) {
+                da = GET_DA (rlda) * RL_NUMWD;          /* start host read */
+                wc = 0200000 - rlmp;
+                maxwc = (RL_NUMSC - GET_SECT (rlda)) * RL_NUMWD;
+                if (wc > maxwc)
+                    wc = maxwc;
+                sim_aio_prefetch (uptr, da * sizeof (int16), sizeof (int16), wc);
+                }
             sim_activate (uptr, rl_swait);              /* activate unit */
             break;
             }                                           /* end switch func */
@@ -440,7 +448,7 @@ t_stat rl_svc (UNIT *uptr)
 int32 err, wc, maxwc, t;
 int32 i, func, da, awc;
 uint32 ma;
-uint16 comp;
+uint16 comp, *xb;
 
 func = GET_FUNC (rlcs);                                 /* get function */
 if (func == RLCS_GSTA) {                                /* get status */
@@ -495,36 +503,45 @@ wc = 0200000 - rlmp;                                    /* get true wc */
 maxwc = (RL_NUMSC - GET_SECT (rlda)) * RL_NUMWD;        /* max transfer */
 if (wc > maxwc)                                         /* track overrun? */
     wc = maxwc;
-err = fseek (uptr->fileref, da * sizeof (int16), SEEK_SET);
-
-if ((func >= RLCS_READ) && (err == 0)) {                /* read (no hdr)? */
-    i = fxread (rlxb, sizeof (int16), wc, uptr->fileref);
-    err = ferror (uptr->fileref);
-    for ( ; i < wc; i++)                                /* fill buffer */
-        rlxb[i] = 0;
-    if (t = Map_WriteW (ma, wc << 1, rlxb)) {           /* store buffer */
+err = 0;
+
+if (func >= RLCS_READ) {                                /* read (no hdr)? */
+    xb = (uint16 *) sim_fmap_ptr (uptr, da * sizeof (int16), wc * sizeof (int16));
+    if (xb == NULL) {                                   /* not mapped? */
+        xb = rlxb;
+        i = sim_uread (uptr, da * sizeof (int16), rlxb, sizeof (int16), wc);
+        err = sim_uerror (uptr);
+        for ( ; i < wc; i++)                            /* fill buffer */
+            rlxb[i] = 0;
+        }
+    if (t = Map_WriteW (ma, wc << 1, xb)) {             /* store buffer */
         rlcs = rlcs | RLCS_ERR | RLCS_NXM;              /* nxm */
         wc = wc - t;                                    /* adjust wc */
         }
     }                                                   /* end read */
 
-if ((func == RLCS_WRITE) && (err == 0)) {               /* write? */
-    if (t = Map_ReadW (ma, wc << 1, rlxb)) {            /* fetch buffer */
+if (func == RLCS_WRITE) {                               /* write? */
+    awc = (wc + (RL_NUMWD - 1)) & ~(RL_NUMWD - 1);      /* mapped? */
+    xb = (uint16 *) sim_fmap_ptr (uptr, da * sizeof (int16), awc * sizeof (int16));
+    if (xb == NULL)
+        xb = rlxb;
+    if (t = Map_ReadW (ma, wc << 1, xb)) {              /* fetch buffer */
         rlcs = rlcs | RLCS_ERR | RLCS_NXM;              /* nxm */
         wc = wc - t;                                    /* adj xfer lnt */
         }
     if (wc) {                                           /* any xfer? */
         awc = (wc + (RL_NUMWD - 1)) & ~(RL_NUMWD - 1);  /* clr to */
         for (i = wc; i < awc; i++)                      /* end of blk */
-            rlxb[i] = 0;
-        fxwrite (rlxb, sizeof (int16), awc, uptr->fileref);
-        err = ferror (uptr->fileref);
+            xb[i] = 0;
+        if (xb == rlxb)
+            sim_uwrite (uptr, da * sizeof (int16), rlxb, sizeof (int16), awc);
+        err = sim_uerror (uptr);
         }
     }                                                   /* end write */
 
-if ((func == RLCS_WCHK) && (err == 0)) {                /* write check? */
-    i = fxread (rlxb, sizeof (int16), wc, uptr->fileref);
-    err = ferror (uptr->fileref);
+if (func == RLCS_WCHK) {                                /* write check? */
+    i = sim_uread (uptr, da * sizeof (int16), rlxb, sizeof (int16), wc);
+    err = sim_uerror (uptr);
     for ( ; i < wc; i++)                                /* fill buffer */
         rlxb[i] = 0;
     awc = wc;                                           /* save wc */
@@ -606,21 +623,27 @@ if (r != SCPE_OK)                                       /* error? */
 uptr->TRK = 0;                                          /* cylinder 0 */
 uptr->STAT = RLDS_VCK;                                  /* new volume */
 if ((p = sim_fsize (uptr->fileref)) == 0) {             /* new disk image? */
-    if (uptr->flags & UNIT_RO)                          /* if ro, done */
-        return SCPE_OK;
-    return pdp11_bad_block (uptr, RL_NUMSC, RL_NUMWD);
-    }
-if ((uptr->flags & UNIT_AUTO) == 0)                     /* autosize? */
-    return SCPE_OK;
-if (p > (RL01_SIZE * sizeof (int16))) {
-    uptr->flags = uptr->flags | UNIT_RL02;
-    uptr->capac = RL02_SIZE;
+    if ((uptr->flags & UNIT_RO) == 0) {                 /* if ro, done */
+        r = pdp11_bad_block (uptr, RL_NUMSC, RL_NUMWD);
+        if (r != SCPE_OK)
+            return r;
+        }
     }
-else {
-    uptr->flags = uptr->flags & ~UNIT_RL02;
-    uptr->capac = RL01_SIZE;
+else if (uptr->flags & UNIT_AUTO) {                     /* autosize? */
+    if (p > (RL01_SIZE * sizeof (int16))) {
+        uptr->flags = uptr->flags | UNIT_RL02;
+        uptr->capac = RL02_SIZE;
+        }
+    else {
+        uptr->flags = uptr->flags & ~UNIT_RL02;
+        uptr->capac = RL01_SIZE;
+        }
     }
-return SCPE_OK;
+r = sim_fattach_opt (uptr, uptr->capac * sizeof (int16), /* -M or -A? */
+    RL_MAXFR * sizeof (int16));
+if (r != SCPE_OK)
+    detach_unit (uptr);
+return r;
 }
 
 /* Set size routine */
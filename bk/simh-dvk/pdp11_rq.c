@@ -584,6 +584,7 @@ DEVICE rq_dev, rqb_dev, rqc_dev,rqd_dev;
 t_stat rq_rd (int32 *data, int32 PA, int32 access);
 t_stat rq_wr (int32 data, int32 PA, int32 access);
 t_stat rq_svc (UNIT *uptr);
+void rq_prefetch (UNIT *uptr, int32 pkt);
 t_stat rq_tmrsvc (UNIT *uptr);
 t_stat rq_quesvc (UNIT *uptr);
 t_stat rq_reset (DEVICE *dptr);
@@ -1604,6 +1605,7 @@ if (uptr = rq_getucb (cp, lu)) {                        /* unit exist? */
         cp->pak[pkt].d[RW_WBCH] = cp->pak[pkt].d[RW_BCH];
         cp->pak[pkt].d[RW_WBLL] = cp->pak[pkt].d[RW_LBNL];
         cp->pak[pkt].d[RW_WBLH] = cp->pak[pkt].d[RW_LBNH];
+        rq_prefetch (uptr, pkt);                        /* start host read */
         sim_activate (uptr, rq_xtime);                  /* activate */
         return OK;                                      /* done */
         }
@@ -1661,6 +1663,7 @@ t_stat rq_svc (UNIT *uptr)
 MSC *cp = rq_ctxmap[uptr->cnum];
 
 uint32 i, t, tbc, abc, wwc;
+uint16 *xb;
 uint32 err = 0;
 int32 pkt = uptr->cpkt;                                 /* get packet */
 uint32 cmd = GETP (pkt, CMD_OPC, OPC);                  /* get cmd */
@@ -1697,22 +1700,23 @@ if (cmd == OP_ERS) {                                    /* erase? */
     wwc = ((tbc + (RQ_NUMBY - 1)) & ~(RQ_NUMBY - 1)) >> 1;
     for (i = 0; i < wwc; i++)                           /* clr buf */
         rqxb[i] = 0;
-    err = sim_fseek (uptr->fileref, da, SEEK_SET);      /* set pos */
-    if (!err)
-        sim_fwrite (rqxb, sizeof (int16), wwc, uptr->fileref);
-    err = ferror (uptr->fileref);                       /* end if erase */
+    sim_uwrite (uptr, da, rqxb, sizeof (int16), wwc);
+    err = sim_uerror (uptr);                            /* end if erase */
     }
 
 else if (cmd == OP_WR) {                                /* write? */
-    t = Map_ReadW (ba, tbc, rqxb);                      /* fetch buffer */
+    wwc = ((tbc + (RQ_NUMBY - 1)) & ~(RQ_NUMBY - 1)) >> 1;
+    xb = (uint16 *) sim_fmap_ptr (uptr, da, wwc << 1);  /* mapped? */
+    if (xb == NULL)
+        xb = rqxb;
+    t = Map_ReadW (ba, tbc, xb);                        /* fetch buffer */
     if (abc = tbc - t) {                                /* any xfer? */
         wwc = ((abc + (RQ_NUMBY - 1)) & ~(RQ_NUMBY - 1)) >> 1;
         for (i = (abc >> 1); i < wwc; i++)
-            rqxb[i] = 0;
-        err = sim_fseek (uptr->fileref, da, SEEK_SET);
-        if (!err)
-            sim_fwrite (rqxb, sizeof (int16), wwc, uptr->fileref);
-        err = ferror (uptr->fileref);
+            xb[i] = 0;
+        if (xb == rqxb)
+            sim_uwrite (uptr, da, rqxb, sizeof (int16), wwc);
+        err = sim_uerror (uptr);
         }
     if (t) {                                            /* nxm? */
         PUTP32 (pkt, RW_WBCL, bc - abc);                /* adj bc */
@@ -1724,15 +1728,16 @@ else if (cmd == OP_WR) {                                /* write? */
     }
 
 else {
-    err = sim_fseek (uptr->fileref, da, SEEK_SET);      /* set pos */
-    if (!err) {
-        i = sim_fread (rqxb, sizeof (int16), tbc >> 1, uptr->fileref);
+    xb = (uint16 *) sim_fmap_ptr (uptr, da, tbc);       /* mapped? */
+    if (xb == NULL) {
+        xb = rqxb;
+        i = sim_uread (uptr, da, rqxb, sizeof (int16), tbc >> 1);
         for ( ; i < (tbc >> 1); i++)                    /* fill */
             rqxb[i] = 0;
-        err = ferror (uptr->fileref);
+        err = sim_uerror (uptr);
         }
     if ((cmd == OP_RD) && !err) {                       /* read? */
-        if (t = Map_WriteW (ba, tbc, rqxb)) {           /* store, nxm? */
+        if (t = Map_WriteW (ba, tbc, xb)) {             /* store, nxm? */
             PUTP32 (pkt, RW_WBCL, bc - (tbc - t));      /* adj bc */
             PUTP32 (pkt, RW_WBAL, ba + (tbc - t));      /* adj ba */
             if (rq_hbe (cp, uptr))                      /* post err log */
@@ -1750,7 +1755,7 @@ else {
                     rq_rw_end (cp, uptr, EF_LOG, ST_HST | SB_HST_NXM);
                 return SCPE_OK;
                 }
-            dby = (rqxb[i >> 1] >> ((i & 1)? 8: 0)) & 0xFF;
+            dby = (xb[i >> 1] >> ((i & 1)? 8: 0)) & 0xFF;
             if (mby != dby) {                           /* cmp err? */
                 PUTP32 (pkt, RW_WBCL, bc - i);          /* adj bc */
                 rq_rw_end (cp, uptr, 0, ST_CMP);        /* done */
@@ -1772,12 +1777,31 @@ bl = bl + ((tbc + (RQ_NUMBY - 1)) / RQ_NUMBY);          /* incr blk # */
 PUTP32 (pkt, RW_WBAL, ba);                              /* update pkt */
 PUTP32 (pkt, RW_WBCL, bc);
 PUTP32 (pkt, RW_WBLL, bl);
-if (bc)                                                 /* more? resched */
+if (bc) {                                               /* more? resched */
+    rq_prefetch (uptr, pkt);
     sim_activate (uptr, rq_xtime);
+    }
 else rq_rw_end (cp, uptr, 0, ST_SUC);                   /* done! */
 return SCPE_OK;
 }
 
+/* Start the host read for the next chunk of a read or compare,
+   for units attached -A; rq_svc picks the data up */
+
+void rq_prefetch (UNIT *uptr, int32 pkt)
+{
+MSC *cp = rq_ctxmap[uptr->cnum];
+uint32 cmd = GETP (pkt, CMD_OPC, OPC);                  /* get cmd */
+uint32 bc = GETP32 (pkt, RW_WBCL);                      /* byte count */
+uint32 bl = GETP32 (pkt, RW_WBLL);                      /* block addr */
+uint32 tbc = (bc > RQ_MAXFR)? RQ_MAXFR: bc;             /* trim cnt to max */
+
+if ((uptr->aio == NULL) || ((cmd != OP_RD) && (cmd != OP_CMP)))
+    return;
+sim_aio_prefetch (uptr, ((t_addr) bl) * RQ_NUMBY, sizeof (int16), tbc >> 1);
+return;
+}
+
 /* Transfer command complete */
 
 t_bool rq_rw_end (MSC *cp, UNIT *uptr, uint32 flg, uint32 sts)
@@ -2313,6 +2337,12 @@ t_stat r;
 r = attach_unit (uptr, cptr);
 if (r != SCPE_OK)
     return r;
+r = sim_fattach_opt (uptr, uptr->capac +                /* -M or -A? */
+    ((t_addr) drv_tab[GET_DTYPE (uptr->flags)].rcts) * RQ_NUMBY, RQ_MAXFR);
+if (r != SCPE_OK) {
+    detach_unit (uptr);
+    return r;
+    }
 if (cp->csta == CST_UP)
     uptr->flags = uptr->flags | UNIT_ATP;
 return SCPE_OK;
@@ -205,6 +205,7 @@
 #define SRBSIZ          1024                            /* save/restore buffer */
 #define SIM_BRK_INILNT  4096                            /* bpt tbl length */
 #define SIM_BRK_ALLTYP  0xFFFFFFFF
+#define SIM_EVQ_INILNT  64                              /* event heap length */
 #define UPDATE_SIM_TIME(x) sim_time = sim_time + (x - sim_interval); \
     sim_rtime = sim_rtime + ((uint32) (x - sim_interval)); \
     x = sim_interval
@@ -294,6 +295,11 @@ t_stat sim_check_console (int32 sec);
 t_stat sim_save (FILE *sfile);
 t_stat sim_rest (FILE *rfile);
 
+/* Event queue package */
+
+static t_bool sim_evq_before (UNIT *a, UNIT *b);
+static void sim_evq_clear (void);
+
 /* Breakpoint package */
 
 t_stat sim_brk_init (void);
@@ -374,7 +380,11 @@ int32 sim_quiet = 0;
 int32 sim_step = 0;
 static double sim_time;
 static uint32 sim_rtime;
-static int32 noqueue_time;
+static int32 sim_ibase;                                 /* sim_interval at last update */
+static UNIT **sim_evq = NULL;                           /* event heap */
+static int32 sim_evq_n = 0;                             /* entries in heap */
+static int32 sim_evq_size = 0;                          /* heap allocation */
+static uint32 sim_evq_seq = 0;                          /* queue order stamp */
 volatile int32 stop_cpu = 0;
 t_value *sim_eval = NULL;
 int32 sim_deb_close = 0;                                /* 1 = close debug */
@@ -620,10 +630,8 @@ if (sim_vm_init != NULL)                                /* call once only */
     (*sim_vm_init)();
 sim_finit ();                                           /* init fio package */
 stop_cpu = 0;
-sim_interval = 0;
 sim_time = sim_rtime = 0;
-noqueue_time = 0;
-sim_clock_queue = NULL;
+sim_evq_clear ();
 sim_is_running = 0;
 sim_log = NULL;
 if (sim_emax <= 0)
@@ -1538,11 +1546,23 @@ else if (!flag)
 return SCPE_OK;
 }
 
+/* Order two heap entries by event time, for SHOW QUEUE */
+
+static int sim_evq_cmp (const void *a, const void *b)
+{
+UNIT *ua = *(UNIT **) a;
+UNIT *ub = *(UNIT **) b;
+
+if (ua == ub)
+    return 0;
+return sim_evq_before (ua, ub)? -1: 1;
+}
+
 t_stat show_queue (FILE *st, DEVICE *dnotused, UNIT *unotused, int32 flag, char *cptr)
 {
 DEVICE *dptr;
-UNIT *uptr;
-int32 accum;
+UNIT *uptr, **sq;
+int32 i;
 
 if (cptr && (*cptr != 0))
     return SCPE_2MARG;
@@ -1553,8 +1573,13 @@ if (sim_clock_queue == NULL) {
     }
 fprintf (st, "%s event queue status, time = %.0f\n",
      sim_name, sim_time);
-accum = 0;
-for (uptr = sim_clock_queue; uptr != NULL; uptr = uptr->next) {
+sq = (UNIT **) malloc (sim_evq_n * sizeof (UNIT *));    /* heap in time order */
+if (sq == NULL)
+    return SCPE_MEM;
+memcpy (sq, sim_evq, sim_evq_n * sizeof (UNIT *));
+qsort (sq, sim_evq_n, sizeof (UNIT *), sim_evq_cmp);
+for (i = 0; i < sim_evq_n; i++) {
+    uptr = sq[i];
     if (uptr == &sim_step_unit)
         fprintf (st, "  Step timer");
     else if ((dptr = find_dev_from_unit (uptr)) != NULL) {
@@ -1563,9 +1588,9 @@ for (uptr = sim_clock_queue; uptr != NULL; uptr = uptr->next) {
             (int32) (uptr - dptr->units));
         }
     else fprintf (st, "  Unknown");
-    fprintf (st, " at %d\n", accum + uptr->time);
-    accum = accum + uptr->time;
+    fprintf (st, " at %d\n", sim_is_active (uptr) - 1);
     }
+free (sq);
 return SCPE_OK;
 }
 
@@ -2097,6 +2122,10 @@ if (!(uptr->flags & UNIT_ATT))                          /* attached? */
     return SCPE_OK;
 if ((dptr = find_dev_from_unit (uptr)) == NULL)
     return SCPE_OK;
+if (uptr->flags & UNIT_MAP)                             /* file mapped? */
+    sim_funmap (uptr);
+if (uptr->aio)                                          /* async I/O? */
+    sim_aio_stop (uptr);
 if (uptr->flags & UNIT_BUF) {
     uint32 cap = (uptr->hwmark + dptr->aincr - 1) / dptr->aincr;
     if (uptr->hwmark && ((uptr->flags & UNIT_RO) == 0)) {
@@ -2637,12 +2666,7 @@ sim_ttcmd ();                                           /* restore console */
 signal (SIGINT, SIG_DFL);                               /* cancel WRU */
 sim_cancel (&sim_step_unit);                            /* cancel step timer */
 sim_throt_cancel ();                                    /* cancel throttle */
-if (sim_clock_queue != NULL) {                          /* update sim time */
-    UPDATE_SIM_TIME (sim_clock_queue->time);
-    }
-else {
-    UPDATE_SIM_TIME (noqueue_time);
-    }
+UPDATE_SIM_TIME (sim_ibase);                            /* update sim time */
 if (sim_log)                                            /* flush console log */
     fflush (sim_log);
 if (sim_deb)                                            /* flush debug log */
@@ -2671,10 +2695,8 @@ return SCPE_OK;
 
 t_stat run_boot_prep (void)
 {
-sim_interval = 0;                                       /* reset queue */
-sim_time = sim_rtime = 0;
-noqueue_time = 0;
-sim_clock_queue = NULL;
+sim_time = sim_rtime = 0;                               /* reset queue */
+sim_evq_clear ();
 return reset_all (0);
 }
 
@@ -4142,10 +4164,116 @@ return SCPE_OK;
    and to see if further events need to be processed, or sim_interval
    reset to count the next one.
 
-   The event queue is maintained in clock order; entry timeouts are
-   RELATIVE to the time in the previous entry.
+   The event queue is a binary heap, ordered by ABSOLUTE event time
+   (uptr->qtime); entries due at the same time are kept in the order
+   they were queued (uptr->qseq).  Each queued unit records its heap
+   slot + 1 in uptr->qidx, 0 if inactive, so that activate, cancel,
+   and process are O(log n) and is_active is O(1).  sim_clock_queue
+   always points to the earliest entry, or is NULL if the queue is
+   empty.  sim_ibase holds the value of sim_interval at the last
+   update of sim_time; the difference is the time elapsed since.
+*/
+
+static t_bool sim_evq_before (UNIT *a, UNIT *b)
+{
+if (a->qtime != b->qtime)
+    return (a->qtime < b->qtime);
+return (((int32) (a->qseq - b->qseq)) < 0);
+}
+
+static void sim_evq_up (int32 i)
+{
+UNIT *uptr = sim_evq[i];
+int32 p;
+
+while (i > 0) {
+    p = (i - 1) >> 1;                                   /* parent */
+    if (!sim_evq_before (uptr, sim_evq[p]))
+        break;
+    sim_evq[i] = sim_evq[p];
+    sim_evq[i]->qidx = i + 1;
+    i = p;
+    }
+sim_evq[i] = uptr;
+uptr->qidx = i + 1;
+return;
+}
+
+static void sim_evq_down (int32 i)
+{
+UNIT *uptr = sim_evq[i];
+int32 c;
+
+for ( ;; ) {
+    c = (i << 1) + 1;                                   /* left child */
+    if (c >= sim_evq_n)
+        break;
+    if (((c + 1) < sim_evq_n) &&                        /* right earlier? */
+        sim_evq_before (sim_evq[c + 1], sim_evq[c]))
+        c = c + 1;
+    if (!sim_evq_before (sim_evq[c], uptr))
+        break;
+    sim_evq[i] = sim_evq[c];
+    sim_evq[i]->qidx = i + 1;
+    i = c;
+    }
+sim_evq[i] = uptr;
+uptr->qidx = i + 1;
+return;
+}
+
+/* Remove a queued unit from the heap */
+
+static void sim_evq_remove (UNIT *uptr)
+{
+int32 i = uptr->qidx - 1;
+UNIT *lptr;
+
+uptr->qidx = 0;
+lptr = sim_evq[--sim_evq_n];                            /* last entry */
+if (i < sim_evq_n) {                                    /* fill the hole */
+    sim_evq[i] = lptr;
+    lptr->qidx = i + 1;
+    sim_evq_up (i);
+    sim_evq_down (lptr->qidx - 1);
+    }
+return;
+}
+
+/* Bring sim_time up to date, then set sim_interval to count down
+   to the earliest entry, or NOQUEUE_WAIT if the queue is empty */
+
+static void sim_evq_sched (void)
+{
+double d;
+
+UPDATE_SIM_TIME (sim_ibase);                            /* update sim time */
+if (sim_evq_n == 0) {                                   /* queue empty? */
+    sim_clock_queue = NULL;
+    sim_interval = sim_ibase = NOQUEUE_WAIT;
+    return;
+    }
+sim_clock_queue = sim_evq[0];
+d = sim_clock_queue->qtime - sim_time;
+sim_interval = sim_ibase = (d > 0)? (int32) d: 0;
+return;
+}
+
+/* Empty the queue (RUN, BOOT, startup) */
 
-   sim_process_event - process event
+static void sim_evq_clear (void)
+{
+int32 i;
+
+for (i = 0; i < sim_evq_n; i++)
+    sim_evq[i]->qidx = 0;
+sim_evq_n = 0;
+sim_clock_queue = NULL;
+sim_interval = sim_ibase = 0;
+return;
+}
+
+/* sim_process_event - process event
 
    Inputs:
         none
@@ -4161,24 +4289,15 @@ t_stat reason;
 
 if (stop_cpu)                                           /* stop CPU? */
     return SCPE_STOP;
-if (sim_clock_queue == NULL) {                          /* queue empty? */
-    UPDATE_SIM_TIME (noqueue_time);                     /* update sim time */
-    sim_interval = noqueue_time = NOQUEUE_WAIT;         /* flag queue empty */
-    return SCPE_OK;
-    }
-UPDATE_SIM_TIME (sim_clock_queue->time);                /* update sim time */
-do {
+sim_evq_sched ();                                       /* update sim time */
+reason = SCPE_OK;
+while ((reason == SCPE_OK) && (sim_interval == 0)) {    /* entries due? */
     uptr = sim_clock_queue;                             /* get first */
-    sim_clock_queue = uptr->next;                       /* remove first */
-    uptr->next = NULL;                                  /* hygiene */
-    uptr->time = 0;
-    if (sim_clock_queue != NULL)
-        sim_interval = sim_clock_queue->time;
-    else sim_interval = noqueue_time = NOQUEUE_WAIT;
+    sim_evq_remove (uptr);                              /* remove first */
+    sim_evq_sched ();
     if (uptr->action != NULL)
         reason = uptr->action (uptr);
-    else reason = SCPE_OK;
-    } while ((reason == SCPE_OK) && (sim_interval == 0));
+    }
 
 /* Empty queue forces sim_interval != 0 */
 
@@ -4196,40 +4315,27 @@ return reason;
 
 t_stat sim_activate (UNIT *uptr, int32 event_time)
 {
-UNIT *cptr, *prvptr;
-int32 accum;
+UNIT **nq;
+int32 nsize;
 
 if (event_time < 0)
     return SCPE_IERR;
-if (sim_is_active (uptr))                               /* already active? */
+if (uptr->qidx != 0)                                    /* already active? */
     return SCPE_OK;
-if (sim_clock_queue == NULL) {
-    UPDATE_SIM_TIME (noqueue_time);
-    }
-else  {                                                 /* update sim time */
-    UPDATE_SIM_TIME (sim_clock_queue->time);
-    }
-
-prvptr = NULL;
-accum = 0;
-for (cptr = sim_clock_queue; cptr != NULL; cptr = cptr->next) {
-    if (event_time < (accum + cptr->time))
-        break;
-    accum = accum + cptr->time;
-    prvptr = cptr;
-    }
-if (prvptr == NULL) {                                   /* insert at head */
-    cptr = uptr->next = sim_clock_queue;
-    sim_clock_queue = uptr;
-    }
-else {
-    cptr = uptr->next = prvptr->next;                   /* insert at prvptr */
-    prvptr->next = uptr;
-    }
-uptr->time = event_time - accum;
-if (cptr != NULL)
-    cptr->time = cptr->time - uptr->time;
-sim_interval = sim_clock_queue->time;
+if (sim_evq_n >= sim_evq_size) {                        /* heap full? */
+    nsize = (sim_evq_size > 0)? sim_evq_size * 2: SIM_EVQ_INILNT;
+    nq = (UNIT **) realloc (sim_evq, nsize * sizeof (UNIT *));
+    if (nq == NULL)
+        return SCPE_MEM;
+    sim_evq = nq;
+    sim_evq_size = nsize;
+    }
+UPDATE_SIM_TIME (sim_ibase);                            /* update sim time */
+uptr->qtime = sim_time + event_time;
+uptr->qseq = sim_evq_seq++;
+sim_evq[sim_evq_n++] = uptr;
+sim_evq_up (sim_evq_n - 1);
+sim_evq_sched ();
 return SCPE_OK;
 }
 
@@ -4259,29 +4365,10 @@ return sim_activate (uptr, event_time);
 
 t_stat sim_cancel (UNIT *uptr)
 {
-UNIT *cptr, *nptr;
-
-if (sim_clock_queue == NULL)
+if (uptr->qidx == 0)                                    /* not queued? */
     return SCPE_OK;
-UPDATE_SIM_TIME (sim_clock_queue->time);                /* update sim time */
-nptr = NULL;
-if (sim_clock_queue == uptr)
-    nptr = sim_clock_queue = uptr->next;
-else {
-    for (cptr = sim_clock_queue; cptr != NULL; cptr = cptr->next) {
-        if (cptr->next == uptr) {
-            nptr = cptr->next = uptr->next;
-            break;                                      /* end queue scan */
-            }
-        }
-    }
-if (nptr != NULL)
-    nptr->time = nptr->time + uptr->time;
-uptr->next = NULL;                                      /* hygiene */
-uptr->time = 0;
-if (sim_clock_queue != NULL)
-    sim_interval = sim_clock_queue->time;
-else sim_interval = noqueue_time = NOQUEUE_WAIT;
+sim_evq_remove (uptr);
+sim_evq_sched ();
 return SCPE_OK;
 }
 
@@ -4295,20 +4382,12 @@ return SCPE_OK;
 
 int32 sim_is_active (UNIT *uptr)
 {
-UNIT *cptr;
-int32 accum;
+double d;
 
-accum = 0;
-for (cptr = sim_clock_queue; cptr != NULL; cptr = cptr->next) {
-    if (cptr == sim_clock_queue) {
-        if (sim_interval > 0)
-            accum = accum + sim_interval;
-        }
-    else accum = accum + cptr->time;
-    if (cptr == uptr)
-        return accum + 1;
-    }
-return 0;
+if (uptr->qidx == 0)                                    /* not queued? */
+    return 0;
+d = uptr->qtime - (sim_time + (sim_ibase - sim_interval));
+return ((d > 0)? (int32) d: 0) + 1;
 }
 
 /* sim_gtime - return global time
@@ -4321,23 +4400,13 @@ return 0;
 
 double sim_gtime (void)
 {
-if (sim_clock_queue == NULL) {
-    UPDATE_SIM_TIME (noqueue_time);
-    }
-else  {
-    UPDATE_SIM_TIME (sim_clock_queue->time);
-    }
+UPDATE_SIM_TIME (sim_ibase);
 return sim_time;
 }
 
 uint32 sim_grtime (void)
 {
-if (sim_clock_queue == NULL) {
-    UPDATE_SIM_TIME (noqueue_time);
-    }
-else  {
-    UPDATE_SIM_TIME (sim_clock_queue->time);
-    }
+UPDATE_SIM_TIME (sim_ibase);
 return sim_rtime;
 }
 
@@ -4350,13 +4419,7 @@ return sim_rtime;
 
 int32 sim_qcount (void)
 {
-int32 cnt;
-UNIT *uptr;
-
-cnt = 0;
-for (uptr = sim_clock_queue; uptr != NULL; uptr = uptr->next)
-    cnt++;
-return cnt;
+return sim_evq_n;
 }
 
 /* Breakpoint package.  This module replaces the VM-implemented one
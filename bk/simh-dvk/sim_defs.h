@@ -352,6 +352,10 @@ struct sim_unit {
     int32               u4;                             /* device specific */
     int32               u5;                             /* device specific */
     int32               u6;                             /* device specific */
+    int32               qidx;                           /* event heap slot + 1 */
+    uint32              qseq;                           /* event queue order */
+    double              qtime;                          /* event time, absolute */
+    struct sim_aio      *aio;                           /* async I/O context */
     };
 
 /* Unit flags */
@@ -375,6 +379,7 @@ struct sim_unit {
 #define UNIT_RAW        010000                          /* raw mode */
 #define UNIT_TEXT       020000                          /* text mode */
 #define UNIT_IDLE       040000                          /* idle eligible */
+#define UNIT_MAP        0100000                         /* file mapped */
 
 #define UNIT_UFMASK_31  (((1u << UNIT_V_RSV) - 1) & ~((1u << UNIT_V_UF_31) - 1))
 #define UNIT_UFMASK     (((1u << UNIT_V_RSV) - 1) & ~((1u << UNIT_V_UF) - 1))
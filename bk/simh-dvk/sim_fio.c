@@ -41,6 +41,10 @@
    sim_write    -       endian independent write (formerly fxwrite)
    sim_fseek    -       extended (>32b) seek (formerly fseek_ext)
    sim_fsize    -       get file size
+   sim_fmap     -       map a unit's file into memory
+   sim_aio_start -      start asynchronous I/O on a unit
+   sim_uread    -       positioned read on a unit, any attach mode
+   sim_uwrite   -       positioned write on a unit, any attach mode
 
    sim_fopen and sim_fseek are OS-dependent.  The other routines are not.
    sim_fsize is always a 32b routine (it is used only with small capacity random
@@ -49,6 +53,8 @@
 
 #include "sim_defs.h"
 
+extern int32 sim_switches;
+
 static unsigned char sim_flip[FLIP_SIZE];
 int32 sim_end = 1;                                      /* 1 = little */
 
@@ -327,3 +333,429 @@ return fseek (st, (int32) xpos, origin);
 #endif
 
 uint32 sim_taddr_64 = _SIM_IO_FSEEK_EXT_;
+
+/* Unit I/O: memory mapped and asynchronous disk transfers
+
+   A disk unit attached with -M has its container file mapped into the
+   simulator's address space; uptr->filebuf points to the mapping,
+   uptr->hwmark holds its length in bytes, and UNIT_MAP is set.  A
+   writable file is extended to the full drive size first, so that every
+   transfer lands inside the mapping.  Controllers copy between the
+   mapping and simulated memory directly (sim_fmap_ptr).
+
+   A disk unit attached with -A hands its transfers to a worker thread.
+   A controller posts the read for a command when the command is
+   started (sim_aio_prefetch) and collects the data when the unit's
+   service event fires (sim_uread), so the host I/O overlaps the
+   simulated seek and rotation time and the event queue stays the
+   only source of completions.  Writes are copied and queued
+   (sim_uwrite); an error is reported by the next sim_uerror on the
+   unit.  Requests are served in the order posted, so a read never
+   overtakes an earlier write.
+
+   sim_uread, sim_uwrite, and sim_uerror hide the choice between a
+   mapped, asynchronous, or plain stdio unit from the controller.
+*/
+
+#if defined (__unix__) || defined (__APPLE__)
+#define SIM_FMAP        1
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined (SIM_ASYNCH_IO)
+#include <pthread.h>
+#include <errno.h>
+
+typedef struct sim_aio_op SIM_AIO_OP;
+
+struct sim_aio_op {
+    SIM_AIO_OP          *next;                          /* work queue link */
+    int                 fd;                             /* file */
+    int32               wr;                             /* 1 = write */
+    t_bool              busy;                           /* queued or running */
+    t_bool              valid;                          /* read data usable */
+    t_addr              pos;                            /* file position */
+    size_t              size;                           /* item size */
+    size_t              count;                          /* items requested */
+    size_t              done;                           /* items transferred */
+    int                 err;                            /* errno, 0 if ok */
+    unsigned char       *buf;                           /* data */
+    };
+
+struct sim_aio {
+    size_t              maxbytes;                       /* buffer size */
+    int                 err;                            /* unreported error */
+    SIM_AIO_OP          rd;                             /* read slot */
+    SIM_AIO_OP          wr;                             /* write slot */
+    };
+
+static pthread_mutex_t sim_aio_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_aio_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sim_aio_done = PTHREAD_COND_INITIALIZER;
+static SIM_AIO_OP *sim_aio_head = NULL;                 /* work queue */
+static SIM_AIO_OP *sim_aio_tail = NULL;
+static t_bool sim_aio_running = FALSE;                  /* worker started */
+
+/* Perform one request */
+
+static void sim_aio_io (SIM_AIO_OP *op)
+{
+size_t n = op->size * op->count;
+size_t got = 0;
+ssize_t r;
+
+op->err = 0;
+while (got < n) {
+    if (op->wr)
+        r = pwrite (op->fd, op->buf + got, n - got, (off_t) (op->pos + got));
+    else r = pread (op->fd, op->buf + got, n - got, (off_t) (op->pos + got));
+    if (r < 0) {
+        if (errno == EINTR)
+            continue;
+        op->err = errno;
+        break;
+        }
+    if (r == 0)                                         /* end of file */
+        break;
+    got = got + r;
+    }
+op->done = got / op->size;
+return;
+}
+
+/* Worker thread */
+
+static void *sim_aio_worker (void *arg)
+{
+SIM_AIO_OP *op;
+
+pthread_mutex_lock (&sim_aio_lock);
+for ( ;; ) {
+    while (sim_aio_head == NULL)
+        pthread_cond_wait (&sim_aio_work, &sim_aio_lock);
+    op = sim_aio_head;                                  /* take first */
+    if ((sim_aio_head = op->next) == NULL)
+        sim_aio_tail = NULL;
+    pthread_mutex_unlock (&sim_aio_lock);
+    sim_aio_io (op);
+    pthread_mutex_lock (&sim_aio_lock);
+    op->busy = FALSE;
+    pthread_cond_broadcast (&sim_aio_done);
+    }
+return NULL;
+}
+
+/* Queue a request, wait for one to finish */
+
+static void sim_aio_post (SIM_AIO_OP *op)
+{
+pthread_mutex_lock (&sim_aio_lock);
+op->busy = TRUE;
+op->next = NULL;
+if (sim_aio_tail)
+    sim_aio_tail->next = op;
+else sim_aio_head = op;
+sim_aio_tail = op;
+pthread_cond_signal (&sim_aio_work);
+pthread_mutex_unlock (&sim_aio_lock);
+return;
+}
+
+static void sim_aio_wait (struct sim_aio *ap, SIM_AIO_OP *op)
+{
+pthread_mutex_lock (&sim_aio_lock);
+while (op->busy)
+    pthread_cond_wait (&sim_aio_done, &sim_aio_lock);
+pthread_mutex_unlock (&sim_aio_lock);
+if (op->wr && op->err) {                                /* write behind failed? */
+    if (ap->err == 0)
+        ap->err = op->err;
+    op->err = 0;
+    }
+return;
+}
+
+/* Start asynchronous I/O on an attached unit */
+
+t_stat sim_aio_start (UNIT *uptr, size_t maxbytes)
+{
+struct sim_aio *ap;
+pthread_t tid;
+
+if (!sim_end)                                           /* no swapping */
+    return SCPE_NOFNC;
+if (uptr->aio)
+    return SCPE_OK;
+ap = (struct sim_aio *) calloc (1, sizeof (struct sim_aio));
+if (ap == NULL)
+    return SCPE_MEM;
+ap->maxbytes = maxbytes;
+ap->rd.buf = (unsigned char *) malloc (maxbytes);
+ap->wr.buf = (unsigned char *) malloc (maxbytes);
+if ((ap->rd.buf == NULL) || (ap->wr.buf == NULL)) {
+    free (ap->rd.buf);
+    free (ap->wr.buf);
+    free (ap);
+    return SCPE_MEM;
+    }
+ap->rd.fd = ap->wr.fd = fileno (uptr->fileref);
+ap->wr.wr = 1;
+pthread_mutex_lock (&sim_aio_lock);
+if (!sim_aio_running) {                                 /* first user? */
+    if (pthread_create (&tid, NULL, &sim_aio_worker, NULL) == 0) {
+        pthread_detach (tid);
+        sim_aio_running = TRUE;
+        }
+    }
+pthread_mutex_unlock (&sim_aio_lock);
+if (!sim_aio_running) {
+    free (ap->rd.buf);
+    free (ap->wr.buf);
+    free (ap);
+    return SCPE_OPENERR;
+    }
+fflush (uptr->fileref);                                 /* stdio is bypassed */
+uptr->aio = ap;
+return SCPE_OK;
+}
+
+/* Drain and stop asynchronous I/O (detach) */
+
+void sim_aio_stop (UNIT *uptr)
+{
+struct sim_aio *ap = uptr->aio;
+
+if (ap == NULL)
+    return;
+sim_aio_wait (ap, &ap->rd);
+sim_aio_wait (ap, &ap->wr);
+if (ap->err) {
+    errno = ap->err;
+    perror ("I/O error");
+    }
+uptr->aio = NULL;
+free (ap->rd.buf);
+free (ap->wr.buf);
+free (ap);
+return;
+}
+
+/* Start reading data that a later sim_uread will ask for */
+
+void sim_aio_prefetch (UNIT *uptr, t_addr pos, size_t size, size_t count)
+{
+struct sim_aio *ap = uptr->aio;
+
+if ((ap == NULL) || (size == 0) || (count == 0) ||
+    ((size * count) > ap->maxbytes))
+    return;
+sim_aio_wait (ap, &ap->rd);                             /* slot free */
+ap->rd.valid = TRUE;
+ap->rd.pos = pos;
+ap->rd.size = size;
+ap->rd.count = count;
+sim_aio_post (&ap->rd);
+return;
+}
+
+static size_t sim_aio_read (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count)
+{
+struct sim_aio *ap = uptr->aio;
+
+if ((size * count) > ap->maxbytes)
+    count = ap->maxbytes / size;
+sim_aio_wait (ap, &ap->rd);
+if (!ap->rd.valid || (ap->rd.pos != pos) ||             /* not prefetched? */
+    (ap->rd.size != size) || (ap->rd.count != count)) {
+    ap->rd.pos = pos;                                   /* read it now */
+    ap->rd.size = size;
+    ap->rd.count = count;
+    sim_aio_post (&ap->rd);
+    sim_aio_wait (ap, &ap->rd);
+    }
+ap->rd.valid = FALSE;                                   /* data consumed */
+if (ap->rd.err && (ap->err == 0))
+    ap->err = ap->rd.err;
+memcpy (bptr, ap->rd.buf, ap->rd.done * size);
+return ap->rd.done;
+}
+
+static size_t sim_aio_write (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count)
+{
+struct sim_aio *ap = uptr->aio;
+
+if ((size * count) > ap->maxbytes)
+    count = ap->maxbytes / size;
+sim_aio_wait (ap, &ap->rd);                             /* no stale prefetch */
+ap->rd.valid = FALSE;
+sim_aio_wait (ap, &ap->wr);                             /* slot free */
+memcpy (ap->wr.buf, bptr, size * count);
+ap->wr.pos = pos;
+ap->wr.size = size;
+ap->wr.count = count;
+sim_aio_post (&ap->wr);
+return count;
+}
+
+#else
+
+t_stat sim_aio_start (UNIT *uptr, size_t maxbytes)
+{
+return SCPE_NOFNC;
+}
+
+void sim_aio_stop (UNIT *uptr)
+{
+return;
+}
+
+void sim_aio_prefetch (UNIT *uptr, t_addr pos, size_t size, size_t count)
+{
+return;
+}
+
+#endif                                                  /* end SIM_ASYNCH_IO */
+
+/* Map an attached unit's file; size is the drive capacity in bytes */
+
+t_stat sim_fmap (UNIT *uptr, t_addr size)
+{
+#if defined (SIM_FMAP)
+int fd = fileno (uptr->fileref);
+off_t len;
+void *mp;
+
+if (!sim_end)                                           /* no swapping */
+    return SCPE_NOFNC;
+fflush (uptr->fileref);
+if ((len = lseek (fd, 0, SEEK_END)) < 0)
+    return SCPE_IOERR;
+if (((uptr->flags & UNIT_RO) == 0) && (len < (off_t) size)) {
+    if (ftruncate (fd, (off_t) size))                   /* extend to size */
+        return SCPE_IOERR;
+    len = size;
+    }
+if (len == 0)                                           /* nothing to map */
+    return SCPE_OK;
+if ((t_uint64) len > 0xFFFFFFFFu)                       /* hwmark is 32b */
+    return SCPE_NOFNC;
+mp = mmap (NULL, (size_t) len,
+    (uptr->flags & UNIT_RO)? PROT_READ: (PROT_READ | PROT_WRITE),
+    MAP_SHARED, fd, 0);
+if (mp == MAP_FAILED)
+    return SCPE_MEM;
+uptr->filebuf = mp;
+uptr->hwmark = (uint32) len;
+uptr->flags = uptr->flags | UNIT_MAP;
+return SCPE_OK;
+#else
+return SCPE_NOFNC;
+#endif
+}
+
+void sim_funmap (UNIT *uptr)
+{
+#if defined (SIM_FMAP)
+if ((uptr->flags & UNIT_MAP) == 0)
+    return;
+munmap (uptr->filebuf, uptr->hwmark);
+uptr->filebuf = NULL;
+uptr->hwmark = 0;
+uptr->flags = uptr->flags & ~UNIT_MAP;
+#endif
+return;
+}
+
+/* Address of bytes pos..pos+len-1 of a mapped unit, NULL if not mapped */
+
+void *sim_fmap_ptr (UNIT *uptr, t_addr pos, size_t len)
+{
+if (((uptr->flags & UNIT_MAP) == 0) ||
+    ((pos + len) > (t_addr) uptr->hwmark))
+    return NULL;
+return ((unsigned char *) uptr->filebuf) + pos;
+}
+
+/* Honor ATTACH -M (map) and -A (asynchronous) for a disk unit
+
+   size is the drive capacity in bytes, maxbytes the largest transfer.
+*/
+
+t_stat sim_fattach_opt (UNIT *uptr, t_addr size, size_t maxbytes)
+{
+if (sim_switches & SWMASK ('M'))
+    return sim_fmap (uptr, size);
+if (sim_switches & SWMASK ('A'))
+    return sim_aio_start (uptr, maxbytes);
+return SCPE_OK;
+}
+
+/* Positioned read and write on a unit's file, any attach mode */
+
+size_t sim_uread (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count)
+{
+size_t n;
+
+if ((size == 0) || (count == 0))
+    return 0;
+if (uptr->flags & UNIT_MAP) {                           /* mapped? */
+    if (pos >= (t_addr) uptr->hwmark)
+        return 0;
+    n = (uptr->hwmark - (size_t) pos) / size;           /* items before end */
+    if (n > count)
+        n = count;
+    memcpy (bptr, ((unsigned char *) uptr->filebuf) + pos, n * size);
+    return n;
+    }
+#if defined (SIM_ASYNCH_IO)
+if (uptr->aio)                                          /* asynchronous? */
+    return sim_aio_read (uptr, pos, bptr, size, count);
+#endif
+if (sim_fseek (uptr->fileref, pos, SEEK_SET))
+    return 0;
+return sim_fread (bptr, size, count, uptr->fileref);
+}
+
+size_t sim_uwrite (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count)
+{
+void *mp;
+
+if ((size == 0) || (count == 0))
+    return 0;
+if ((mp = sim_fmap_ptr (uptr, pos, size * count)) != NULL) {
+    memcpy (mp, bptr, size * count);                    /* mapped */
+    return count;
+    }
+#if defined (SIM_ASYNCH_IO)
+if (uptr->aio)                                          /* asynchronous? */
+    return sim_aio_write (uptr, pos, bptr, size, count);
+#endif
+if (sim_fseek (uptr->fileref, pos, SEEK_SET))
+    return 0;
+count = sim_fwrite (bptr, size, count, uptr->fileref);
+if (uptr->flags & UNIT_MAP)                             /* past the mapping */
+    fflush (uptr->fileref);
+return count;
+}
+
+/* Error test: stdio error, or a not yet reported asynchronous one
+
+   The asynchronous error is cleared once returned; the stdio error
+   stays until the caller's clearerr, as with ferror.
+*/
+
+int sim_uerror (UNIT *uptr)
+{
+int err = ferror (uptr->fileref);
+
+#if defined (SIM_ASYNCH_IO)
+if (uptr->aio && uptr->aio->err) {
+    if (err == 0)
+        err = uptr->aio->err;
+    uptr->aio->err = 0;
+    }
+#endif
+return err;
+}
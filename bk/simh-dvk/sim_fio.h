@@ -42,5 +42,15 @@ size_t sim_fread (void *bptr, size_t size, size_t count, FILE *fptr);
 size_t sim_fwrite (void *bptr, size_t size, size_t count, FILE *fptr);
 uint32 sim_fsize (FILE *fptr);
 uint32 sim_fsize_name (char *fname);
+t_stat sim_fmap (UNIT *uptr, t_addr size);
+void sim_funmap (UNIT *uptr);
+void *sim_fmap_ptr (UNIT *uptr, t_addr pos, size_t len);
+t_stat sim_aio_start (UNIT *uptr, size_t maxbytes);
+void sim_aio_stop (UNIT *uptr);
+void sim_aio_prefetch (UNIT *uptr, t_addr pos, size_t size, size_t count);
+t_stat sim_fattach_opt (UNIT *uptr, t_addr size, size_t maxbytes);
+size_t sim_uread (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count);
+size_t sim_uwrite (UNIT *uptr, t_addr pos, void *bptr, size_t size, size_t count);
+int sim_uerror (UNIT *uptr);
 
 #endif
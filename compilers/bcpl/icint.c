@@ -1,9 +1,13 @@
 /* Copyright (c) 2004 Robert Nordier.  All rights reserved. */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "blib.h"
+#include "icjit.h"
 
-#define VSIZE       32000
+#define VSIZE       100000
 #define MGLOB       1
 #define MPROG       402
 
@@ -38,6 +42,9 @@ static int C;
 static int D;
 static int W;
 
+static void translate();
+static int interpret();
+
 static void
 rch()
 {
@@ -120,7 +127,7 @@ next:
 sw:
     switch (Ch) {
 
-    default: if (Ch == EOF) return;
+    default: if (Ch == EOF) { translate(); return; }
         printf("\nBAD CH %c AT P = %d\n", Ch, P);
         goto next;
 
@@ -160,7 +167,7 @@ sw:
         labref(rdn(), A);
         goto sw;
     case 'Z': for (i = 0; i <= 500; i++)
-        if (Labv[i] > 0) printf("L%d UNSET\n", i);
+            if (Labv[i] > 0) printf("L%d UNSET\n", i);
         goto clear;
     }
     W = f << FSHIFT;
@@ -183,9 +190,233 @@ sw:
     goto sw;
 }
 
+#ifdef __GNUC__
+/*
+ * Direct-threaded interpreter.
+ *
+ * After loading, every word of the program is decoded in advance
+ * into a struct ins: the address of a handler specialised for the
+ * function and the addressing mode, the address field and the
+ * instruction length.  Jumps and calls address the same locations
+ * in T as in M, so the code does not move.  Locations beyond the
+ * loaded program are decoded on first execution.  The program is
+ * assumed not to modify its own instructions.
+ */
+struct ins {
+    void *op;           /* handler */
+    int d;              /* address field */
+    int len;            /* instruction length, words */
+};
+
+static struct ins *T;
+static void **Optab;    /* handlers: function x mode, then X codes */
+
+#define NMODES      7   /* direct, P, G, I, IP, IG, other */
+#define NXOPS       40
+#define OPINDEX(f, m)   ((f) * NMODES + (m))
+#define XINDEX(n)   (OPINDEX(8, 0) + (n))
+#define NOPS        XINDEX(NXOPS + 2)
+#define OPERROR     XINDEX(NXOPS)
+#define OPDECODE    XINDEX(NXOPS + 1)
+
+/* Decode the word at M[i] into T[i]. */
+static void
+decode(i)
+{
+    int w = M[i];
+    int f = w >> FSHIFT;
+    int m;
+
+    T[i].len = 1;
+    if ((w & DBIT) == 0)
+        T[i].d = w & ABITS;
+    else {
+        T[i].d = M[i + 1];
+        T[i].len = 2;
+    }
+    switch (w & (IBIT | PBIT | GBIT)) {
+    case 0:             m = 0; break;
+    case PBIT:          m = 1; break;
+    case GBIT:          m = 2; break;
+    case IBIT:          m = 3; break;
+    case IBIT | PBIT:   m = 4; break;
+    case IBIT | GBIT:   m = 5; break;
+    default:            m = 6; break;
+    }
+    if (f < 0 || f > 7)
+        T[i].op = Optab[OPERROR];
+    else if (f < 7 || m == 6)
+        T[i].op = Optab[OPINDEX(f, m)];
+    else if (m != 0 || T[i].d < 1 || T[i].d >= NXOPS)
+        T[i].op = Optab[OPINDEX(7, 6)];
+    else
+        T[i].op = Optab[XINDEX(T[i].d)];
+}
+
+static void
+translate()
+{
+    int i;
+
+    T = malloc(VSIZE * sizeof(struct ins));
+    if (T == NULL) {
+        fprintf(stderr, "icint: out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < VSIZE; i++) {
+        T[i].op = Optab[OPDECODE];
+        T[i].d = 0;
+        T[i].len = 0;
+    }
+    for (i = MPROG; i < P; i++)
+        decode(i);
+}
+
+/*
+ * The registers live in locals of interpret() while it runs;
+ * the handlers use them in lower case.
+ */
+#define NEXT    { cyc++; I = T + c; c += I->len; goto *I->op; }
+
+/* Handlers of a function for all the addressing modes. */
+#define MODES(f, body) \
+    f##_d:  d = I->d;               body; \
+    f##_p:  d = I->d + p;           body; \
+    f##_g:  d = I->d + g;           body; \
+    f##_i:  d = M[I->d];            body; \
+    f##_ip: d = M[I->d + p];        body; \
+    f##_ig: d = M[I->d + g];        body; \
+    f##_x:  d = generic(I, p, g);   body;
+#define MODEADDRS(f) \
+    &&f##_d, &&f##_p, &&f##_g, &&f##_i, &&f##_ip, &&f##_ig, &&f##_x
+
+/* Effective address of an instruction in an unusual mode. */
+static int
+generic(I, p, g)
+    struct ins *I;
+{
+    int w = M[I - T];
+    int d = I->d;
+
+    if ((w & PBIT) != 0) d += p;
+    if ((w & GBIT) != 0) d += g;
+    if ((w & IBIT) != 0) d = M[d];
+    return d;
+}
+
+static int
+interpret(init)
+{
+    static void *ops[NOPS] = {
+        MODEADDRS(L), MODEADDRS(S), MODEADDRS(A), MODEADDRS(J),
+        MODEADDRS(T), MODEADDRS(F), MODEADDRS(K), MODEADDRS(X),
+        &&error, &&x1, &&x2, &&x3, &&x4, &&x5, &&x6, &&x7, &&x8, &&x9,
+        &&x10, &&x11, &&x12, &&x13, &&x14, &&x15, &&x16, &&x17, &&x18,
+        &&x19, &&x20, &&x21, &&x22, &&x23, &&x24, &&x25, &&x26, &&x27,
+        &&x28, &&x29, &&x30, &&x31, &&x32, &&x33, &&x34, &&x35, &&x36,
+        &&x37, &&x38, &&x39, &&error, &&decode,
+    };
+    struct ins *I;
+    int a = A, b = B, c = C, d = D, p = P, g = G;
+    int cyc = 0;
+
+    if (init) {
+        Optab = ops;
+        return 0;
+    }
+    NEXT;
+
+decode:
+    decode(I - T);
+    c += I->len;
+    goto *I->op;
+
+    MODES(L, { b = a; a = d; NEXT; })
+    MODES(S, { M[d] = a; NEXT; })
+    MODES(A, { a = a + d; NEXT; })
+    MODES(J, { c = d; NEXT; })
+    MODES(T, { a = !a; if (!a) c = d; NEXT; })
+    MODES(F, { if (!a) c = d; NEXT; })
+    MODES(K, { d += p; M[d] = p; M[d + 1] = c; p = d; c = a; NEXT; })
+    MODES(X, { if (d >= 1 && d < NXOPS) goto *ops[XINDEX(d)]; goto error; })
+
+error:
+    printf("\nINTCODE ERROR AT C = %d\n", c - 1);
+    a = -1;
+    goto stop;
+
+x1:  a = M[a]; NEXT;
+x2:  a = -a; NEXT;
+x3:  a = ~a; NEXT;
+x4:  c = M[p + 1];
+     p = M[p];
+     NEXT;
+x5:  a = b * a; NEXT;
+x6:  a = b / a; NEXT;
+x7:  a = b % a; NEXT;
+x8:  a = b + a; NEXT;
+x9:  a = b - a; NEXT;
+x10: a = b == a ? ~0 : 0; NEXT;
+x11: a = b != a ? ~0 : 0; NEXT;
+x12: a = b < a  ? ~0 : 0; NEXT;
+x13: a = b >= a ? ~0 : 0; NEXT;
+x14: a = b > a ? ~0 : 0; NEXT;
+x15: a = b <= a ? ~0 : 0; NEXT;
+x16: a = b << a; NEXT;
+x17: a = b >> a; NEXT;
+x18: a = b & a; NEXT;
+x19: a = b | a; NEXT;
+x20: a = b ^ a; NEXT;
+x21: a = b ^ ~a; NEXT;
+x22: a = 0;
+     goto stop;
+x23: b = M[c]; d = M[c + 1];
+     while (b != 0) {
+         b--; c += 2;
+         if (a == M[c]) { d = M[c + 1]; break; }
+     }
+     c = d;
+     NEXT;
+x24: selectinput(a); NEXT;
+x25: selectoutput(a); NEXT;
+x26: a = rdch(); NEXT;
+x27: wrch(a); NEXT;
+x28: a = findinput(a); NEXT;
+x29: a = findoutput(a); NEXT;
+x30: goto stop;
+x31: a = M[p]; NEXT;
+x32: p = a; c = b; NEXT;
+x33: endread(); NEXT;
+x34: endwrite(); NEXT;
+x35: d = p + b + 1;
+     M[d] = M[p];
+     M[d + 1] = M[p + 1];
+     M[d + 2] = p;
+     M[d + 3] = b;
+     p = d;
+     c = a;
+     NEXT;
+x36: a = getbyte(a, b); NEXT;
+x37: putbyte(a, b, M[p + 4]); NEXT;
+x38: a = input(); NEXT;
+x39: a = output(); NEXT;
+
+stop:
+    A = a; B = b; C = c; D = d; P = p; G = g;
+    Cyclecount = cyc;
+    return a;
+}
+#else
+static void
+translate()
+{
+}
+
 static int
-interpret()
+interpret(init)
 {
+    if (init)
+        return 0;
 fetch:
     Cyclecount++;
     W = M[C++];
@@ -271,15 +502,64 @@ fetch:
         }
     }
 }
+#endif
+
+/*
+ * Run the program as native code, and finish it in the interpreter
+ * if the native code leaves off early.
+ */
+static int
+native()
+{
+    struct jstate s;
+    int n;
+
+    s.a = A; s.b = B; s.c = C; s.p = P;
+    s.cyc = 0;
+    jitrun(&s);
+    A = s.a; B = s.b; C = s.c; P = s.p;
+    if (!s.miss) {
+        Cyclecount = s.cyc;
+        return A;
+    }
+    n = s.cyc;
+    Cyclecount = 0;
+    A = interpret(FALSE);
+    Cyclecount += n;
+    return A;
+}
+
+/* Host processor cycle counter, for the -s report. */
+static double
+hostcycles()
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    return (double) __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
 
 int
 main(argc, argv)
     char **argv;
 {
     int pgvec[VSIZE];
+    int sflag = FALSE;
+    int jflag = FALSE;
+    clock_t t0;
+    double c0, jsec = 0;
 
+    for (; argc > 2 && argv[1][0] == '-'; argc--, argv++) {
+        if (strcmp(argv[1], "-s") == 0)
+            sflag = TRUE;
+        else if (strcmp(argv[1], "-j") == 0)
+            jflag = TRUE;
+        else
+            break;
+    }
     if (argc != 2) {
-        fprintf(stderr, "usage: icint file\n");
+        fprintf(stderr, "usage: icint [-s] [-j] file\n");
         return 1;
     }
     fp = fopen(argv[1], "r");
@@ -295,12 +575,38 @@ main(argc, argv)
     M[P++] = X22;
     initio();
     //printf("INTCODE SYSTEM ENTERED\n");
+    interpret(TRUE);
     assemble();
     fclose(fp);
     printf("INTCODE SIZE = %d\n", P - MPROG);
+    if (jflag) {
+        t0 = clock();
+        if (!jitcompile(MPROG, P, G, VSIZE)) {
+            fprintf(stderr, "icint: no native code, interpreting\n");
+            jflag = FALSE;
+        }
+        jsec = (double) (clock() - t0) / CLOCKS_PER_SEC;
+    }
     C = MPROG;
     Cyclecount = 0;
-    A = interpret();
+    t0 = clock();
+    c0 = hostcycles();
+    A = jflag ? native() : interpret(FALSE);
     printf("EXECUTION CYCLES = %d, STATUS = %d\n", Cyclecount, A);
+    if (sflag) {
+        double sec = (double) (clock() - t0) / CLOCKS_PER_SEC;
+        double cyc = hostcycles() - c0;
+
+        fprintf(stderr, "INSTRUCTIONS = %d, TIME = %.3f SEC", Cyclecount, sec);
+        if (sec > 0)
+            fprintf(stderr, ", %.1f MIPS", Cyclecount / sec / 1e6);
+        if (cyc > 0 && Cyclecount > 0)
+            fprintf(stderr, ", %.2f HOST CYCLES/INSTRUCTION",
+                cyc / Cyclecount);
+        fprintf(stderr, "\n");
+        if (jflag)
+            fprintf(stderr, "NATIVE CODE = %d BYTES, TRANSLATION TIME = %.3f SEC\n",
+                jitsize(), jsec);
+    }
     return A;
 }
@@ -0,0 +1,654 @@
+/* Copyright (c) 2004 Robert Nordier.  All rights reserved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "blib.h"
+#include "icjit.h"
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+
+/*
+ * INTCODE to x86-64 translator.
+ *
+ * Every word of the loaded program is translated into a fragment
+ * of native code, as if an instruction started there, and a table
+ * maps INTCODE addresses to fragments.  Static jumps go straight
+ * to their fragments; calls, returns and switchon go through the
+ * table.  An instruction the translator does not handle, or a jump
+ * outside the program, leaves the native code with the machine
+ * state in a struct jstate, and the interpreter carries on.  As
+ * in the interpreter, the program must not modify its own code.
+ *
+ * Registers in the native code:
+ *      ebx     A
+ *      ebp     B
+ *      r14d    P
+ *      r15d    instruction count
+ *      r12     M
+ *      r13     address table
+ * G never changes and C is known at each instruction, so neither
+ * needs a register.  All of these are preserved by C functions,
+ * so library routines are called directly.
+ */
+
+#define FSHIFT      13
+#define IBIT        010000
+#define PBIT        04000
+#define GBIT        02000
+#define DBIT        01000
+#define ABITS       0777
+
+#define RAX         0
+#define RCX         1
+#define RDX         2
+#define RBX         3
+#define NOINDEX     4
+#define RBP         5
+#define RSI         6
+#define RDI         7
+#define R12         12
+#define R13         13
+#define R14         14
+#define R15         15
+
+#define CC_E        0x4         /* condition codes */
+#define CC_NE       0x5
+#define CC_L        0xc
+#define CC_GE       0xd
+#define CC_LE       0xe
+#define CC_G        0xf
+#define CC_AE       0x3
+#define ALWAYS      (-1)
+
+#define FRAGMAX     128         /* longest fragment, bytes */
+
+extern int *M;
+
+static unsigned char *Code;     /* native code */
+static size_t Codesize;
+static unsigned char *Cp;       /* emission point */
+static unsigned char *Enter;    /* entry from C */
+static unsigned char *Exit;     /* return to C */
+static unsigned char *Miss;     /* address not translated */
+static void **Nat;              /* INTCODE address -> native code */
+static int Vsize;
+static int Lo, Hi, G;
+
+static struct patch {
+    unsigned char *at;          /* rel32 field */
+    int to;                     /* INTCODE address */
+} *Patch;
+static int Npatch;
+
+static void
+byte(x)
+{
+    *Cp++ = x;
+}
+
+static void
+word(x)
+{
+    byte(x);
+    byte(x >> 8);
+    byte(x >> 16);
+    byte(x >> 24);
+}
+
+static void
+quad(x)
+    void *x;
+{
+    unsigned long v = (unsigned long) x;
+
+    word((int) v);
+    word((int) (v >> 32));
+}
+
+/* 32-bit displacement from the end of the field to 'to'. */
+static void
+rel(to)
+    unsigned char *to;
+{
+    word(to - (Cp + 4));
+}
+
+static void
+rex(w, reg, index, base)
+{
+    int x = 0x40 | w << 3 | (reg >> 3) << 2 | (index >> 3) << 1 | base >> 3;
+
+    if (x != 0x40)
+        byte(x);
+}
+
+/* op reg, [base + index << scale + disp] */
+static void
+mem(op, reg, base, index, scale, disp)
+{
+    rex(0, reg, index, base);
+    byte(op);
+    byte(0x84 | (reg & 7) << 3);
+    byte(scale << 6 | (index & 7) << 3 | (base & 7));
+    word(disp);
+}
+
+#define LOAD(r, index, disp)    mem(0x8b, r, R12, index, 2, disp)
+#define STORE(r, index, disp)   mem(0x89, r, R12, index, 2, disp)
+#define MOV(dst, src)           reg(0x89, dst, src)
+
+/* op dst, src */
+static void
+reg(op, dst, src)
+{
+    rex(0, src, 0, dst);
+    byte(op);
+    byte(0xc0 | (src & 7) << 3 | (dst & 7));
+}
+
+/* mov r, imm */
+static void
+movi(r, x)
+{
+    rex(0, 0, 0, r);
+    byte(0xb8 | (r & 7));
+    word(x);
+}
+
+/* add, or, and, sub, xor, cmp (ext 0, 1, 4, 5, 6, 7) r, imm */
+static void
+alui(ext, r, x)
+{
+    rex(0, 0, 0, r);
+    byte(0x81);
+    byte(0xc0 | ext << 3 | (r & 7));
+    word(x);
+}
+
+/* not, neg, idiv (ext 2, 3, 7) r */
+static void
+unary(ext, r)
+{
+    rex(0, 0, 0, r);
+    byte(0xf7);
+    byte(0xc0 | ext << 3 | (r & 7));
+}
+
+static void
+call(fn)
+    void *fn;
+{
+    byte(0x48); byte(0xb8); quad(fn);   /* mov rax, fn */
+    byte(0xff); byte(0xd0);             /* call rax */
+}
+
+/* Jump to the INTCODE address in eax. */
+static void
+dispatch()
+{
+    byte(0x3d); word(Vsize);                    /* cmp eax, Vsize */
+    byte(0x0f); byte(0x80 | CC_AE); rel(Miss);  /* jae Miss */
+    byte(0x41); byte(0xff); byte(0x64);         /* jmp [r13 + rax*8] */
+    byte(0xc5); byte(0);
+}
+
+/* Short jump over code emitted later, unless condition cc holds. */
+static unsigned char *
+skipunless(cc)
+{
+    byte(0x70 | (cc ^ 1));
+    byte(0);
+    return Cp;
+}
+
+static void
+skipto(from)
+    unsigned char *from;
+{
+    from[-1] = Cp - from;
+}
+
+/* Jump, if condition cc holds, to INTCODE address t. */
+static void
+jump(cc, t)
+{
+    unsigned char *skip = NULL;
+
+    if (t >= Lo && t < Hi) {
+        if (cc == ALWAYS)
+            byte(0xe9);
+        else {
+            byte(0x0f);
+            byte(0x80 | cc);
+        }
+        Patch[Npatch].at = Cp;
+        Patch[Npatch].to = t;
+        Npatch++;
+        word(0);
+        return;
+    }
+    if (cc != ALWAYS)
+        skip = skipunless(cc);
+    movi(RAX, t);
+    dispatch();
+    if (skip != NULL)
+        skipto(skip);
+}
+
+/* Return to C with C = c; the interpreter takes over if miss is set. */
+static void
+leave(c, miss)
+{
+    movi(RCX, c);
+    movi(RDX, miss);
+    byte(0xe9);
+    rel(Exit);
+}
+
+static int
+small(k)
+{
+    return k > -(1 << 28) && k < (1 << 28);
+}
+
+/* Compute the operand of instruction w with address field k into r. */
+static void
+operand(r, w, k)
+{
+    int m = w & (IBIT | PBIT | GBIT);
+
+    switch (m) {
+    case 0:
+        movi(r, k);
+        return;
+    case PBIT:
+        mem(0x8d, r, R14, NOINDEX, 0, k);       /* lea r, [r14 + k] */
+        return;
+    case GBIT:
+        movi(r, k + G);
+        return;
+    case IBIT:
+        if (!small(k)) break;
+        LOAD(r, NOINDEX, 4 * k);
+        return;
+    case IBIT | PBIT:
+        if (!small(k)) break;
+        LOAD(r, R14, 4 * k);
+        return;
+    case IBIT | GBIT:
+        if (!small(k + G)) break;
+        LOAD(r, NOINDEX, 4 * (k + G));
+        return;
+    }
+    movi(r, k);
+    if ((m & PBIT) != 0) reg(0x01, r, R14);
+    if ((m & GBIT) != 0) alui(0, r, G);
+    if ((m & IBIT) != 0) LOAD(r, r, 0);
+}
+
+/* A = B relation A, as ~0 or 0 */
+static void
+relation(cc)
+{
+    reg(0x39, RBP, RBX);                        /* cmp ebp, ebx */
+    byte(0x0f); byte(0x90 | cc); byte(0xc3);    /* setcc bl */
+    byte(0x0f); byte(0xb6); byte(0xdb);         /* movzx ebx, bl */
+    unary(3, RBX);
+}
+
+/* switchon: return the target in the low half, the new B in the high. */
+static unsigned long
+jswitch(a, c)
+{
+    int b = M[c], d = M[c + 1];
+
+    while (b != 0) {
+        b--; c += 2;
+        if (a == M[c]) { d = M[c + 1]; break; }
+    }
+    return (unsigned long) (unsigned) b << 32 | (unsigned) d;
+}
+
+/* Translate the instruction at M[i]. */
+static void
+fragment(i)
+{
+    int w = M[i];
+    int f = w >> FSHIFT;
+    int m = w & (IBIT | PBIT | GBIT);
+    int k, c, len;
+    unsigned char *skip;
+
+    if ((w & DBIT) == 0) {
+        k = w & ABITS;
+        len = 1;
+    } else {
+        k = M[i + 1];
+        len = 2;
+    }
+    c = i + len;
+    if (f < 0 || f > 7 || (f == 7 && (m != 0 || k < 1 || k > 39))) {
+        leave(i, 1);
+        return;
+    }
+    byte(0x41); byte(0xff); byte(0xc7);         /* inc r15d */
+
+    switch (f) {
+    case 0:
+        MOV(RBP, RBX);
+        operand(RBX, w, k);
+        break;
+    case 1:
+        if (m == 0 && small(k))
+            STORE(RBX, NOINDEX, 4 * k);
+        else if (m == PBIT && small(k))
+            STORE(RBX, R14, 4 * k);
+        else if (m == GBIT && small(k + G))
+            STORE(RBX, NOINDEX, 4 * (k + G));
+        else {
+            operand(RAX, w, k);
+            STORE(RBX, RAX, 0);
+        }
+        break;
+    case 2:
+        if (m == 0)
+            alui(0, RBX, k);
+        else {
+            operand(RAX, w, k);
+            reg(0x01, RBX, RAX);
+        }
+        break;
+    case 3:
+        if (m == 0 || m == GBIT)
+            jump(ALWAYS, m == 0 ? k : k + G);
+        else {
+            operand(RAX, w, k);
+            dispatch();
+        }
+        return;
+    case 4:
+    case 5:
+        if (m != 0 && m != GBIT)
+            operand(RAX, w, k);
+        reg(0x85, RBX, RBX);                    /* test ebx, ebx */
+        if (f == 4) {
+            movi(RBX, 0);
+            byte(0x0f); byte(0x94); byte(0xc3); /* sete bl */
+        }
+        if (m == 0 || m == GBIT)
+            jump(f == 4 ? CC_NE : CC_E, m == 0 ? k : k + G);
+        else {
+            skip = skipunless(f == 4 ? CC_NE : CC_E);
+            dispatch();
+            skipto(skip);
+        }
+        break;
+    case 6:
+        operand(RAX, w, k);
+        reg(0x01, RAX, R14);
+        STORE(R14, RAX, 0);
+        mem(0xc7, 0, R12, RAX, 2, 4);           /* mov [M + d + 1], c */
+        word(c);
+        MOV(R14, RAX);
+        MOV(RAX, RBX);
+        dispatch();
+        return;
+    case 7:
+        switch (k) {
+        case 1: LOAD(RBX, RBX, 0); break;
+        case 2: unary(3, RBX); break;
+        case 3: unary(2, RBX); break;
+        case 4:
+            LOAD(RAX, R14, 4);
+            LOAD(R14, R14, 0);
+            dispatch();
+            return;
+        case 5:
+            byte(0x0f); byte(0xaf); byte(0xdd); /* imul ebx, ebp */
+            break;
+        case 6:
+        case 7:
+            MOV(RAX, RBP);
+            byte(0x99);                         /* cdq */
+            unary(7, RBX);
+            MOV(RBX, k == 6 ? RAX : RDX);
+            break;
+        case 8: reg(0x01, RBX, RBP); break;
+        case 9:
+            MOV(RAX, RBP);
+            reg(0x29, RAX, RBX);
+            MOV(RBX, RAX);
+            break;
+        case 10: relation(CC_E); break;
+        case 11: relation(CC_NE); break;
+        case 12: relation(CC_L); break;
+        case 13: relation(CC_GE); break;
+        case 14: relation(CC_G); break;
+        case 15: relation(CC_LE); break;
+        case 16:
+        case 17:
+            MOV(RCX, RBX);
+            MOV(RBX, RBP);
+            byte(0xd3); byte(k == 16 ? 0xe3 : 0xfb);    /* shl/sar ebx, cl */
+            break;
+        case 18: reg(0x21, RBX, RBP); break;
+        case 19: reg(0x09, RBX, RBP); break;
+        case 20: reg(0x31, RBX, RBP); break;
+        case 21:
+            unary(2, RBX);
+            reg(0x31, RBX, RBP);
+            break;
+        case 22:
+            movi(RBX, 0);
+            leave(c, 0);
+            return;
+        case 23:
+            MOV(RDI, RBX);
+            movi(RSI, c);
+            call((void *) jswitch);
+            byte(0x48); byte(0x89); byte(0xc1); /* mov rcx, rax */
+            byte(0x48); byte(0xc1); byte(0xe9); byte(32);   /* shr rcx, 32 */
+            MOV(RBP, RCX);
+            MOV(RAX, RAX);
+            dispatch();
+            return;
+        case 24: MOV(RDI, RBX); call((void *) selectinput); break;
+        case 25: MOV(RDI, RBX); call((void *) selectoutput); break;
+        case 26: call((void *) rdch); MOV(RBX, RAX); break;
+        case 27: MOV(RDI, RBX); call((void *) wrch); break;
+        case 28:
+            MOV(RDI, RBX);
+            call((void *) findinput);
+            MOV(RBX, RAX);
+            break;
+        case 29:
+            MOV(RDI, RBX);
+            call((void *) findoutput);
+            MOV(RBX, RAX);
+            break;
+        case 30:
+            leave(c, 0);
+            return;
+        case 31: LOAD(RBX, R14, 0); break;
+        case 32:
+            MOV(R14, RBX);
+            MOV(RAX, RBP);
+            dispatch();
+            return;
+        case 33: call((void *) endread); break;
+        case 34: call((void *) endwrite); break;
+        case 35:
+            mem(0x8d, RAX, R14, RBP, 0, 1);     /* lea eax, [r14 + rbp + 1] */
+            LOAD(RCX, R14, 0);
+            STORE(RCX, RAX, 0);
+            LOAD(RCX, R14, 4);
+            STORE(RCX, RAX, 4);
+            STORE(R14, RAX, 8);
+            STORE(RBP, RAX, 12);
+            MOV(R14, RAX);
+            MOV(RAX, RBX);
+            dispatch();
+            return;
+        case 36:
+            MOV(RDI, RBX);
+            MOV(RSI, RBP);
+            call((void *) getbyte);
+            MOV(RBX, RAX);
+            break;
+        case 37:
+            MOV(RDI, RBX);
+            MOV(RSI, RBP);
+            LOAD(RDX, R14, 16);
+            call((void *) putbyte);
+            break;
+        case 38: call((void *) input); MOV(RBX, RAX); break;
+        case 39: call((void *) output); MOV(RBX, RAX); break;
+        }
+        break;
+    }
+    if (len != 1 || c >= Hi)
+        jump(ALWAYS, c);
+}
+
+/* Code shared by all fragments. */
+static void
+stubs()
+{
+    /* int enter(struct jstate *s, void *code) */
+    Enter = Cp;
+    byte(0x53);                                 /* push rbx */
+    byte(0x55);                                 /* push rbp */
+    byte(0x41); byte(0x54);                     /* push r12 */
+    byte(0x41); byte(0x55);                     /* push r13 */
+    byte(0x41); byte(0x56);                     /* push r14 */
+    byte(0x41); byte(0x57);                     /* push r15 */
+    byte(0x57);                                 /* push rdi */
+    byte(0x49); byte(0xbc); quad(M);            /* mov r12, M */
+    byte(0x49); byte(0xbd); quad(Nat);          /* mov r13, Nat */
+    byte(0x8b); byte(0x5f); byte(0);            /* mov ebx, [rdi].a */
+    byte(0x8b); byte(0x6f); byte(4);            /* mov ebp, [rdi].b */
+    byte(0x44); byte(0x8b); byte(0x77); byte(12);   /* mov r14d, [rdi].p */
+    byte(0x44); byte(0x8b); byte(0x7f); byte(16);   /* mov r15d, [rdi].cyc */
+    byte(0xff); byte(0xe6);                     /* jmp rsi */
+
+    /* ecx = C, edx = miss */
+    Exit = Cp;
+    byte(0x5f);                                 /* pop rdi */
+    byte(0x89); byte(0x5f); byte(0);            /* mov [rdi].a, ebx */
+    byte(0x89); byte(0x6f); byte(4);            /* mov [rdi].b, ebp */
+    byte(0x89); byte(0x4f); byte(8);            /* mov [rdi].c, ecx */
+    byte(0x44); byte(0x89); byte(0x77); byte(12);   /* mov [rdi].p, r14d */
+    byte(0x44); byte(0x89); byte(0x7f); byte(16);   /* mov [rdi].cyc, r15d */
+    byte(0x89); byte(0x57); byte(20);           /* mov [rdi].miss, edx */
+    MOV(RAX, RBX);
+    byte(0x41); byte(0x5f);                     /* pop r15 */
+    byte(0x41); byte(0x5e);                     /* pop r14 */
+    byte(0x41); byte(0x5d);                     /* pop r13 */
+    byte(0x41); byte(0x5c);                     /* pop r12 */
+    byte(0x5d);                                 /* pop rbp */
+    byte(0x5b);                                 /* pop rbx */
+    byte(0xc3);                                 /* ret */
+
+    /* eax = C */
+    Miss = Cp;
+    MOV(RCX, RAX);
+    movi(RDX, 1);
+    byte(0xe9);
+    rel(Exit);
+}
+
+/*
+ * Translate the program in M[lo] to M[hi - 1]; g is the global
+ * vector and vsize the size of M.  Return 0 if there is no room
+ * for the code.
+ */
+int
+jitcompile(lo, hi, g, vsize)
+{
+    unsigned char *end;
+    void *p;
+    int i;
+
+    Lo = lo;
+    Hi = hi;
+    G = g;
+    Vsize = vsize;
+    Codesize = (size_t) (hi - lo) * FRAGMAX + 4096;
+    p = mmap(NULL, Codesize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    Nat = malloc(vsize * sizeof(void *));
+    Patch = malloc(2 * (hi - lo + 1) * sizeof(struct patch));
+    if (p == MAP_FAILED || Nat == NULL || Patch == NULL)
+        return 0;
+    Code = Cp = p;
+    Npatch = 0;
+
+    stubs();
+    for (i = 0; i < vsize; i++)
+        Nat[i] = Miss;
+    for (i = lo; i < hi; i++) {
+        Nat[i] = Cp;
+        fragment(i);
+        if (Cp - (unsigned char *) Nat[i] > FRAGMAX) {
+            fprintf(stderr, "icjit: fragment too long at %d\n", i);
+            abort();
+        }
+    }
+    end = Cp;
+    for (i = 0; i < Npatch; i++) {
+        unsigned char *at = Patch[i].at;
+        unsigned char *to = Nat[Patch[i].to];
+
+        Cp = at;
+        rel(to);
+    }
+    free(Patch);
+    Cp = end;
+    if (mprotect(Code, Codesize, PROT_READ | PROT_EXEC) < 0)
+        return 0;
+    return 1;
+}
+
+/*
+ * Run the translated program from s->c until it stops, or until
+ * it reaches code it cannot run, which sets s->miss.
+ */
+int
+jitrun(s)
+    struct jstate *s;
+{
+    if (s->c < 0 || s->c >= Vsize || Nat[s->c] == Miss) {
+        s->miss = 1;
+        return s->a;
+    }
+    return ((int (*)(struct jstate *, void *)) Enter)(s, Nat[s->c]);
+}
+
+/* Bytes of native code. */
+int
+jitsize()
+{
+    return Cp - Code;
+}
+#else
+int
+jitcompile(lo, hi, g, vsize)
+{
+    return 0;
+}
+
+int
+jitrun(s)
+    struct jstate *s;
+{
+    s->miss = 1;
+    return s->a;
+}
+
+int
+jitsize()
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,12 @@
+/* INTCODE to native code translator for icint. */
+
+/* INTCODE machine state passed to and from the native code. */
+struct jstate {
+    int a, b, c, p;
+    int cyc;            /* instructions executed */
+    int miss;           /* nonzero: continue interpreting at c */
+};
+
+int jitcompile(int lo, int hi, int g, int vsize);
+int jitrun(struct jstate *s);
+int jitsize(void);
@@ -64,6 +64,15 @@ void do_counter ()
 
 int main (int argc, char **argv)
 {
+    /* Optional waveform file. */
+    if (argc > 1) {
+        trace_open (argv[1]);
+        trace_signal (&clock, 1);
+        trace_signal (&reset, 1);
+        trace_signal (&enable, 1);
+        trace_signal (&count, 4);
+    }
+
     /* Create processes with 4kbyte stacks. */
     process_init ("clock", do_clock, 4096);
     process_init ("counter", do_counter, 4096);
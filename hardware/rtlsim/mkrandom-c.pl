@@ -1,13 +1,22 @@
 #!/usr/bin/env perl
 
-$gates = 64;
-$steps = 2000;
-$loops = 30000;
+#
+# Usage: mkrandom-c.pl [gates [steps [loops [delay-probability [toggle]]]]]
+#
+# With nonzero toggle, the inputs are inverted instead of being
+# set from the outputs, so the gates keep switching.
+#
+$gates = $ARGV[0] || 64;
+$steps = $ARGV[1] || 2000;
+$loops = $ARGV[2] || 30000;
+$pdelay = $ARGV[3] || 0.2;
+$toggle = $ARGV[4] || 0;
 #$steps = 2;
 #$loops = 1;
 srand (123);
 
 print qq[#include <stdio.h>
+#include <string.h>
 #include "rtlsim.h"
 ];
 
@@ -33,14 +42,10 @@ for ($i = 0; $i < $gates; ++$i) {
 
     $op = $binop[int(rand() * 6)];
     $op = sprintf "$op", "a$x.value", "a$y.value";
+    $bin[$i] = "a$x a$y";
 
     print qq[void do_b$i () {
-    process_sensitive (&a$x, 0);
-    process_sensitive (&a$y, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b$i, $op);
-    }
+    signal_set (&b$i, $op);
 }
 ];
 }
@@ -58,14 +63,10 @@ for ($i = 0; $i < $gates; ++$i) {
 
     $op = $binop[int(rand() * 6)];
     $op = sprintf "$op", "b$x.value", "b$y.value";
+    $cin[$i] = "b$x b$y";
 
     print qq[void do_c$i () {
-    process_sensitive (&b$x, 0);
-    process_sensitive (&b$y, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c$i, $op);
-    }
+    signal_set (&c$i, $op);
 }
 ];
 }
@@ -74,21 +75,60 @@ print qq[void print_a_b_c() {
     value_t a = 0, b = 0, c = 0;
 ];
 for ($i = 0; $i < $gates; ++$i) {
-    print qq[    a |= a$i.value << $i;
-    b |= b$i.value << $i;
-    c |= c$i.value << $i;
+    $bit = $i % 64;
+    print qq[    a ^= a$i.value << $bit;
+    b ^= b$i.value << $bit;
+    c ^= c$i.value << $bit;
 ];
 }
 print qq[    printf ("%016llx %016llx %016llx\\n", a, b, c);
 }
 
-int main() {
+void trace_all() {
+];
+for ($i = 0; $i < $gates; ++$i) {
+    print qq[    trace_signal (&a$i, 1);
+    trace_signal (&b$i, 1);
+    trace_signal (&c$i, 1);
+];
+}
+print qq[}
+
+/*
+ * With -l, use the levelized schedule; -t gives the number of threads.
+ * With -v, write all signals to the waveform file.
+ */
+int main (int argc, char **argv) {
     int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp (argv[i], "-l") == 0)
+            process_levelized = 1;
+        else if (strcmp (argv[i], "-t") == 0 && i+1 < argc) {
+            process_levelized = 1;
+            process_threads = atoi (argv[++i]);
+        } else if (strcmp (argv[i], "-v") == 0 && i+1 < argc) {
+            trace_open (argv[++i]);
+            trace_all();
+        }
+    }
 ];
 
 for ($i = 0; $i < $gates; ++$i) {
-    print qq[    process_init ("b$i", do_b$i, 4096);
-    process_init ("c$i", do_c$i, 4096);
+    print qq[    comb_init ("b$i", do_b$i);
+];
+    foreach $s (split (/ /, $bin[$i])) {
+        print qq[    comb_input (&$s);
+];
+    }
+    print qq[    comb_output (&b$i);
+    comb_init ("c$i", do_c$i);
+];
+    foreach $s (split (/ /, $cin[$i])) {
+        print qq[    comb_input (&$s);
+];
+    }
+    print qq[    comb_output (&c$i);
 ];
 }
 
@@ -101,11 +141,15 @@ print qq[    process_delay (1);
 ];
 
 for ($i = 0; $i < $steps; ++$i) {
-    if (rand() < 0.2) {
+    if (rand() < $pdelay) {
         printf "        process_delay (1);\n";
     }
     $x = int(rand() * $gates);
-    printf "        signal_set (&a$x, ! c$x.value);\n";
+    if ($toggle) {
+        printf "        signal_set (&a$x, ! a$x.value);\n";
+    } else {
+        printf "        signal_set (&a$x, ! c$x.value);\n";
+    }
 }
 
 print qq[
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "rtlsim.h"
 signal_t a0 = signal_init ("a0", ~0);
 signal_t b0 = signal_init ("b0", ~0);
@@ -193,1356 +194,1311 @@ signal_t a63 = signal_init ("a63", ~0);
 signal_t b63 = signal_init ("b63", ~0);
 signal_t c63 = signal_init ("c63", ~0);
 void do_b0 () {
-    process_sensitive (&a18, 0);
-    process_sensitive (&a27, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b0, !(a18.value ^ a27.value));
-    }
+    signal_set (&b0, !(a18.value ^ a27.value));
 }
 void do_b1 () {
-    process_sensitive (&a10, 0);
-    process_sensitive (&a9, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b1, (a10.value | a9.value));
-    }
+    signal_set (&b1, (a10.value | a9.value));
 }
 void do_b2 () {
-    process_sensitive (&a42, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b2, a42.value ^ a55.value);
-    }
+    signal_set (&b2, a42.value ^ a55.value);
 }
 void do_b3 () {
-    process_sensitive (&a13, 0);
-    process_sensitive (&a53, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b3, (a13.value | a53.value));
-    }
+    signal_set (&b3, (a13.value | a53.value));
 }
 void do_b4 () {
-    process_sensitive (&a0, 0);
-    process_sensitive (&a14, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b4, !(a0.value ^ a14.value));
-    }
+    signal_set (&b4, !(a0.value ^ a14.value));
 }
 void do_b5 () {
-    process_sensitive (&a13, 0);
-    process_sensitive (&a57, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b5, (a13.value | a57.value));
-    }
+    signal_set (&b5, (a13.value | a57.value));
 }
 void do_b6 () {
-    process_sensitive (&a63, 0);
-    process_sensitive (&a16, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b6, !(a63.value ^ a16.value));
-    }
+    signal_set (&b6, !(a63.value ^ a16.value));
 }
 void do_b7 () {
-    process_sensitive (&a41, 0);
-    process_sensitive (&a26, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b7, !(a41.value ^ a26.value));
-    }
+    signal_set (&b7, !(a41.value ^ a26.value));
 }
 void do_b8 () {
-    process_sensitive (&a31, 0);
-    process_sensitive (&a62, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b8, a31.value ^ a62.value);
-    }
+    signal_set (&b8, a31.value ^ a62.value);
 }
 void do_b9 () {
-    process_sensitive (&a18, 0);
-    process_sensitive (&a54, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b9, !(a18.value ^ a54.value));
-    }
+    signal_set (&b9, !(a18.value ^ a54.value));
 }
 void do_b10 () {
-    process_sensitive (&a57, 0);
-    process_sensitive (&a5, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b10, a57.value & a5.value);
-    }
+    signal_set (&b10, a57.value & a5.value);
 }
 void do_b11 () {
-    process_sensitive (&a5, 0);
-    process_sensitive (&a50, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b11, !(a5.value ^ a50.value));
-    }
+    signal_set (&b11, !(a5.value ^ a50.value));
 }
 void do_b12 () {
-    process_sensitive (&a28, 0);
-    process_sensitive (&a47, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b12, !(a28.value ^ a47.value));
-    }
+    signal_set (&b12, !(a28.value ^ a47.value));
 }
 void do_b13 () {
-    process_sensitive (&a55, 0);
-    process_sensitive (&a6, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b13, !(a55.value | a6.value));
-    }
+    signal_set (&b13, !(a55.value | a6.value));
 }
 void do_b14 () {
-    process_sensitive (&a24, 0);
-    process_sensitive (&a48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b14, !(a24.value ^ a48.value));
-    }
+    signal_set (&b14, !(a24.value ^ a48.value));
 }
 void do_b15 () {
-    process_sensitive (&a45, 0);
-    process_sensitive (&a28, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b15, !(a45.value ^ a28.value));
-    }
+    signal_set (&b15, !(a45.value ^ a28.value));
 }
 void do_b16 () {
-    process_sensitive (&a36, 0);
-    process_sensitive (&a26, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b16, !(a36.value | a26.value));
-    }
+    signal_set (&b16, !(a36.value | a26.value));
 }
 void do_b17 () {
-    process_sensitive (&a39, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b17, !(a39.value & a55.value));
-    }
+    signal_set (&b17, !(a39.value & a55.value));
 }
 void do_b18 () {
-    process_sensitive (&a26, 0);
-    process_sensitive (&a57, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b18, !(a26.value & a57.value));
-    }
+    signal_set (&b18, !(a26.value & a57.value));
 }
 void do_b19 () {
-    process_sensitive (&a39, 0);
-    process_sensitive (&a32, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b19, a39.value ^ a32.value);
-    }
+    signal_set (&b19, a39.value ^ a32.value);
 }
 void do_b20 () {
-    process_sensitive (&a13, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b20, !(a13.value & a55.value));
-    }
+    signal_set (&b20, !(a13.value & a55.value));
 }
 void do_b21 () {
-    process_sensitive (&a51, 0);
-    process_sensitive (&a46, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b21, (a51.value | a46.value));
-    }
+    signal_set (&b21, (a51.value | a46.value));
 }
 void do_b22 () {
-    process_sensitive (&a18, 0);
-    process_sensitive (&a51, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b22, a18.value ^ a51.value);
-    }
+    signal_set (&b22, a18.value ^ a51.value);
 }
 void do_b23 () {
-    process_sensitive (&a17, 0);
-    process_sensitive (&a43, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b23, a17.value ^ a43.value);
-    }
+    signal_set (&b23, a17.value ^ a43.value);
 }
 void do_b24 () {
-    process_sensitive (&a16, 0);
-    process_sensitive (&a2, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b24, (a16.value | a2.value));
-    }
+    signal_set (&b24, (a16.value | a2.value));
 }
 void do_b25 () {
-    process_sensitive (&a30, 0);
-    process_sensitive (&a32, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b25, !(a30.value | a32.value));
-    }
+    signal_set (&b25, !(a30.value | a32.value));
 }
 void do_b26 () {
-    process_sensitive (&a44, 0);
-    process_sensitive (&a62, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b26, a44.value & a62.value);
-    }
+    signal_set (&b26, a44.value & a62.value);
 }
 void do_b27 () {
-    process_sensitive (&a52, 0);
-    process_sensitive (&a25, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b27, !(a52.value ^ a25.value));
-    }
+    signal_set (&b27, !(a52.value ^ a25.value));
 }
 void do_b28 () {
-    process_sensitive (&a36, 0);
-    process_sensitive (&a61, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b28, !(a36.value | a61.value));
-    }
+    signal_set (&b28, !(a36.value | a61.value));
 }
 void do_b29 () {
-    process_sensitive (&a21, 0);
-    process_sensitive (&a48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b29, !(a21.value | a48.value));
-    }
+    signal_set (&b29, !(a21.value | a48.value));
 }
 void do_b30 () {
-    process_sensitive (&a47, 0);
-    process_sensitive (&a56, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b30, !(a47.value & a56.value));
-    }
+    signal_set (&b30, !(a47.value & a56.value));
 }
 void do_b31 () {
-    process_sensitive (&a56, 0);
-    process_sensitive (&a17, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b31, !(a56.value & a17.value));
-    }
+    signal_set (&b31, !(a56.value & a17.value));
 }
 void do_b32 () {
-    process_sensitive (&a18, 0);
-    process_sensitive (&a4, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b32, !(a18.value ^ a4.value));
-    }
+    signal_set (&b32, !(a18.value ^ a4.value));
 }
 void do_b33 () {
-    process_sensitive (&a56, 0);
-    process_sensitive (&a52, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b33, !(a56.value & a52.value));
-    }
+    signal_set (&b33, !(a56.value & a52.value));
 }
 void do_b34 () {
-    process_sensitive (&a48, 0);
-    process_sensitive (&a28, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b34, !(a48.value ^ a28.value));
-    }
+    signal_set (&b34, !(a48.value ^ a28.value));
 }
 void do_b35 () {
-    process_sensitive (&a40, 0);
-    process_sensitive (&a49, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b35, a40.value & a49.value);
-    }
+    signal_set (&b35, a40.value & a49.value);
 }
 void do_b36 () {
-    process_sensitive (&a40, 0);
-    process_sensitive (&a5, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b36, (a40.value | a5.value));
-    }
+    signal_set (&b36, (a40.value | a5.value));
 }
 void do_b37 () {
-    process_sensitive (&a7, 0);
-    process_sensitive (&a11, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b37, !(a7.value & a11.value));
-    }
+    signal_set (&b37, !(a7.value & a11.value));
 }
 void do_b38 () {
-    process_sensitive (&a33, 0);
-    process_sensitive (&a28, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b38, a33.value ^ a28.value);
-    }
+    signal_set (&b38, a33.value ^ a28.value);
 }
 void do_b39 () {
-    process_sensitive (&a0, 0);
-    process_sensitive (&a9, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b39, a0.value & a9.value);
-    }
+    signal_set (&b39, a0.value & a9.value);
 }
 void do_b40 () {
-    process_sensitive (&a30, 0);
-    process_sensitive (&a24, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b40, (a30.value | a24.value));
-    }
+    signal_set (&b40, (a30.value | a24.value));
 }
 void do_b41 () {
-    process_sensitive (&a38, 0);
-    process_sensitive (&a5, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b41, a38.value & a5.value);
-    }
+    signal_set (&b41, a38.value & a5.value);
 }
 void do_b42 () {
-    process_sensitive (&a10, 0);
-    process_sensitive (&a41, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b42, (a10.value | a41.value));
-    }
+    signal_set (&b42, (a10.value | a41.value));
 }
 void do_b43 () {
-    process_sensitive (&a24, 0);
-    process_sensitive (&a39, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b43, a24.value & a39.value);
-    }
+    signal_set (&b43, a24.value & a39.value);
 }
 void do_b44 () {
-    process_sensitive (&a41, 0);
-    process_sensitive (&a54, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b44, a41.value ^ a54.value);
-    }
+    signal_set (&b44, a41.value ^ a54.value);
 }
 void do_b45 () {
-    process_sensitive (&a29, 0);
-    process_sensitive (&a32, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b45, !(a29.value & a32.value));
-    }
+    signal_set (&b45, !(a29.value & a32.value));
 }
 void do_b46 () {
-    process_sensitive (&a18, 0);
-    process_sensitive (&a54, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b46, a18.value & a54.value);
-    }
+    signal_set (&b46, a18.value & a54.value);
 }
 void do_b47 () {
-    process_sensitive (&a45, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b47, !(a45.value ^ a55.value));
-    }
+    signal_set (&b47, !(a45.value ^ a55.value));
 }
 void do_b48 () {
-    process_sensitive (&a15, 0);
-    process_sensitive (&a16, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b48, !(a15.value ^ a16.value));
-    }
+    signal_set (&b48, !(a15.value ^ a16.value));
 }
 void do_b49 () {
-    process_sensitive (&a13, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b49, !(a13.value & a55.value));
-    }
+    signal_set (&b49, !(a13.value & a55.value));
 }
 void do_b50 () {
-    process_sensitive (&a28, 0);
-    process_sensitive (&a6, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b50, !(a28.value & a6.value));
-    }
+    signal_set (&b50, !(a28.value & a6.value));
 }
 void do_b51 () {
-    process_sensitive (&a5, 0);
-    process_sensitive (&a37, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b51, !(a5.value & a37.value));
-    }
+    signal_set (&b51, !(a5.value & a37.value));
 }
 void do_b52 () {
-    process_sensitive (&a50, 0);
-    process_sensitive (&a42, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b52, a50.value & a42.value);
-    }
+    signal_set (&b52, a50.value & a42.value);
 }
 void do_b53 () {
-    process_sensitive (&a57, 0);
-    process_sensitive (&a5, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b53, !(a57.value ^ a5.value));
-    }
+    signal_set (&b53, !(a57.value ^ a5.value));
 }
 void do_b54 () {
-    process_sensitive (&a35, 0);
-    process_sensitive (&a10, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b54, !(a35.value | a10.value));
-    }
+    signal_set (&b54, !(a35.value | a10.value));
 }
 void do_b55 () {
-    process_sensitive (&a49, 0);
-    process_sensitive (&a38, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b55, a49.value ^ a38.value);
-    }
+    signal_set (&b55, a49.value ^ a38.value);
 }
 void do_b56 () {
-    process_sensitive (&a46, 0);
-    process_sensitive (&a48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b56, !(a46.value | a48.value));
-    }
+    signal_set (&b56, !(a46.value | a48.value));
 }
 void do_b57 () {
-    process_sensitive (&a56, 0);
-    process_sensitive (&a33, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b57, !(a56.value | a33.value));
-    }
+    signal_set (&b57, !(a56.value | a33.value));
 }
 void do_b58 () {
-    process_sensitive (&a55, 0);
-    process_sensitive (&a55, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b58, !(a55.value & a55.value));
-    }
+    signal_set (&b58, !(a55.value & a55.value));
 }
 void do_b59 () {
-    process_sensitive (&a40, 0);
-    process_sensitive (&a22, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b59, a40.value & a22.value);
-    }
+    signal_set (&b59, a40.value & a22.value);
 }
 void do_b60 () {
-    process_sensitive (&a14, 0);
-    process_sensitive (&a61, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b60, !(a14.value ^ a61.value));
-    }
+    signal_set (&b60, !(a14.value ^ a61.value));
 }
 void do_b61 () {
-    process_sensitive (&a28, 0);
-    process_sensitive (&a53, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b61, !(a28.value ^ a53.value));
-    }
+    signal_set (&b61, !(a28.value ^ a53.value));
 }
 void do_b62 () {
-    process_sensitive (&a49, 0);
-    process_sensitive (&a23, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b62, (a49.value | a23.value));
-    }
+    signal_set (&b62, (a49.value | a23.value));
 }
 void do_b63 () {
-    process_sensitive (&a4, 0);
-    process_sensitive (&a11, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&b63, !(a4.value ^ a11.value));
-    }
+    signal_set (&b63, !(a4.value ^ a11.value));
 }
 void do_c0 () {
-    process_sensitive (&b20, 0);
-    process_sensitive (&b3, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c0, !(b20.value & b3.value));
-    }
+    signal_set (&c0, !(b20.value & b3.value));
 }
 void do_c1 () {
-    process_sensitive (&b58, 0);
-    process_sensitive (&b63, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c1, !(b58.value & b63.value));
-    }
+    signal_set (&c1, !(b58.value & b63.value));
 }
 void do_c2 () {
-    process_sensitive (&b23, 0);
-    process_sensitive (&b22, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c2, (b23.value | b22.value));
-    }
+    signal_set (&c2, (b23.value | b22.value));
 }
 void do_c3 () {
-    process_sensitive (&b50, 0);
-    process_sensitive (&b25, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c3, !(b50.value | b25.value));
-    }
+    signal_set (&c3, !(b50.value | b25.value));
 }
 void do_c4 () {
-    process_sensitive (&b39, 0);
-    process_sensitive (&b3, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c4, b39.value ^ b3.value);
-    }
+    signal_set (&c4, b39.value ^ b3.value);
 }
 void do_c5 () {
-    process_sensitive (&b57, 0);
-    process_sensitive (&b22, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c5, !(b57.value & b22.value));
-    }
+    signal_set (&c5, !(b57.value & b22.value));
 }
 void do_c6 () {
-    process_sensitive (&b44, 0);
-    process_sensitive (&b9, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c6, b44.value ^ b9.value);
-    }
+    signal_set (&c6, b44.value ^ b9.value);
 }
 void do_c7 () {
-    process_sensitive (&b49, 0);
-    process_sensitive (&b61, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c7, !(b49.value | b61.value));
-    }
+    signal_set (&c7, !(b49.value | b61.value));
 }
 void do_c8 () {
-    process_sensitive (&b50, 0);
-    process_sensitive (&b9, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c8, !(b50.value | b9.value));
-    }
+    signal_set (&c8, !(b50.value | b9.value));
 }
 void do_c9 () {
-    process_sensitive (&b10, 0);
-    process_sensitive (&b49, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c9, b10.value ^ b49.value);
-    }
+    signal_set (&c9, b10.value ^ b49.value);
 }
 void do_c10 () {
-    process_sensitive (&b63, 0);
-    process_sensitive (&b20, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c10, b63.value & b20.value);
-    }
+    signal_set (&c10, b63.value & b20.value);
 }
 void do_c11 () {
-    process_sensitive (&b22, 0);
-    process_sensitive (&b60, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c11, (b22.value | b60.value));
-    }
+    signal_set (&c11, (b22.value | b60.value));
 }
 void do_c12 () {
-    process_sensitive (&b37, 0);
-    process_sensitive (&b9, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c12, b37.value ^ b9.value);
-    }
+    signal_set (&c12, b37.value ^ b9.value);
 }
 void do_c13 () {
-    process_sensitive (&b43, 0);
-    process_sensitive (&b54, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c13, !(b43.value ^ b54.value));
-    }
+    signal_set (&c13, !(b43.value ^ b54.value));
 }
 void do_c14 () {
-    process_sensitive (&b62, 0);
-    process_sensitive (&b43, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c14, !(b62.value ^ b43.value));
-    }
+    signal_set (&c14, !(b62.value ^ b43.value));
 }
 void do_c15 () {
-    process_sensitive (&b63, 0);
-    process_sensitive (&b47, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c15, !(b63.value & b47.value));
-    }
+    signal_set (&c15, !(b63.value & b47.value));
 }
 void do_c16 () {
-    process_sensitive (&b57, 0);
-    process_sensitive (&b44, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c16, b57.value ^ b44.value);
-    }
+    signal_set (&c16, b57.value ^ b44.value);
 }
 void do_c17 () {
-    process_sensitive (&b32, 0);
-    process_sensitive (&b11, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c17, !(b32.value & b11.value));
-    }
+    signal_set (&c17, !(b32.value & b11.value));
 }
 void do_c18 () {
-    process_sensitive (&b57, 0);
-    process_sensitive (&b53, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c18, b57.value ^ b53.value);
-    }
+    signal_set (&c18, b57.value ^ b53.value);
 }
 void do_c19 () {
-    process_sensitive (&b24, 0);
-    process_sensitive (&b51, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c19, b24.value ^ b51.value);
-    }
+    signal_set (&c19, b24.value ^ b51.value);
 }
 void do_c20 () {
-    process_sensitive (&b53, 0);
-    process_sensitive (&b48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c20, (b53.value | b48.value));
-    }
+    signal_set (&c20, (b53.value | b48.value));
 }
 void do_c21 () {
-    process_sensitive (&b12, 0);
-    process_sensitive (&b27, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c21, !(b12.value ^ b27.value));
-    }
+    signal_set (&c21, !(b12.value ^ b27.value));
 }
 void do_c22 () {
-    process_sensitive (&b32, 0);
-    process_sensitive (&b4, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c22, b32.value ^ b4.value);
-    }
+    signal_set (&c22, b32.value ^ b4.value);
 }
 void do_c23 () {
-    process_sensitive (&b37, 0);
-    process_sensitive (&b2, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c23, !(b37.value ^ b2.value));
-    }
+    signal_set (&c23, !(b37.value ^ b2.value));
 }
 void do_c24 () {
-    process_sensitive (&b34, 0);
-    process_sensitive (&b4, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c24, (b34.value | b4.value));
-    }
+    signal_set (&c24, (b34.value | b4.value));
 }
 void do_c25 () {
-    process_sensitive (&b9, 0);
-    process_sensitive (&b24, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c25, (b9.value | b24.value));
-    }
+    signal_set (&c25, (b9.value | b24.value));
 }
 void do_c26 () {
-    process_sensitive (&b60, 0);
-    process_sensitive (&b13, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c26, (b60.value | b13.value));
-    }
+    signal_set (&c26, (b60.value | b13.value));
 }
 void do_c27 () {
-    process_sensitive (&b22, 0);
-    process_sensitive (&b39, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c27, !(b22.value & b39.value));
-    }
+    signal_set (&c27, !(b22.value & b39.value));
 }
 void do_c28 () {
-    process_sensitive (&b60, 0);
-    process_sensitive (&b39, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c28, !(b60.value & b39.value));
-    }
+    signal_set (&c28, !(b60.value & b39.value));
 }
 void do_c29 () {
-    process_sensitive (&b32, 0);
-    process_sensitive (&b14, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c29, b32.value ^ b14.value);
-    }
+    signal_set (&c29, b32.value ^ b14.value);
 }
 void do_c30 () {
-    process_sensitive (&b57, 0);
-    process_sensitive (&b49, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c30, !(b57.value | b49.value));
-    }
+    signal_set (&c30, !(b57.value | b49.value));
 }
 void do_c31 () {
-    process_sensitive (&b61, 0);
-    process_sensitive (&b44, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c31, b61.value & b44.value);
-    }
+    signal_set (&c31, b61.value & b44.value);
 }
 void do_c32 () {
-    process_sensitive (&b19, 0);
-    process_sensitive (&b20, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c32, b19.value ^ b20.value);
-    }
+    signal_set (&c32, b19.value ^ b20.value);
 }
 void do_c33 () {
-    process_sensitive (&b45, 0);
-    process_sensitive (&b24, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c33, !(b45.value ^ b24.value));
-    }
+    signal_set (&c33, !(b45.value ^ b24.value));
 }
 void do_c34 () {
-    process_sensitive (&b31, 0);
-    process_sensitive (&b35, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c34, !(b31.value | b35.value));
-    }
+    signal_set (&c34, !(b31.value | b35.value));
 }
 void do_c35 () {
-    process_sensitive (&b23, 0);
-    process_sensitive (&b63, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c35, b23.value ^ b63.value);
-    }
+    signal_set (&c35, b23.value ^ b63.value);
 }
 void do_c36 () {
-    process_sensitive (&b5, 0);
-    process_sensitive (&b48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c36, (b5.value | b48.value));
-    }
+    signal_set (&c36, (b5.value | b48.value));
 }
 void do_c37 () {
-    process_sensitive (&b20, 0);
-    process_sensitive (&b26, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c37, b20.value ^ b26.value);
-    }
+    signal_set (&c37, b20.value ^ b26.value);
 }
 void do_c38 () {
-    process_sensitive (&b30, 0);
-    process_sensitive (&b21, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c38, b30.value ^ b21.value);
-    }
+    signal_set (&c38, b30.value ^ b21.value);
 }
 void do_c39 () {
-    process_sensitive (&b62, 0);
-    process_sensitive (&b54, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c39, b62.value & b54.value);
-    }
+    signal_set (&c39, b62.value & b54.value);
 }
 void do_c40 () {
-    process_sensitive (&b13, 0);
-    process_sensitive (&b36, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c40, b13.value & b36.value);
-    }
+    signal_set (&c40, b13.value & b36.value);
 }
 void do_c41 () {
-    process_sensitive (&b37, 0);
-    process_sensitive (&b22, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c41, !(b37.value & b22.value));
-    }
+    signal_set (&c41, !(b37.value & b22.value));
 }
 void do_c42 () {
-    process_sensitive (&b26, 0);
-    process_sensitive (&b25, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c42, !(b26.value | b25.value));
-    }
+    signal_set (&c42, !(b26.value | b25.value));
 }
 void do_c43 () {
-    process_sensitive (&b8, 0);
-    process_sensitive (&b18, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c43, b8.value & b18.value);
-    }
+    signal_set (&c43, b8.value & b18.value);
 }
 void do_c44 () {
-    process_sensitive (&b47, 0);
-    process_sensitive (&b61, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c44, !(b47.value | b61.value));
-    }
+    signal_set (&c44, !(b47.value | b61.value));
 }
 void do_c45 () {
-    process_sensitive (&b40, 0);
-    process_sensitive (&b15, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c45, !(b40.value | b15.value));
-    }
+    signal_set (&c45, !(b40.value | b15.value));
 }
 void do_c46 () {
-    process_sensitive (&b11, 0);
-    process_sensitive (&b39, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c46, !(b11.value & b39.value));
-    }
+    signal_set (&c46, !(b11.value & b39.value));
 }
 void do_c47 () {
-    process_sensitive (&b17, 0);
-    process_sensitive (&b61, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c47, !(b17.value ^ b61.value));
-    }
+    signal_set (&c47, !(b17.value ^ b61.value));
 }
 void do_c48 () {
-    process_sensitive (&b15, 0);
-    process_sensitive (&b26, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c48, !(b15.value | b26.value));
-    }
+    signal_set (&c48, !(b15.value | b26.value));
 }
 void do_c49 () {
-    process_sensitive (&b45, 0);
-    process_sensitive (&b48, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c49, !(b45.value & b48.value));
-    }
+    signal_set (&c49, !(b45.value & b48.value));
 }
 void do_c50 () {
-    process_sensitive (&b15, 0);
-    process_sensitive (&b44, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c50, b15.value & b44.value);
-    }
+    signal_set (&c50, b15.value & b44.value);
 }
 void do_c51 () {
-    process_sensitive (&b38, 0);
-    process_sensitive (&b44, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c51, !(b38.value & b44.value));
-    }
+    signal_set (&c51, !(b38.value & b44.value));
 }
 void do_c52 () {
-    process_sensitive (&b54, 0);
-    process_sensitive (&b13, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c52, !(b54.value | b13.value));
-    }
+    signal_set (&c52, !(b54.value | b13.value));
 }
 void do_c53 () {
-    process_sensitive (&b37, 0);
-    process_sensitive (&b28, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c53, b37.value ^ b28.value);
-    }
+    signal_set (&c53, b37.value ^ b28.value);
 }
 void do_c54 () {
-    process_sensitive (&b61, 0);
-    process_sensitive (&b33, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c54, b61.value & b33.value);
-    }
+    signal_set (&c54, b61.value & b33.value);
 }
 void do_c55 () {
-    process_sensitive (&b39, 0);
-    process_sensitive (&b17, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c55, !(b39.value ^ b17.value));
-    }
+    signal_set (&c55, !(b39.value ^ b17.value));
 }
 void do_c56 () {
-    process_sensitive (&b20, 0);
-    process_sensitive (&b37, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c56, (b20.value | b37.value));
-    }
+    signal_set (&c56, (b20.value | b37.value));
 }
 void do_c57 () {
-    process_sensitive (&b47, 0);
-    process_sensitive (&b3, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c57, !(b47.value | b3.value));
-    }
+    signal_set (&c57, !(b47.value | b3.value));
 }
 void do_c58 () {
-    process_sensitive (&b11, 0);
-    process_sensitive (&b25, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c58, !(b11.value ^ b25.value));
-    }
+    signal_set (&c58, !(b11.value ^ b25.value));
 }
 void do_c59 () {
-    process_sensitive (&b30, 0);
-    process_sensitive (&b50, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c59, b30.value ^ b50.value);
-    }
+    signal_set (&c59, b30.value ^ b50.value);
 }
 void do_c60 () {
-    process_sensitive (&b55, 0);
-    process_sensitive (&b47, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c60, !(b55.value & b47.value));
-    }
+    signal_set (&c60, !(b55.value & b47.value));
 }
 void do_c61 () {
-    process_sensitive (&b34, 0);
-    process_sensitive (&b30, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c61, !(b34.value & b30.value));
-    }
+    signal_set (&c61, !(b34.value & b30.value));
 }
 void do_c62 () {
-    process_sensitive (&b56, 0);
-    process_sensitive (&b42, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c62, b56.value ^ b42.value);
-    }
+    signal_set (&c62, b56.value ^ b42.value);
 }
 void do_c63 () {
-    process_sensitive (&b20, 0);
-    process_sensitive (&b0, 0);
-    for (;;) {
-        process_wait();
-        signal_set (&c63, !(b20.value | b0.value));
-    }
+    signal_set (&c63, !(b20.value | b0.value));
 }
 void print_a_b_c() {
     value_t a = 0, b = 0, c = 0;
-    a |= a0.value << 0;
-    b |= b0.value << 0;
-    c |= c0.value << 0;
-    a |= a1.value << 1;
-    b |= b1.value << 1;
-    c |= c1.value << 1;
-    a |= a2.value << 2;
-    b |= b2.value << 2;
-    c |= c2.value << 2;
-    a |= a3.value << 3;
-    b |= b3.value << 3;
-    c |= c3.value << 3;
-    a |= a4.value << 4;
-    b |= b4.value << 4;
-    c |= c4.value << 4;
-    a |= a5.value << 5;
-    b |= b5.value << 5;
-    c |= c5.value << 5;
-    a |= a6.value << 6;
-    b |= b6.value << 6;
-    c |= c6.value << 6;
-    a |= a7.value << 7;
-    b |= b7.value << 7;
-    c |= c7.value << 7;
-    a |= a8.value << 8;
-    b |= b8.value << 8;
-    c |= c8.value << 8;
-    a |= a9.value << 9;
-    b |= b9.value << 9;
-    c |= c9.value << 9;
-    a |= a10.value << 10;
-    b |= b10.value << 10;
-    c |= c10.value << 10;
-    a |= a11.value << 11;
-    b |= b11.value << 11;
-    c |= c11.value << 11;
-    a |= a12.value << 12;
-    b |= b12.value << 12;
-    c |= c12.value << 12;
-    a |= a13.value << 13;
-    b |= b13.value << 13;
-    c |= c13.value << 13;
-    a |= a14.value << 14;
-    b |= b14.value << 14;
-    c |= c14.value << 14;
-    a |= a15.value << 15;
-    b |= b15.value << 15;
-    c |= c15.value << 15;
-    a |= a16.value << 16;
-    b |= b16.value << 16;
-    c |= c16.value << 16;
-    a |= a17.value << 17;
-    b |= b17.value << 17;
-    c |= c17.value << 17;
-    a |= a18.value << 18;
-    b |= b18.value << 18;
-    c |= c18.value << 18;
-    a |= a19.value << 19;
-    b |= b19.value << 19;
-    c |= c19.value << 19;
-    a |= a20.value << 20;
-    b |= b20.value << 20;
-    c |= c20.value << 20;
-    a |= a21.value << 21;
-    b |= b21.value << 21;
-    c |= c21.value << 21;
-    a |= a22.value << 22;
-    b |= b22.value << 22;
-    c |= c22.value << 22;
-    a |= a23.value << 23;
-    b |= b23.value << 23;
-    c |= c23.value << 23;
-    a |= a24.value << 24;
-    b |= b24.value << 24;
-    c |= c24.value << 24;
-    a |= a25.value << 25;
-    b |= b25.value << 25;
-    c |= c25.value << 25;
-    a |= a26.value << 26;
-    b |= b26.value << 26;
-    c |= c26.value << 26;
-    a |= a27.value << 27;
-    b |= b27.value << 27;
-    c |= c27.value << 27;
-    a |= a28.value << 28;
-    b |= b28.value << 28;
-    c |= c28.value << 28;
-    a |= a29.value << 29;
-    b |= b29.value << 29;
-    c |= c29.value << 29;
-    a |= a30.value << 30;
-    b |= b30.value << 30;
-    c |= c30.value << 30;
-    a |= a31.value << 31;
-    b |= b31.value << 31;
-    c |= c31.value << 31;
-    a |= a32.value << 32;
-    b |= b32.value << 32;
-    c |= c32.value << 32;
-    a |= a33.value << 33;
-    b |= b33.value << 33;
-    c |= c33.value << 33;
-    a |= a34.value << 34;
-    b |= b34.value << 34;
-    c |= c34.value << 34;
-    a |= a35.value << 35;
-    b |= b35.value << 35;
-    c |= c35.value << 35;
-    a |= a36.value << 36;
-    b |= b36.value << 36;
-    c |= c36.value << 36;
-    a |= a37.value << 37;
-    b |= b37.value << 37;
-    c |= c37.value << 37;
-    a |= a38.value << 38;
-    b |= b38.value << 38;
-    c |= c38.value << 38;
-    a |= a39.value << 39;
-    b |= b39.value << 39;
-    c |= c39.value << 39;
-    a |= a40.value << 40;
-    b |= b40.value << 40;
-    c |= c40.value << 40;
-    a |= a41.value << 41;
-    b |= b41.value << 41;
-    c |= c41.value << 41;
-    a |= a42.value << 42;
-    b |= b42.value << 42;
-    c |= c42.value << 42;
-    a |= a43.value << 43;
-    b |= b43.value << 43;
-    c |= c43.value << 43;
-    a |= a44.value << 44;
-    b |= b44.value << 44;
-    c |= c44.value << 44;
-    a |= a45.value << 45;
-    b |= b45.value << 45;
-    c |= c45.value << 45;
-    a |= a46.value << 46;
-    b |= b46.value << 46;
-    c |= c46.value << 46;
-    a |= a47.value << 47;
-    b |= b47.value << 47;
-    c |= c47.value << 47;
-    a |= a48.value << 48;
-    b |= b48.value << 48;
-    c |= c48.value << 48;
-    a |= a49.value << 49;
-    b |= b49.value << 49;
-    c |= c49.value << 49;
-    a |= a50.value << 50;
-    b |= b50.value << 50;
-    c |= c50.value << 50;
-    a |= a51.value << 51;
-    b |= b51.value << 51;
-    c |= c51.value << 51;
-    a |= a52.value << 52;
-    b |= b52.value << 52;
-    c |= c52.value << 52;
-    a |= a53.value << 53;
-    b |= b53.value << 53;
-    c |= c53.value << 53;
-    a |= a54.value << 54;
-    b |= b54.value << 54;
-    c |= c54.value << 54;
-    a |= a55.value << 55;
-    b |= b55.value << 55;
-    c |= c55.value << 55;
-    a |= a56.value << 56;
-    b |= b56.value << 56;
-    c |= c56.value << 56;
-    a |= a57.value << 57;
-    b |= b57.value << 57;
-    c |= c57.value << 57;
-    a |= a58.value << 58;
-    b |= b58.value << 58;
-    c |= c58.value << 58;
-    a |= a59.value << 59;
-    b |= b59.value << 59;
-    c |= c59.value << 59;
-    a |= a60.value << 60;
-    b |= b60.value << 60;
-    c |= c60.value << 60;
-    a |= a61.value << 61;
-    b |= b61.value << 61;
-    c |= c61.value << 61;
-    a |= a62.value << 62;
-    b |= b62.value << 62;
-    c |= c62.value << 62;
-    a |= a63.value << 63;
-    b |= b63.value << 63;
-    c |= c63.value << 63;
+    a ^= a0.value << 0;
+    b ^= b0.value << 0;
+    c ^= c0.value << 0;
+    a ^= a1.value << 1;
+    b ^= b1.value << 1;
+    c ^= c1.value << 1;
+    a ^= a2.value << 2;
+    b ^= b2.value << 2;
+    c ^= c2.value << 2;
+    a ^= a3.value << 3;
+    b ^= b3.value << 3;
+    c ^= c3.value << 3;
+    a ^= a4.value << 4;
+    b ^= b4.value << 4;
+    c ^= c4.value << 4;
+    a ^= a5.value << 5;
+    b ^= b5.value << 5;
+    c ^= c5.value << 5;
+    a ^= a6.value << 6;
+    b ^= b6.value << 6;
+    c ^= c6.value << 6;
+    a ^= a7.value << 7;
+    b ^= b7.value << 7;
+    c ^= c7.value << 7;
+    a ^= a8.value << 8;
+    b ^= b8.value << 8;
+    c ^= c8.value << 8;
+    a ^= a9.value << 9;
+    b ^= b9.value << 9;
+    c ^= c9.value << 9;
+    a ^= a10.value << 10;
+    b ^= b10.value << 10;
+    c ^= c10.value << 10;
+    a ^= a11.value << 11;
+    b ^= b11.value << 11;
+    c ^= c11.value << 11;
+    a ^= a12.value << 12;
+    b ^= b12.value << 12;
+    c ^= c12.value << 12;
+    a ^= a13.value << 13;
+    b ^= b13.value << 13;
+    c ^= c13.value << 13;
+    a ^= a14.value << 14;
+    b ^= b14.value << 14;
+    c ^= c14.value << 14;
+    a ^= a15.value << 15;
+    b ^= b15.value << 15;
+    c ^= c15.value << 15;
+    a ^= a16.value << 16;
+    b ^= b16.value << 16;
+    c ^= c16.value << 16;
+    a ^= a17.value << 17;
+    b ^= b17.value << 17;
+    c ^= c17.value << 17;
+    a ^= a18.value << 18;
+    b ^= b18.value << 18;
+    c ^= c18.value << 18;
+    a ^= a19.value << 19;
+    b ^= b19.value << 19;
+    c ^= c19.value << 19;
+    a ^= a20.value << 20;
+    b ^= b20.value << 20;
+    c ^= c20.value << 20;
+    a ^= a21.value << 21;
+    b ^= b21.value << 21;
+    c ^= c21.value << 21;
+    a ^= a22.value << 22;
+    b ^= b22.value << 22;
+    c ^= c22.value << 22;
+    a ^= a23.value << 23;
+    b ^= b23.value << 23;
+    c ^= c23.value << 23;
+    a ^= a24.value << 24;
+    b ^= b24.value << 24;
+    c ^= c24.value << 24;
+    a ^= a25.value << 25;
+    b ^= b25.value << 25;
+    c ^= c25.value << 25;
+    a ^= a26.value << 26;
+    b ^= b26.value << 26;
+    c ^= c26.value << 26;
+    a ^= a27.value << 27;
+    b ^= b27.value << 27;
+    c ^= c27.value << 27;
+    a ^= a28.value << 28;
+    b ^= b28.value << 28;
+    c ^= c28.value << 28;
+    a ^= a29.value << 29;
+    b ^= b29.value << 29;
+    c ^= c29.value << 29;
+    a ^= a30.value << 30;
+    b ^= b30.value << 30;
+    c ^= c30.value << 30;
+    a ^= a31.value << 31;
+    b ^= b31.value << 31;
+    c ^= c31.value << 31;
+    a ^= a32.value << 32;
+    b ^= b32.value << 32;
+    c ^= c32.value << 32;
+    a ^= a33.value << 33;
+    b ^= b33.value << 33;
+    c ^= c33.value << 33;
+    a ^= a34.value << 34;
+    b ^= b34.value << 34;
+    c ^= c34.value << 34;
+    a ^= a35.value << 35;
+    b ^= b35.value << 35;
+    c ^= c35.value << 35;
+    a ^= a36.value << 36;
+    b ^= b36.value << 36;
+    c ^= c36.value << 36;
+    a ^= a37.value << 37;
+    b ^= b37.value << 37;
+    c ^= c37.value << 37;
+    a ^= a38.value << 38;
+    b ^= b38.value << 38;
+    c ^= c38.value << 38;
+    a ^= a39.value << 39;
+    b ^= b39.value << 39;
+    c ^= c39.value << 39;
+    a ^= a40.value << 40;
+    b ^= b40.value << 40;
+    c ^= c40.value << 40;
+    a ^= a41.value << 41;
+    b ^= b41.value << 41;
+    c ^= c41.value << 41;
+    a ^= a42.value << 42;
+    b ^= b42.value << 42;
+    c ^= c42.value << 42;
+    a ^= a43.value << 43;
+    b ^= b43.value << 43;
+    c ^= c43.value << 43;
+    a ^= a44.value << 44;
+    b ^= b44.value << 44;
+    c ^= c44.value << 44;
+    a ^= a45.value << 45;
+    b ^= b45.value << 45;
+    c ^= c45.value << 45;
+    a ^= a46.value << 46;
+    b ^= b46.value << 46;
+    c ^= c46.value << 46;
+    a ^= a47.value << 47;
+    b ^= b47.value << 47;
+    c ^= c47.value << 47;
+    a ^= a48.value << 48;
+    b ^= b48.value << 48;
+    c ^= c48.value << 48;
+    a ^= a49.value << 49;
+    b ^= b49.value << 49;
+    c ^= c49.value << 49;
+    a ^= a50.value << 50;
+    b ^= b50.value << 50;
+    c ^= c50.value << 50;
+    a ^= a51.value << 51;
+    b ^= b51.value << 51;
+    c ^= c51.value << 51;
+    a ^= a52.value << 52;
+    b ^= b52.value << 52;
+    c ^= c52.value << 52;
+    a ^= a53.value << 53;
+    b ^= b53.value << 53;
+    c ^= c53.value << 53;
+    a ^= a54.value << 54;
+    b ^= b54.value << 54;
+    c ^= c54.value << 54;
+    a ^= a55.value << 55;
+    b ^= b55.value << 55;
+    c ^= c55.value << 55;
+    a ^= a56.value << 56;
+    b ^= b56.value << 56;
+    c ^= c56.value << 56;
+    a ^= a57.value << 57;
+    b ^= b57.value << 57;
+    c ^= c57.value << 57;
+    a ^= a58.value << 58;
+    b ^= b58.value << 58;
+    c ^= c58.value << 58;
+    a ^= a59.value << 59;
+    b ^= b59.value << 59;
+    c ^= c59.value << 59;
+    a ^= a60.value << 60;
+    b ^= b60.value << 60;
+    c ^= c60.value << 60;
+    a ^= a61.value << 61;
+    b ^= b61.value << 61;
+    c ^= c61.value << 61;
+    a ^= a62.value << 62;
+    b ^= b62.value << 62;
+    c ^= c62.value << 62;
+    a ^= a63.value << 63;
+    b ^= b63.value << 63;
+    c ^= c63.value << 63;
     printf ("%016llx %016llx %016llx\n", a, b, c);
 }
 
-int main() {
+void trace_all() {
+    trace_signal (&a0, 1);
+    trace_signal (&b0, 1);
+    trace_signal (&c0, 1);
+    trace_signal (&a1, 1);
+    trace_signal (&b1, 1);
+    trace_signal (&c1, 1);
+    trace_signal (&a2, 1);
+    trace_signal (&b2, 1);
+    trace_signal (&c2, 1);
+    trace_signal (&a3, 1);
+    trace_signal (&b3, 1);
+    trace_signal (&c3, 1);
+    trace_signal (&a4, 1);
+    trace_signal (&b4, 1);
+    trace_signal (&c4, 1);
+    trace_signal (&a5, 1);
+    trace_signal (&b5, 1);
+    trace_signal (&c5, 1);
+    trace_signal (&a6, 1);
+    trace_signal (&b6, 1);
+    trace_signal (&c6, 1);
+    trace_signal (&a7, 1);
+    trace_signal (&b7, 1);
+    trace_signal (&c7, 1);
+    trace_signal (&a8, 1);
+    trace_signal (&b8, 1);
+    trace_signal (&c8, 1);
+    trace_signal (&a9, 1);
+    trace_signal (&b9, 1);
+    trace_signal (&c9, 1);
+    trace_signal (&a10, 1);
+    trace_signal (&b10, 1);
+    trace_signal (&c10, 1);
+    trace_signal (&a11, 1);
+    trace_signal (&b11, 1);
+    trace_signal (&c11, 1);
+    trace_signal (&a12, 1);
+    trace_signal (&b12, 1);
+    trace_signal (&c12, 1);
+    trace_signal (&a13, 1);
+    trace_signal (&b13, 1);
+    trace_signal (&c13, 1);
+    trace_signal (&a14, 1);
+    trace_signal (&b14, 1);
+    trace_signal (&c14, 1);
+    trace_signal (&a15, 1);
+    trace_signal (&b15, 1);
+    trace_signal (&c15, 1);
+    trace_signal (&a16, 1);
+    trace_signal (&b16, 1);
+    trace_signal (&c16, 1);
+    trace_signal (&a17, 1);
+    trace_signal (&b17, 1);
+    trace_signal (&c17, 1);
+    trace_signal (&a18, 1);
+    trace_signal (&b18, 1);
+    trace_signal (&c18, 1);
+    trace_signal (&a19, 1);
+    trace_signal (&b19, 1);
+    trace_signal (&c19, 1);
+    trace_signal (&a20, 1);
+    trace_signal (&b20, 1);
+    trace_signal (&c20, 1);
+    trace_signal (&a21, 1);
+    trace_signal (&b21, 1);
+    trace_signal (&c21, 1);
+    trace_signal (&a22, 1);
+    trace_signal (&b22, 1);
+    trace_signal (&c22, 1);
+    trace_signal (&a23, 1);
+    trace_signal (&b23, 1);
+    trace_signal (&c23, 1);
+    trace_signal (&a24, 1);
+    trace_signal (&b24, 1);
+    trace_signal (&c24, 1);
+    trace_signal (&a25, 1);
+    trace_signal (&b25, 1);
+    trace_signal (&c25, 1);
+    trace_signal (&a26, 1);
+    trace_signal (&b26, 1);
+    trace_signal (&c26, 1);
+    trace_signal (&a27, 1);
+    trace_signal (&b27, 1);
+    trace_signal (&c27, 1);
+    trace_signal (&a28, 1);
+    trace_signal (&b28, 1);
+    trace_signal (&c28, 1);
+    trace_signal (&a29, 1);
+    trace_signal (&b29, 1);
+    trace_signal (&c29, 1);
+    trace_signal (&a30, 1);
+    trace_signal (&b30, 1);
+    trace_signal (&c30, 1);
+    trace_signal (&a31, 1);
+    trace_signal (&b31, 1);
+    trace_signal (&c31, 1);
+    trace_signal (&a32, 1);
+    trace_signal (&b32, 1);
+    trace_signal (&c32, 1);
+    trace_signal (&a33, 1);
+    trace_signal (&b33, 1);
+    trace_signal (&c33, 1);
+    trace_signal (&a34, 1);
+    trace_signal (&b34, 1);
+    trace_signal (&c34, 1);
+    trace_signal (&a35, 1);
+    trace_signal (&b35, 1);
+    trace_signal (&c35, 1);
+    trace_signal (&a36, 1);
+    trace_signal (&b36, 1);
+    trace_signal (&c36, 1);
+    trace_signal (&a37, 1);
+    trace_signal (&b37, 1);
+    trace_signal (&c37, 1);
+    trace_signal (&a38, 1);
+    trace_signal (&b38, 1);
+    trace_signal (&c38, 1);
+    trace_signal (&a39, 1);
+    trace_signal (&b39, 1);
+    trace_signal (&c39, 1);
+    trace_signal (&a40, 1);
+    trace_signal (&b40, 1);
+    trace_signal (&c40, 1);
+    trace_signal (&a41, 1);
+    trace_signal (&b41, 1);
+    trace_signal (&c41, 1);
+    trace_signal (&a42, 1);
+    trace_signal (&b42, 1);
+    trace_signal (&c42, 1);
+    trace_signal (&a43, 1);
+    trace_signal (&b43, 1);
+    trace_signal (&c43, 1);
+    trace_signal (&a44, 1);
+    trace_signal (&b44, 1);
+    trace_signal (&c44, 1);
+    trace_signal (&a45, 1);
+    trace_signal (&b45, 1);
+    trace_signal (&c45, 1);
+    trace_signal (&a46, 1);
+    trace_signal (&b46, 1);
+    trace_signal (&c46, 1);
+    trace_signal (&a47, 1);
+    trace_signal (&b47, 1);
+    trace_signal (&c47, 1);
+    trace_signal (&a48, 1);
+    trace_signal (&b48, 1);
+    trace_signal (&c48, 1);
+    trace_signal (&a49, 1);
+    trace_signal (&b49, 1);
+    trace_signal (&c49, 1);
+    trace_signal (&a50, 1);
+    trace_signal (&b50, 1);
+    trace_signal (&c50, 1);
+    trace_signal (&a51, 1);
+    trace_signal (&b51, 1);
+    trace_signal (&c51, 1);
+    trace_signal (&a52, 1);
+    trace_signal (&b52, 1);
+    trace_signal (&c52, 1);
+    trace_signal (&a53, 1);
+    trace_signal (&b53, 1);
+    trace_signal (&c53, 1);
+    trace_signal (&a54, 1);
+    trace_signal (&b54, 1);
+    trace_signal (&c54, 1);
+    trace_signal (&a55, 1);
+    trace_signal (&b55, 1);
+    trace_signal (&c55, 1);
+    trace_signal (&a56, 1);
+    trace_signal (&b56, 1);
+    trace_signal (&c56, 1);
+    trace_signal (&a57, 1);
+    trace_signal (&b57, 1);
+    trace_signal (&c57, 1);
+    trace_signal (&a58, 1);
+    trace_signal (&b58, 1);
+    trace_signal (&c58, 1);
+    trace_signal (&a59, 1);
+    trace_signal (&b59, 1);
+    trace_signal (&c59, 1);
+    trace_signal (&a60, 1);
+    trace_signal (&b60, 1);
+    trace_signal (&c60, 1);
+    trace_signal (&a61, 1);
+    trace_signal (&b61, 1);
+    trace_signal (&c61, 1);
+    trace_signal (&a62, 1);
+    trace_signal (&b62, 1);
+    trace_signal (&c62, 1);
+    trace_signal (&a63, 1);
+    trace_signal (&b63, 1);
+    trace_signal (&c63, 1);
+}
+
+/*
+ * With -l, use the levelized schedule; -t gives the number of threads.
+ * With -v, write all signals to the waveform file.
+ */
+int main (int argc, char **argv) {
     int i;
-    process_init ("b0", do_b0, 4096);
-    process_init ("c0", do_c0, 4096);
-    process_init ("b1", do_b1, 4096);
-    process_init ("c1", do_c1, 4096);
-    process_init ("b2", do_b2, 4096);
-    process_init ("c2", do_c2, 4096);
-    process_init ("b3", do_b3, 4096);
-    process_init ("c3", do_c3, 4096);
-    process_init ("b4", do_b4, 4096);
-    process_init ("c4", do_c4, 4096);
-    process_init ("b5", do_b5, 4096);
-    process_init ("c5", do_c5, 4096);
-    process_init ("b6", do_b6, 4096);
-    process_init ("c6", do_c6, 4096);
-    process_init ("b7", do_b7, 4096);
-    process_init ("c7", do_c7, 4096);
-    process_init ("b8", do_b8, 4096);
-    process_init ("c8", do_c8, 4096);
-    process_init ("b9", do_b9, 4096);
-    process_init ("c9", do_c9, 4096);
-    process_init ("b10", do_b10, 4096);
-    process_init ("c10", do_c10, 4096);
-    process_init ("b11", do_b11, 4096);
-    process_init ("c11", do_c11, 4096);
-    process_init ("b12", do_b12, 4096);
-    process_init ("c12", do_c12, 4096);
-    process_init ("b13", do_b13, 4096);
-    process_init ("c13", do_c13, 4096);
-    process_init ("b14", do_b14, 4096);
-    process_init ("c14", do_c14, 4096);
-    process_init ("b15", do_b15, 4096);
-    process_init ("c15", do_c15, 4096);
-    process_init ("b16", do_b16, 4096);
-    process_init ("c16", do_c16, 4096);
-    process_init ("b17", do_b17, 4096);
-    process_init ("c17", do_c17, 4096);
-    process_init ("b18", do_b18, 4096);
-    process_init ("c18", do_c18, 4096);
-    process_init ("b19", do_b19, 4096);
-    process_init ("c19", do_c19, 4096);
-    process_init ("b20", do_b20, 4096);
-    process_init ("c20", do_c20, 4096);
-    process_init ("b21", do_b21, 4096);
-    process_init ("c21", do_c21, 4096);
-    process_init ("b22", do_b22, 4096);
-    process_init ("c22", do_c22, 4096);
-    process_init ("b23", do_b23, 4096);
-    process_init ("c23", do_c23, 4096);
-    process_init ("b24", do_b24, 4096);
-    process_init ("c24", do_c24, 4096);
-    process_init ("b25", do_b25, 4096);
-    process_init ("c25", do_c25, 4096);
-    process_init ("b26", do_b26, 4096);
-    process_init ("c26", do_c26, 4096);
-    process_init ("b27", do_b27, 4096);
-    process_init ("c27", do_c27, 4096);
-    process_init ("b28", do_b28, 4096);
-    process_init ("c28", do_c28, 4096);
-    process_init ("b29", do_b29, 4096);
-    process_init ("c29", do_c29, 4096);
-    process_init ("b30", do_b30, 4096);
-    process_init ("c30", do_c30, 4096);
-    process_init ("b31", do_b31, 4096);
-    process_init ("c31", do_c31, 4096);
-    process_init ("b32", do_b32, 4096);
-    process_init ("c32", do_c32, 4096);
-    process_init ("b33", do_b33, 4096);
-    process_init ("c33", do_c33, 4096);
-    process_init ("b34", do_b34, 4096);
-    process_init ("c34", do_c34, 4096);
-    process_init ("b35", do_b35, 4096);
-    process_init ("c35", do_c35, 4096);
-    process_init ("b36", do_b36, 4096);
-    process_init ("c36", do_c36, 4096);
-    process_init ("b37", do_b37, 4096);
-    process_init ("c37", do_c37, 4096);
-    process_init ("b38", do_b38, 4096);
-    process_init ("c38", do_c38, 4096);
-    process_init ("b39", do_b39, 4096);
-    process_init ("c39", do_c39, 4096);
-    process_init ("b40", do_b40, 4096);
-    process_init ("c40", do_c40, 4096);
-    process_init ("b41", do_b41, 4096);
-    process_init ("c41", do_c41, 4096);
-    process_init ("b42", do_b42, 4096);
-    process_init ("c42", do_c42, 4096);
-    process_init ("b43", do_b43, 4096);
-    process_init ("c43", do_c43, 4096);
-    process_init ("b44", do_b44, 4096);
-    process_init ("c44", do_c44, 4096);
-    process_init ("b45", do_b45, 4096);
-    process_init ("c45", do_c45, 4096);
-    process_init ("b46", do_b46, 4096);
-    process_init ("c46", do_c46, 4096);
-    process_init ("b47", do_b47, 4096);
-    process_init ("c47", do_c47, 4096);
-    process_init ("b48", do_b48, 4096);
-    process_init ("c48", do_c48, 4096);
-    process_init ("b49", do_b49, 4096);
-    process_init ("c49", do_c49, 4096);
-    process_init ("b50", do_b50, 4096);
-    process_init ("c50", do_c50, 4096);
-    process_init ("b51", do_b51, 4096);
-    process_init ("c51", do_c51, 4096);
-    process_init ("b52", do_b52, 4096);
-    process_init ("c52", do_c52, 4096);
-    process_init ("b53", do_b53, 4096);
-    process_init ("c53", do_c53, 4096);
-    process_init ("b54", do_b54, 4096);
-    process_init ("c54", do_c54, 4096);
-    process_init ("b55", do_b55, 4096);
-    process_init ("c55", do_c55, 4096);
-    process_init ("b56", do_b56, 4096);
-    process_init ("c56", do_c56, 4096);
-    process_init ("b57", do_b57, 4096);
-    process_init ("c57", do_c57, 4096);
-    process_init ("b58", do_b58, 4096);
-    process_init ("c58", do_c58, 4096);
-    process_init ("b59", do_b59, 4096);
-    process_init ("c59", do_c59, 4096);
-    process_init ("b60", do_b60, 4096);
-    process_init ("c60", do_c60, 4096);
-    process_init ("b61", do_b61, 4096);
-    process_init ("c61", do_c61, 4096);
-    process_init ("b62", do_b62, 4096);
-    process_init ("c62", do_c62, 4096);
-    process_init ("b63", do_b63, 4096);
-    process_init ("c63", do_c63, 4096);
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp (argv[i], "-l") == 0)
+            process_levelized = 1;
+        else if (strcmp (argv[i], "-t") == 0 && i+1 < argc) {
+            process_levelized = 1;
+            process_threads = atoi (argv[++i]);
+        } else if (strcmp (argv[i], "-v") == 0 && i+1 < argc) {
+            trace_open (argv[++i]);
+            trace_all();
+        }
+    }
+    comb_init ("b0", do_b0);
+    comb_input (&a18);
+    comb_input (&a27);
+    comb_output (&b0);
+    comb_init ("c0", do_c0);
+    comb_input (&b20);
+    comb_input (&b3);
+    comb_output (&c0);
+    comb_init ("b1", do_b1);
+    comb_input (&a10);
+    comb_input (&a9);
+    comb_output (&b1);
+    comb_init ("c1", do_c1);
+    comb_input (&b58);
+    comb_input (&b63);
+    comb_output (&c1);
+    comb_init ("b2", do_b2);
+    comb_input (&a42);
+    comb_input (&a55);
+    comb_output (&b2);
+    comb_init ("c2", do_c2);
+    comb_input (&b23);
+    comb_input (&b22);
+    comb_output (&c2);
+    comb_init ("b3", do_b3);
+    comb_input (&a13);
+    comb_input (&a53);
+    comb_output (&b3);
+    comb_init ("c3", do_c3);
+    comb_input (&b50);
+    comb_input (&b25);
+    comb_output (&c3);
+    comb_init ("b4", do_b4);
+    comb_input (&a0);
+    comb_input (&a14);
+    comb_output (&b4);
+    comb_init ("c4", do_c4);
+    comb_input (&b39);
+    comb_input (&b3);
+    comb_output (&c4);
+    comb_init ("b5", do_b5);
+    comb_input (&a13);
+    comb_input (&a57);
+    comb_output (&b5);
+    comb_init ("c5", do_c5);
+    comb_input (&b57);
+    comb_input (&b22);
+    comb_output (&c5);
+    comb_init ("b6", do_b6);
+    comb_input (&a63);
+    comb_input (&a16);
+    comb_output (&b6);
+    comb_init ("c6", do_c6);
+    comb_input (&b44);
+    comb_input (&b9);
+    comb_output (&c6);
+    comb_init ("b7", do_b7);
+    comb_input (&a41);
+    comb_input (&a26);
+    comb_output (&b7);
+    comb_init ("c7", do_c7);
+    comb_input (&b49);
+    comb_input (&b61);
+    comb_output (&c7);
+    comb_init ("b8", do_b8);
+    comb_input (&a31);
+    comb_input (&a62);
+    comb_output (&b8);
+    comb_init ("c8", do_c8);
+    comb_input (&b50);
+    comb_input (&b9);
+    comb_output (&c8);
+    comb_init ("b9", do_b9);
+    comb_input (&a18);
+    comb_input (&a54);
+    comb_output (&b9);
+    comb_init ("c9", do_c9);
+    comb_input (&b10);
+    comb_input (&b49);
+    comb_output (&c9);
+    comb_init ("b10", do_b10);
+    comb_input (&a57);
+    comb_input (&a5);
+    comb_output (&b10);
+    comb_init ("c10", do_c10);
+    comb_input (&b63);
+    comb_input (&b20);
+    comb_output (&c10);
+    comb_init ("b11", do_b11);
+    comb_input (&a5);
+    comb_input (&a50);
+    comb_output (&b11);
+    comb_init ("c11", do_c11);
+    comb_input (&b22);
+    comb_input (&b60);
+    comb_output (&c11);
+    comb_init ("b12", do_b12);
+    comb_input (&a28);
+    comb_input (&a47);
+    comb_output (&b12);
+    comb_init ("c12", do_c12);
+    comb_input (&b37);
+    comb_input (&b9);
+    comb_output (&c12);
+    comb_init ("b13", do_b13);
+    comb_input (&a55);
+    comb_input (&a6);
+    comb_output (&b13);
+    comb_init ("c13", do_c13);
+    comb_input (&b43);
+    comb_input (&b54);
+    comb_output (&c13);
+    comb_init ("b14", do_b14);
+    comb_input (&a24);
+    comb_input (&a48);
+    comb_output (&b14);
+    comb_init ("c14", do_c14);
+    comb_input (&b62);
+    comb_input (&b43);
+    comb_output (&c14);
+    comb_init ("b15", do_b15);
+    comb_input (&a45);
+    comb_input (&a28);
+    comb_output (&b15);
+    comb_init ("c15", do_c15);
+    comb_input (&b63);
+    comb_input (&b47);
+    comb_output (&c15);
+    comb_init ("b16", do_b16);
+    comb_input (&a36);
+    comb_input (&a26);
+    comb_output (&b16);
+    comb_init ("c16", do_c16);
+    comb_input (&b57);
+    comb_input (&b44);
+    comb_output (&c16);
+    comb_init ("b17", do_b17);
+    comb_input (&a39);
+    comb_input (&a55);
+    comb_output (&b17);
+    comb_init ("c17", do_c17);
+    comb_input (&b32);
+    comb_input (&b11);
+    comb_output (&c17);
+    comb_init ("b18", do_b18);
+    comb_input (&a26);
+    comb_input (&a57);
+    comb_output (&b18);
+    comb_init ("c18", do_c18);
+    comb_input (&b57);
+    comb_input (&b53);
+    comb_output (&c18);
+    comb_init ("b19", do_b19);
+    comb_input (&a39);
+    comb_input (&a32);
+    comb_output (&b19);
+    comb_init ("c19", do_c19);
+    comb_input (&b24);
+    comb_input (&b51);
+    comb_output (&c19);
+    comb_init ("b20", do_b20);
+    comb_input (&a13);
+    comb_input (&a55);
+    comb_output (&b20);
+    comb_init ("c20", do_c20);
+    comb_input (&b53);
+    comb_input (&b48);
+    comb_output (&c20);
+    comb_init ("b21", do_b21);
+    comb_input (&a51);
+    comb_input (&a46);
+    comb_output (&b21);
+    comb_init ("c21", do_c21);
+    comb_input (&b12);
+    comb_input (&b27);
+    comb_output (&c21);
+    comb_init ("b22", do_b22);
+    comb_input (&a18);
+    comb_input (&a51);
+    comb_output (&b22);
+    comb_init ("c22", do_c22);
+    comb_input (&b32);
+    comb_input (&b4);
+    comb_output (&c22);
+    comb_init ("b23", do_b23);
+    comb_input (&a17);
+    comb_input (&a43);
+    comb_output (&b23);
+    comb_init ("c23", do_c23);
+    comb_input (&b37);
+    comb_input (&b2);
+    comb_output (&c23);
+    comb_init ("b24", do_b24);
+    comb_input (&a16);
+    comb_input (&a2);
+    comb_output (&b24);
+    comb_init ("c24", do_c24);
+    comb_input (&b34);
+    comb_input (&b4);
+    comb_output (&c24);
+    comb_init ("b25", do_b25);
+    comb_input (&a30);
+    comb_input (&a32);
+    comb_output (&b25);
+    comb_init ("c25", do_c25);
+    comb_input (&b9);
+    comb_input (&b24);
+    comb_output (&c25);
+    comb_init ("b26", do_b26);
+    comb_input (&a44);
+    comb_input (&a62);
+    comb_output (&b26);
+    comb_init ("c26", do_c26);
+    comb_input (&b60);
+    comb_input (&b13);
+    comb_output (&c26);
+    comb_init ("b27", do_b27);
+    comb_input (&a52);
+    comb_input (&a25);
+    comb_output (&b27);
+    comb_init ("c27", do_c27);
+    comb_input (&b22);
+    comb_input (&b39);
+    comb_output (&c27);
+    comb_init ("b28", do_b28);
+    comb_input (&a36);
+    comb_input (&a61);
+    comb_output (&b28);
+    comb_init ("c28", do_c28);
+    comb_input (&b60);
+    comb_input (&b39);
+    comb_output (&c28);
+    comb_init ("b29", do_b29);
+    comb_input (&a21);
+    comb_input (&a48);
+    comb_output (&b29);
+    comb_init ("c29", do_c29);
+    comb_input (&b32);
+    comb_input (&b14);
+    comb_output (&c29);
+    comb_init ("b30", do_b30);
+    comb_input (&a47);
+    comb_input (&a56);
+    comb_output (&b30);
+    comb_init ("c30", do_c30);
+    comb_input (&b57);
+    comb_input (&b49);
+    comb_output (&c30);
+    comb_init ("b31", do_b31);
+    comb_input (&a56);
+    comb_input (&a17);
+    comb_output (&b31);
+    comb_init ("c31", do_c31);
+    comb_input (&b61);
+    comb_input (&b44);
+    comb_output (&c31);
+    comb_init ("b32", do_b32);
+    comb_input (&a18);
+    comb_input (&a4);
+    comb_output (&b32);
+    comb_init ("c32", do_c32);
+    comb_input (&b19);
+    comb_input (&b20);
+    comb_output (&c32);
+    comb_init ("b33", do_b33);
+    comb_input (&a56);
+    comb_input (&a52);
+    comb_output (&b33);
+    comb_init ("c33", do_c33);
+    comb_input (&b45);
+    comb_input (&b24);
+    comb_output (&c33);
+    comb_init ("b34", do_b34);
+    comb_input (&a48);
+    comb_input (&a28);
+    comb_output (&b34);
+    comb_init ("c34", do_c34);
+    comb_input (&b31);
+    comb_input (&b35);
+    comb_output (&c34);
+    comb_init ("b35", do_b35);
+    comb_input (&a40);
+    comb_input (&a49);
+    comb_output (&b35);
+    comb_init ("c35", do_c35);
+    comb_input (&b23);
+    comb_input (&b63);
+    comb_output (&c35);
+    comb_init ("b36", do_b36);
+    comb_input (&a40);
+    comb_input (&a5);
+    comb_output (&b36);
+    comb_init ("c36", do_c36);
+    comb_input (&b5);
+    comb_input (&b48);
+    comb_output (&c36);
+    comb_init ("b37", do_b37);
+    comb_input (&a7);
+    comb_input (&a11);
+    comb_output (&b37);
+    comb_init ("c37", do_c37);
+    comb_input (&b20);
+    comb_input (&b26);
+    comb_output (&c37);
+    comb_init ("b38", do_b38);
+    comb_input (&a33);
+    comb_input (&a28);
+    comb_output (&b38);
+    comb_init ("c38", do_c38);
+    comb_input (&b30);
+    comb_input (&b21);
+    comb_output (&c38);
+    comb_init ("b39", do_b39);
+    comb_input (&a0);
+    comb_input (&a9);
+    comb_output (&b39);
+    comb_init ("c39", do_c39);
+    comb_input (&b62);
+    comb_input (&b54);
+    comb_output (&c39);
+    comb_init ("b40", do_b40);
+    comb_input (&a30);
+    comb_input (&a24);
+    comb_output (&b40);
+    comb_init ("c40", do_c40);
+    comb_input (&b13);
+    comb_input (&b36);
+    comb_output (&c40);
+    comb_init ("b41", do_b41);
+    comb_input (&a38);
+    comb_input (&a5);
+    comb_output (&b41);
+    comb_init ("c41", do_c41);
+    comb_input (&b37);
+    comb_input (&b22);
+    comb_output (&c41);
+    comb_init ("b42", do_b42);
+    comb_input (&a10);
+    comb_input (&a41);
+    comb_output (&b42);
+    comb_init ("c42", do_c42);
+    comb_input (&b26);
+    comb_input (&b25);
+    comb_output (&c42);
+    comb_init ("b43", do_b43);
+    comb_input (&a24);
+    comb_input (&a39);
+    comb_output (&b43);
+    comb_init ("c43", do_c43);
+    comb_input (&b8);
+    comb_input (&b18);
+    comb_output (&c43);
+    comb_init ("b44", do_b44);
+    comb_input (&a41);
+    comb_input (&a54);
+    comb_output (&b44);
+    comb_init ("c44", do_c44);
+    comb_input (&b47);
+    comb_input (&b61);
+    comb_output (&c44);
+    comb_init ("b45", do_b45);
+    comb_input (&a29);
+    comb_input (&a32);
+    comb_output (&b45);
+    comb_init ("c45", do_c45);
+    comb_input (&b40);
+    comb_input (&b15);
+    comb_output (&c45);
+    comb_init ("b46", do_b46);
+    comb_input (&a18);
+    comb_input (&a54);
+    comb_output (&b46);
+    comb_init ("c46", do_c46);
+    comb_input (&b11);
+    comb_input (&b39);
+    comb_output (&c46);
+    comb_init ("b47", do_b47);
+    comb_input (&a45);
+    comb_input (&a55);
+    comb_output (&b47);
+    comb_init ("c47", do_c47);
+    comb_input (&b17);
+    comb_input (&b61);
+    comb_output (&c47);
+    comb_init ("b48", do_b48);
+    comb_input (&a15);
+    comb_input (&a16);
+    comb_output (&b48);
+    comb_init ("c48", do_c48);
+    comb_input (&b15);
+    comb_input (&b26);
+    comb_output (&c48);
+    comb_init ("b49", do_b49);
+    comb_input (&a13);
+    comb_input (&a55);
+    comb_output (&b49);
+    comb_init ("c49", do_c49);
+    comb_input (&b45);
+    comb_input (&b48);
+    comb_output (&c49);
+    comb_init ("b50", do_b50);
+    comb_input (&a28);
+    comb_input (&a6);
+    comb_output (&b50);
+    comb_init ("c50", do_c50);
+    comb_input (&b15);
+    comb_input (&b44);
+    comb_output (&c50);
+    comb_init ("b51", do_b51);
+    comb_input (&a5);
+    comb_input (&a37);
+    comb_output (&b51);
+    comb_init ("c51", do_c51);
+    comb_input (&b38);
+    comb_input (&b44);
+    comb_output (&c51);
+    comb_init ("b52", do_b52);
+    comb_input (&a50);
+    comb_input (&a42);
+    comb_output (&b52);
+    comb_init ("c52", do_c52);
+    comb_input (&b54);
+    comb_input (&b13);
+    comb_output (&c52);
+    comb_init ("b53", do_b53);
+    comb_input (&a57);
+    comb_input (&a5);
+    comb_output (&b53);
+    comb_init ("c53", do_c53);
+    comb_input (&b37);
+    comb_input (&b28);
+    comb_output (&c53);
+    comb_init ("b54", do_b54);
+    comb_input (&a35);
+    comb_input (&a10);
+    comb_output (&b54);
+    comb_init ("c54", do_c54);
+    comb_input (&b61);
+    comb_input (&b33);
+    comb_output (&c54);
+    comb_init ("b55", do_b55);
+    comb_input (&a49);
+    comb_input (&a38);
+    comb_output (&b55);
+    comb_init ("c55", do_c55);
+    comb_input (&b39);
+    comb_input (&b17);
+    comb_output (&c55);
+    comb_init ("b56", do_b56);
+    comb_input (&a46);
+    comb_input (&a48);
+    comb_output (&b56);
+    comb_init ("c56", do_c56);
+    comb_input (&b20);
+    comb_input (&b37);
+    comb_output (&c56);
+    comb_init ("b57", do_b57);
+    comb_input (&a56);
+    comb_input (&a33);
+    comb_output (&b57);
+    comb_init ("c57", do_c57);
+    comb_input (&b47);
+    comb_input (&b3);
+    comb_output (&c57);
+    comb_init ("b58", do_b58);
+    comb_input (&a55);
+    comb_input (&a55);
+    comb_output (&b58);
+    comb_init ("c58", do_c58);
+    comb_input (&b11);
+    comb_input (&b25);
+    comb_output (&c58);
+    comb_init ("b59", do_b59);
+    comb_input (&a40);
+    comb_input (&a22);
+    comb_output (&b59);
+    comb_init ("c59", do_c59);
+    comb_input (&b30);
+    comb_input (&b50);
+    comb_output (&c59);
+    comb_init ("b60", do_b60);
+    comb_input (&a14);
+    comb_input (&a61);
+    comb_output (&b60);
+    comb_init ("c60", do_c60);
+    comb_input (&b55);
+    comb_input (&b47);
+    comb_output (&c60);
+    comb_init ("b61", do_b61);
+    comb_input (&a28);
+    comb_input (&a53);
+    comb_output (&b61);
+    comb_init ("c61", do_c61);
+    comb_input (&b34);
+    comb_input (&b30);
+    comb_output (&c61);
+    comb_init ("b62", do_b62);
+    comb_input (&a49);
+    comb_input (&a23);
+    comb_output (&b62);
+    comb_init ("c62", do_c62);
+    comb_input (&b56);
+    comb_input (&b42);
+    comb_output (&c62);
+    comb_init ("b63", do_b63);
+    comb_input (&a4);
+    comb_input (&a11);
+    comb_output (&b63);
+    comb_init ("c63", do_c63);
+    comb_input (&b20);
+    comb_input (&b0);
+    comb_output (&c63);
     signal_set (&a0, 0);
     signal_set (&a1, 0);
     signal_set (&a2, 0);
@@ -14,14 +14,69 @@
  */
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 #include "rtlsim.h"
 
+value_t time_ticks;
+signal_t *signal_active;
+process_t *process_current;
+process_t *process_queue;
+process_t process_main;
+
+int process_levelized;
+int process_threads;
+process_t *comb_current;
+
 /*
- * Set a value of the signal.
- * Value will be updated on next simulation cycle.
- * If the value changed, put the signal to active list.
+ * In levelized mode, the combinational processes are split into
+ * partitions, one per thread.  A partition owns its processes with
+ * their outputs, and the lists of its activated processes.  In a
+ * parallel pass, all threads call their processes of the same level,
+ * then meet at a barrier.  Activations of processes from other
+ * partitions are passed through the outboxes, and picked up by
+ * the owners after the barrier.
  */
-void signal_set (signal_t *sig, value_t value)
+#define COMB_PARMIN     64      /* Fewest activations for a parallel pass */
+#define COMB_SPIN       1000    /* Spins before yielding the processor */
+
+typedef struct {
+    process_t   **pending;      /* Activated processes, by level */
+    int         first;          /* Lowest level with activated processes */
+    int         next [2];       /* Lowest level for the next step */
+    int         sent;           /* Lowest level sent to other partitions */
+    unsigned    step;           /* Step of the parallel pass */
+    struct box {
+        process_t **proc;
+        int     count, size;
+    } out [2] [PROCESS_MAXTHREADS]; /* Activations for other partitions */
+    struct change {
+        signal_t *sig;
+        value_t old;
+    } *changed;                 /* Outputs with coroutines to activate */
+    int         nchanged, maxchanged;
+} partition_t;
+
+static process_t *comb_list;    /* Combinational processes */
+static partition_t *comb_part;  /* Partitions */
+static int comb_nparts;         /* Number of partitions */
+static int comb_nlevels;        /* Number of levels */
+static int comb_npending;       /* Activations for the next pass */
+static unsigned comb_step;      /* Step to start the next parallel pass */
+static unsigned comb_pass;      /* Parallel passes started */
+static unsigned comb_barcount;  /* Threads at the barrier */
+static unsigned comb_bargen;    /* Barriers passed */
+static int comb_inpass;         /* Parallel pass is running */
+static process_t *comb_running; /* Process being called, in serial pass */
+static pthread_mutex_t comb_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t comb_start = PTHREAD_COND_INITIALIZER;
+
+static void signal_activate (signal_t *sig, int comb, partition_t *self);
+
+/*
+ * Put the signal to the list of active signals.
+ */
+static void signal_post (signal_t *sig, value_t value)
 {
     sig->new_value = value;
 
@@ -33,6 +88,36 @@ void signal_set (signal_t *sig, value_t value)
     }
 }
 
+/*
+ * Set a value of the signal.
+ * Value will be updated on next simulation cycle.
+ * If the value changed, put the signal to active list.
+ * An output of the combinational process being called
+ * changes at once, for processes of higher levels.
+ */
+void signal_set (signal_t *sig, value_t value)
+{
+    process_t *driver = sig->driver;
+
+    if (driver != 0 && (driver == comb_running ||
+        (comb_inpass && driver->running))) {
+        if (value != sig->value) {
+            sig->new_value = value;
+            signal_activate (sig, 1, comb_inpass ?
+                &comb_part [driver->partition] : 0);
+            if (sig->trace && ! comb_inpass)
+                trace_change (sig, value);
+            sig->value = value;
+        }
+    } else if (comb_inpass) {
+        /* Parallel pass: the list is shared by threads. */
+        pthread_mutex_lock (&comb_lock);
+        signal_post (sig, value);
+        pthread_mutex_unlock (&comb_lock);
+    } else
+        signal_post (sig, value);
+}
+
 /*
  * Delay the current process by a given number of clock ticks.
  */
@@ -63,6 +148,404 @@ void process_delay (unsigned ticks)
     process_wait();
 }
 
+static void *grow (void *array, int *size, int elsize)
+{
+    *size = *size ? *size * 2 : 64;
+    array = realloc (array, *size * elsize);
+    if (array == 0) {
+        printf ("Out of memory\n");
+        exit (-1);
+    }
+    return array;
+}
+
+/*
+ * Put the combinational process to the list of its level.
+ */
+static void comb_push (partition_t *part, process_t *proc)
+{
+    if (proc->pending)
+        return;
+    proc->pending = 1;
+    proc->next = part->pending [proc->level];
+    part->pending [proc->level] = proc;
+    if (proc->level < part->first)
+        part->first = proc->level;
+}
+
+/*
+ * Activate the combinational process.  In a parallel pass, self is
+ * the partition of the thread, and a process of other partition
+ * is sent to the owner.
+ */
+static void comb_activate (process_t *proc, partition_t *self)
+{
+    partition_t *part = &comb_part [proc->partition];
+    struct box *box;
+
+    if (self == 0) {
+        comb_npending++;
+        comb_push (part, proc);
+        return;
+    }
+    if (part == self) {
+        comb_push (part, proc);
+        return;
+    }
+    box = &self->out [self->step & 1] [proc->partition];
+    if (box->count == box->size)
+        box->proc = grow (box->proc, &box->size, sizeof(process_t*));
+    box->proc [box->count++] = proc;
+    if (proc->level < self->sent)
+        self->sent = proc->level;
+}
+
+/*
+ * Remember a changed output, to activate the coroutines
+ * sensitive to it, and to trace it, when the parallel pass is over.
+ */
+static void comb_defer (signal_t *sig, partition_t *self)
+{
+    if (self->nchanged == self->maxchanged)
+        self->changed = grow (self->changed, &self->maxchanged,
+            sizeof(struct change));
+    self->changed [self->nchanged].sig = sig;
+    self->changed [self->nchanged].old = sig->value;
+    self->nchanged++;
+}
+
+/*
+ * Activate all processes, sensitive to the change of the signal
+ * from value to new_value.  Combinational processes are skipped
+ * unless comb is set.  In a parallel pass, self is the partition
+ * of the thread.
+ */
+static void signal_activate (signal_t *sig, int comb, partition_t *self)
+{
+    hook_t *hook;
+    int deferred = 0;
+
+    for (hook = sig->activate; hook != 0; hook = hook->next) {
+        process_t *proc = hook->process;
+
+        if (proc->comb) {
+            if (comb)
+                comb_activate (proc, self);
+            continue;
+        }
+        if (self != 0) {
+            /* The process queue is not shared by threads. */
+            if (! deferred)
+                comb_defer (sig, self);
+            deferred = 1;
+            continue;
+        }
+        if (proc->next == 0) {
+            /* Signal change should matches the edge flag. */
+            if ((hook->edge & POSEDGE) &&
+                (sig->value != 0 || sig->new_value == 0))
+                continue;
+            if ((hook->edge & NEGEDGE) &&
+                (sig->value == 0 || sig->new_value != 0))
+                continue;
+
+            /* Put the process to queue of pending events. */
+            proc->next = process_queue;
+            process_queue = proc;
+            //printf ("(%llu) Process '%s' activated\n", time_ticks, proc->name);
+        }
+    }
+    if (self != 0 && sig->trace && ! deferred)
+        comb_defer (sig, self);
+}
+
+/*
+ * Wait while the counter keeps the value.
+ */
+static void comb_wait (unsigned *counter, unsigned value)
+{
+    int n = 0;
+
+    while (__atomic_load_n (counter, __ATOMIC_ACQUIRE) == value) {
+        if (++n > COMB_SPIN)
+            sched_yield();
+    }
+}
+
+/*
+ * Wait until all threads come to the barrier.
+ */
+static void comb_barrier (void)
+{
+    unsigned gen = __atomic_load_n (&comb_bargen, __ATOMIC_ACQUIRE);
+
+    if (__atomic_add_fetch (&comb_barcount, 1, __ATOMIC_ACQ_REL) == comb_nparts) {
+        comb_barcount = 0;
+        __atomic_store_n (&comb_bargen, gen + 1, __ATOMIC_RELEASE);
+    } else
+        comb_wait (&comb_bargen, gen);
+}
+
+
+/*
+ * Call the activated combinational processes, level by level,
+ * in the current thread.
+ */
+static void comb_serial (void)
+{
+    partition_t *part;
+    process_t *proc;
+    int level = comb_nlevels;
+
+    for (part = comb_part; part < comb_part + comb_nparts; part++)
+        if (part->first < level)
+            level = part->first;
+
+    for (; level < comb_nlevels; level++) {
+        for (part = comb_part; part < comb_part + comb_nparts; part++) {
+            while ((proc = part->pending [level]) != 0) {
+                part->pending [level] = proc->next;
+                proc->next = 0;
+                proc->pending = 0;
+                comb_running = proc;
+                proc->func();
+            }
+        }
+    }
+    for (part = comb_part; part < comb_part + comb_nparts; part++)
+        part->first = comb_nlevels;
+    comb_running = 0;
+}
+
+/*
+ * Share of a parallel pass for one thread.
+ */
+static void comb_run (partition_t *self)
+{
+    int me = self - comb_part;
+    partition_t *part;
+    process_t *proc;
+    int level, par;
+
+    self->step = comb_step;
+    comb_barrier();
+    for (;;) {
+        /* Find the lowest level, activated in any partition. */
+        par = self->step & 1;
+        level = comb_nlevels;
+        for (part = comb_part; part < comb_part + comb_nparts; part++)
+            if (part->next [par] < level)
+                level = part->next [par];
+        if (level == comb_nlevels)
+            break;
+
+        /* Take activations from other partitions. */
+        for (part = comb_part; part < comb_part + comb_nparts; part++) {
+            struct box *box = &part->out [par ^ 1] [me];
+
+            while (box->count > 0)
+                comb_push (self, box->proc [--box->count]);
+        }
+
+        self->sent = comb_nlevels;
+        if (self->first == level) {
+            while ((proc = self->pending [level]) != 0) {
+                self->pending [level] = proc->next;
+                proc->next = 0;
+                proc->pending = 0;
+                proc->running = 1;
+                proc->func();
+                proc->running = 0;
+            }
+            do
+                self->first++;
+            while (self->first < comb_nlevels &&
+                   self->pending [self->first] == 0);
+        }
+        self->next [par ^ 1] = (self->first < self->sent) ?
+            self->first : self->sent;
+        self->step++;
+        comb_barrier();
+    }
+}
+
+/*
+ * Wait for the next parallel pass.  After a short spin the thread
+ * sleeps, so that idle workers do not hold the processors
+ * between passes.
+ */
+static void comb_park (unsigned pass)
+{
+    int n = 0;
+
+    while (__atomic_load_n (&comb_pass, __ATOMIC_ACQUIRE) == pass) {
+        if (++n > COMB_SPIN) {
+            pthread_mutex_lock (&comb_lock);
+            while (__atomic_load_n (&comb_pass, __ATOMIC_ACQUIRE) == pass)
+                pthread_cond_wait (&comb_start, &comb_lock);
+            pthread_mutex_unlock (&comb_lock);
+            break;
+        }
+    }
+}
+
+static void *comb_worker (void *arg)
+{
+    unsigned pass = 0;
+
+    for (;;) {
+        comb_park (pass);
+        pass++;
+        comb_run (arg);
+    }
+    return 0;
+}
+
+/*
+ * Call the activated combinational processes on all threads.
+ */
+static void comb_parallel (void)
+{
+    partition_t *part;
+    struct change *ch;
+
+    for (part = comb_part; part < comb_part + comb_nparts; part++)
+        part->next [comb_step & 1] = part->first;
+    comb_inpass = 1;
+    pthread_mutex_lock (&comb_lock);
+    __atomic_add_fetch (&comb_pass, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast (&comb_start);
+    pthread_mutex_unlock (&comb_lock);
+    comb_run (comb_part);
+    comb_inpass = 0;
+
+    /* The next pass starts with other parity, so that
+     * the threads still finishing this one are not confused. */
+    comb_step = comb_part->step + 1;
+
+    /* Activate coroutines, sensitive to changed outputs. */
+    for (part = comb_part; part < comb_part + comb_nparts; part++) {
+        for (ch = part->changed; ch < part->changed + part->nchanged; ch++) {
+            value_t value = ch->sig->value;
+
+            ch->sig->value = ch->old;
+            ch->sig->new_value = value;
+            signal_activate (ch->sig, 0, 0);
+            if (ch->sig->trace)
+                trace_change (ch->sig, value);
+            ch->sig->value = value;
+        }
+        part->nchanged = 0;
+    }
+}
+
+/*
+ * Rank the combinational processes, so that every process
+ * gets a higher level than the drivers of all its inputs.
+ * Split them into partitions and start the threads.
+ */
+static void comb_levelize (void)
+{
+    process_t *proc, *ready = 0;
+    partition_t *part;
+    signal_t *sig;
+    hook_t *hook;
+    int nprocs = 0, nranked = 0;
+    pthread_t thread;
+
+    for (proc = comb_list; proc != 0; proc = proc->link) {
+        proc->level = 0;
+        proc->npred = 0;
+        nprocs++;
+    }
+    for (proc = comb_list; proc != 0; proc = proc->link)
+        for (sig = proc->outputs; sig != 0; sig = sig->link)
+            for (hook = sig->activate; hook != 0; hook = hook->next)
+                if (hook->process->comb)
+                    hook->process->npred++;
+
+    /* Take processes in topological order. */
+    for (proc = comb_list; proc != 0; proc = proc->link) {
+        if (proc->npred == 0) {
+            proc->next = ready;
+            ready = proc;
+        }
+    }
+    comb_nlevels = 0;
+    while (ready != 0) {
+        proc = ready;
+        ready = proc->next;
+        proc->next = 0;
+        nranked++;
+        if (proc->level >= comb_nlevels)
+            comb_nlevels = proc->level + 1;
+
+        for (sig = proc->outputs; sig != 0; sig = sig->link) {
+            for (hook = sig->activate; hook != 0; hook = hook->next) {
+                process_t *succ = hook->process;
+
+                if (! succ->comb)
+                    continue;
+                if (succ->level <= proc->level)
+                    succ->level = proc->level + 1;
+                if (--succ->npred == 0) {
+                    succ->next = ready;
+                    ready = succ;
+                }
+            }
+        }
+    }
+    if (nranked < nprocs) {
+        printf ("Combinational loop: cannot levelize\n");
+        exit (-1);
+    }
+
+    /* Split the processes into equal partitions,
+     * in the order of creation. */
+    comb_nparts = process_threads;
+    if (comb_nparts > PROCESS_MAXTHREADS)
+        comb_nparts = PROCESS_MAXTHREADS;
+    if (comb_nparts > nprocs)
+        comb_nparts = nprocs;
+    if (comb_nparts < 1)
+        comb_nparts = 1;
+    comb_part = calloc (comb_nparts, sizeof(partition_t));
+    if (comb_part == 0) {
+        printf ("Out of memory\n");
+        exit (-1);
+    }
+    for (part = comb_part; part < comb_part + comb_nparts; part++) {
+        part->pending = calloc (comb_nlevels, sizeof(process_t*));
+        if (part->pending == 0) {
+            printf ("Out of memory\n");
+            exit (-1);
+        }
+        part->first = comb_nlevels;
+    }
+    nranked = nprocs;
+    for (proc = comb_list; proc != 0; proc = proc->link)
+        proc->partition = (long long) --nranked * comb_nparts / nprocs;
+
+    for (part = comb_part + 1; part < comb_part + comb_nparts; part++) {
+        if (pthread_create (&thread, 0, comb_worker, part) != 0) {
+            printf ("Cannot create thread\n");
+            exit (-1);
+        }
+    }
+}
+
+/*
+ * Call the activated combinational processes in levelized mode.
+ */
+static void comb_evaluate (void)
+{
+    if (comb_npending >= COMB_PARMIN && comb_nparts > 1)
+        comb_parallel();
+    else
+        comb_serial();
+    comb_npending = 0;
+}
+
 /*
  * Wait for activation of any signal from a sensitivity list.
  * Switch to next active process.
@@ -76,38 +559,31 @@ void process_wait (void)
         printf ("Internal error: empty process queue\n");
         exit (-1);
     }
-    if (process_queue->delay != 0) {
+    if (comb_list != 0 && comb_part == 0)
+        comb_levelize();
+
+    while (process_queue->delay != 0 && signal_active != 0) {
         /* Delta cycle finished.
          * Schedule processes for active signals. */
         while (signal_active != 0) {
-            hook_t *hook = signal_active->activate;
             signal_t *next = signal_active->next;
 
             /* Handle all processes, sensitive to this signal. */
-            for (; hook != 0; hook = hook->next) {
-                if (hook->process->next == 0) {
-                    /* Signal change should matches the edge flag. */
-                    if ((hook->edge & POSEDGE) &&
-                        (signal_active->value != 0 ||
-                         signal_active->new_value == 0))
-                        continue;
-                    if ((hook->edge & NEGEDGE) &&
-                        (signal_active->value == 0 ||
-                         signal_active->new_value != 0))
-                        continue;
-
-                    /* Put the process to queue of pending events. */
-                    hook->process->next = process_queue;
-                    process_queue = hook->process;
-                    //printf ("(%llu) Process '%s' activated\n", time_ticks, hook->process->name);
-                }
-            }
+            signal_activate (signal_active, 1, 0);
+
             /* Setup a new signal value. */
+            if (signal_active->trace)
+                trace_change (signal_active, signal_active->new_value);
             signal_active->value = signal_active->new_value;
             signal_active->next = 0;
             signal_active = next;
         }
     	//printf ("(%llu) ---\n", time_ticks);
+
+        /* Call the combinational processes in levelized mode.
+         * They can activate other processes, or set signals
+         * for the next delta cycle. */
+        comb_evaluate();
     }
     /* Select next process from the queue. */
     process_current = process_queue;
@@ -190,3 +666,73 @@ process_t *_process_setup (process_t *proc, const char *name,
     proc->next = process_queue;
     return proc;
 }
+
+/*
+ * Body of a combinational process, run as a coroutine.
+ */
+static void comb_loop ()
+{
+    for (;;) {
+        process_wait();
+        process_current->func();
+    }
+}
+
+/*
+ * Create a combinational process.  Sensitive inputs and
+ * outputs of the process must be given by comb_input()
+ * and comb_output() right after.
+ */
+process_t *_comb_setup (process_t *proc, const char *name, void (*func)())
+{
+    if (! process_levelized) {
+        /* A coroutine, which calls the function on every activation.
+         * The stack is taken from the heap: a large design has
+         * more of them than the stack of main() can hold. */
+        proc = malloc (COMB_STACK);
+        if (proc == 0) {
+            printf ("Out of memory\n");
+            exit (-1);
+        }
+        process_queue = _process_setup (proc, name, comb_loop, COMB_STACK);
+        proc->func = func;
+        return proc;
+    }
+    if (comb_part != 0) {
+        printf ("Process '%s' created after start of simulation\n", name);
+        exit (-1);
+    }
+    memset (proc, 0, sizeof(process_t));
+    proc->name = name;
+    proc->func = func;
+    proc->comb = 1;
+    proc->link = comb_list;
+    comb_list = proc;
+    return proc;
+}
+
+/*
+ * Make the combinational process being created sensitive
+ * to any change of the signal.
+ */
+void _comb_input (signal_t *sig, hook_t *hook)
+{
+    hook->process = comb_current;
+    hook->edge = 0;
+    hook->next = sig->activate;
+    hook->prev = 0;
+    if (hook->next != 0)
+        hook->next->prev = hook;
+    sig->activate = hook;
+}
+
+/*
+ * Declare the signal an output of the combinational process
+ * being created.  Only this process should set the signal.
+ */
+void comb_output (signal_t *sig)
+{
+    sig->driver = comb_current;
+    sig->link = comb_current->outputs;
+    comb_current->outputs = sig;
+}
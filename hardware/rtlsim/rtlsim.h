@@ -26,7 +26,7 @@ typedef unsigned long long value_t;     /* Value of signal or time */
 /*--------------------------------------
  * Time
  */
-value_t time_ticks;             /* Current simulation time */
+extern value_t time_ticks;      /* Current simulation time */
 
 /*--------------------------------------
  * Signal
@@ -37,9 +37,12 @@ struct signal_t {
     const char  *name;          /* Name for log file */
     value_t     value;          /* Current value */
     value_t     new_value;      /* Value for next cycle */
+    process_t   *driver;        /* Combinational process which sets it */
+    signal_t    *link;          /* Next output of the same driver */
+    int         trace;          /* Index in waveform trace, or 0 */
 };
 
-signal_t *signal_active;        /* List of active signals for the current cycle */
+extern signal_t *signal_active; /* List of active signals for the current cycle */
 
 void signal_set (signal_t *sig, value_t value);
 
@@ -53,11 +56,20 @@ struct process_t {
     const char  *name;          /* Name for log file */
     value_t     delay;          /* Time to wait */
     jmp_buf     context;        /* User context for thread switching */
+    void        (*func)();      /* Function of combinational process */
+    process_t   *link;          /* Next combinational process */
+    signal_t    *outputs;       /* Signals set by the function */
+    int         comb;           /* Called directly, in levelized mode */
+    int         level;          /* Rank in the levelized schedule */
+    int         npred;          /* Unranked predecessors, when levelizing */
+    int         pending;        /* Queued for the current pass */
+    int         running;        /* Being called, in parallel pass */
+    int         partition;      /* Thread, in levelized mode */
 };
 
-process_t *process_current;     /* Current running process */
-process_t *process_queue;       /* Queue of pending events */
-process_t process_main;         /* Main process */
+extern process_t *process_current; /* Current running process */
+extern process_t *process_queue;   /* Queue of pending events */
+extern process_t process_main;     /* Main process */
 
 void process_wait (void);
 void process_delay (unsigned ticks);
@@ -67,6 +79,36 @@ process_t *_process_setup (process_t *proc, const char *name,
 #define process_init(_name, _func, _nbytes) (process_queue = \
     _process_setup (alloca (_nbytes), _name, _func, _nbytes))
 
+/*--------------------------------------
+ * Combinational process
+ *
+ * A function without state, which computes its outputs from
+ * its inputs, and is called again whenever any input changes.
+ * Normally it runs as a coroutine like any other process.
+ * When process_levelized is set before the processes are created,
+ * the combinational processes are ranked by their dependencies
+ * and called directly, in one pass per delta cycle, each after
+ * all its inputs have settled.  With process_threads above 1,
+ * the processes are split into as many partitions, and each
+ * level of a large pass is evaluated by all threads in parallel.
+ */
+#define COMB_STACK      4096    /* Stack of combinational process */
+#define PROCESS_MAXTHREADS 64   /* Limit of process_threads */
+
+extern int process_levelized;   /* Levelized mode */
+extern int process_threads;     /* Threads for levelized mode */
+extern process_t *comb_current; /* Process being created */
+
+process_t *_comb_setup (process_t *proc, const char *name, void (*func)());
+void _comb_input (signal_t *sig, hook_t *hook);
+void comb_output (signal_t *sig);
+
+#define comb_init(_name, _func) (comb_current = _comb_setup ( \
+    process_levelized ? alloca (sizeof(process_t)) : 0, _name, _func))
+
+#define comb_input(_sig) \
+    _comb_input (_sig, alloca (sizeof(hook_t)))
+
 
 /*--------------------------------------
  * Sensitivity hook
@@ -125,3 +167,20 @@ struct hook_t {
         _signal_unhook (_sig2, &_hook2); \
         _signal_unhook (_sig3, &_hook3); \
     }
+
+/*--------------------------------------
+ * Waveform trace
+ *
+ * Changes of the signals, added by trace_signal(), are written
+ * to the file in VCD format.  The simulator puts them to a ring
+ * buffer of TRACE_BUFSIZE records, and a background thread formats
+ * and writes them, so that a long trace takes a fixed amount of
+ * memory, and little time of the simulation.  All signals must
+ * be added before the first change of any of them.
+ */
+#define TRACE_BUFSIZE   65536   /* Records in the ring buffer, power of 2 */
+
+void trace_open (const char *filename);
+void trace_signal (signal_t *sig, int width);
+void trace_change (signal_t *sig, value_t value);
+void trace_close (void);
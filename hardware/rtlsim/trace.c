@@ -0,0 +1,314 @@
+/*
+ * Waveform trace for RTL simulator, in VCD format.
+ *
+ * Copyright (C) 2013 Serge Vakulenko <serge@vak.ru>
+ *
+ * This file is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You can redistribute this file and/or modify it under the terms of the GNU
+ * General Public License (GPL) as published by the Free Software Foundation;
+ * either version 2 of the License, or (at your discretion) any later version.
+ * See the accompanying file "COPYING.txt" for more details.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "rtlsim.h"
+
+/*
+ * Record of the ring buffer: a new value of the signal,
+ * or a new time when index is 0.
+ */
+typedef struct {
+    unsigned    index;          /* Signal in the table, or 0 */
+    value_t     value;          /* New value, or time */
+} record_t;
+
+/*
+ * Traced signal.
+ */
+typedef struct {
+    signal_t    *sig;
+    int         width;          /* Number of bits */
+    value_t     value;          /* Value at start of trace */
+    char        id [8];         /* Identifier code in VCD file */
+    int         idlen;          /* Length of the code */
+} trace_t;
+
+static FILE *trace_file;
+static trace_t *trace_sig;      /* Table of signals, from index 1 */
+static int trace_nsigs;         /* Number of signals */
+static int trace_maxsigs;       /* Allocated size of the table */
+static value_t trace_start;     /* Time of trace_open() */
+static value_t trace_time;      /* Time of the last record */
+static int trace_running;       /* Writer thread is started */
+static int trace_done;          /* No more records */
+static pthread_t trace_thread;
+
+static char trace_out [65536];  /* Output of the writer thread */
+static int trace_outlen;
+
+static record_t trace_buf [TRACE_BUFSIZE];
+static unsigned trace_head;     /* Records put by the simulator */
+static unsigned trace_tail;     /* Records written by the thread */
+static unsigned trace_limit;    /* Head can advance up to here */
+
+/*
+ * Append the text to the output buffer.
+ */
+static void put_text (char *p, int len)
+{
+    if (trace_outlen + len > sizeof(trace_out)) {
+        fwrite (trace_out, 1, trace_outlen, trace_file);
+        trace_outlen = 0;
+    }
+    memcpy (trace_out + trace_outlen, p, len);
+    trace_outlen += len;
+}
+
+/*
+ * Write a value of the signal.
+ */
+static void put_value (trace_t *t, value_t value)
+{
+    char buf [80], *p = buf + sizeof(buf);
+
+    if (t->width == 1 && trace_outlen + 10 <= sizeof(trace_out)) {
+        /* Most signals are single bits. */
+        p = trace_out + trace_outlen;
+        *p++ = '0' + (value & 1);
+        memcpy (p, t->id, 8);
+        p [t->idlen] = '\n';
+        trace_outlen += t->idlen + 2;
+        return;
+    }
+    *--p = '\n';
+    p -= t->idlen;
+    memcpy (p, t->id, t->idlen);
+    if (t->width == 1) {
+        *--p = '0' + (value & 1);
+    } else {
+        if (t->width < 64)
+            value &= (1ULL << t->width) - 1;
+        *--p = ' ';
+        do {
+            *--p = '0' + (value & 1);
+            value >>= 1;
+        } while (value != 0);
+        *--p = 'b';
+    }
+    put_text (p, buf + sizeof(buf) - p);
+}
+
+/*
+ * Write a new time.
+ */
+static void put_time (value_t time)
+{
+    char buf [32], *p = buf + sizeof(buf);
+
+    *--p = '\n';
+    do {
+        *--p = '0' + time % 10;
+        time /= 10;
+    } while (time != 0);
+    *--p = '#';
+    put_text (p, buf + sizeof(buf) - p);
+}
+
+/*
+ * Write the declarations of signals and their initial values.
+ */
+static void put_header (void)
+{
+    trace_t *t;
+
+    fprintf (trace_file, "$version rtlsim $end\n");
+    fprintf (trace_file, "$timescale 1ns $end\n");
+    fprintf (trace_file, "$scope module top $end\n");
+    for (t = trace_sig + 1; t <= trace_sig + trace_nsigs; t++)
+        fprintf (trace_file, "$var wire %d %s %s $end\n",
+            t->width, t->id, t->sig->name);
+    fprintf (trace_file, "$upscope $end\n");
+    fprintf (trace_file, "$enddefinitions $end\n");
+    put_time (trace_start);
+    put_text ("$dumpvars\n", 10);
+    for (t = trace_sig + 1; t <= trace_sig + trace_nsigs; t++)
+        put_value (t, t->value);
+    put_text ("$end\n", 5);
+}
+
+/*
+ * Background thread: take records from the ring buffer,
+ * and write them to the file.
+ */
+static void *trace_writer (void *arg)
+{
+    struct timespec pause = { 0, 1000000 };
+    unsigned tail = 0, head;
+    record_t *r;
+    int done;
+
+    put_header();
+    for (;;) {
+        done = __atomic_load_n (&trace_done, __ATOMIC_ACQUIRE);
+        head = __atomic_load_n (&trace_head, __ATOMIC_ACQUIRE);
+        if (tail == head) {
+            if (done)
+                break;
+            if (trace_outlen > 0) {
+                fwrite (trace_out, 1, trace_outlen, trace_file);
+                trace_outlen = 0;
+            }
+            nanosleep (&pause, 0);
+            continue;
+        }
+        while (tail != head) {
+            r = &trace_buf [tail & (TRACE_BUFSIZE - 1)];
+            if (r->index == 0)
+                put_time (r->value);
+            else
+                put_value (&trace_sig [r->index], r->value);
+            tail++;
+
+            /* Give the space back in pieces,
+             * so that the simulator need not wait long. */
+            if ((tail & (TRACE_BUFSIZE/16 - 1)) == 0)
+                __atomic_store_n (&trace_tail, tail, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n (&trace_tail, tail, __ATOMIC_RELEASE);
+    }
+    fwrite (trace_out, 1, trace_outlen, trace_file);
+    return 0;
+}
+
+/*
+ * Put a record to the ring buffer.
+ * Wait for the writer, when the buffer is full.
+ */
+static void trace_put (unsigned index, value_t value)
+{
+    record_t *r;
+
+    while (trace_head == trace_limit) {
+        trace_limit = __atomic_load_n (&trace_tail, __ATOMIC_ACQUIRE) +
+            TRACE_BUFSIZE;
+        if (trace_head == trace_limit)
+            sched_yield();
+    }
+    r = &trace_buf [trace_head & (TRACE_BUFSIZE - 1)];
+    r->index = index;
+    r->value = value;
+    __atomic_store_n (&trace_head, trace_head + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Start the writer thread.  The table of signals is fixed from now on.
+ */
+static void trace_run (void)
+{
+    trace_running = 1;
+    trace_limit = TRACE_BUFSIZE;
+    if (pthread_create (&trace_thread, 0, trace_writer, 0) != 0) {
+        printf ("Cannot create thread\n");
+        exit (-1);
+    }
+}
+
+/*
+ * Create the trace file.  It is closed at exit.
+ */
+void trace_open (const char *filename)
+{
+    if (trace_file != 0) {
+        printf ("Trace file is already open\n");
+        exit (-1);
+    }
+    trace_file = fopen (filename, "w");
+    if (trace_file == 0) {
+        perror (filename);
+        exit (-1);
+    }
+    setvbuf (trace_file, 0, _IOFBF, 65536);
+    trace_start = time_ticks;
+    trace_time = time_ticks;
+    atexit (trace_close);
+}
+
+/*
+ * Add the signal to the trace.  All signals must be added
+ * before the first change of any of them.
+ */
+void trace_signal (signal_t *sig, int width)
+{
+    trace_t *t;
+    char *p;
+    int n;
+
+    if (trace_file == 0) {
+        printf ("Trace file is not open\n");
+        exit (-1);
+    }
+    if (trace_running) {
+        printf ("Signal '%s': cannot trace after start\n", sig->name);
+        exit (-1);
+    }
+    if (sig->trace != 0)
+        return;
+    if (trace_nsigs + 1 >= trace_maxsigs) {
+        trace_maxsigs = trace_maxsigs ? trace_maxsigs * 2 : 64;
+        trace_sig = realloc (trace_sig, trace_maxsigs * sizeof(trace_t));
+        if (trace_sig == 0) {
+            printf ("Out of memory\n");
+            exit (-1);
+        }
+    }
+    sig->trace = ++trace_nsigs;
+    t = &trace_sig [sig->trace];
+    t->sig = sig;
+    t->width = (width < 1) ? 1 : (width > 64) ? 64 : width;
+    t->value = sig->value;
+
+    /* Identifier code: a number in base 94, from '!' to '~'. */
+    n = sig->trace - 1;
+    p = t->id;
+    do {
+        *p++ = '!' + n % 94;
+        n /= 94;
+    } while (n > 0);
+    *p = 0;
+    t->idlen = p - t->id;
+}
+
+/*
+ * The traced signal gets a new value.  Called by the simulator.
+ */
+void trace_change (signal_t *sig, value_t value)
+{
+    if (! trace_running)
+        trace_run();
+    if (time_ticks != trace_time) {
+        trace_time = time_ticks;
+        trace_put (0, time_ticks);
+    }
+    trace_put (sig->trace, value);
+}
+
+/*
+ * Write the rest of the trace, and close the file.
+ */
+void trace_close (void)
+{
+    if (trace_file == 0)
+        return;
+    if (! trace_running)
+        trace_run();
+    __atomic_store_n (&trace_done, 1, __ATOMIC_RELEASE);
+    pthread_join (trace_thread, 0);
+    fclose (trace_file);
+    trace_file = 0;
+}
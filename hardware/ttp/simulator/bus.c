@@ -20,50 +20,42 @@
  */
 void bus_step (bus_t *c)
 {
+	char activity [2*BUS_MAXPORTS];
+	int i, port, nactive;
+
 	/*printf ("--%s-- step\n", c->name);*/
-	switch (c->run) {
+	if (c->run) {
 		/* Рабочий режим. Транслируем сигнал с активного входного
 		 * порта на выходной порт. */
-	case 1:
-		c->tx = c->rn0;
-		break;
-	case 2:
-		c->tx = c->rn1;
-		break;
-	case 4:
-		c->tx = c->rn2;
-		break;
-	case 8:
-		c->tx = c->rn3;
-		break;
-	default:
+		c->tx = c->rn [c->run - 1];
+	} else {
 		/* Холостой режим. Дожидаемся активности на одном из портов
 		 * переходим в рабочий режим. */
-		if ((! c->rn0) + (! c->rn1) + (! c->rn2) + (! c->rn3) > 1) {
-			printf ("--%s-- error: activity %d-%d-%d-%d\n", c->name,
-				! c->rn0, ! c->rn1, ! c->rn2, ! c->rn3);
+		port = -1;
+		nactive = 0;
+		for (i=0; i<c->nports; ++i) {
+			if (c->rn [i] == 0) {
+				if (port < 0)
+					port = i;
+				++nactive;
+			}
 		}
-		if (c->rn0 == 0) {
-/*			printf ("--%s-- port 0 active\n", c->name);*/
-			c->run = 1;
-			c->tx = 0;
-		} else if (c->rn1 == 0) {
-/*			printf ("--%s-- port 1 active\n", c->name);*/
-			c->run = 2;
-			c->tx = 0;
-		} else if (c->rn2 == 0) {
-/*			printf ("--%s-- port 2 active\n", c->name);*/
-			c->run = 4;
-			c->tx = 0;
-		} else if (c->rn3 == 0) {
-/*			printf ("--%s-- port 3 active\n", c->name);*/
-			c->run = 8;
+		if (nactive > 1) {
+			for (i=0; i<c->nports; ++i) {
+				activity [2*i] = c->rn [i] ? '0' : '1';
+				activity [2*i+1] = '-';
+			}
+			activity [2*c->nports - 1] = 0;
+			printf ("--%s-- error: activity %s\n", c->name, activity);
+		}
+		if (port >= 0) {
+/*			printf ("--%s-- port %d active\n", c->name, port);*/
+			c->run = port + 1;
 			c->tx = 0;
 		} else
 			c->tx = 1;
 
 		c->idle_counter = 0;
-		break;
 	}
 	if (c->run) {
 		/* Если в течение 4-х циклов активный порт находится
@@ -80,19 +72,24 @@ void bus_step (bus_t *c)
 void bus_reset (bus_t *c)
 {
 	const char *name;
+	int nports;
 
 	/*printf ("--%s-- reset\n", c->name);*/
 	name = c->name;
+	nports = c->nports;
 	memset (c, 0, sizeof (bus_t));
 	c->name = name;
+	c->nports = nports;
 }
 
-bus_t *bus_alloc ()
+bus_t *bus_alloc (int nports)
 {
 	bus_t *c;
 
 	/*printf ("\n--%s-- started\n", c->name);*/
 	c = calloc (1, sizeof (*c));
+	if (c)
+		c->nports = nports;
 	return c;
 }
 
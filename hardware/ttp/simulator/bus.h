@@ -1,11 +1,11 @@
+#define BUS_MAXPORTS	64	/* Наибольшее количество входных портов */
+
 struct _bus_t {
 	const char *name;
+	int nports;		/* Количество входных портов */
 
 	/* Входы. */
-	int rn0;
-	int rn1;
-	int rn2;
-	int rn3;
+	int rn [BUS_MAXPORTS];
 
 	/* Выходы. */
 	int tx;
@@ -20,6 +20,6 @@ typedef struct _bus_t bus_t;
  */
 void bus_step (bus_t *c);
 
-bus_t *bus_alloc ();
+bus_t *bus_alloc (int nports);
 void bus_free (bus_t *c);
 void bus_reset (bus_t *c);
@@ -18,6 +18,7 @@ struct _cpu_t {
 	const char *name;
 	void (*reset_func) (struct _cpu_t*);
 	unsigned reset_eip;
+	int num;			/* номер узла в кластере */
 
 	/* Входы. */
 	int rst;
@@ -30,7 +30,7 @@ typedef struct _history_t {
 
 	int bus0_tx, bus1_tx;
 
-	int nstep;				/* номер шага */
+	unsigned long long nstep;		/* номер шага */
 	int slot_start;				/* начало слота */
 	int cycle_start;			/* начало цикла */
 	double time_usec;			/* время в миллисекундах */
@@ -456,7 +456,7 @@ static void ui_step (simulator_t *sim)
 	simulator_step (sim);
 	chart_step (sim);
 	append_history (sim);
-	status_print (sim, "Шаг %d, время %.5f мксек", sim->nstep, sim->time_usec);
+	status_print (sim, "Шаг %llu, время %.5f мксек", sim->nstep, sim->time_usec);
 }
 
 /*
@@ -786,8 +786,8 @@ int main (int argc, char *argv[])
 	/* Читаем структуру пользовательского интерфейса из XML-файла glade. */
 	sim->ui = glade_xml_new ("simulator.glade", "window_top", NULL);
 
+	simulator_init (sim, NNODES);
 	ui_init (sim);
-	simulator_init (sim);
 	clear_history (sim);
 	draw_schematics (sim);
 
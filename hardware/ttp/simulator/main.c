@@ -8,6 +8,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/time.h>
 #include "simulator.h"
 #include "simstruct.h"
 
@@ -20,7 +21,8 @@ void ui_print (const char *fmt, ...)
 	va_list ap;
 
 	va_start (ap, fmt);
-	vprintf (fmt, ap);
+	if (! simulator_log (fmt, ap))
+		vprintf (fmt, ap);
 	va_end (ap);
 }
 
@@ -35,40 +37,104 @@ void ui_draw_cpu (simulator_t *sim, int i, int active)
 {
 }
 
+static void usage ()
+{
+	fprintf (stderr, "Usage: sim [-n nodes] [-t seconds] [-j threads]\n");
+	fprintf (stderr, "Options:\n");
+	fprintf (stderr, "  -n nodes     number of nodes in cluster, 1...%d, default %d\n",
+		MAXNODES, NNODES);
+	fprintf (stderr, "  -t seconds   simulate given time of the bus, then print statistics;\n");
+	fprintf (stderr, "               by default, run forever\n");
+	fprintf (stderr, "  -j threads   simulate nodes in parallel, with given number of threads\n");
+	exit (1);
+}
+
+/*
+ * Текущее время в секундах.
+ */
+static double real_time ()
+{
+	struct timeval tv;
+
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
 int main (int argc, char *argv[])
 {
 	simulator_t *sim;
+	int nnodes = NNODES, nthreads = 1, i;
+	double seconds = 0, t0, t1;
+	simtime_t time_limit;
+
+	for (;;) {
+		switch (getopt (argc, argv, "n:t:j:")) {
+		case EOF:
+			break;
+		case 'n':
+			nnodes = strtol (optarg, 0, 0);
+			continue;
+		case 't':
+			seconds = strtod (optarg, 0);
+			continue;
+		case 'j':
+			nthreads = strtol (optarg, 0, 0);
+			continue;
+		default:
+			usage ();
+		}
+		break;
+	}
+	if (optind != argc || nnodes < 1 || nnodes > MAXNODES || nthreads < 1)
+		usage ();
 
 	sim = calloc (1, sizeof (*sim));
 	if (! sim) {
 		fprintf (stderr, "Out of memory\n");
 		exit (1);
 	}
-	simulator_init (sim);
+	simulator_init (sim, nnodes);
 
 	/* Установка параметров модели. */
 	simulator_set_bus_rate (sim, 10);			/* 10 Мбит/сек */
 
-	simulator_set_cpu_frequency (sim, 0, 10);		/* 50 МГц */
-	simulator_set_ctlr_frequency (sim, 0, 0);		/* +100 ppm */
-
-	simulator_set_cpu_frequency (sim, 1, 10);		/* 20 МГц */
-	simulator_set_ctlr_frequency (sim, 1, 0);		/* -100 ppm */
-#if NNODES > 2
-	simulator_set_cpu_frequency (sim, 2, 50);		/* 50 МГц */
-	simulator_set_ctlr_frequency (sim, 2, 0);		/* 0 ppm */
-#endif
-#if NNODES > 3
-	simulator_set_cpu_frequency (sim, 3, 50);		/* 50 МГц */
-	simulator_set_ctlr_frequency (sim, 3, 0);		/* 0 ppm */
-#endif
+	simulator_set_cpu_frequency (sim, 0, 10);		/* 10 МГц */
+	simulator_set_ctlr_frequency (sim, 0, 0);		/* 0 ppm */
+	if (nnodes > 1) {
+		simulator_set_cpu_frequency (sim, 1, 10);	/* 10 МГц */
+		simulator_set_ctlr_frequency (sim, 1, 0);	/* 0 ppm */
+	}
+	for (i=2; i<nnodes; ++i) {
+		simulator_set_cpu_frequency (sim, i, 50);	/* 50 МГц */
+		simulator_set_ctlr_frequency (sim, i, 0);	/* 0 ppm */
+	}
+	if (nthreads > 1)
+		simulator_set_threads (sim, nthreads);
 	printf ("Started.\n");
 
-	/* Пуск симулятора в непрерывном режиме. */
-	for (;;) {
-		simulator_step (sim);
-/*		printf ("Шаг %d, время %.5f мксек\n", sim->nstep, sim->time_usec);*/
-/*		usleep (10000);*/
+	if (seconds <= 0) {
+		if (nthreads > 1) {
+			/* Параллельный режим, без ограничения времени. */
+			simulator_run (sim, ~(simtime_t) 0);
+		}
+		/* Пуск симулятора в непрерывном режиме. */
+		for (;;) {
+			simulator_step (sim);
+/*			printf ("Шаг %llu, время %.5f мксек\n", sim->nstep, sim->time_usec);*/
+/*			usleep (10000);*/
+		}
 	}
+
+	/* Пакетный режим: моделируем заданное время работы шины
+	 * и выдаём скорость симуляции. */
+	time_limit = (simtime_t) (seconds * 1e6 + 0.5) * PS_PER_USEC;
+	t0 = real_time ();
+	simulator_run (sim, time_limit);
+	t1 = real_time ();
+
+	printf ("%d nodes, %.6f seconds of bus time, %llu steps\n",
+		nnodes, sim->time_usec / 1e6, sim->nstep);
+	printf ("%.3f seconds of real time, %.0f steps/sec\n",
+		t1 - t0, (t1 > t0) ? sim->nstep / (t1 - t0) : 0.0);
 	return 0;
 }
@@ -0,0 +1,84 @@
+/*
+ * Эмуляция процессора пассивного узла кластера TTP.
+ * Узел только принимает данные, слотов передачи у него нет.
+ * Используется для узлов с номерами 2 и выше.
+ *
+ * Автор: Сергей Вакуленко, ИТМиВТ 2008.
+ */
+#include "ttc-reg.h"
+#include "cpu.h"
+#include "node.h"
+
+#ifdef MATLAB_MEX_FILE
+#   include "mex.h"
+#else
+#   include "simulator.h"
+#endif
+
+/*
+ * Функция пользователя.
+ */
+void node_passive (cpu_t *c)
+{
+	int cluster_mode, start_node;
+	unsigned long cluster_time, local_time, prev_time;
+	unsigned short x, y;
+
+	/* Проверка и печать номера и даты ревизии контроллера TTP. */
+	node_check_revision (c);
+
+	/* Сброс контроллера в исходное состояние. */
+	cpu_write (c, TTC_GCR, TTC_GCR_GRST);
+	cpu_write (c, TTC_GCR, 0);
+
+	/* Установка регистров, режим 1. */
+	node_setup (c, c->num);
+	node_set_mode (c, 1);
+
+	/* Пассивный старт. */
+	cpu_write (c, TTC_NMR, TTC_MR_RXEN0 | TTC_MR_RXEN1 | TTC_MR_STRT | 1);
+	cpu_write (c, TTC_GCR, TTC_GCR_GRUN);
+
+	/*---------------------------
+	 * 1) Ждем стартового пакета.
+	 */
+	for (;;) {
+		if (node_wait_start_packet (c, &cluster_mode, &start_node,
+		    &cluster_time, &local_time))
+			break;
+	}
+	cpu_write (c, TTC_GSR, TTC_GSR_CCL);
+
+	/*---------------------------
+	 * 2) Синхронизируемся.
+	 */
+	printf ("--%s--0 cluster mode=%d, start node=%d, cluster time=%ld, local time=%ld\n",
+		c->name, cluster_mode, start_node, cluster_time, local_time);
+
+	/* Устанавливаем режим кластера cluster_mode. */
+	node_set_mode (c, cluster_mode);
+
+	/* Снимаем стартовый бит. Передатчик не включаем. */
+	cpu_write (c, TTC_NMR, TTC_MR_RXEN0 | TTC_MR_RXEN1 | cluster_mode);
+
+	/* Корректируем время на основе cluster_time и local_time. */
+	node_set_cycle_duration (c, 1, local_time - cluster_time);
+
+	/* Ждем конца цикла, чтобы перейти на новый режим и время. */
+	node_wait_gsr (c, TTC_GSR_CCL);
+
+	printf ("--%s-- successfully started\n", c->name);
+
+	/* Рабочий цикл узла: принимаем X и Y, переданные узлами 0 и 1. */
+	prev_time = ~0;
+	for (;;) {
+		local_time = cpu_read32 (c, TTC_CTR);
+		if (node_time_reached (SLOT2_TIME, local_time, prev_time)) {
+			node_get_ushort (c, &x, ADDR(x0), ADDR(x0_status),
+				ADDR(x1), ADDR(x1_status));
+			node_get_ushort (c, &y, ADDR(y0), ADDR(y0_status),
+				ADDR(y1), ADDR(y1_status));
+		}
+		prev_time = local_time;
+	}
+}
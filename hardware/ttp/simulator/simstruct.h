@@ -3,32 +3,66 @@
  *
  * Автор: Сергей Вакуленко, ИТМиВТ 2008.
  */
+#include <stdarg.h>
 #include "ctlr.h"
 #include "bus.h"
 #include "cpu.h"
 
-#define NNODES			2	/* Количество узлов в кластере */
+#define NNODES			2	/* Количество узлов в оконном интерфейсе */
+#define MAXNODES		BUS_MAXPORTS /* Наибольшее количество узлов */
 #define STACK_BYTES		64000	/* Размер стека для сопроцесса */
 
+/*
+ * Время моделирования в пикосекундах.  Длительности тактов
+ * при всех значениях частот из интерфейса выражаются точно.
+ */
+typedef unsigned long long simtime_t;
+
+#define PS_PER_USEC		1000000ULL
+
+/*
+ * Элемент очереди событий: очередной такт модуля.
+ * Модуль 2*i - контроллер узла #i, модуль 2*i+1 - процессор узла #i.
+ */
+typedef struct {
+	simtime_t time;				/* момент такта */
+	int module;				/* номер модуля */
+} event_t;
+
+typedef struct _pool_t pool_t;		/* потоки параллельного режима */
+
 typedef struct _simulator_t {
 	/* Модули, образующие кластер TTP */
-	controller_t *ctlr [NNODES];		/* контроллеры TTP */
-	cpu_t *node [NNODES];			/* процессоры */
+	int nnodes;				/* количество узлов */
+	controller_t *ctlr [MAXNODES];		/* контроллеры TTP */
+	cpu_t *node [MAXNODES];			/* процессоры */
 	bus_t *bus0, *bus1;			/* шины */
 
 	/* Численные параметры модели. */
-	int rst [NNODES];			/* сброс процессоров */
+	int rst [MAXNODES];			/* сброс процессоров */
 	int bus_mbps;				/* скорость шин */
-	int cpu_mhz [NNODES];			/* частота процессоров */
-	int ctlr_ppm [NNODES];			/* точность частоты контроллеров */
+	int cpu_mhz [MAXNODES];			/* частота процессоров */
+	int ctlr_ppm [MAXNODES];		/* точность частоты контроллеров */
+
+	/* Время моделирования. */
+	unsigned long long nstep;		/* номер шага */
+	double time_usec;			/* текущее время, микросекунды */
+	simtime_t time;				/* текущее время */
+	simtime_t node_time_step [MAXNODES];	/* длительность такта процессоров */
+	simtime_t ctlr_time_step [MAXNODES];	/* длительность такта контроллеров */
+	simtime_t node_time_last [MAXNODES];	/* момент последнего такта процессоров */
+	simtime_t ctlr_time_last [MAXNODES];	/* момент последнего такта контроллеров */
+
+	/* Очередь событий: пирамида, упорядоченная по времени. */
+	int nevents;
+	event_t queue [2*MAXNODES];
+
+	/* Модули, сделавшие такт на последнем шаге. */
+	int nactive;
+	int active [2*MAXNODES];
 
-	/* Время моделирования, микросекунды. */
-	int nstep;				/* номер шага */
-	double time_usec;			/* текущее время */
-	double node_time_step [NNODES];		/* длительность такта процессоров */
-	double ctlr_time_step [NNODES];		/* длительность такта контроллеров */
-	double node_time_last [NNODES];		/* момент последнего такта процессоров */
-	double ctlr_time_last [NNODES];		/* момент последнего такта контроллеров */
+	/* Параллельный режим, или 0. */
+	pool_t *pool;
 
 #ifdef GTK_WINDOW
 	/* История, nstep элементов. */
@@ -57,9 +91,12 @@ typedef struct _simulator_t {
 
 } simulator_t;
 
-void simulator_init (simulator_t *sim);
+void simulator_init (simulator_t *sim, int nnodes);
 void simulator_reset (simulator_t *sim);
 void simulator_step (simulator_t *sim);
+void simulator_run (simulator_t *sim, simtime_t until);
+void simulator_set_threads (simulator_t *sim, int nthreads);
+int simulator_log (const char *fmt, va_list ap);
 void simulator_set_cpu_frequency (simulator_t *sim, int node_num, int mhz);
 void simulator_set_bus_rate (simulator_t *sim, int mhz);
 void simulator_set_ctlr_frequency (simulator_t *sim, int node_num, int ppm);
@@ -6,31 +6,54 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 #include "simulator.h"
 #include "simstruct.h"
 
-#define EPSILON		1e-10
-
 extern void node0 (cpu_t *c);
 extern void node1 (cpu_t *c);
-#if NNODES > 2
-extern void node2 (cpu_t *c);
-#endif
-#if NNODES > 3
-extern void node3 (cpu_t *c);
-#endif
-
-static void (*node_start [NNODES]) () = {
-	node0,
-	node1,
-#if NNODES > 2
-	node2,
-#endif
-#if NNODES > 3
-	node3,
-#endif
+extern void node_passive (cpu_t *c);
+
+#define POOL_SPIN	1000	/* Циклов ожидания до уступки процессора */
+
+/*
+ * Сообщение узла, выданное в параллельном режиме.
+ */
+typedef struct {
+	simtime_t time;				/* момент такта */
+	int module;				/* номер модуля */
+	char *text;
+} message_t;
+
+/*
+ * Журнал сообщений узла за один интервал параллельного режима.
+ */
+typedef struct {
+	simtime_t time;				/* текущий такт узла */
+	int module;
+	int count;				/* количество сообщений */
+	int max;				/* размер массива */
+	message_t *msg;
+} journal_t;
+
+/*
+ * Потоки параллельного режима.
+ */
+struct _pool_t {
+	int nthreads;				/* количество потоков */
+	unsigned epoch;				/* номер интервала, запускает потоки */
+	unsigned done;				/* потоков, закончивших интервал */
+	unsigned next_node;			/* очередной узел для потоков */
+	simtime_t time_end;			/* конец интервала */
+	journal_t journal [MAXNODES];
 };
 
+/*
+ * Журнал узла, который моделирует текущий поток.
+ */
+static __thread journal_t *journal_current;
+
 #define CONTEXT_SAVE(c,ret) 	__asm__ volatile (	\
 	"movl %0, %%eax \n"				\
 	"movl %%ebp, (%%eax) \n"			\
@@ -188,27 +211,133 @@ static void cpu_step (cpu_t *c)
 	__asm__ volatile ("1:");
 }
 
+/*
+ * Момент последнего такта модуля.
+ */
+static simtime_t module_last (simulator_t *sim, int m)
+{
+	if (m & 1)
+		return sim->node_time_last [m >> 1];
+	return sim->ctlr_time_last [m >> 1];
+}
+
+/*
+ * Длительность такта модуля.
+ */
+static simtime_t module_step (simulator_t *sim, int m)
+{
+	if (m & 1)
+		return sim->node_time_step [m >> 1];
+	return sim->ctlr_time_step [m >> 1];
+}
+
+/*
+ * Момент следующего такта модуля.
+ */
+static simtime_t module_next (simulator_t *sim, int m)
+{
+	if (m & 1)
+		return sim->node_time_last [m >> 1] + sim->node_time_step [m >> 1];
+	return sim->ctlr_time_last [m >> 1] + sim->ctlr_time_step [m >> 1];
+}
+
+/*
+ * Порядок событий в очереди: по времени, затем по номеру модуля.
+ */
+static int event_before (event_t *a, event_t *b)
+{
+	return a->time < b->time ||
+		(a->time == b->time && a->module < b->module);
+}
+
+/*
+ * Добавление события в очередь.
+ */
+static void queue_push (simulator_t *sim, int m)
+{
+	event_t ev, *q = sim->queue;
+	int k, parent;
+
+	ev.time = module_next (sim, m);
+	ev.module = m;
+	for (k = sim->nevents++; k > 0; k = parent) {
+		parent = (k - 1) / 2;
+		if (! event_before (&ev, &q[parent]))
+			break;
+		q[k] = q[parent];
+	}
+	q[k] = ev;
+}
+
+/*
+ * Извлечение ближайшего события из очереди.
+ * Возвращает номер модуля.
+ */
+static int queue_pop (simulator_t *sim)
+{
+	event_t ev, *q = sim->queue;
+	int k, child, m;
+
+	m = q[0].module;
+	ev = q[--sim->nevents];
+	for (k = 0; ; k = child) {
+		child = 2*k + 1;
+		if (child >= sim->nevents)
+			break;
+		if (child + 1 < sim->nevents && event_before (&q[child+1], &q[child]))
+			++child;
+		if (! event_before (&q[child], &ev))
+			break;
+		q[k] = q[child];
+	}
+	q[k] = ev;
+	return m;
+}
+
+/*
+ * Заполнение очереди заново, после изменения параметров.
+ */
+static void queue_build (simulator_t *sim)
+{
+	int m;
+
+	sim->nevents = 0;
+	for (m=0; m<2*sim->nnodes; ++m)
+		queue_push (sim, m);
+}
+
 /*
  * Инициализация симулятора, выделение памяти для всех модулей,
  * старт подчинённых потоков.
  */
-void simulator_init (simulator_t *sim)
+void simulator_init (simulator_t *sim, int nnodes)
 {
+	char name [16];
 	int i;
-	static const char *ctlr_names [] = { "ttp0", "ttp1", "ttp2", "ttp3" };
-	static const char *node_names [] = { "node0", "node1", "node2", "node3" };
 
-	for (i=0; i<NNODES; ++i) {
+	if (nnodes < 1 || nnodes > MAXNODES) {
+		fprintf (stderr, "Number of nodes must be 1...%d\n", MAXNODES);
+		exit (1);
+	}
+	sim->nnodes = nnodes;
+	for (i=0; i<nnodes; ++i) {
 		sim->ctlr[i] = ctlr_alloc ();
-		sim->ctlr[i]->name = ctlr_names [i];
-
-		sim->node[i] = cpu_alloc (node_start[i]);
-		sim->node[i]->name = node_names [i];
+		sprintf (name, "ttp%d", i);
+		sim->ctlr[i]->name = strdup (name);
+
+		/* Узлы 0 и 1 передают данные по расписанию,
+		 * остальные только принимают. */
+		sim->node[i] = cpu_alloc (i == 0 ? node0 :
+			i == 1 ? node1 : node_passive);
+		sim->node[i]->num = i;
+		sprintf (name, "node%d", i);
+		sim->node[i]->name = strdup (name);
 	}
-	sim->bus0 = bus_alloc ();
+	sim->bus0 = bus_alloc (nnodes);
 	sim->bus0->name = "bus0";
-	sim->bus1 = bus_alloc ();
+	sim->bus1 = bus_alloc (nnodes);
 	sim->bus1->name = "bus1";
+	queue_build (sim);
 }
 
 /*
@@ -218,7 +347,7 @@ void simulator_reset (simulator_t *sim)
 {
 	int i;
 
-	for (i=0; i<NNODES; ++i) {
+	for (i=0; i<sim->nnodes; ++i) {
 		cpu_reset (sim->node[i], 0);
 		ctlr_reset (sim->ctlr[i]);
 		sim->node_time_last [i] = 0;
@@ -231,111 +360,396 @@ void simulator_reset (simulator_t *sim)
 
 	/* Обнуляем текущее время и моменты последнего такта. */
 	sim->nstep = 0;
+	sim->time = 0;
 	sim->time_usec = 0;
+	sim->nactive = 0;
+	queue_build (sim);
 }
 
 /*
- * Выполнение одного шага симулятора.
+ * Такт TTP-контроллера узла #i, коммуникационная часть.
  */
-void simulator_step (simulator_t *sim)
+static void step_ctlr (simulator_t *sim, int i, simtime_t time)
+{
+	sim->ctlr[i]->rx0    = sim->bus0->tx;
+	sim->ctlr[i]->rx1    = sim->bus1->tx;
+	ctlr_step_rxtx (sim->ctlr[i]);
+
+	sim->ctlr_time_last [i] = time;
+}
+
+/*
+ * Такт процессора узла #i и процессорной части его контроллера.
+ */
+static void step_cpu (simulator_t *sim, int i, simtime_t time)
 {
-	int i, need_bus_step = 0;
-	double time_next, tn;
-
-	/* Вычисляем шаг по времени.
-	 * Берём минимальный шаг по всем модулям. */
-	time_next = sim->time_usec + 1000000;
-	for (i=0; i<NNODES; ++i) {
-		tn = sim->node_time_last [i] + sim->node_time_step [i];
-/*printf ("%s tn=%.8g\n", sim->node[i]->name, tn);*/
-		if (time_next > tn)
-			time_next = tn;
-		tn = sim->ctlr_time_last [i] + sim->ctlr_time_step [i];
-/*printf ("%s tn=%.8g\n", sim->ctlr[i]->name, tn);*/
-		if (time_next > tn)
-			time_next = tn;
+	sim->node[i]->datain = sim->ctlr[i]->dataout;
+	sim->node[i]->ack    = sim->ctlr[i]->ack;
+	if (sim->rst[i]) {
+		/* Сброс процессора. */
+		cpu_reset (sim->node[i], 0);
+	} else
+		cpu_step (sim->node[i]);
+
+	/* TTP-контроллер узла #i, процессорная часть */
+	sim->ctlr[i]->datain = sim->node[i]->dataout;
+	sim->ctlr[i]->addr   = sim->node[i]->addr;
+	sim->ctlr[i]->rd     = sim->node[i]->rd;
+	sim->ctlr[i]->wrh    = sim->node[i]->wrh;
+	sim->ctlr[i]->wrl    = sim->node[i]->wrl;
+	ctlr_step_cpu (sim->ctlr[i]);
+
+	sim->node_time_last [i] = time;
+}
+
+/*
+ * Такт шин, после тактов всех контроллеров в данный момент.
+ */
+static void step_bus (simulator_t *sim)
+{
+	int i;
+
+	for (i=0; i<sim->nnodes; ++i) {
+		sim->bus0->rn[i] = sim->ctlr[i]->tx;
+		sim->bus1->rn[i] = sim->ctlr[i]->tx;
 	}
+	bus_step (sim->bus0);
+	bus_step (sim->bus1);
+}
 
-	/* Проходим по всем модулям и делаем шаг для тех,
-	 * которые попадают по времени. */
-	for (i=0; i<NNODES; ++i) {
-		if (sim->ctlr_time_last [i] + sim->ctlr_time_step [i] - time_next <
-		    EPSILON) {
-			/* TTP-контроллер узла #i, коммуникационная часть */
-			sim->ctlr[i]->rx0    = sim->bus0->tx;
-			sim->ctlr[i]->rx1    = sim->bus1->tx;
-			ctlr_step_rxtx (sim->ctlr[i]);
-
-			sim->ctlr_time_last [i] = time_next;
+/*
+ * Выполнение одного шага симулятора.
+ */
+void simulator_step (simulator_t *sim)
+{
+	int stepped [2*MAXNODES];
+	int i, k, m, n, need_bus_step = 0;
+	simtime_t time_next;
+
+	/* Берём из очереди все модули, такт которых приходится
+	 * на ближайший момент времени.  Они идут по возрастанию
+	 * номеров: для каждого узла контроллер, затем процессор. */
+	time_next = sim->queue[0].time;
+	n = 0;
+	while (sim->nevents > 0 && sim->queue[0].time == time_next)
+		stepped [n++] = queue_pop (sim);
+
+	for (k=0; k<n; ++k) {
+		m = stepped [k];
+		i = m >> 1;
+		if (! (m & 1)) {
+			step_ctlr (sim, i, time_next);
 			need_bus_step = 1;
 
 			/* Подкрашиваем активный блок. */
 			ui_draw_ctlr (sim, i, 1);
-		} else
-			ui_draw_ctlr (sim, i, 0);
-
-		if (sim->node_time_last [i] + sim->node_time_step [i] - time_next <
-		    EPSILON) {
-			/* Процессор узла #i */
-			sim->node[i]->datain = sim->ctlr[i]->dataout;
-			sim->node[i]->ack    = sim->ctlr[i]->ack;
-			if (sim->rst[i]) {
-				/* Сброс процессора. */
-				cpu_reset (sim->node[i], 0);
-			} else
-				cpu_step (sim->node[i]);
-
-			/* TTP-контроллер узла #i, процессорная часть */
-			sim->ctlr[i]->datain = sim->node[i]->dataout;
-			sim->ctlr[i]->addr   = sim->node[i]->addr;
-			sim->ctlr[i]->rd     = sim->node[i]->rd;
-			sim->ctlr[i]->wrh    = sim->node[i]->wrh;
-			sim->ctlr[i]->wrl    = sim->node[i]->wrl;
-			ctlr_step_cpu (sim->ctlr[i]);
-
-			sim->node_time_last [i] = time_next;
+		} else {
+			step_cpu (sim, i, time_next);
 
 			/* Подкрашиваем активный блок. */
 			ui_draw_cpu (sim, i, 1);
-		} else
-			ui_draw_cpu (sim, i, 0);
+		}
+		queue_push (sim, m);
 	}
 
-	if (need_bus_step) {
-		/* Шины */
-		sim->bus0->rn0 = sim->ctlr[0]->tx;
-		sim->bus1->rn0 = sim->ctlr[0]->tx;
-		sim->bus0->rn1 = sim->ctlr[1]->tx;
-		sim->bus1->rn1 = sim->ctlr[1]->tx;
-#if NNODES > 2
-		sim->bus0->rn2 = sim->ctlr[2]->tx;
-		sim->bus1->rn2 = sim->ctlr[2]->tx;
-#else
-		sim->bus0->rn2 = 1;
-		sim->bus1->rn2 = 1;
-#endif
-#if NNODES > 3
-		sim->bus0->rn3 = sim->ctlr[3]->tx;
-		sim->bus1->rn3 = sim->ctlr[3]->tx;
-#else
-		sim->bus0->rn3 = 1;
-		sim->bus1->rn3 = 1;
-#endif
-		bus_step (sim->bus0);
-		bus_step (sim->bus1);
+	/* Снимаем подсветку с блоков, активных на прошлом шаге. */
+	for (k=0; k<sim->nactive; ++k) {
+		m = sim->active [k];
+		if (module_last (sim, m) == time_next)
+			continue;
+		if (m & 1)
+			ui_draw_cpu (sim, m >> 1, 0);
+		else
+			ui_draw_ctlr (sim, m >> 1, 0);
 	}
+	memcpy (sim->active, stepped, n * sizeof (int));
+	sim->nactive = n;
+
+	if (need_bus_step)
+		step_bus (sim);
 	++sim->nstep;
-	sim->time_usec = time_next;
+	sim->time = time_next;
+	sim->time_usec = (double) time_next / PS_PER_USEC;
+}
+
+/*
+ * Сообщение от узла, который моделируется в параллельном режиме.
+ * Запоминается в журнале узла, чтобы выдать сообщения в том же
+ * порядке, что и при последовательном моделировании.
+ * Возвращает 0, если вызвано не из такта узла.
+ */
+int simulator_log (const char *fmt, va_list ap)
+{
+	journal_t *j = journal_current;
+	message_t *msg;
+	char buf [512];
+
+	if (! j)
+		return 0;
+	vsnprintf (buf, sizeof(buf), fmt, ap);
+	if (j->count >= j->max) {
+		j->max = j->max ? j->max * 2 : 16;
+		j->msg = realloc (j->msg, j->max * sizeof (message_t));
+		if (! j->msg) {
+			fprintf (stderr, "Out of memory\n");
+			exit (1);
+		}
+	}
+	msg = &j->msg [j->count++];
+	msg->time = j->time;
+	msg->module = j->module;
+	msg->text = strdup (buf);
+	return 1;
+}
+
+/*
+ * Выдача сообщений из журналов всех узлов,
+ * по порядку моментов времени и номеров модулей.
+ */
+static void journal_flush (simulator_t *sim)
+{
+	journal_t *j, *first;
+	message_t *msg, *best;
+	int pos [MAXNODES];
+	int i;
+
+	memset (pos, 0, sim->nnodes * sizeof (int));
+	for (;;) {
+		best = 0;
+		first = 0;
+		for (i=0; i<sim->nnodes; ++i) {
+			j = &sim->pool->journal [i];
+			if (pos[i] >= j->count)
+				continue;
+			msg = &j->msg [pos[i]];
+			if (! best || msg->time < best->time ||
+			    (msg->time == best->time && msg->module < best->module)) {
+				best = msg;
+				first = j;
+			}
+		}
+		if (! best)
+			break;
+		printf ("%s", best->text);
+		free (best->text);
+		++pos [first - sim->pool->journal];
+	}
+	for (i=0; i<sim->nnodes; ++i)
+		sim->pool->journal[i].count = 0;
+}
+
+/*
+ * Моделирование узла #i до момента time_end включительно.
+ * Узел зависит от других только через шины, а шины не меняются
+ * до конца интервала, поэтому узлы моделируются независимо.
+ */
+static void node_run (simulator_t *sim, int i, simtime_t time_end)
+{
+	journal_t *j = &sim->pool->journal [i];
+	simtime_t tc, tp;
+
+	journal_current = j;
+	for (;;) {
+		tc = sim->ctlr_time_last [i] + sim->ctlr_time_step [i];
+		tp = sim->node_time_last [i] + sim->node_time_step [i];
+		if (tc <= tp) {
+			/* В один момент контроллер идёт раньше процессора. */
+			if (tc > time_end)
+				break;
+			j->time = tc;
+			j->module = 2*i;
+			step_ctlr (sim, i, tc);
+		} else {
+			if (tp > time_end)
+				break;
+			j->time = tp;
+			j->module = 2*i + 1;
+			step_cpu (sim, i, tp);
+		}
+	}
+	journal_current = 0;
+}
+
+/*
+ * Ожидание, пока счётчик сохраняет значение.
+ */
+static void pool_wait (unsigned *counter, unsigned value)
+{
+	int n = 0;
+
+	while (__atomic_load_n (counter, __ATOMIC_ACQUIRE) == value) {
+		if (++n > POOL_SPIN)
+			sched_yield ();
+	}
+}
+
+/*
+ * Доля интервала для одного потока: берём узлы по одному,
+ * пока они не кончатся.
+ */
+static void pool_run (simulator_t *sim)
+{
+	pool_t *pool = sim->pool;
+	int i;
+
+	for (;;) {
+		i = __atomic_fetch_add (&pool->next_node, 1, __ATOMIC_ACQ_REL);
+		if (i >= sim->nnodes)
+			break;
+		node_run (sim, i, pool->time_end);
+	}
+	__atomic_add_fetch (&pool->done, 1, __ATOMIC_ACQ_REL);
+}
+
+static void *pool_worker (void *arg)
+{
+	simulator_t *sim = arg;
+	unsigned epoch = 0;
+
+	for (;;) {
+		pool_wait (&sim->pool->epoch, epoch);
+		epoch++;
+		pool_run (sim);
+	}
+	return 0;
+}
+
+/*
+ * Количество шагов последовательного режима в интервале до time_end:
+ * различных моментов, в которые делает такт хотя бы один модуль.
+ */
+static unsigned long long count_steps (simulator_t *sim, simtime_t time_end)
+{
+	simtime_t next [2*MAXNODES], t;
+	unsigned long long n = 0;
+	int m, nmodules = 2*sim->nnodes;
+
+	for (m=0; m<nmodules; ++m)
+		next[m] = module_next (sim, m);
+	for (;;) {
+		t = next[0];
+		for (m=1; m<nmodules; ++m)
+			if (next[m] < t)
+				t = next[m];
+		if (t > time_end)
+			break;
+		++n;
+		for (m=0; m<nmodules; ++m)
+			if (next[m] == t)
+				next[m] += module_step (sim, m);
+	}
+	return n;
+}
+
+/*
+ * Один интервал параллельного режима: все узлы выполняют
+ * свои такты до ближайшего такта контроллеров, затем шаг шин.
+ * Последний интервал кончается на первом шаге не раньше until.
+ */
+static void simulator_parallel (simulator_t *sim, simtime_t until)
+{
+	pool_t *pool = sim->pool;
+	simtime_t time_ctlr, time_end, t;
+	int i, m, n;
+
+	time_ctlr = module_next (sim, 0);
+	for (i=1; i<sim->nnodes; ++i) {
+		t = module_next (sim, 2*i);
+		if (t < time_ctlr)
+			time_ctlr = t;
+	}
+	time_end = time_ctlr;
+	if (time_end >= until) {
+		for (m=0; m<2*sim->nnodes; ++m) {
+			t = module_next (sim, m);
+			if (t < until)
+				t += (until - t + module_step (sim, m) - 1) /
+					module_step (sim, m) * module_step (sim, m);
+			if (t < time_end)
+				time_end = t;
+		}
+	}
+	sim->nstep += count_steps (sim, time_end);
+
+	/* Запускаем потоки, главный поток работает вместе с ними. */
+	pool->time_end = time_end;
+	pool->next_node = 0;
+	pool->done = 0;
+	__atomic_add_fetch (&pool->epoch, 1, __ATOMIC_RELEASE);
+	pool_run (sim);
+	for (n=0; __atomic_load_n (&pool->done, __ATOMIC_ACQUIRE) != pool->nthreads; )
+		if (++n > POOL_SPIN)
+			sched_yield ();
+
+	journal_flush (sim);
+	if (time_end == time_ctlr)
+		step_bus (sim);
+	sim->time = time_end;
+	sim->time_usec = (double) time_end / PS_PER_USEC;
+}
+
+/*
+ * Моделирование до первого шага не раньше момента until.
+ * При нескольких потоках узлы моделируются параллельно,
+ * с тем же результатом, что и последовательно.
+ */
+void simulator_run (simulator_t *sim, simtime_t until)
+{
+	if (! sim->pool || sim->pool->nthreads < 2) {
+		while (sim->time < until)
+			simulator_step (sim);
+		return;
+	}
+	while (sim->time < until)
+		simulator_parallel (sim, until);
+
+	/* Очередь нужна для последующих одиночных шагов. */
+	sim->nactive = 0;
+	queue_build (sim);
+}
+
+/*
+ * Установка количества потоков для simulator_run().
+ * Вызывается один раз, после simulator_init().
+ */
+void simulator_set_threads (simulator_t *sim, int nthreads)
+{
+	pthread_t thread;
+	int i;
+
+	sim->pool = calloc (1, sizeof (pool_t));
+	if (! sim->pool) {
+		fprintf (stderr, "Out of memory\n");
+		exit (1);
+	}
+	sim->pool->nthreads = nthreads;
+	for (i=1; i<nthreads; ++i) {
+		if (pthread_create (&thread, 0, pool_worker, sim) != 0) {
+			fprintf (stderr, "Cannot create thread\n");
+			exit (1);
+		}
+	}
+	printf ("Using %d threads.\n", nthreads);
 }
 
 void simulator_set_cpu_frequency (simulator_t *sim, int node_num, int val)
 {
 	sim->cpu_mhz [node_num] = val;
 
-	/* Устанавливаем длительность такта процессора в микросекундах. */
-	sim->node_time_step [node_num] = 1.0 / sim->cpu_mhz [node_num];
+	/* Устанавливаем длительность такта процессора. */
+	sim->node_time_step [node_num] = (PS_PER_USEC + val/2) / val;
 	printf ("CPU %d frequency set to %d MHz, time step %g usec.\n",
-		node_num, sim->cpu_mhz [node_num], sim->node_time_step [node_num]);
+		node_num, sim->cpu_mhz [node_num],
+		(double) sim->node_time_step [node_num] / PS_PER_USEC);
+	queue_build (sim);
+}
+
+/*
+ * Длительность такта контроллера, с учётом точности частоты.
+ */
+static simtime_t ctlr_step (int mbps, int ppm)
+{
+	return ((long long) PS_PER_USEC + ppm + mbps/2) / mbps;
 }
 
 void simulator_set_bus_rate (simulator_t *sim, int val)
@@ -345,22 +759,23 @@ void simulator_set_bus_rate (simulator_t *sim, int val)
 	sim->bus_mbps = val;
 	printf ("Bus data rate changed to %d Mbps.\n", sim->bus_mbps);
 
-	/* Устанавливаем длительность такта контроллеров в микросекундах. */
-	for (i=0; i<NNODES; ++i) {
-		sim->ctlr_time_step [i] = (1.0 + sim->ctlr_ppm [i] / 1000000.0) /
-			sim->bus_mbps;
+	/* Устанавливаем длительность такта контроллеров. */
+	for (i=0; i<sim->nnodes; ++i) {
+		sim->ctlr_time_step [i] = ctlr_step (sim->bus_mbps, sim->ctlr_ppm [i]);
 		printf ("TTP controller %d time step %g usec.\n",
-			i, sim->ctlr_time_step [i]);
+			i, (double) sim->ctlr_time_step [i] / PS_PER_USEC);
 	}
+	queue_build (sim);
 }
 
 void simulator_set_ctlr_frequency (simulator_t *sim, int node_num, int val)
 {
 	sim->ctlr_ppm [node_num] = val;
 
-	/* Устанавливаем длительность такта контроллеров в микросекундах. */
-	sim->ctlr_time_step [node_num] = (1.0 + sim->ctlr_ppm [node_num] / 1000000.0) /
-		sim->bus_mbps;
+	/* Устанавливаем длительность такта контроллера. */
+	sim->ctlr_time_step [node_num] = ctlr_step (sim->bus_mbps, val);
 	printf ("TTP controller %d frequency precision set to %+d ppm, time step %g usec.\n",
-		node_num, sim->ctlr_ppm [node_num], sim->ctlr_time_step [node_num]);
+		node_num, sim->ctlr_ppm [node_num],
+		(double) sim->ctlr_time_step [node_num] / PS_PER_USEC);
+	queue_build (sim);
 }
@@ -93,7 +93,7 @@ static void mdlStart (SimStruct *S)
 	bus_t *c;
 	char *name;
 
-	c = bus_alloc ();
+	c = bus_alloc (4);
 	ssSetPWorkValue (S, 0, c);
 
 	name = strrchr (ssGetPath (S), '/');
@@ -112,10 +112,10 @@ static void mdlOutputs (SimStruct *S, int_T tid)
 	bus_t *c = (bus_t*) ssGetPWorkValue(S,0);
 
 	/* Входные порты */
-	c->rn0    = *(boolean_T*) ssGetInputPortSignal (S,0);
-	c->rn1    = *(boolean_T*) ssGetInputPortSignal (S,1);
-	c->rn2    = *(boolean_T*) ssGetInputPortSignal (S,2);
-	c->rn3    = *(boolean_T*) ssGetInputPortSignal (S,3);
+	c->rn[0]  = *(boolean_T*) ssGetInputPortSignal (S,0);
+	c->rn[1]  = *(boolean_T*) ssGetInputPortSignal (S,1);
+	c->rn[2]  = *(boolean_T*) ssGetInputPortSignal (S,2);
+	c->rn[3]  = *(boolean_T*) ssGetInputPortSignal (S,3);
 
 	bus_step (c);
 
@@ -11,6 +11,7 @@
  * version of the Common Public License.
  * http://www.opensource.org/licenses/cpl.php
  */
+#include <string.h>
 #include "GeneralHashFunctions.h"
 
 /*
@@ -158,3 +159,78 @@ unsigned int APHash (char *str, unsigned int len)
 	}
 	return hash;
 }
+
+/*
+ * FNV-1a Hash Function, 64-bit variant folded to 32 bits
+ */
+unsigned int FNV1aHash (char *str, unsigned int len)
+{
+	unsigned long long hash = 0xcbf29ce484222325ULL;
+	unsigned int i = 0;
+
+	for (i = 0; i < len; str++, i++) {
+		hash ^= (unsigned char)(*str);
+		hash *= 0x100000001b3ULL;
+	}
+	return (unsigned int) (hash ^ (hash >> 32));
+}
+
+/*
+ * Unaligned little-endian loads for word-at-a-time hashing.
+ */
+static inline unsigned long long load64 (const char *p)
+{
+	unsigned long long v;
+
+	memcpy (&v, p, sizeof (v));
+	return v;
+}
+
+static inline unsigned long long load32 (const char *p)
+{
+	unsigned int v;
+
+	memcpy (&v, p, sizeof (v));
+	return v;
+}
+
+/*
+ * Multiply 64x64 to 128 bits and fold halves together.
+ */
+static inline unsigned long long wymix (unsigned long long a,
+	unsigned long long b)
+{
+	__uint128_t r = (__uint128_t) a * b;
+
+	return (unsigned long long) r ^ (unsigned long long) (r >> 64);
+}
+
+/*
+ * WY Hash Function (wyhash-style mixer, 16 bytes per step)
+ */
+unsigned int WYHash (char *str, unsigned int len)
+{
+	const unsigned long long p0 = 0xa0761d6478bd642fULL;
+	const unsigned long long p1 = 0xe7037ed1a0b428dbULL;
+	const unsigned long long p2 = 0x8ebc6af09c88c6e3ULL;
+	unsigned long long seed = p0 ^ len;
+	unsigned long long a = 0, b = 0, hash;
+	unsigned int n = len;
+
+	for (; n > 16; str += 16, n -= 16)
+		seed = wymix (load64 (str) ^ p1, load64 (str + 8) ^ seed);
+
+	if (n >= 8) {
+		a = load64 (str);
+		b = load64 (str + n - 8);
+	} else if (n >= 4) {
+		a = load32 (str) << 32 | load32 (str + n - 4);
+	} else if (n > 0) {
+		a = (unsigned long long) (unsigned char) str[0] << 16 |
+		    (unsigned long long) (unsigned char) str[n >> 1] << 8 |
+		    (unsigned char) str[n - 1];
+	}
+	hash = wymix (a ^ p1, b ^ seed);
+	hash = wymix (hash ^ p2, len ^ p1);
+	return (unsigned int) (hash ^ (hash >> 32));
+}
@@ -25,4 +25,6 @@ unsigned int SDBMHash (char* str, unsigned int len);
 unsigned int DJBHash  (char* str, unsigned int len);
 unsigned int DEKHash  (char* str, unsigned int len);
 unsigned int APHash   (char* str, unsigned int len);
+unsigned int FNV1aHash (char* str, unsigned int len);
+unsigned int WYHash   (char* str, unsigned int len);
 #endif
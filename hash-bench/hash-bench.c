@@ -2,36 +2,86 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "GeneralHashFunctions.h"
 
-const char version[] = "1.0";
+const char version[] = "1.1";
 const char copyright[] = "Copyright (C) 2006 Serge Vakulenko";
 
 char *progname;
 
+struct hashtab {
+	const char	*name;
+	hash_function_t	func;
+} hashtab[] = {
+	{ "rs",		RSHash,		},
+	{ "js",		JSHash,		},
+	{ "pjw",	PJWHash,	},
+	{ "elf",	ELFHash,	},
+	{ "bkdr",	BKDRHash,	},
+	{ "sdbm",	SDBMHash,	},
+	{ "djb",	DJBHash,	},
+	{ "dek",	DEKHash,	},
+	{ "ap",		APHash,		},
+	{ "fnv",	FNV1aHash,	},
+	{ "wy",		WYHash,		},
+	{ 0,		0,		},
+};
+
+int hashnum = 0;		/* index in hashtab + 1, 0 when not set */
+int benchmode = 0;		/* measure speed and distribution */
+long benchkeys = 10000000;	/* number of keys to hash per function */
+volatile unsigned int bench_sink;
+int nthreads = 0;		/* hash mmapped file in parallel when > 0 */
+
 hash_function_t func = 0;
 
 /* options descriptor */
 static struct option longopts[] = {
-	{ "rs",		no_argument,	(int*) &func,	(int) RSHash, },
-	{ "js",		no_argument,	(int*) &func,	(int) JSHash, },
-	{ "pjw",	no_argument,	(int*) &func,	(int) PJWHash, },
-	{ "elf",	no_argument,	(int*) &func,	(int) ELFHash, },
-	{ "bkdr",	no_argument,	(int*) &func,	(int) BKDRHash, },
-	{ "sdbm",	no_argument,	(int*) &func,	(int) SDBMHash, },
-	{ "djb",	no_argument,	(int*) &func,	(int) DJBHash, },
-	{ "dek",	no_argument,	(int*) &func,	(int) DEKHash, },
-	{ "ap",		no_argument,	(int*) &func,	(int) APHash, },
-	{ 0,		0,		0,		0, },
+	{ "rs",		no_argument,		&hashnum,	1, },
+	{ "js",		no_argument,		&hashnum,	2, },
+	{ "pjw",	no_argument,		&hashnum,	3, },
+	{ "elf",	no_argument,		&hashnum,	4, },
+	{ "bkdr",	no_argument,		&hashnum,	5, },
+	{ "sdbm",	no_argument,		&hashnum,	6, },
+	{ "djb",	no_argument,		&hashnum,	7, },
+	{ "dek",	no_argument,		&hashnum,	8, },
+	{ "ap",		no_argument,		&hashnum,	9, },
+	{ "fnv",	no_argument,		&hashnum,	10, },
+	{ "wy",		no_argument,		&hashnum,	11, },
+	{ "bench",	no_argument,		&benchmode,	1, },
+	{ "keys",	required_argument,	0,		'k', },
+	{ "threads",	required_argument,	0,		'j', },
+	{ 0,		0,			0,		0, },
 };
 
+/*
+ * Words of the input file, loaded into memory for benchmarking.
+ */
+struct word {
+	char		*str;
+	unsigned int	len;
+};
+
+struct word *words;
+unsigned int nwords;
+unsigned long long nbytes;
+
 void usage ()
 {
 	fprintf (stderr, "Hash bench, Version %s, %s\n", version, copyright);
 	fprintf (stderr, "Usage:\n");
         fprintf (stderr, "\t%s [--rs | --js | --pjw | --elf | --bkdr | --sdbm |\n",
                 progname);
-        fprintf (stderr, "\t\t\t--djb | --dek | --ap] [file]\n");
+        fprintf (stderr, "\t\t\t--djb | --dek | --ap | --fnv | --wy]\n");
+        fprintf (stderr, "\t\t\t[--threads=N file | file]\n");
+        fprintf (stderr, "\t%s --bench [--keys=N] [--<hash>] [file]\n",
+                progname);
 	exit (-1);
 }
 
@@ -50,21 +100,378 @@ void bench ()
 	}
 }
 
+/*
+ * Part of mmapped input, hashed by one worker thread.
+ * The output is accumulated in a private buffer.
+ */
+struct chunk {
+	pthread_t	tid;
+	const char	*start, *end;
+	char		*out;
+	size_t		outlen, outalloc;
+};
+
+static const char hexdigit[] = "0123456789abcdef";
+
+/*
+ * Hash all lines of the chunk, in the same format as bench().
+ */
+void *bench_chunk (void *arg)
+{
+	struct chunk *c = arg;
+	const char *line, *next, *p;
+	unsigned int hash, len, i;
+	char *o;
+
+	for (line = c->start; line < c->end; line = next) {
+		next = memchr (line, '\n', c->end - line);
+		if (next)
+			next++;
+		else
+			next = c->end;
+		for (p = line; p < next; p++)
+			if (*p == '/' || *p == ' ' || *p == '\t' ||
+			    *p == '\f' || *p == '\r' || *p == '\n')
+				break;
+		len = p - line;
+		if (len == 0)
+			continue;
+		hash = func ((char*) line, len);
+
+		if (c->outlen + len + 11 > c->outalloc) {
+			c->outalloc = (c->outalloc + len + 11) * 2;
+			c->out = realloc (c->out, c->outalloc);
+			if (! c->out) {
+				fprintf (stderr, "%s: out of memory\n", progname);
+				exit (-1);
+			}
+		}
+		o = c->out + c->outlen;
+		memcpy (o, line, len);
+		o += len;
+		*o++ = ' ';
+		*o++ = ' ';
+		for (i=0; i<8; i++)
+			*o++ = hexdigit [hash >> (28 - i*4) & 15];
+		*o++ = '\n';
+		c->outlen = o - c->out;
+	}
+	return 0;
+}
+
+/*
+ * Map the file into memory, split it into line-aligned chunks
+ * and hash them on worker threads. Results are written in
+ * the original order.
+ */
+void bench_parallel (const char *filename)
+{
+	struct chunk *chunk;
+	struct stat st;
+	const char *text, *p;
+	size_t size;
+	int fd, i, err;
+
+	fd = open (filename, O_RDONLY);
+	if (fd < 0 || fstat (fd, &st) < 0) {
+		perror (filename);
+		exit (-1);
+	}
+	size = st.st_size;
+	if (size == 0)
+		return;
+	text = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (text == MAP_FAILED) {
+		perror (filename);
+		exit (-1);
+	}
+	close (fd);
+	madvise ((void*) text, size, MADV_SEQUENTIAL);
+
+	chunk = calloc (nthreads, sizeof (struct chunk));
+	if (! chunk) {
+		fprintf (stderr, "%s: out of memory\n", progname);
+		exit (-1);
+	}
+	p = text;
+	for (i=0; i<nthreads; i++) {
+		chunk[i].start = p;
+		if (i == nthreads-1) {
+			p = text + size;
+		} else {
+			/* Advance to the end of line past the nominal boundary. */
+			if (p < text + size * (i+1) / nthreads)
+				p = text + size * (i+1) / nthreads;
+			p = memchr (p, '\n', text + size - p);
+			p = p ? p + 1 : text + size;
+		}
+		chunk[i].end = p;
+		chunk[i].outalloc = (p - chunk[i].start) * 3 / 2 + 64;
+		chunk[i].out = malloc (chunk[i].outalloc);
+		if (! chunk[i].out) {
+			fprintf (stderr, "%s: out of memory\n", progname);
+			exit (-1);
+		}
+		err = pthread_create (&chunk[i].tid, 0, bench_chunk, &chunk[i]);
+		if (err) {
+			fprintf (stderr, "%s: cannot create thread: %s\n",
+				progname, strerror (err));
+			exit (-1);
+		}
+	}
+	for (i=0; i<nthreads; i++) {
+		pthread_join (chunk[i].tid, 0);
+		fwrite (chunk[i].out, 1, chunk[i].outlen, stdout);
+		free (chunk[i].out);
+	}
+	free (chunk);
+	munmap ((void*) text, size);
+}
+
+/*
+ * Read the whole stdin into memory and split it into words,
+ * the same way bench() does.
+ */
+void load_words ()
+{
+	char *text, *line, *next, *p;
+	size_t size = 0, alloc = 1024*1024, n;
+	unsigned int maxwords;
+
+	text = malloc (alloc + 1);
+	if (! text) {
+		fprintf (stderr, "%s: out of memory\n", progname);
+		exit (-1);
+	}
+	while ((n = fread (text + size, 1, alloc - size, stdin)) > 0) {
+		size += n;
+		if (size < alloc)
+			continue;
+		alloc *= 2;
+		text = realloc (text, alloc + 1);
+		if (! text) {
+			fprintf (stderr, "%s: out of memory\n", progname);
+			exit (-1);
+		}
+	}
+	text [size] = 0;
+
+	maxwords = 1024;
+	words = malloc (maxwords * sizeof (struct word));
+	nwords = 0;
+	nbytes = 0;
+	for (line = text; line < text + size; line = next) {
+		next = strchr (line, '\n');
+		if (next)
+			*next++ = 0;
+		else
+			next = text + size;
+		p = line;
+		strsep (&p, "/ \t\f\r");
+		if (! *line)
+			continue;
+		if (nwords >= maxwords) {
+			maxwords *= 2;
+			words = realloc (words, maxwords * sizeof (struct word));
+		}
+		if (! words) {
+			fprintf (stderr, "%s: out of memory\n", progname);
+			exit (-1);
+		}
+		words[nwords].str = line;
+		words[nwords].len = strlen (line);
+		nbytes += words[nwords].len;
+		nwords++;
+	}
+}
+
+double now ()
+{
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int is_prime (unsigned int n)
+{
+	unsigned int d;
+
+	if (n < 2)
+		return 0;
+	for (d = 2; d * d <= n; d++)
+		if (n % d == 0)
+			return 0;
+	return 1;
+}
+
+int compare_hash (const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int*) a;
+	unsigned int y = *(const unsigned int*) b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Chi-square of bucket occupancy, divided by degrees of freedom.
+ * Uniform distribution gives values close to 1.0.
+ */
+double chi_square (unsigned int *hash, unsigned int *count,
+	unsigned int tabsize, int pow2)
+{
+	double expected = (double) nwords / tabsize, chi2 = 0, d;
+	unsigned int i;
+
+	memset (count, 0, tabsize * sizeof (unsigned int));
+	for (i = 0; i < nwords; i++) {
+		if (pow2)
+			count [hash[i] & (tabsize - 1)]++;
+		else
+			count [hash[i] % tabsize]++;
+	}
+	for (i = 0; i < tabsize; i++) {
+		d = count[i] - expected;
+		chi2 += d * d / expected;
+	}
+	return chi2 / (tabsize - 1);
+}
+
+/*
+ * Measure speed and distribution quality of one hash function.
+ */
+void bench_speed (struct hashtab *h, unsigned int *hash, unsigned int *sorted,
+	unsigned int *count, unsigned int pow2size, unsigned int primesize)
+{
+	unsigned int i, iter, niter, dups, sink = 0;
+	double t0, elapsed;
+
+	/* Compute hashes once, this also warms up the caches. */
+	for (i = 0; i < nwords; i++)
+		hash[i] = h->func (words[i].str, words[i].len);
+
+	niter = (benchkeys + nwords - 1) / nwords;
+	if (niter < 1)
+		niter = 1;
+	t0 = now ();
+	for (iter = 0; iter < niter; iter++)
+		for (i = 0; i < nwords; i++)
+			sink += h->func (words[i].str, words[i].len);
+	elapsed = now () - t0;
+
+	/* Full 32-bit collisions. */
+	memcpy (sorted, hash, nwords * sizeof (unsigned int));
+	qsort (sorted, nwords, sizeof (unsigned int), compare_hash);
+	dups = 0;
+	for (i = 1; i < nwords; i++)
+		if (sorted[i] == sorted[i-1])
+			dups++;
+
+	printf ("%-6s %8.2f %8.3f %6u %10.3f %10.3f\n", h->name,
+		elapsed * 1e9 / ((double) niter * nwords),
+		(double) niter * nbytes / elapsed / 1e9, dups,
+		chi_square (hash, count, pow2size, 1),
+		chi_square (hash, count, primesize, 0));
+
+	/* Keep the compiler from dropping the timed loop. */
+	bench_sink += sink;
+}
+
+void bench_all ()
+{
+	unsigned int *hash, *sorted, *count, pow2size, primesize;
+	struct hashtab *h;
+
+	load_words ();
+	if (nwords < 2) {
+		fprintf (stderr, "%s: not enough words\n", progname);
+		exit (-1);
+	}
+
+	/* Table sizes: power of two and prime, with load factor about 1. */
+	for (pow2size = 2; pow2size < nwords; pow2size <<= 1)
+		continue;
+	for (primesize = nwords; ! is_prime (primesize); primesize++)
+		continue;
+
+	hash = malloc (nwords * sizeof (unsigned int));
+	sorted = malloc (nwords * sizeof (unsigned int));
+	count = malloc ((pow2size > primesize ? pow2size : primesize) *
+		sizeof (unsigned int));
+	if (! hash || ! sorted || ! count) {
+		fprintf (stderr, "%s: out of memory\n", progname);
+		exit (-1);
+	}
+
+	printf ("%u words, %llu bytes, %ld keys per function\n",
+		nwords, nbytes, benchkeys);
+	printf ("%-6s %8s %8s %6s %10s %10s\n", "hash", "ns/key", "GB/s",
+		"dups", "chi2/2^n", "chi2/prime");
+	printf ("%-6s %8s %8s %6s %10u %10u\n", "", "", "", "",
+		pow2size, primesize);
+
+	if (func) {
+		bench_speed (&hashtab[hashnum-1], hash, sorted, count,
+			pow2size, primesize);
+	} else {
+		for (h=hashtab; h->name; h++)
+			bench_speed (h, hash, sorted, count,
+				pow2size, primesize);
+	}
+	free (hash);
+	free (sorted);
+	free (count);
+}
+
 int main (int argc, char **argv)
 {
+	int c;
+
 	progname = *argv;
-	while (getopt_long (argc, argv, "", longopts, 0) >= 0)
-		continue;
+	while ((c = getopt_long (argc, argv, "", longopts, 0)) >= 0) {
+		switch (c) {
+		case 0:
+			break;
+		case 'j':
+			nthreads = strtol (optarg, 0, 0);
+			if (nthreads <= 0)
+				usage ();
+			break;
+		case 'k':
+			benchkeys = strtol (optarg, 0, 0);
+			if (benchkeys <= 0)
+				usage ();
+			break;
+		default:
+			usage ();
+		}
+	}
 	argc -= optind;
 	argv += optind;
 
-	if (! func || argc > 1)
+	if (hashnum)
+		func = hashtab[hashnum-1].func;
+	if ((! func && ! benchmode) || argc > 1)
 		usage ();
+	if (nthreads && benchmode) {
+		fprintf (stderr, "%s: --threads cannot be used with --bench\n",
+			progname);
+		exit (-1);
+	}
+	if (nthreads) {
+		if (argc < 1)
+			usage ();
+		bench_parallel (argv[0]);
+		return (0);
+	}
 
 	if (argc > 0 && ! freopen (argv[0], "r", stdin)) {
 		perror (argv[0]);
 		exit (-1);
 	}
-	bench ();
+	if (benchmode)
+		bench_all ();
+	else
+		bench ();
 	return (0);
 }
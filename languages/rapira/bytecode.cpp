@@ -0,0 +1,101 @@
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "bytecode.h"
+#include <iostream>
+#include <iomanip>
+#include "object.h"
+
+/*** Names of the instructions, for listings ***/
+static const char* names[BC_COUNT] =
+{
+	"nop", "const", "load", "store", "pop", "over", "jump", "jumpfalse",
+	"jumptrue", "add", "subtract", "multiply", "divide", "intdivide",
+	"remainder", "exponent", "equal", "unequal", "greater", "less",
+	"greateq", "lesseq", "and", "or", "negate", "not", "length", "select",
+	"slice", "sequence", "call", "output", "newline", "selectassign",
+	"sliceassign", "forinit", "fortest", "forstep", "repeatinit",
+	"repeattest", "repeatstep", "return", "leave", "execute", "evaluate"
+};
+
+/*** Constructor ***/
+Bytecode::Bytecode()
+{
+}
+
+/*** Append an instruction, return its address ***/
+unsigned int Bytecode::emit(unsigned char op, int arg, Node* node)
+{
+	Instruction ins;
+	ins.op = op;
+	ins.arg = arg;
+	ins.node = node;
+	code.push_back(ins);
+	return code.size() - 1;
+}
+
+/*** Get the address of the next instruction ***/
+unsigned int Bytecode::getLength()
+{
+	return code.size();
+}
+
+/*** Get an instruction ***/
+Instruction& Bytecode::getInstruction(unsigned int address)
+{
+	return code.at(address);
+}
+
+/*** Get the first instruction ***/
+Instruction* Bytecode::getStart()
+{
+	return &code[0];
+}
+
+/*** Add a constant, return its index ***/
+unsigned int Bytecode::addConstant(Object* obj)
+{
+	constants.push_back(obj);
+	return constants.size() - 1;
+}
+
+/*** Get a constant ***/
+Object* Bytecode::getConstant(unsigned int index)
+{
+	return constants[index];
+}
+
+/*** Print a listing of the code ***/
+void Bytecode::dump()
+{
+	for(unsigned int i = 0; i < code.size(); i++)
+	{
+		std::cout << std::setw(5) << i << "  " << std::setw(12) << std::left << names[code[i].op] << std::right;
+		std::cout << std::setw(6) << code[i].arg;
+		if(code[i].node != 0)
+			std::cout << "   ; line " << code[i].node->getLineNumber();
+		std::cout << std::endl;
+	}
+}
+
+/*** Destructor ***/
+Bytecode::~Bytecode()
+{
+	for(unsigned int i = 0; i < constants.size(); i++)
+		delete constants.at(i);
+}
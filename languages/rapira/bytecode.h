@@ -0,0 +1,130 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+
+class Node;
+class Object;
+
+/*** Bytecode instructions ***/
+#define BC_NOP				0	// Do nothing
+#define BC_CONST			1	// Push a copy of constant <arg>
+#define BC_LOAD				2	// Push the value of a variable
+#define BC_STORE			3	// Pop a value into the target of an assignment
+#define BC_POP				4	// Drop the top of the stack
+#define BC_OVER				5	// Push a copy of the value below the top
+#define BC_JUMP				6	// Jump to <arg>
+#define BC_JUMPFALSE		7	// Pop a logical, jump to <arg> if false
+#define BC_JUMPTRUE			8	// Pop a logical, jump to <arg> if true
+#define BC_ADD				9
+#define BC_SUBTRACT			10
+#define BC_MULTIPLY			11
+#define BC_DIVIDE			12
+#define BC_INTDIVIDE		13
+#define BC_REMAINDER		14
+#define BC_EXPONENT			15
+#define BC_EQUAL			16
+#define BC_UNEQUAL			17
+#define BC_GREATER			18
+#define BC_LESS				19
+#define BC_GREATEQ			20
+#define BC_LESSEQ			21
+#define BC_AND				22
+#define BC_OR				23
+#define BC_NEGATE			24
+#define BC_NOT				25
+#define BC_LENGTH			26
+#define BC_SELECT			27
+#define BC_SLICE			28	// <arg> bit 0: lower index, bit 1: upper index
+#define BC_SEQUENCE			29	// Pop <arg> values into a new sequence
+#define BC_CALL				30	// Call with <arg> arguments
+#define BC_OUTPUT			31	// Pop and print a value
+#define BC_NEWLINE			32
+#define BC_SELECTASSIGN		33
+#define BC_SLICEASSIGN		34
+#define BC_FORINIT			35	// Pop the initial value of a for loop counter
+#define BC_FORTEST			36	// Pop step and limit, jump to <arg> when done
+#define BC_FORSTEP			37	// Pop step, advance the for loop counter
+#define BC_REPEATINIT		38	// Check the repeat counter on the stack
+#define BC_REPEATTEST		39	// Jump to <arg> when the repeat counter is zero
+#define BC_REPEATSTEP		40	// Decrement the repeat counter
+#define BC_RETURN			41	// Pop a value and return it
+#define BC_LEAVE			42	// Leave with status <arg>
+#define BC_EXECUTE			43	// Execute a node by walking the tree
+#define BC_EVALUATE			44	// Evaluate an object by walking the tree
+#define BC_COUNT			45
+
+/*** A single bytecode instruction ***/
+struct Instruction
+{
+	/*** The operation code ***/
+	unsigned char op;
+
+	/*** The operand: a constant index, a jump target or a count ***/
+	int arg;
+
+	/*** The node which produced this instruction ***/
+	Node* node;
+};
+
+class Bytecode
+{
+
+	public:
+
+		/*** Constructor ***/
+		Bytecode();
+
+		/*** Append an instruction, return its address ***/
+		unsigned int emit(unsigned char op, int arg, Node* node);
+
+		/*** Get the address of the next instruction ***/
+		unsigned int getLength();
+
+		/*** Get an instruction ***/
+		Instruction& getInstruction(unsigned int address);
+
+		/*** Get the first instruction ***/
+		Instruction* getStart();
+
+		/*** Add a constant, return its index ***/
+		unsigned int addConstant(Object* obj);
+
+		/*** Get a constant ***/
+		Object* getConstant(unsigned int index);
+
+		/*** Print a listing of the code ***/
+		void dump();
+
+		/*** Destructor ***/
+		~Bytecode();
+
+	private:
+
+		/*** The instructions ***/
+		std::vector<Instruction> code;
+
+		/*** The constant pool ***/
+		std::vector<Object*> constants;
+
+};
+
+#endif
@@ -0,0 +1,116 @@
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "compiler.h"
+#include "node.h"
+#include "object.h"
+
+/*** Constructor ***/
+Compiler::Compiler(Bytecode* pCode)
+{
+	code = pCode;
+}
+
+/*** Compile a statement or a list of statements ***/
+Bytecode* Compiler::compile(Node* node)
+{
+	Bytecode* result = new Bytecode();
+	Compiler compiler(result);
+	node->compileExecute(compiler);
+	compiler.emit(BC_LEAVE, S_SUCCESS, 0);
+	compiler.finish();
+	return result;
+}
+
+/*** Append an instruction ***/
+unsigned int Compiler::emit(unsigned char op, int arg, Node* node)
+{
+	return code->emit(op, arg, node);
+}
+
+/*** Append an instruction which refers to a label ***/
+void Compiler::emitJump(unsigned char op, unsigned int label, Node* node)
+{
+	fixups.push_back(code->emit(op, label, node));
+}
+
+/*** Append a load of a constant ***/
+void Compiler::emitConstant(Object* obj, Node* node)
+{
+	code->emit(BC_CONST, code->addConstant(obj), node);
+}
+
+/*** Append an exit from the innermost loop ***/
+void Compiler::emitExit(Node* node)
+{
+	if(exits.empty())
+		code->emit(BC_LEAVE, S_EXIT, node);
+	else
+		emitJump(BC_JUMP, exits.back(), node);
+}
+
+/*** Append a tree walking execution of a node ***/
+void Compiler::emitExecute(Node* node)
+{
+	// An exit status of the node continues at the exit label
+	if(exits.empty())
+		code->emit(BC_EXECUTE, -1, node);
+	else
+		emitJump(BC_EXECUTE, exits.back(), node);
+}
+
+/*** Create a new label ***/
+unsigned int Compiler::newLabel()
+{
+	labels.push_back(-1);
+	return labels.size() - 1;
+}
+
+/*** Bind a label to the next instruction ***/
+void Compiler::setLabel(unsigned int label)
+{
+	labels.at(label) = code->getLength();
+}
+
+/*** Enter a loop, exits will jump to the label ***/
+void Compiler::pushExit(unsigned int label)
+{
+	exits.push_back(label);
+}
+
+/*** Leave a loop ***/
+void Compiler::popExit()
+{
+	exits.pop_back();
+}
+
+/*** Resolve the labels ***/
+void Compiler::finish()
+{
+	for(unsigned int i = 0; i < fixups.size(); i++)
+	{
+		Instruction& ins = code->getInstruction(fixups.at(i));
+		ins.arg = labels.at(ins.arg);
+	}
+	fixups.clear();
+}
+
+/*** Destructor ***/
+Compiler::~Compiler()
+{
+}
@@ -0,0 +1,85 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include "bytecode.h"
+
+class Compiler
+{
+
+	public:
+
+		/*** Constructor ***/
+		Compiler(Bytecode* pCode);
+
+		/*** Compile a statement or a list of statements ***/
+		static Bytecode* compile(Node* node);
+
+		/*** Append an instruction ***/
+		unsigned int emit(unsigned char op, int arg, Node* node);
+
+		/*** Append an instruction which refers to a label ***/
+		void emitJump(unsigned char op, unsigned int label, Node* node);
+
+		/*** Append a load of a constant ***/
+		void emitConstant(Object* obj, Node* node);
+
+		/*** Append an exit from the innermost loop ***/
+		void emitExit(Node* node);
+
+		/*** Append a tree walking execution of a node ***/
+		void emitExecute(Node* node);
+
+		/*** Create a new label ***/
+		unsigned int newLabel();
+
+		/*** Bind a label to the next instruction ***/
+		void setLabel(unsigned int label);
+
+		/*** Enter a loop, exits will jump to the label ***/
+		void pushExit(unsigned int label);
+
+		/*** Leave a loop ***/
+		void popExit();
+
+		/*** Resolve the labels ***/
+		void finish();
+
+		/*** Destructor ***/
+		~Compiler();
+
+	private:
+
+		/*** The code being generated ***/
+		Bytecode* code;
+
+		/*** The addresses of labels, or -1 when not bound yet ***/
+		std::vector<int> labels;
+
+		/*** The addresses of instructions which refer to labels ***/
+		std::vector<unsigned int> fixups;
+
+		/*** The stack of exit labels of enclosing loops ***/
+		std::vector<unsigned int> exits;
+
+};
+
+#endif
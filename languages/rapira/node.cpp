@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "node.h"
+#include "compiler.h"
 
 /*** Constructor ***/
 Node::Node()
@@ -55,3 +56,9 @@ unsigned int Node::getColumnNumber() const
 {
 	return colNum;
 }
+
+/*** Compile this node into bytecode ***/
+void Node::compileExecute(Compiler& compiler)
+{
+	compiler.emitExecute(this);
+}
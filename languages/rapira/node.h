@@ -21,6 +21,8 @@
 
 #include "outcome.h"
 
+class Compiler;
+
 class Node
 {
 
@@ -50,6 +52,9 @@ class Node
 			return Outcome();
 		}
 
+		/*** Compile this node into bytecode ***/
+		virtual void compileExecute(Compiler& compiler);
+
 		/*** Clone this node ***/
 		virtual Node* clone() const { return new Node(*this); }
 
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nodelist.h"
+#include "compiler.h"
 
 /*** Constructor ***/
 NodeList::NodeList()
@@ -86,6 +87,13 @@ Outcome NodeList::execute()
 	return Outcome(S_SUCCESS);
 }
 
+/*** Compile this list into bytecode ***/
+void NodeList::compileExecute(Compiler& compiler)
+{
+	for(unsigned int i = 0; i < getLength(); i++)
+		getNode(i)->compileExecute(compiler);
+}
+
 /*** Destructor ***/
 NodeList::~NodeList()
 {
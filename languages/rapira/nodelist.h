@@ -54,6 +54,9 @@ class NodeList : public Node
 		/*** Execute this list ***/
 		Outcome execute();
 
+		/*** Compile this list into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		NodeList* clone() const
 		{
@@ -1,4 +1,5 @@
 #include "object.h"
+#include "compiler.h"
 
 // ReRap Version 0.9
 // Copyright 2011 Matthew Mikolay.
@@ -28,3 +29,15 @@ Outcome Object::execute()
 {
 	return Outcome(S_SUCCESS);
 }
+
+/*** Evaluate this object to a value ***/
+Value Object::evaluateValue()
+{
+	return Value(evaluate());
+}
+
+/*** Compile the evaluation of this object into bytecode ***/
+void Object::compileEvaluate(Compiler& compiler)
+{
+	compiler.emit(BC_EVALUATE, 0, this);
+}
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include "node.h"
+#include "value.h"
 
 /*** Rapira primitive types ***/
 #define OBJ_EMPTY			0
@@ -83,6 +84,12 @@ class Object : public Node
 			return clone();
 		}
 
+		/*** Evaluate this object to a value ***/
+		virtual Value evaluateValue();
+
+		/*** Compile the evaluation of this object into bytecode ***/
+		virtual void compileEvaluate(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Object* clone() const { return new Object(*this); }
 
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "add.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Add::Add()
@@ -52,121 +53,146 @@ void Add::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Add::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Add::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj1->getType() == OBJ_EMPTY)
-		return obj2->clone();
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Add::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() == OBJ_EMPTY)
+		return obj2;
 
-	if(obj2->getType() == OBJ_EMPTY)
-		return obj1->clone();
+	if(obj2.getType() == OBJ_EMPTY)
+		return obj1;
 
-	if(obj1->getType() == OBJ_INTEGER)
+	if(obj1.getType() == OBJ_INTEGER)
 	{
-		Integer* cast1 = static_cast<Integer*>(obj1.get());
+		long value1 = obj1.getInteger();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Integer(cast1->getValue() + cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeInteger(value1 + value2);
 		}
 		
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(cast1->getValue() + cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeReal(value1 + value2);
 		}
 		
-		if(obj2->getType() == OBJ_TEXT)
+		if(obj2.getType() == OBJ_TEXT)
 		{
-			Text* cast2 = static_cast<Text*>(obj2.get());
+			Text* cast2 = static_cast<Text*>(obj2.getObject());
 			std::stringstream ss;
-			ss << cast1->getValue();
-			return new Text(ss.str() + cast2->getValue());
+			ss << value1;
+			return Value(new Text(ss.str() + cast2->getValue()));
 		}
 
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_REAL)
+	if(obj1.getType() == OBJ_REAL)
 	{
-		Real* cast1 = static_cast<Real*>(obj1.get());
+		double value1 = obj1.getReal();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Real(cast1->getValue() + cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeReal(value1 + value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(cast1->getValue() + cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeReal(value1 + value2);
 		}
 
-		if(obj2->getType() == OBJ_TEXT)
+		if(obj2.getType() == OBJ_TEXT)
 		{
-			Text* cast2 = static_cast<Text*>(obj2.get());
+			Text* cast2 = static_cast<Text*>(obj2.getObject());
 			std::stringstream ss;
-			ss << cast1->getValue();
-			return new Text(ss.str() + cast2->getValue());
+			ss << value1;
+			return Value(new Text(ss.str() + cast2->getValue()));
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(obj1.getType() == OBJ_TEXT)
 	{
-		Text* cast1 = static_cast<Text*>(obj1.get());
+		Text* cast1 = static_cast<Text*>(obj1.getObject());
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
+			long value2 = obj2.getInteger();
 			std::stringstream ss;
-			ss << cast2->getValue();
-			return new Text(cast1->getValue() + ss.str());
+			ss << value2;
+			return Value(new Text(cast1->getValue() + ss.str()));
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
+			double value2 = obj2.getReal();
 			std::stringstream ss;
-			ss << cast2->getValue();
-			return new Text(cast1->getValue() + ss.str());
+			ss << value2;
+			return Value(new Text(cast1->getValue() + ss.str()));
 		}
 
-		if(obj2->getType() == OBJ_TEXT)
+		if(obj2.getType() == OBJ_TEXT)
 		{
-			Text* cast2 = static_cast<Text*>(obj2.get());
-			return new Text(cast1->getValue() + cast2->getValue());
+			Text* cast2 = static_cast<Text*>(obj2.getObject());
+			return Value(new Text(cast1->getValue() + cast2->getValue()));
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(obj1.getType() == OBJ_SEQUENCE)
 	{
-		if(obj2->getType() != OBJ_SEQUENCE)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_SEQUENCE)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, obj2.getType(), 2);
 
-		Sequence* cast1 = static_cast<Sequence*>(obj1.get());
-		Sequence* cast2 = static_cast<Sequence*>(obj2.get());
+		Sequence* cast1 = static_cast<Sequence*>(obj1.getObject());
+		Sequence* cast2 = static_cast<Sequence*>(obj2.getObject());
 
-		Sequence* seqResult = new Sequence(cast1->getList());
+		Sequence* seqResult = cast1->clone();
 		for(unsigned int i = 0; i < cast2->getLength(); i++)
 			seqResult->pushObject(cast2->getObject(i)->clone());
 
-		return seqResult;
+		return Value(seqResult);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj2.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Add::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj2->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_ADD, 0, this);
 }
 
 /*** Destructor ***/
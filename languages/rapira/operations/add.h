@@ -49,6 +49,15 @@ class Add : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
+		/*** Apply this operation to evaluated arguments ***/
+		Value apply(const Value& obj1, const Value& obj2);
+
+		/*** Compile the evaluation of this object ***/
+		void compileEvaluate(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Add* clone() const
 		{
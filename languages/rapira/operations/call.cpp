@@ -17,17 +17,23 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "call.h"
+#include "../compiler.h"
+#include "../vm.h"
 
 /*** Constructor ***/
 Call::Call()
 {
 	setIdentifier(0);
+	calledScope = 0;
+	calledSlot = 0;
 }
 
 /*** Constructor ***/
 Call::Call(Object* pIden)
 {
 	setIdentifier(pIden);
+	calledScope = 0;
+	calledSlot = 0;
 }
 
 /*** Get this operation's type ***/
@@ -79,30 +85,62 @@ Object* Call::evaluate()
 		return retVal.release();
 	}
 
+	checkProcedure(idenEval.get());
+
+	// Evaluate the arguments
+	std::vector<Object*> values;
+	try
+	{
+		for(unsigned int i = 0; i < args.size(); i++)
+			values.push_back(args.at(i).first->evaluate());
+	}
+	catch(Excep& e)
+	{
+		for(unsigned int i = 0; i < values.size(); i++)
+			delete values.at(i);
+		throw;
+	}
+
+	return invoke(static_cast<Procedure*>(idenEval.get()), values, false);
+}
+
+/*** Apply this call to an evaluated procedure and arguments ***/
+Object* Call::apply(Object* idenEval, std::vector<Object*>& values)
+{
+	// Execute a special function with the argument values
+	if(idenEval->getType() == OBJ_SPFUNCTION)
+	{
+		SpecialFunction* spf = static_cast<SpecialFunction*>(idenEval);
+		for(unsigned int i = 0; i < args.size(); i++)
+			if(args.at(i).second == true)
+				throw Excep(getLineNumber(), getColumnNumber(), "Special functions cannot receive in-out arguments!");
+
+		for(unsigned int i = 0; i < values.size(); i++)
+		{
+			spf->addArgument(values.at(i));
+			values.at(i) = 0;
+		}
+		return spf->evaluate();
+	}
+
+	checkProcedure(idenEval);
+	return invoke(static_cast<Procedure*>(idenEval), values, true);
+}
+
+/*** Check that a procedure can be called with the arguments ***/
+void Call::checkProcedure(Object* idenEval)
+{
 	// Confirm that the given object is a procedure or function
 	if(idenEval->getType() != OBJ_PROCEDURE && idenEval->getType() != OBJ_FUNCTION)
 		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_PROCEDURE | OBJ_FUNCTION, idenEval->getType());
 
-	// Cast the evaluated identifier to a procedure
-	std::auto_ptr<Procedure> proc(static_cast<Procedure*>(idenEval.release()));
+	Procedure* proc = static_cast<Procedure*>(idenEval);
 
 	// Confirm that the number of arguments in this call
 	// is equal to the number of parameters accepted by the procedure
-	if(proc->getParameters().size() != args.size())
+	if(proc->getParameterCount() != args.size())
 		throw Excep(getLineNumber(), getColumnNumber(), "Invalid number of arguments passed to procedure or function!");
 
-	// Create a vector of pair of strings
-	// First : <<< old name >>>
-	// Second :<<< new name>>>
-	std::vector< std::pair<std::string, std::string> > transfer;
-
-	// Create a new Variable Manager
-	VariableManager manager;
-
-	// Create a vector to store the evaluated arguments,
-	// which will later be added to the variable manager
-	std::vector< std::pair<std::string, Object*> > addArgs;
-
 	// Loop through the arguments making sure they match the corresponding parameter type
 	for(unsigned int i = 0; i < args.size(); i++)
 	{
@@ -112,34 +150,40 @@ Object* Call::evaluate()
 			throw Excep(getLineNumber(), getColumnNumber(), "Functions cannot receive in-out arguments!");
 
 		// Compare procedure and argument types
-		if(args.at(i).second != proc->getParameters().at(i).second)
+		if(args.at(i).second != proc->isInOutParameter(i))
 			throw Excep(getLineNumber(), getColumnNumber(), "Argument in/in-out type did not match parameter in/in-out type!");
-
-		// Evaluate the argument
-		std::auto_ptr<Object> argEval(args.at(i).first->evaluate());
-
-		// If this argument is a variable and
-		// in-out, keep track of it!
-		if(args.at(i).first->getType() == OP_VARIABLE && args.at(i).second == true)
-			transfer.push_back(std::pair<std::string, std::string>(static_cast<Variable*>(args.at(i).first)->getIdentifier(), proc->getParameters().at(i).first->getIdentifier()));
-
-		// Push a new variable onto addArgs
-		// It has the identifier of the corresponding parameter
-		// And the value of the corresponding argument
-		addArgs.push_back(std::pair<std::string, Object*>(proc->getParameterVariable(i)->getIdentifier(), argEval.release()));
 	}
+}
+
+/*** Run a procedure, the argument values are taken over ***/
+Object* Call::invoke(Procedure* proc, std::vector<Object*>& values, bool compiled)
+{
+	// Create a new Variable Manager
+	VariableManager manager;
 
-	// Push a new entry onto the Variable Manager
-	manager.pushEntry();
+	// Push a new entry for the procedure's scope
+	Scope* scope = proc->getScope();
+	manager.pushEntry(scope);
 
 	// Add a reference to the procedure which was
 	// called to the variable manager
 	if(iden->getType() == OP_VARIABLE)
-		manager.setObject(static_cast<Variable*>(iden)->getIdentifier(), proc->clone());
+	{
+		// The slot is looked up once for each procedure called from here
+		if(calledScope != scope)
+		{
+			calledSlot = scope->resolve(static_cast<Variable*>(iden)->getIdentifier());
+			calledScope = scope;
+		}
+		manager.setObject(calledSlot, proc->clone());
+	}
 
-	// Loop through addArgs, adding to the Variable Manager
-	for(unsigned int i = 0; i < addArgs.size(); i++)
-		manager.setObject(addArgs.at(i).first, addArgs.at(i).second);
+	// Bind the argument values to the parameters
+	for(unsigned int i = 0; i < values.size(); i++)
+	{
+		proc->getParameterVariable(i)->setBinding(values.at(i));
+		values.at(i) = 0;
+	}
 
 	// Execute any intern command
 	if(proc->getIntern() != 0)
@@ -151,12 +195,22 @@ Object* Call::evaluate()
 
 	// Execute the statements of the procedure
 	std::auto_ptr<Object> retVal;
-	Outcome retOut = proc->execute();
+	Outcome retOut = compiled ? VirtualMachine().run(proc->getCode()) : proc->execute();
 	retVal.reset(retOut.getObject());
 
-	// Use the transfer vector to set the variables on the lower level to the ones on the current level
-	for(unsigned int i = 0; i < transfer.size(); i++)
-		manager.setTopLevelObject(transfer.at(i).first, manager.getObject(transfer.at(i).second)->clone());
+	// Set the in-out variables on the lower level to the ones on the current level
+	for(unsigned int i = 0; i < args.size(); i++)
+	{
+		if(args.at(i).first->getType() == OP_VARIABLE && args.at(i).second == true)
+		{
+			Variable* arg = static_cast<Variable*>(args.at(i).first);
+			Object* result = proc->getParameterVariable(i)->getBinding()->clone();
+			if(arg->getSlot() >= 0)
+				manager.setTopLevelObject((unsigned int) arg->getSlot(), result);
+			else
+				manager.setTopLevelObject(arg->getIdentifier(), result);
+		}
+	}
 
 	// Transfer any modified extern variables to the lower level
 	if(proc->getExtern() != 0)
@@ -173,6 +227,28 @@ Object* Call::evaluate()
 	return retVal.release();
 }
 
+/*** Compile the evaluation of this object ***/
+void Call::compileEvaluate(Compiler& compiler)
+{
+	if(iden == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
+	}
+
+	iden->compileEvaluate(compiler);
+	for(unsigned int i = 0; i < args.size(); i++)
+		args.at(i).first->compileEvaluate(compiler);
+	compiler.emit(BC_CALL, args.size(), this);
+}
+
+/*** Compile this node as a statement ***/
+void Call::compileExecute(Compiler& compiler)
+{
+	compileEvaluate(compiler);
+	compiler.emit(BC_POP, 0, this);
+}
+
 /*** Destructor ***/
 Call::~Call()
 {
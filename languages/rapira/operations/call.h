@@ -58,6 +58,15 @@ class Call : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Apply this call to an evaluated procedure and arguments ***/
+		Object* apply(Object* idenEval, std::vector<Object*>& values);
+
+		/*** Compile the evaluation of this object ***/
+		void compileEvaluate(Compiler& compiler);
+
+		/*** Compile this node as a statement ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Call* clone() const
 		{
@@ -76,12 +85,24 @@ class Call : public Object
 
 	private:
 
+		/*** Check that a procedure can be called with the arguments ***/
+		void checkProcedure(Object* idenEval);
+
+		/*** Run a procedure, the argument values are taken over ***/
+		Object* invoke(Procedure* proc, std::vector<Object*>& values, bool compiled);
+
 		/*** The identifier ***/
 		Object* iden;
 
 		/*** The arguments ***/
 		std::vector< std::pair<Object*, bool> > args;
 
+		/*** The scope last called, in which the identifier has a slot ***/
+		Scope* calledScope;
+
+		/*** The slot of the identifier in the scope last called ***/
+		unsigned int calledSlot;
+
 };
 
 #endif
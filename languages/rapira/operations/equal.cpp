@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "equal.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Equal::Equal()
@@ -52,103 +53,127 @@ void Equal::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Equal::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Equal::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_SEQUENCE | OBJ_TEXT | OBJ_LOGICAL, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_SEQUENCE | OBJ_TEXT | OBJ_LOGICAL, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj1->getType() == OBJ_EMPTY && obj2->getType() == OBJ_EMPTY)
-		return new Logical(true);
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Equal::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() == OBJ_EMPTY && obj2.getType() == OBJ_EMPTY)
+		return Value::makeLogical(true);
 
-	if(obj1->getType() == OBJ_EMPTY || obj2->getType() == OBJ_EMPTY)
-		return new Logical(false);
+	if(obj1.getType() == OBJ_EMPTY || obj2.getType() == OBJ_EMPTY)
+		return Value::makeLogical(false);
 
-	if(obj1->getType() == OBJ_LOGICAL)
+	if(obj1.getType() == OBJ_LOGICAL)
 	{
-		if(obj2->getType() != OBJ_LOGICAL)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_LOGICAL)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj2.getType(), 2);
 
-		Logical* cast1 = static_cast<Logical*>(obj1.get());
-		Logical* cast2 = static_cast<Logical*>(obj2.get());
-		return new Logical(cast1->getValue() == cast2->getValue());
+		bool value1 = obj1.getLogical();
+		bool value2 = obj2.getLogical();
+		return Value::makeLogical(value1 == value2);
 	}
 
-	if(obj1->getType() == OBJ_INTEGER)
+	if(obj1.getType() == OBJ_INTEGER)
 	{
-		Integer* cast1 = static_cast<Integer*>(obj1.get());
+		long value1 = obj1.getInteger();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Logical(cast1->getValue() == cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeLogical(value1 == value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Logical(cast1->getValue() == cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeLogical(value1 == value2);
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_REAL)
+	if(obj1.getType() == OBJ_REAL)
 	{
-		Real* cast1 = static_cast<Real*>(obj1.get());
+		double value1 = obj1.getReal();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Logical(cast1->getValue() == cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeLogical(value1 == value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Logical(cast1->getValue() == cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeLogical(value1 == value2);
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(obj1.getType() == OBJ_TEXT)
 	{
-		if(obj2->getType() != OBJ_TEXT)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_TEXT)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, obj2.getType(), 2);
 
-		Text* cast1 = static_cast<Text*>(obj1.get());
-		Text* cast2 = static_cast<Text*>(obj2.get());
-		return new Logical(cast1->getValue().compare(cast2->getValue()) == 0);
+		Text* cast1 = static_cast<Text*>(obj1.getObject());
+		Text* cast2 = static_cast<Text*>(obj2.getObject());
+		return Value::makeLogical(cast1->getValue().compare(cast2->getValue()) == 0);
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(obj1.getType() == OBJ_SEQUENCE)
 	{
-		if(obj2->getType() != OBJ_SEQUENCE)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_SEQUENCE)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, obj2.getType(), 2);
 
-		Sequence* cast1 = static_cast<Sequence*>(obj1.get());
-		Sequence* cast2 = static_cast<Sequence*>(obj2.get());
+		Sequence* cast1 = static_cast<Sequence*>(obj1.getObject());
+		Sequence* cast2 = static_cast<Sequence*>(obj2.getObject());
 
 		if(cast1->getLength() != cast2->getLength())
-			return new Logical(false);
+			return Value::makeLogical(false);
 
 		for(unsigned int i = 0; i < cast1->getLength(); i++)
 		{
-			std::auto_ptr<Object> eqResult(Equal(cast1->getObject(i)->clone(), cast2->getObject(i)->clone()).evaluate());
-			Logical* logResult = static_cast<Logical*>(eqResult.get());
-			if(logResult->getValue() == false)
-				return new Logical(false);
+			Value eqResult(apply(Value::copy(cast1->getObject(i)), Value::copy(cast2->getObject(i))));
+			if(eqResult.getLogical() == false)
+				return Value::makeLogical(false);
 		}
 
-		return new Logical(true);
+		return Value::makeLogical(true);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE | OBJ_INTEGER, obj1.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Equal::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE | OBJ_INTEGER, obj1->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_EQUAL, 0, this);
 }
 
 /*** Destructor ***/
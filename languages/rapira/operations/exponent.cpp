@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "exponent.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Exponent::Exponent()
@@ -52,55 +53,80 @@ void Exponent::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Exponent::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Exponent::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj1->getType() == OBJ_INTEGER)
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Exponent::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() == OBJ_INTEGER)
 	{
-		Integer* cast1 = static_cast<Integer*>(obj1.get());
+		long value1 = obj1.getInteger();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Integer((long) pow((double) cast1->getValue(), cast2->getValue()));
+			long value2 = obj2.getInteger();
+			return Value::makeInteger((long) pow((double) value1, value2));
 		}
 		
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(pow(cast1->getValue(), cast2->getValue()));
+			double value2 = obj2.getReal();
+			return Value::makeReal(pow(value1, value2));
 		}
 
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_REAL)
+	if(obj1.getType() == OBJ_REAL)
 	{
-		Real* cast1 = static_cast<Real*>(obj1.get());
+		double value1 = obj1.getReal();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Real(pow(cast1->getValue(), cast2->getValue()));
+			long value2 = obj2.getInteger();
+			return Value::makeReal(pow(value1, value2));
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(pow(cast1->getValue(), cast2->getValue()));
+			double value2 = obj2.getReal();
+			return Value::makeReal(pow(value1, value2));
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2.getType(), 2);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj1.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Exponent::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj1->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_EXPONENT, 0, this);
 }
 
 /*** Destructor ***/
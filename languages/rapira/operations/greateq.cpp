@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "greateq.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 GreatEq::GreatEq()
@@ -53,25 +54,46 @@ void GreatEq::setArgument2(Object* pArg)
 /*** Evaluate this object ***/
 Object* GreatEq::evaluate()
 {
-	std::auto_ptr<Object> lessOperation;
-	try
-	{
-		lessOperation.reset(Less(arg1->clone(), arg2->clone()).evaluate());
-	}
-	catch(MissingArgumentException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getArgumentNumber());
-	}
-	catch(InvalidTypeException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getReceivedType(), e.getArgumentNumber());
-	}
-	catch(Excep& e)
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value GreatEq::evaluateValue()
+{
+	if(arg1 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
+	if(arg2 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 2);
+
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
+
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value GreatEq::apply(const Value& obj1, const Value& obj2)
+{
+	Less less;
+	less.setLineNumber(getLineNumber());
+	less.setColumnNumber(getColumnNumber());
+
+	Value lessOperation(less.apply(obj1, obj2));
+	return Value::makeLogical(!lessOperation.getLogical());
+}
+
+/*** Compile the evaluation of this object ***/
+void GreatEq::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
 	{
-		throw e;
+		Object::compileEvaluate(compiler);
+		return;
 	}
-	Object* result = Not(lessOperation->clone()).evaluate();
-	return result;
+
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_GREATEQ, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "greater.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Greater::Greater()
@@ -52,55 +53,80 @@ void Greater::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Greater::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Greater::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj1->getType() == OBJ_INTEGER)
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Greater::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() == OBJ_INTEGER)
 	{
-		Integer* cast1 = static_cast<Integer*>(obj1.get());
+		long value1 = obj1.getInteger();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Logical(cast1->getValue() > cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeLogical(value1 > value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Logical(cast1->getValue() > cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeLogical(value1 > value2);
 		}
 
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_REAL)
+	if(obj1.getType() == OBJ_REAL)
 	{
-		Real* cast1 = static_cast<Real*>(obj1.get());
+		double value1 = obj1.getReal();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Logical(cast1->getValue() > cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeLogical(value1 > value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Logical(cast1->getValue() > cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeLogical(value1 > value2);
 		}
 
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2.getType(), 2);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Greater::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_REAL | OBJ_INTEGER, obj2->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_GREATER, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "length.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Length::Length()
@@ -44,29 +45,53 @@ void Length::setArgument(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Length::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Length::evaluateValue()
 {
 	if(arg == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, 1);
 
-	std::auto_ptr<Object> obj(arg->evaluate());
+	Value obj(arg->evaluateValue());
 
-	if(obj->getType() == OBJ_EMPTY)
-		return new Integer(0);
+	return apply(obj);
+}
 
-	if(obj->getType() == OBJ_TEXT)
+/*** Apply this operation to an evaluated argument ***/
+Value Length::apply(const Value& obj)
+{
+	if(obj.getType() == OBJ_EMPTY)
+		return Value::makeInteger(0);
+
+	if(obj.getType() == OBJ_TEXT)
 	{
-		Text* cast = static_cast<Text*>(obj.get());
-		return new Integer(cast->getLength());
+		Text* cast = static_cast<Text*>(obj.getObject());
+		return Value::makeInteger(cast->getLength());
 	}
 
-	if(obj->getType() == OBJ_SEQUENCE)
+	if(obj.getType() == OBJ_SEQUENCE)
+	{
+		Sequence* cast = static_cast<Sequence*>(obj.getObject());
+		return Value::makeInteger(cast->getLength());
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Length::compileEvaluate(Compiler& compiler)
+{
+	if(arg == 0)
 	{
-		Sequence* cast = static_cast<Sequence*>(obj.get());
-		return new Integer(cast->getLength());
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj->getType(), 1);
-	return 0;
+	arg->compileEvaluate(compiler);
+	compiler.emit(BC_LENGTH, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "less.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Less::Less()
@@ -53,28 +54,54 @@ void Less::setArgument2(Object* pArg)
 /*** Evaluate this object ***/
 Object* Less::evaluate()
 {
-	std::auto_ptr<Object> greatOperation;
-	try
-	{
-		greatOperation.reset(Greater(arg1->clone(), arg2->clone()).evaluate());
-	}
-	catch(MissingArgumentException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getArgumentNumber());
-	}
-	catch(InvalidTypeException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getReceivedType(), e.getArgumentNumber());
-	}
-	catch(Excep& e)
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Less::evaluateValue()
+{
+	if(arg1 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
+	if(arg2 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 2);
+
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
+
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Less::apply(const Value& obj1, const Value& obj2)
+{
+	Greater greater;
+	greater.setLineNumber(getLineNumber());
+	greater.setColumnNumber(getColumnNumber());
+
+	Equal equal;
+	equal.setLineNumber(getLineNumber());
+	equal.setColumnNumber(getColumnNumber());
+
+	Value greatOperation(greater.apply(obj1, obj2));
+	Value equalOperation(equal.apply(obj1, obj2));
+
+	bool greatResult = greatOperation.getLogical();
+	bool equalResult = equalOperation.getLogical();
+	return Value::makeLogical(!(greatResult || equalResult));
+}
+
+/*** Compile the evaluation of this object ***/
+void Less::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
 	{
-		throw e;
+		Object::compileEvaluate(compiler);
+		return;
 	}
-	std::auto_ptr<Object> equalOperation(Equal(arg1->clone(), arg2->clone()).evaluate());
-	std::auto_ptr<Object> orOperation(Or(greatOperation->clone(), equalOperation->clone()).evaluate());
-	Object* result = Not(orOperation->clone()).evaluate();
 
-	return result;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_LESS, 0, this);
 }
 
 /*** Destructor ***/
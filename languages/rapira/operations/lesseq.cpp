@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "lesseq.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 LessEq::LessEq()
@@ -53,25 +54,46 @@ void LessEq::setArgument2(Object* pArg)
 /*** Evaluate this object ***/
 Object* LessEq::evaluate()
 {
-	std::auto_ptr<Object> greatOperation;
-	try
-	{
-		greatOperation.reset(Greater(arg1->clone(), arg2->clone()).evaluate());
-	}
-	catch(InvalidTypeException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getReceivedType(), e.getArgumentNumber());
-	}
-	catch(MissingArgumentException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getArgumentNumber());
-	}
-	catch(Excep& e)
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value LessEq::evaluateValue()
+{
+	if(arg1 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
+	if(arg2 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 2);
+
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
+
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value LessEq::apply(const Value& obj1, const Value& obj2)
+{
+	Greater greater;
+	greater.setLineNumber(getLineNumber());
+	greater.setColumnNumber(getColumnNumber());
+
+	Value greatOperation(greater.apply(obj1, obj2));
+	return Value::makeLogical(!greatOperation.getLogical());
+}
+
+/*** Compile the evaluation of this object ***/
+void LessEq::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
 	{
-		throw e;
+		Object::compileEvaluate(compiler);
+		return;
 	}
-	Object* result = Not(greatOperation->clone()).evaluate();
-	return result;
+
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_LESSEQ, 0, this);
 }
 
 /*** Destructor ***/
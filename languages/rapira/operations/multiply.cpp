@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "multiply.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Multiply::Multiply()
@@ -52,130 +53,155 @@ void Multiply::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Multiply::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Multiply::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj1->getType() == OBJ_INTEGER)
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Multiply::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() == OBJ_INTEGER)
 	{
-		Integer* cast1 = static_cast<Integer*>(obj1.get());
+		long value1 = obj1.getInteger();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Integer(cast1->getValue() * cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeInteger(value1 * value2);
 		}
 		
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(cast1->getValue() * cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeReal(value1 * value2);
 		}
 
-		if(obj2->getType() == OBJ_TEXT)
+		if(obj2.getType() == OBJ_TEXT)
 		{
-			Text* cast2 = static_cast<Text*>(obj2.get());
+			Text* cast2 = static_cast<Text*>(obj2.getObject());
 
-			if(cast1->getValue() <= 0)
-				throw NegativeValueException(getLineNumber(), getColumnNumber(), cast1->getValue(), 1);
+			if(value1 <= 0)
+				throw NegativeValueException(getLineNumber(), getColumnNumber(), value1, 1);
 
 			Text* txtResult = new Text();
 
-			for(unsigned int i = 0; i < (unsigned int) cast1->getValue(); i++)
+			for(unsigned int i = 0; i < (unsigned int) value1; i++)
 				txtResult->setValue(txtResult->getValue() + cast2->getValue());
 
-			return txtResult;
+			return Value(txtResult);
 		}
 
-		if(obj2->getType() == OBJ_SEQUENCE)
+		if(obj2.getType() == OBJ_SEQUENCE)
 		{
-			Sequence* cast2 = static_cast<Sequence*>(obj2.get());
+			Sequence* cast2 = static_cast<Sequence*>(obj2.getObject());
 
-			if(cast1->getValue() <= 0)
-				throw NegativeValueException(getLineNumber(), getColumnNumber(), cast1->getValue(), 1);
+			if(value1 <= 0)
+				throw NegativeValueException(getLineNumber(), getColumnNumber(), value1, 1);
 
 			Sequence* seqResult = new Sequence();
 
-			for(unsigned int i = 0; i < (unsigned int) cast1->getValue(); i++)
+			for(unsigned int i = 0; i < (unsigned int) value1; i++)
 			{
 				for(unsigned int j = 0; j < cast2->getLength(); j++)
 					seqResult->pushObject(cast2->getObject(j)->clone());
 			}
 
-			return seqResult;
+			return Value(seqResult);
 		}
 
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_REAL)
+	if(obj1.getType() == OBJ_REAL)
 	{
-		Real* cast1 = static_cast<Real*>(obj1.get());
+		double value1 = obj1.getReal();
 
-		if(obj2->getType() == OBJ_INTEGER)
+		if(obj2.getType() == OBJ_INTEGER)
 		{
-			Integer* cast2 = static_cast<Integer*>(obj2.get());
-			return new Real(cast1->getValue() * cast2->getValue());
+			long value2 = obj2.getInteger();
+			return Value::makeReal(value1 * value2);
 		}
 
-		if(obj2->getType() == OBJ_REAL)
+		if(obj2.getType() == OBJ_REAL)
 		{
-			Real* cast2 = static_cast<Real*>(obj2.get());
-			return new Real(cast1->getValue() * cast2->getValue());
+			double value2 = obj2.getReal();
+			return Value::makeReal(value1 * value2);
 		}
 		
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2->getType(), 2);
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj2.getType(), 2);
 	}
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(obj1.getType() == OBJ_TEXT)
 	{
-		Text* cast1 = static_cast<Text*>(obj1.get());
+		Text* cast1 = static_cast<Text*>(obj1.getObject());
 
-		if(obj2->getType() != OBJ_INTEGER)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_INTEGER)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2.getType(), 2);
 
-		Integer* cast2 = static_cast<Integer*>(obj2.get());
+		long value2 = obj2.getInteger();
 
-		if(cast2->getValue() <= 0)
-			throw NegativeValueException(getLineNumber(), getColumnNumber(), cast2->getValue(), 2);
+		if(value2 <= 0)
+			throw NegativeValueException(getLineNumber(), getColumnNumber(), value2, 2);
 
 		Text* txtResult = new Text();
 
-		for(unsigned int i = 0; i < (unsigned int) cast2->getValue(); i++)
+		for(unsigned int i = 0; i < (unsigned int) value2; i++)
 			txtResult->setValue(txtResult->getValue() + cast1->getValue());
 
-		return txtResult;
+		return Value(txtResult);
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(obj1.getType() == OBJ_SEQUENCE)
 	{
-		if(obj2->getType() != OBJ_INTEGER)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2->getType(), 2);
+		if(obj2.getType() != OBJ_INTEGER)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2.getType(), 2);
 
-		Sequence* cast1 = static_cast<Sequence*>(obj1.get());
-		Integer* cast2 = static_cast<Integer*>(obj2.get());
+		Sequence* cast1 = static_cast<Sequence*>(obj1.getObject());
+		long value2 = obj2.getInteger();
 
-		if(cast2->getValue() <= 0)
-			throw NegativeValueException(getLineNumber(), getColumnNumber(), cast2->getValue(), 2);
+		if(value2 <= 0)
+			throw NegativeValueException(getLineNumber(), getColumnNumber(), value2, 2);
 
 		Sequence* seqResult = new Sequence();
 
-		for(unsigned int i = 0; i < (unsigned int) cast2->getValue(); i++)
+		for(unsigned int i = 0; i < (unsigned int) value2; i++)
 		{
 			for(unsigned int j = 0; j < cast1->getLength(); j++)
 				seqResult->pushObject(cast1->getObject(j)->clone());
 		}
 
-		return seqResult;
+		return Value(seqResult);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj1.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Multiply::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_SEQUENCE, obj1->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_MULTIPLY, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "negate.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Negate::Negate()
@@ -44,26 +45,50 @@ void Negate::setArgument(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Negate::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Negate::evaluateValue()
 {
 	if(arg == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, 1);
 
-	std::auto_ptr<Object> obj(arg->evaluate());
+	Value obj(arg->evaluateValue());
 
-	if(obj->getType() == OBJ_INTEGER)
+	return apply(obj);
+}
+
+/*** Apply this operation to an evaluated argument ***/
+Value Negate::apply(const Value& obj)
+{
+	if(obj.getType() == OBJ_INTEGER)
 	{
-		Integer* cast = static_cast<Integer*>(obj.get());
-		return new Integer(-cast->getValue());
+		long value = obj.getInteger();
+		return Value::makeInteger(-value);
 	}
 
-	if(obj->getType() == OBJ_REAL)
+	if(obj.getType() == OBJ_REAL)
+	{
+		double value = obj.getReal();
+		return Value::makeReal(-value);
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Negate::compileEvaluate(Compiler& compiler)
+{
+	if(arg == 0)
 	{
-		Real* cast = static_cast<Real*>(obj.get());
-		return new Real(-cast->getValue());
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, obj->getType(), 1);
-	return 0;
+	arg->compileEvaluate(compiler);
+	compiler.emit(BC_NEGATE, 0, this);
 }
 
 /*** Destructor ***/
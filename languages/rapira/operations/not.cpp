@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "not.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Not::Not()
@@ -44,18 +45,43 @@ void Not::setArgument(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Not::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Not::evaluateValue()
 {
 	if(arg == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, 1);
 
-	std::auto_ptr<Object> obj(arg->evaluate());
+	Value obj(arg->evaluateValue());
 
-	if(obj->getType() != OBJ_LOGICAL)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj->getType(), 1);
+	return apply(obj);
+}
+
+/*** Apply this operation to an evaluated argument ***/
+Value Not::apply(const Value& obj)
+{
+	if(obj.getType() != OBJ_LOGICAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj.getType(), 1);
 
-	Logical* cast = static_cast<Logical*>(obj.get());
+	bool value = obj.getLogical();
+
+	return Value::makeLogical(!value);
+}
+
+/*** Compile the evaluation of this object ***/
+void Not::compileEvaluate(Compiler& compiler)
+{
+	if(arg == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
+	}
 
-	return new Logical(!cast->getValue());
+	arg->compileEvaluate(compiler);
+	compiler.emit(BC_NOT, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "or.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Or::Or()
@@ -52,24 +53,51 @@ void Or::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Or::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Or::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	if(obj1->getType() != OBJ_LOGICAL)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj1->getType(), 1);
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	std::auto_ptr<Object> obj2(arg2->evaluate());
-	if(obj2->getType() != OBJ_LOGICAL)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj2->getType(), 2);
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Or::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() != OBJ_LOGICAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj1.getType(), 1);
 
-	Logical* cast1 = static_cast<Logical*>(obj1.get());
-	Logical* cast2 = static_cast<Logical*>(obj2.get());
+	if(obj2.getType() != OBJ_LOGICAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, obj2.getType(), 2);
+
+	bool value1 = obj1.getLogical();
+	bool value2 = obj2.getLogical();
+
+	return Value::makeLogical(value1 || value2);
+}
+
+/*** Compile the evaluation of this object ***/
+void Or::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
+	}
 
-	return new Logical(cast1->getValue() || cast2->getValue());
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_OR, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "remainder.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Remainder::Remainder()
@@ -52,27 +53,53 @@ void Remainder::setArgument2(Object* pArg)
 
 /*** Evaluate this object ***/
 Object* Remainder::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Remainder::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, 2);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
+
+	return apply(obj1, obj2);
+}
 
-	if(obj1->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj1->getType(), 1);
-	if(obj2->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2->getType(), 2);
+/*** Apply this operation to evaluated arguments ***/
+Value Remainder::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj1.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj1.getType(), 1);
+	if(obj2.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2.getType(), 2);
 
-	Integer* cast1 = static_cast<Integer*>(obj1.get());
-	Integer* cast2 = static_cast<Integer*>(obj2.get());
+	long value1 = obj1.getInteger();
+	long value2 = obj2.getInteger();
 
-	if(cast2->getValue() == 0)
+	if(value2 == 0)
 		throw DivideByZeroException(getLineNumber(), getColumnNumber(), 2);
 
-	return new Integer(cast1->getValue() % cast2->getValue());
+	return Value::makeInteger(value1 % value2);
+}
+
+/*** Compile the evaluation of this object ***/
+void Remainder::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
+	}
+
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_REMAINDER, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "select.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Select::Select()
@@ -64,42 +65,67 @@ Object* Select::getArgument2()
 
 /*** Evaluate this object ***/
 Object* Select::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Select::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, 1);
 	if(arg2 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, 1);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2(arg2->evaluate());
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
 
-	if(obj2->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2->getType(), 2);
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Select::apply(const Value& obj1, const Value& obj2)
+{
+	if(obj2.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2.getType(), 2);
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(obj1.getType() == OBJ_TEXT)
 	{
-		Text* cast1	= static_cast<Text*>(obj1.get());
-		Integer* cast2	= static_cast<Integer*>(obj2.get());
+		Text* cast1	= static_cast<Text*>(obj1.getObject());
+		long value2	= obj2.getInteger();
 
-		if(cast2->getValue() < 1 || cast2->getValue() > (int) cast1->getLength())
-			throw InvalidIndexException(getLineNumber(), getColumnNumber(), cast2->getValue(), 2);
+		if(value2 < 1 || value2 > (int) cast1->getLength())
+			throw InvalidIndexException(getLineNumber(), getColumnNumber(), value2, 2);
 
-		return cast1->getChar(cast2->getValue() - 1);
+		return Value(cast1->getChar(value2 - 1));
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(obj1.getType() == OBJ_SEQUENCE)
 	{
-		Sequence* cast1	= static_cast<Sequence*>(obj1.get());
-		Integer* cast2	= static_cast<Integer*>(obj2.get());
+		Sequence* cast1	= static_cast<Sequence*>(obj1.getObject());
+		long value2	= obj2.getInteger();
 
-		if(cast2->getValue() < 1 || cast2->getValue() > (int) cast1->getLength())
-			throw InvalidIndexException(getLineNumber(), getColumnNumber(), cast2->getValue(), 2);
+		if(value2 < 1 || value2 > (int) cast1->getLength())
+			throw InvalidIndexException(getLineNumber(), getColumnNumber(), value2, 2);
 
-		return cast1->getObject(cast2->getValue() - 1)->clone();
+		return Value::copy(cast1->getObject(value2 - 1));
+	}
+
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj1.getType(), 1);
+}
+
+/*** Compile the evaluation of this object ***/
+void Select::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj1->getType(), 1);
-	return 0;
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_SELECT, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "slice.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Slice::Slice()
@@ -78,37 +79,49 @@ Object* Slice::getArgument3()
 
 /*** Evaluate this object ***/
 Object* Slice::evaluate()
+{
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Slice::evaluateValue()
 {
 	if(arg1 == 0)
 		throw MissingArgumentException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, 1);
 
-	std::auto_ptr<Object> obj1(arg1->evaluate());
-	std::auto_ptr<Object> obj2;
-	std::auto_ptr<Object> obj3;
+	Value obj1(arg1->evaluateValue());
+	Value obj2;
+	Value obj3;
 
 	if(arg2 != 0)
-		obj2.reset(arg2->evaluate());
+		obj2 = arg2->evaluateValue();
 	if(arg3 != 0)
-		obj3.reset(arg3->evaluate());
+		obj3 = arg3->evaluateValue();
+
+	return apply(obj1, arg2 != 0 ? &obj2 : 0, arg3 != 0 ? &obj3 : 0);
+}
 
+/*** Apply this operation to evaluated arguments, the indices may be null ***/
+Value Slice::apply(const Value& obj1, const Value* obj2, const Value* obj3)
+{
 	long index1 = 0;
 	long index2 = 0;
 
-	if(obj2.get() == 0)
+	if(obj2 == 0)
 		index1 = 1;
 	else if(obj2->getType() == OBJ_INTEGER)
-		index1 = static_cast<Integer*>(obj2.get())->getValue();
+		index1 = obj2->getInteger();
 	else
 		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj2->getType(), 2);
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(obj1.getType() == OBJ_TEXT)
 	{
-		Text* cast1 = static_cast<Text*>(obj1.get());
+		Text* cast1 = static_cast<Text*>(obj1.getObject());
 
-		if(obj3.get() == 0)
+		if(obj3 == 0)
 			index2 = cast1->getLength();
 		else if(obj3->getType() == OBJ_INTEGER)
-			index2 = static_cast<Integer*>(obj3.get())->getValue();
+			index2 = obj3->getInteger();
 		else
 			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj3->getType(), 3);
 
@@ -118,18 +131,18 @@ Object* Slice::evaluate()
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), index2, 2);
 
 		if(index1 > index2)
-			return new Text();
-		return new Text(cast1->getValue().substr(index1 - 1, index2 - index1 + 1));
+			return Value(new Text());
+		return Value(cast1->slice(index1 - 1, index2 - index1 + 1));
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(obj1.getType() == OBJ_SEQUENCE)
 	{
-		Sequence* cast1 = static_cast<Sequence*>(obj1.get());
+		Sequence* cast1 = static_cast<Sequence*>(obj1.getObject());
 
-		if(obj3.get() == 0)
+		if(obj3 == 0)
 			index2 = cast1->getLength();
 		else if(obj3->getType() == OBJ_INTEGER)
-			index2 = static_cast<Integer*>(obj3.get())->getValue();
+			index2 = obj3->getInteger();
 		else
 			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, obj3->getType(), 3);
 
@@ -138,19 +151,38 @@ Object* Slice::evaluate()
 		if(index2 > (int) cast1->getLength())
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), index2, 2);
 
-		Sequence* seqResult = new Sequence();
+		// The slice shares the objects of the sequence
+		if(index1 > index2)
+			return Value(new Sequence());
+		return Value(cast1->slice(index1 - 1, index2 - index1 + 1));
+	}
 
-		if(index1 <= index2)
-		{
-			for(unsigned int i = index1 - 1; i < (unsigned) index2; i++)
-				seqResult->pushObject(cast1->getObject(i)->clone());
-		}
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj1.getType(), 1);
+}
 
-		return seqResult;
+/*** Compile the evaluation of this object ***/
+void Slice::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0)
+	{
+		Object::compileEvaluate(compiler);
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT | OBJ_SEQUENCE, obj1->getType(), 1);
-	return 0;
+	// The argument tells which of the indices are on the stack
+	int present = 0;
+	arg1->compileEvaluate(compiler);
+	if(arg2 != 0)
+	{
+		arg2->compileEvaluate(compiler);
+		present |= 1;
+	}
+	if(arg3 != 0)
+	{
+		arg3->compileEvaluate(compiler);
+		present |= 2;
+	}
+	compiler.emit(BC_SLICE, present, this);
 }
 
 /*** Destructor ***/
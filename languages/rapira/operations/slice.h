@@ -61,6 +61,15 @@ class Slice : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
+		/*** Apply this operation to evaluated arguments, the indices may be null ***/
+		Value apply(const Value& obj1, const Value* obj2, const Value* obj3);
+
+		/*** Compile the evaluation of this object ***/
+		void compileEvaluate(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Slice* clone() const
 		{
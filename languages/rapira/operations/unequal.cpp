@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "unequal.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Unequal::Unequal()
@@ -53,25 +54,46 @@ void Unequal::setArgument2(Object* pArg)
 /*** Evaluate this object ***/
 Object* Unequal::evaluate()
 {
-	std::auto_ptr<Object> eqResult;
-	try
-	{
-		eqResult.reset(Equal(arg1->clone(), arg2->clone()).evaluate());
-	}
-	catch(InvalidTypeException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getReceivedType(), e.getArgumentNumber());
-	}
-	catch(MissingArgumentException& e)
-	{
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), e.getExpectedType(), e.getArgumentNumber());
-	}
-	catch(Excep& e)
+	return evaluateValue().release();
+}
+
+/*** Evaluate this object to a value ***/
+Value Unequal::evaluateValue()
+{
+	if(arg1 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_SEQUENCE | OBJ_TEXT | OBJ_LOGICAL, 1);
+	if(arg2 == 0)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_SEQUENCE | OBJ_TEXT | OBJ_LOGICAL, 2);
+
+	Value obj1(arg1->evaluateValue());
+	Value obj2(arg2->evaluateValue());
+
+	return apply(obj1, obj2);
+}
+
+/*** Apply this operation to evaluated arguments ***/
+Value Unequal::apply(const Value& obj1, const Value& obj2)
+{
+	Equal equal;
+	equal.setLineNumber(getLineNumber());
+	equal.setColumnNumber(getColumnNumber());
+
+	Value eqResult(equal.apply(obj1, obj2));
+	return Value::makeLogical(!eqResult.getLogical());
+}
+
+/*** Compile the evaluation of this object ***/
+void Unequal::compileEvaluate(Compiler& compiler)
+{
+	if(arg1 == 0 || arg2 == 0)
 	{
-		throw e;
+		Object::compileEvaluate(compiler);
+		return;
 	}
-	Object* notResult = Not(eqResult.get()->clone()).evaluate();
-	return notResult;
+
+	arg1->compileEvaluate(compiler);
+	arg2->compileEvaluate(compiler);
+	compiler.emit(BC_UNEQUAL, 0, this);
 }
 
 /*** Destructor ***/
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "parser.h"
+#include "compiler.h"
 
 /*** Constructor ***/
 Parser::Parser(std::string pFilename, std::vector<Token> pTokens)
@@ -26,6 +27,19 @@ Parser::Parser(std::string pFilename, std::vector<Token> pTokens)
 	index = 0;
 	srand((unsigned)time(0));
 	list = new NodeList();
+	code = 0;
+
+	// The main program's variables live in the bottom entry
+	scope = &globals;
+	VariableManager manager;
+	manager.pushEntry(&globals);
+}
+
+/*** Give a parsed variable a slot in the current scope ***/
+Variable* Parser::resolve(Variable* var)
+{
+	var->resolve(scope);
+	return var;
 }
 
 /*** Parse a separation ***/
@@ -84,11 +98,27 @@ void Parser::executeProgram()
 	//	throw ParserSyntaxException(list->getBreakToken(), "Invalid command!");
 }
 
+/*** Compile the program into bytecode ***/
+Bytecode* Parser::compileProgram()
+{
+	if(code == 0)
+		code = Compiler::compile(list);
+	return code;
+}
+
+/*** Run the compiled program ***/
+void Parser::runProgram()
+{
+	Outcome result;
+	result = VirtualMachine().run(compileProgram());
+}
+
 /*** Destructor ***/
 Parser::~Parser()
 {
 	VariableManager manager;
 	manager.empty();
+	delete code;
 	delete list;
 }
 
@@ -196,7 +226,7 @@ Assign* Parser::parseAssign()
 	if(!hasTokens() || peekToken().getType() != T_IDENTIFIER)
 		throw ParserSyntaxException(getToken(), "Expected variable identifier!");
 
-	std::auto_ptr<Variable> target(new Variable(getToken().getLexeme()));
+	std::auto_ptr<Variable> target(resolve(new Variable(getToken().getLexeme())));
 
 	if(!hasTokens() || peekToken().getType() != T_ASSIGN)
 		throw ParserSyntaxException(getToken(), "Expected ':='!");
@@ -670,6 +700,10 @@ void Parser::parseProcedure()
 	proc->setLineNumber(tokProc.getLineNumber());
 	proc->setColumnNumber(tokProc.getColumnNumber());
 
+	// The body's variables are given slots in the procedure's own scope
+	Scope* outer = scope;
+	scope = proc->getScope();
+
 	// Look for the left parentheses
 	if(!hasTokens() || peekToken().getType() != T_LPAREN)
 		throw ParserSyntaxException(getToken(), "Expected '('!");
@@ -696,7 +730,7 @@ void Parser::parseProcedure()
 		Token paramName = getToken();
 
 		// Store the parameter
-		proc->pushParameter(new Variable(paramName), isInOut);
+		proc->pushParameter(resolve(new Variable(paramName)), isInOut);
 
 		if(!hasTokens() || peekToken().getType() != T_COMMA)
 			break;
@@ -749,6 +783,8 @@ void Parser::parseProcedure()
 	// Set the procedure's statements
 	proc->setStatements(stmts.release());
 
+	scope = outer;
+
 	// Add the object to the VariableManager
 	manager.setObject(procName, proc.release());
 }
@@ -777,6 +813,10 @@ void Parser::parseFunction()
 	proc->setLineNumber(tokFun.getLineNumber());
 	proc->setColumnNumber(tokFun.getColumnNumber());
 
+	// The body's variables are given slots in the procedure's own scope
+	Scope* outer = scope;
+	scope = proc->getScope();
+
 	// Look for the left parentheses
 	if(!hasTokens() || peekToken().getType() != T_LPAREN)
 		throw ParserSyntaxException(getToken(), "Expected '('!");
@@ -800,7 +840,7 @@ void Parser::parseFunction()
 		Token paramName = getToken();
 
 		// Store the parameter
-		proc->pushParameter(new Variable(paramName), false);
+		proc->pushParameter(resolve(new Variable(paramName)), false);
 
 		if(!hasTokens() || peekToken().getType() != T_COMMA)
 			break;
@@ -853,6 +893,8 @@ void Parser::parseFunction()
 	// Set the procedure's statements
 	proc->setStatements(stmts.release());
 
+	scope = outer;
+
 	// Add the object to the VariableManager
 	manager.setObject(procName, proc.release());
 }
@@ -946,7 +988,7 @@ Node* Parser::parseSliceSelectAssign()
 		throw ParserSyntaxException(getToken(), "Expected variable identifier!");
 
 	// Store the variable
-	std::auto_ptr<Variable> target(new Variable(getToken()));
+	std::auto_ptr<Variable> target(resolve(new Variable(getToken())));
 
 	if(!hasTokens() || peekToken().getType() != T_LBRACKET)
 		throw ParserSyntaxException(getToken(), "Expected '['!");
@@ -1392,7 +1434,7 @@ Object* Parser::parseValue()
 		return new Text(getToken());
 
 	if(peekToken().getType() == T_IDENTIFIER)
-		return new Variable(getToken());
+		return resolve(new Variable(getToken()));
 
 	return 0;
 }
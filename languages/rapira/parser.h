@@ -27,6 +27,7 @@
 
 #include "nodelist.h"
 #include "token.h"
+#include "vm.h"
 
 /*** Operations ***/
 #include "operations/add.h"
@@ -82,6 +83,12 @@ class Parser
 		/*** Descend the asbtract syntax tree ***/
 		void executeProgram();
 
+		/*** Compile the program into bytecode ***/
+		Bytecode* compileProgram();
+
+		/*** Run the compiled program ***/
+		void runProgram();
+
 		/*** Destructor ***/
 		~Parser();
 
@@ -93,12 +100,24 @@ class Parser
 		/*** The list of nodes for the generated abstract syntax tree ***/
 		NodeList* list;
 
+		/*** The compiled program ***/
+		Bytecode* code;
+
 		/*** The list of tokens ***/
 		std::vector<Token> tokens;
 
 		/*** The current index of the token being processed ***/
 		unsigned int index;
 
+		/*** The scope of the main program ***/
+		Scope globals;
+
+		/*** The scope of the code being parsed ***/
+		Scope* scope;
+
+		/*** Give a parsed variable a slot in the current scope ***/
+		Variable* resolve(Variable* var);
+
 		/*** If the token list contains more tokens ***/
 		bool hasTokens();
 
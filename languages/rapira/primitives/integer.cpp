@@ -80,6 +80,12 @@ Object* Integer::evaluate()
 	return clone();
 }
 
+/*** Evaluate this object to a value ***/
+Value Integer::evaluateValue()
+{
+	return Value::makeInteger(value);
+}
+
 /*** Destructor ***/
 Integer::~Integer()
 {
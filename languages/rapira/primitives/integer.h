@@ -56,6 +56,9 @@ class Integer : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
 		/*** Clone this object ***/
 		Integer* clone() const { return new Integer(value); }
 
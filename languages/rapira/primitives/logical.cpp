@@ -68,6 +68,12 @@ Object* Logical::evaluate()
 	return clone();
 }
 
+/*** Evaluate this object to a value ***/
+Value Logical::evaluateValue()
+{
+	return Value::makeLogical(value);
+}
+
 /*** Destructor ***/
 Logical::~Logical()
 {
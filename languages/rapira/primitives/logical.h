@@ -49,6 +49,9 @@ class Logical : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
 		/*** Clone this object ***/
 		Logical* clone() const { return new Logical(value); }
 
@@ -17,32 +17,47 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "procedure.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Procedure::Procedure()
 {
-	setStatements(0);
+	createBody();
 	isFunc = false;
-	ex = 0;
-	in = 0;
 }
 
 /*** Constructor ***/
 Procedure::Procedure(bool pIsFunc)
 {
-	setStatements(0);
+	createBody();
 	isFunc = pIsFunc;
-	ex = 0;
-	in = 0;
 }
 
 /*** Constructor ***/
 Procedure::Procedure(NodeList* pStmts, bool pIsFunc)
 {
+	createBody();
 	setStatements(pStmts);
 	isFunc = pIsFunc;
-	ex = 0;
-	in = 0;
+}
+
+/*** Constructor ***/
+Procedure::Procedure(ProcedureBody* pBody, bool pIsFunc)
+{
+	body = pBody;
+	body->refCount++;
+	isFunc = pIsFunc;
+}
+
+/*** Create an empty body ***/
+void Procedure::createBody()
+{
+	body = new ProcedureBody();
+	body->stmts = 0;
+	body->ex = 0;
+	body->in = 0;
+	body->code = 0;
+	body->refCount = 1;
 }
 
 /*** Get this operation's type ***/
@@ -56,37 +71,64 @@ unsigned char Procedure::getType()
 /*** Set the statements ***/
 void Procedure::setStatements(NodeList* pStmts)
 {
-	stmts = pStmts;
+	body->stmts = pStmts;
 }
 
 /*** Push a parameters ***/
 void Procedure::pushParameter(Variable* pParam, bool isInOut)
 {
-	params.push_back(std::pair<Variable*, bool>(pParam, isInOut));
+	body->params.push_back(std::pair<Variable*, bool>(pParam, isInOut));
 }
 
 /*** Get the statements ***/
 NodeList* Procedure::getStatements()
 {
-	return stmts;
+	return body->stmts;
 }
 
 /*** Get the parameters ***/
 std::vector< std::pair<Variable*, bool> > Procedure::getParameters()
 {
-	return params;
+	return body->params;
 }
 
 /*** Get a parameter ***/
 Variable* Procedure::getParameterVariable(unsigned int index)
 {
-	return params.at(index).first;
+	return body->params.at(index).first;
+}
+
+/*** Get the number of parameters ***/
+unsigned int Procedure::getParameterCount()
+{
+	return body->params.size();
+}
+
+/*** If a parameter is in-out ***/
+bool Procedure::isInOutParameter(unsigned int index)
+{
+	return body->params.at(index).second;
+}
+
+/*** Get the compiled statements ***/
+Bytecode* Procedure::getCode()
+{
+	// Compile on the first call, the code is shared by all copies
+	if(body->code == 0)
+		body->code = Compiler::compile(body->stmts);
+	return body->code;
+}
+
+/*** Get the scope of the variables ***/
+Scope* Procedure::getScope()
+{
+	return &body->scope;
 }
 
 /*** Execute this node ***/
 Outcome Procedure::execute()
 {
-	return stmts->execute();
+	return body->stmts->execute();
 }
 
 /*** Evaluate this object ***/
@@ -98,33 +140,38 @@ Object* Procedure::evaluate()
 /*** Set the extern command ***/
 void Procedure::setExtern(Extern* pEx)
 {
-	ex = pEx;
+	body->ex = pEx;
 }
 
 /*** Get the extern command ***/
 Extern* Procedure::getExtern()
 {
-	return ex;
+	return body->ex;
 }
 
 /*** Set the intern command ***/
 void Procedure::setIntern(Intern* pIn)
 {
-	in = pIn;
+	body->in = pIn;
 }
 
 /*** Get the intern command ***/
 Intern* Procedure::getIntern()
 {
-	return in;
+	return body->in;
 }
 
 /*** Destructor ***/
 Procedure::~Procedure()
 {
-	delete ex;
-	delete in;
-	delete stmts;
-	for(unsigned int i = 0; i < params.size(); i++)
-		delete params.at(i).first;
+	if(--body->refCount != 0)
+		return;
+
+	delete body->code;
+	delete body->ex;
+	delete body->in;
+	delete body->stmts;
+	for(unsigned int i = 0; i < body->params.size(); i++)
+		delete body->params.at(i).first;
+	delete body;
 }
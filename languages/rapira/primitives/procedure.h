@@ -22,9 +22,37 @@
 #include "../nodelist.h"
 #include "../object.h"
 #include "variable.h"
+#include "../scope.h"
 #include "../statements/intern.h"
 #include "../statements/extern.h"
 
+class Bytecode;
+
+/*** The definition of a procedure, shared by its copies ***/
+struct ProcedureBody
+{
+	/*** The procedure statements ***/
+	NodeList* stmts;
+
+	/*** The procedure parameters ***/
+	std::vector< std::pair<Variable*, bool> > params;
+
+	/*** The extern command for this procedure ***/
+	Extern* ex;
+
+	/*** The intern command for this procedure ***/
+	Intern* in;
+
+	/*** The compiled statements, or null when not compiled yet ***/
+	Bytecode* code;
+
+	/*** The slots of the parameters and variables ***/
+	Scope scope;
+
+	/*** The number of procedures which refer to this body ***/
+	unsigned int refCount;
+};
+
 class Procedure : public Object
 {
 
@@ -57,6 +85,18 @@ class Procedure : public Object
 		/*** Get a parameter ***/
 		Variable* getParameterVariable(unsigned int index);
 
+		/*** Get the number of parameters ***/
+		unsigned int getParameterCount();
+
+		/*** If a parameter is in-out ***/
+		bool isInOutParameter(unsigned int index);
+
+		/*** Get the compiled statements ***/
+		Bytecode* getCode();
+
+		/*** Get the scope of the variables ***/
+		Scope* getScope();
+
 		/*** Execute this node ***/
 		Outcome execute();
 
@@ -66,14 +106,7 @@ class Procedure : public Object
 		/*** Clone this object ***/
 		Procedure* clone() const
 		{
-			Procedure* result = new Procedure(stmts->clone(), isFunc);
-			for(unsigned int i = 0; i < params.size(); i++)
-				result->pushParameter(params.at(i).first->clone(), params.at(i).second);
-			if(ex != 0)
-				result->setExtern(ex->clone());
-			if(in != 0)
-				result->setIntern(in->clone());
-			return result;
+			return new Procedure(body, isFunc);
 		}
 
 		/*** Set the extern command ***/
@@ -93,21 +126,18 @@ class Procedure : public Object
 
 	private:
 
-		/*** The procedure statements ***/
-		NodeList* stmts;
+		/*** Constructor ***/
+		Procedure(ProcedureBody* pBody, bool pIsFunc);
+
+		/*** Create an empty body ***/
+		void createBody();
 
-		/*** The procedure parameters ***/
-		std::vector< std::pair<Variable*, bool> > params;
+		/*** The shared definition of this procedure ***/
+		ProcedureBody* body;
 
 		/*** If this procedure is a function ***/
 		bool isFunc;
 
-		/*** The extern command for this procedure ***/
-		Extern* ex;
-
-		/*** The intern command for this procedure ***/
-		Intern* in;
-
 };
 
 #endif
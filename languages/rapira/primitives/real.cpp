@@ -87,6 +87,12 @@ Object* Real::evaluate()
 	return clone();
 }
 
+/*** Evaluate this object to a value ***/
+Value Real::evaluateValue()
+{
+	return Value::makeReal(value);
+}
+
 /*** Destructor ***/
 Real::~Real()
 {
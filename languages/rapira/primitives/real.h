@@ -57,6 +57,9 @@ class Real : public Object
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
 		/*** Clone this object ***/
 		Real* clone() const { return new Real(value); }
 
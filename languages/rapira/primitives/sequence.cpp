@@ -17,27 +17,92 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "sequence.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Sequence::Sequence()
 {
+	createData();
 }
 
 /*** Constructor ***/
 Sequence::Sequence(std::vector<Object*> pSeq)
 {
+	createData();
+
 	// Copy the objects from the
 	// given list to the current list
 	for(unsigned int i = 0; i < pSeq.size(); i++)
 		pushObject(pSeq.at(i)->clone());
 }
 
+/*** Constructor, refers to part of existing data ***/
+Sequence::Sequence(SequenceData* pData, unsigned int pStart, unsigned int pLength)
+{
+	data = pData;
+	data->refCount++;
+	start = pStart;
+	length = pLength;
+}
+
+/*** Create empty data ***/
+void Sequence::createData()
+{
+	data = new SequenceData();
+	data->refCount = 1;
+	start = 0;
+	length = 0;
+}
+
+/*** Drop the reference to the data ***/
+void Sequence::releaseData()
+{
+	if(--data->refCount != 0)
+		return;
+
+	// Delete all objects
+	for(unsigned int i = 0; i < data->list.size(); i++)
+		delete data->list.at(i);
+	delete data;
+}
+
+/*** Give this sequence data of its own before modifying it ***/
+void Sequence::detach()
+{
+	std::vector<Object*>& list = data->list;
+
+	// The only reference may still be to a part of the data
+	if(data->refCount == 1)
+	{
+		if(start == 0 && length == list.size())
+			return;
+
+		for(unsigned int i = 0; i < start; i++)
+			delete list.at(i);
+		for(unsigned int i = start + length; i < list.size(); i++)
+			delete list.at(i);
+		list.erase(list.begin() + start + length, list.end());
+		list.erase(list.begin(), list.begin() + start);
+		start = 0;
+		return;
+	}
+
+	SequenceData* copy = new SequenceData();
+	copy->refCount = 1;
+	copy->list.reserve(length);
+	for(unsigned int i = 0; i < length; i++)
+		copy->list.push_back(list.at(start + i)->clone());
+
+	data->refCount--;
+	data = copy;
+	start = 0;
+}
+
 /*** Clear the sequence ***/
 void Sequence::clear()
 {
-	// Delete all objects
-	for(unsigned int i = 0; i < getLength(); i++)
-		delete list.at(i);
+	releaseData();
+	createData();
 }
 
 /*** Get this object's type ***/
@@ -49,25 +114,31 @@ unsigned char Sequence::getType()
 /*** Get this sequence's length ***/
 unsigned int Sequence::getLength()
 {
-	return list.size();
+	return length;
 }
 
 /*** Push an object onto this sequence ***/
 void Sequence::pushObject(Object* obj)
 {
-	list.push_back(obj);
+	detach();
+	data->list.push_back(obj);
+	length++;
 }
 
 /*** Pop an object off of this sequence ***/
 void Sequence::popObject()
 {
-	delete getObject(getLength() - 1);
-	list.pop_back();
+	detach();
+	delete data->list.back();
+	data->list.pop_back();
+	length--;
 }
 
 /*** Set an object at an index ***/
 void Sequence::setObject(unsigned int index, Object* obj)
 {
+	detach();
+	std::vector<Object*>& list = data->list;
 	if(list.at(index) != 0)
 		delete list.at(index);
 	list.at(index) = obj;
@@ -76,13 +147,21 @@ void Sequence::setObject(unsigned int index, Object* obj)
 /*** Get an object at an index ***/
 Object* Sequence::getObject(unsigned int index)
 {
-	return list.at(index);
+	if(index >= length)
+		throw std::out_of_range("Sequence::getObject");
+	return data->list[start + index];
 }
 
 /*** Get the list of objects ***/
 std::vector<Object*> Sequence::getList()
 {
-	return list;
+	return std::vector<Object*>(data->list.begin() + start, data->list.begin() + start + length);
+}
+
+/*** Get part of this sequence, which shares its objects ***/
+Sequence* Sequence::slice(unsigned int pStart, unsigned int pLength)
+{
+	return new Sequence(data, start + pStart, pLength);
 }
 
 /*** Evaluate this object ***/
@@ -102,8 +181,16 @@ Object* Sequence::evaluate()
 	return result;
 }
 
+/*** Compile the evaluation of this object ***/
+void Sequence::compileEvaluate(Compiler& compiler)
+{
+	for(unsigned int i = 0; i < getLength(); i++)
+		getObject(i)->compileEvaluate(compiler);
+	compiler.emit(BC_SEQUENCE, getLength(), this);
+}
+
 /*** Destructor ***/
 Sequence::~Sequence()
 {
-	clear();
+	releaseData();
 }
@@ -19,9 +19,20 @@
 // You should have received a copy of the GNU General Public License
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <stdexcept>
 #include <vector>
 #include "../object.h"
 
+/*** The objects of a sequence, shared by its copies ***/
+struct SequenceData
+{
+	/*** The objects ***/
+	std::vector<Object*> list;
+
+	/*** The number of sequences which refer to this data ***/
+	unsigned int refCount;
+};
+
 class Sequence : public Object
 {
 
@@ -57,13 +68,19 @@ class Sequence : public Object
 		/*** Get the list of objects ***/
 		std::vector<Object*> getList();
 
+		/*** Get part of this sequence, which shares its objects ***/
+		Sequence* slice(unsigned int pStart, unsigned int pLength);
+
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
-		// Clone this object
+		/*** Compile the evaluation of this object ***/
+		void compileEvaluate(Compiler& compiler);
+
+		// Clone this object, the objects are shared until either is modified
 		Sequence* clone() const
 		{
-			return new Sequence(list);
+			return new Sequence(data, start, length);
 		}
 
 		/*** Destructor ***/
@@ -71,8 +88,26 @@ class Sequence : public Object
 
 	private:
 
-		/*** This sequence's list ***/
-		std::vector<Object*> list;
+		/*** Constructor, refers to part of existing data ***/
+		Sequence(SequenceData* pData, unsigned int pStart, unsigned int pLength);
+
+		/*** Create empty data ***/
+		void createData();
+
+		/*** Drop the reference to the data ***/
+		void releaseData();
+
+		/*** Give this sequence data of its own before modifying it ***/
+		void detach();
+
+		/*** This sequence's data, possibly shared ***/
+		SequenceData* data;
+
+		/*** The index in the data of the first object ***/
+		unsigned int start;
+
+		/*** The number of objects ***/
+		unsigned int length;
 
 };
 
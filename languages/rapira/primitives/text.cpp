@@ -21,6 +21,7 @@
 /*** Constructor ***/
 Text::Text()
 {
+	data = 0;
 	setValue("");
 }
 
@@ -30,6 +31,7 @@ Text::Text(Token tok)
 	if(tok.getType() != T_STRING)
 		throw InvalidInitException(getLineNumber(), getColumnNumber(), OBJ_TEXT);
 
+	data = 0;
 	setValue(tok.getLexeme());
 	setLineNumber(tok.getLineNumber());
 	setColumnNumber(tok.getColumnNumber());
@@ -38,15 +40,43 @@ Text::Text(Token tok)
 /*** Constructor ***/
 Text::Text(std::string pValue)
 {
+	data = 0;
 	setValue(pValue);
 }
 
 /*** Constructor ***/
 Text::Text(char pValue)
 {
+	data = 0;
 	setValue(pValue);
 }
 
+/*** Copy constructor, the characters are shared ***/
+Text::Text(const Text& other) : Object(other)
+{
+	data = other.data;
+	data->refCount++;
+	start = other.start;
+	length = other.length;
+}
+
+/*** Constructor, refers to part of existing data ***/
+Text::Text(TextData* pData, unsigned int pStart, unsigned int pLength)
+{
+	data = pData;
+	data->refCount++;
+	start = pStart;
+	length = pLength;
+}
+
+/*** Drop the reference to the data ***/
+void Text::releaseData()
+{
+	if(data != 0 && --data->refCount == 0)
+		delete data;
+	data = 0;
+}
+
 /*** Get this object's type ***/
 unsigned char Text::getType()
 {
@@ -56,25 +86,38 @@ unsigned char Text::getType()
 /*** Get this text's length ***/
 unsigned int Text::getLength()
 {
-	return value.length();
+	return length;
 }
 
 /*** Set this text's value ***/
 void Text::setValue(std::string pValue)
 {
-	value = pValue;
+	// Shared characters are left to the other texts
+	if(data != 0 && data->refCount == 1)
+		data->value = pValue;
+	else
+	{
+		releaseData();
+		data = new TextData();
+		data->value = pValue;
+		data->refCount = 1;
+	}
+	start = 0;
+	length = pValue.length();
 }
 
 /*** Set this text's value ***/
 void Text::setValue(char pValue)
 {
-	value = std::string(1, pValue);
+	setValue(std::string(1, pValue));
 }
 
 /*** Get this text's value ***/
 std::string Text::getValue()
 {
-	return value;
+	if(start == 0 && length == data->value.length())
+		return data->value;
+	return data->value.substr(start, length);
 }
 
 /*** Evaluate this object ***/
@@ -86,10 +129,19 @@ Object* Text::evaluate()
 /*** Get a character ***/
 Text* Text::getChar(unsigned int index)
 {
-	return new Text(value.at(index));
+	if(index >= length)
+		throw std::out_of_range("Text::getChar");
+	return new Text(data->value[start + index]);
+}
+
+/*** Get part of this text, which shares its characters ***/
+Text* Text::slice(unsigned int pStart, unsigned int pLength)
+{
+	return new Text(data, start + pStart, pLength);
 }
 
 /*** Destructor ***/
 Text::~Text()
 {
+	releaseData();
 }
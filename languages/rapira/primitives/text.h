@@ -19,11 +19,22 @@
 // You should have received a copy of the GNU General Public License
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <stdexcept>
 #include <string>
 #include "../object.h"
 #include "../token.h"
 #include "../exceptions/invalidinit.h"
 
+/*** The characters of a text, shared by its copies ***/
+struct TextData
+{
+	/*** The characters ***/
+	std::string value;
+
+	/*** The number of texts which refer to this data ***/
+	unsigned int refCount;
+};
+
 class Text : public Object
 {
 
@@ -41,6 +52,9 @@ class Text : public Object
 		/*** Constructor ***/
 		Text(char pValue);
 
+		/*** Copy constructor, the characters are shared ***/
+		Text(const Text& other);
+
 		/*** Get this object's type ***/
 		unsigned char getType();
 
@@ -62,6 +76,9 @@ class Text : public Object
 		/*** Get a character ***/
 		Text* getChar(unsigned int index);
 
+		/*** Get part of this text, which shares its characters ***/
+		Text* slice(unsigned int pStart, unsigned int pLength);
+
 		/*** Clone this object ***/
 		Text* clone() const { return new Text(*this); }
 
@@ -70,8 +87,23 @@ class Text : public Object
 
 	private:
 
-		/*** The value of this text ***/
-		std::string value;
+		/*** Constructor, refers to part of existing data ***/
+		Text(TextData* pData, unsigned int pStart, unsigned int pLength);
+
+		/*** Texts are not assigned to each other ***/
+		Text& operator=(const Text& other);
+
+		/*** Drop the reference to the data ***/
+		void releaseData();
+
+		/*** This text's data, possibly shared ***/
+		TextData* data;
+
+		/*** The index in the data of the first character ***/
+		unsigned int start;
+
+		/*** The number of characters ***/
+		unsigned int length;
 
 };
 
@@ -17,11 +17,14 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "variable.h"
+#include "../compiler.h"
+#include "../scope.h"
 
 /*** Constructor ***/
 Variable::Variable()
 {
 	setIdentifier("");
+	slot = -1;
 }
 
 /*** Constructor ***/
@@ -30,12 +33,14 @@ Variable::Variable(Token tok)
 	setIdentifier(tok.getLexeme());
 	setLineNumber(tok.getLineNumber());
 	setColumnNumber(tok.getColumnNumber());
+	slot = -1;
 }
 
 /*** Constructor ***/
 Variable::Variable(std::string pIden)
 {
 	setIdentifier(pIden);
+	slot = -1;
 }
 
 /*** Get this variable's type ***/
@@ -56,13 +61,75 @@ std::string Variable::getIdentifier()
 	return iden;
 }
 
+/*** Give this variable a slot in a scope ***/
+void Variable::resolve(Scope* scope)
+{
+	// Special values are still looked up by name
+	VariableManager manager;
+	if(manager.isSpecial(iden))
+		slot = -1;
+	else
+		slot = scope->resolve(iden);
+}
+
+/*** Get this variable's slot, or -1 when it is looked up by name ***/
+int Variable::getSlot()
+{
+	return slot;
+}
+
+/*** Get the object to which this variable refers, or null ***/
+Object* Variable::getBinding()
+{
+	VariableManager manager;
+	if(slot >= 0)
+		return manager.getObject((unsigned int) slot);
+	return manager.getObject(iden);
+}
+
+/*** Set the object to which this variable refers ***/
+void Variable::setBinding(Object* obj)
+{
+	VariableManager manager;
+	if(slot >= 0)
+		manager.setObject((unsigned int) slot, obj);
+	else
+		manager.setObject(iden, obj);
+}
+
+/*** Set this variable to a value, which is taken over ***/
+void Variable::setBindingValue(Value& value)
+{
+	VariableManager manager;
+	if(slot >= 0)
+		manager.setValue((unsigned int) slot, value);
+	else
+		manager.setObject(iden, value.release());
+}
+
 /*** Evaluate this object ***/
 Object* Variable::evaluate()
 {
-	VariableManager manager;
-	if(!manager.hasObject(getIdentifier()))
+	Object* obj = getBinding();
+	if(obj == 0)
 		return new Object();
-	return manager.getObject(getIdentifier())->clone();
+	return obj->clone();
+}
+
+/*** Compile the evaluation of this object ***/
+void Variable::compileEvaluate(Compiler& compiler)
+{
+	compiler.emit(BC_LOAD, 0, this);
+}
+
+/*** Evaluate this object to a value ***/
+Value Variable::evaluateValue()
+{
+	// Numbers and logicals are read without copying the object
+	Object* obj = getBinding();
+	if(obj == 0)
+		return Value();
+	return Value::copy(obj);
 }
 
 /*** Destructor ***/
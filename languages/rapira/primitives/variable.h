@@ -24,6 +24,8 @@
 #include "../object.h"
 #include "../varmanager.h"
 
+class Scope;
+
 class Variable : public Object
 {
 
@@ -47,11 +49,37 @@ class Variable : public Object
 		/*** Get this variable's identifier ***/
 		std::string getIdentifier();
 
+		/*** Give this variable a slot in a scope ***/
+		void resolve(Scope* scope);
+
+		/*** Get this variable's slot, or -1 when it is looked up by name ***/
+		int getSlot();
+
+		/*** Get the object to which this variable refers, or null ***/
+		Object* getBinding();
+
+		/*** Set the object to which this variable refers ***/
+		void setBinding(Object* obj);
+
+		/*** Set this variable to a value, which is taken over ***/
+		void setBindingValue(Value& value);
+
 		/*** Evaluate this object ***/
 		Object* evaluate();
 
+		/*** Evaluate this object to a value ***/
+		Value evaluateValue();
+
+		/*** Compile the evaluation of this object ***/
+		void compileEvaluate(Compiler& compiler);
+
 		/*** Clone this object ***/
-		Variable* clone() const { return new Variable(iden); }
+		Variable* clone() const
+		{
+			Variable* nvar = new Variable(iden);
+			nvar->slot = slot;
+			return nvar;
+		}
 
 		/*** Destructor ***/
 		~Variable();
@@ -61,6 +89,9 @@ class Variable : public Object
 		/*** The identifier of this variable ***/
 		std::string iden;
 
+		/*** The slot of this variable in its scope ***/
+		int slot;
+
 };
 
 #endif
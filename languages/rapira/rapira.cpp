@@ -42,18 +42,34 @@ void error(Excep& e)
 
 int main(int argc, char* argv[])
 {
-	if(argc != 2)
+	// Look for the options before the filename
+	bool useTree = false;
+	bool dumpCode = false;
+	int argi = 1;
+	for(; argi < argc && argv[argi][0] == '-'; argi++)
+	{
+		if(std::string(argv[argi]) == "-t")
+			useTree = true;
+		else if(std::string(argv[argi]) == "-d")
+			dumpCode = true;
+		else
+			break;
+	}
+
+	if(argi != argc - 1)
 	{
 		std::cerr << "Invalid number of arguments!" << std::endl;
-		std::cerr << "Usage: rapira [filename]" << std::endl;
+		std::cerr << "Usage: rapira [-t] [-d] [filename]" << std::endl;
+		std::cerr << "  -t  run by walking the syntax tree" << std::endl;
+		std::cerr << "  -d  print the compiled bytecode" << std::endl;
 		return 1;
 	}
 
 	// Set the filename
-	filename = argv[1];
+	filename = argv[argi];
 
 	// Initialize the lexer
-	Lexer lexer(argv[1]);
+	Lexer lexer(argv[argi]);
 
 	// Confirm that the input file has been opened correctly
 	if(!lexer.isOpen())
@@ -85,7 +101,12 @@ int main(int argc, char* argv[])
 	try
 	{
 		parser.parse();
-		parser.executeProgram();
+		if(dumpCode)
+			parser.compileProgram()->dump();
+		else if(useTree)
+			parser.executeProgram();
+		else
+			parser.runProgram();
 	}
 	catch(Excep& e)
 	{
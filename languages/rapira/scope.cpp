@@ -0,0 +1,56 @@
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "scope.h"
+
+/*** Constructor ***/
+Scope::Scope()
+{
+}
+
+/*** Get the slot of an identifier, adding it when not found ***/
+unsigned int Scope::resolve(std::string id)
+{
+	std::map<std::string, unsigned int>::iterator it = slots.find(id);
+	if(it != slots.end())
+		return it->second;
+
+	unsigned int slot = slots.size();
+	slots[id] = slot;
+	return slot;
+}
+
+/*** Find the slot of an identifier, or -1 when not found ***/
+int Scope::find(std::string id)
+{
+	std::map<std::string, unsigned int>::iterator it = slots.find(id);
+	if(it == slots.end())
+		return -1;
+	return it->second;
+}
+
+/*** Get the number of slots ***/
+unsigned int Scope::getSize()
+{
+	return slots.size();
+}
+
+/*** Destructor ***/
+Scope::~Scope()
+{
+}
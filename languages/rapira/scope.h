@@ -0,0 +1,54 @@
+#ifndef SCOPE_H
+#define SCOPE_H
+
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <map>
+#include <string>
+
+/*** The variables of a procedure or of the main program, each ***/
+/*** identifier is given a slot in the frames of that scope.   ***/
+class Scope
+{
+
+	public:
+
+		/*** Constructor ***/
+		Scope();
+
+		/*** Get the slot of an identifier, adding it when not found ***/
+		unsigned int resolve(std::string id);
+
+		/*** Find the slot of an identifier, or -1 when not found ***/
+		int find(std::string id);
+
+		/*** Get the number of slots ***/
+		unsigned int getSize();
+
+		/*** Destructor ***/
+		~Scope();
+
+	private:
+
+		/*** The slot of each identifier ***/
+		std::map<std::string, unsigned int> slots;
+
+};
+
+#endif
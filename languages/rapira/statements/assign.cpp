@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "assign.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Assign::Assign()
@@ -47,20 +48,43 @@ void Assign::setExpression(Object* pExpr)
 /*** Execute this node ***/
 Outcome Assign::execute()
 {
-	std::auto_ptr<Object> var(target->evaluate());
-	if(var->getType() == OBJ_PROCEDURE || var->getType() == OBJ_FUNCTION)
-		throw InvalidAssignmentException(getLineNumber(), getColumnNumber(), target->getIdentifier(), "Cannot overwrite a procedure or function!");
+	Value value(expr->evaluateValue());
+	store(target, value, this);
+	return Outcome(S_SUCCESS);
+}
+
+/*** Assign an evaluated value to the target ***/
+void Assign::store(Value& value)
+{
+	store(target, value, this);
+}
+
+/*** Assign an evaluated value to a variable, the value is taken over ***/
+void Assign::store(Variable* variable, Value& value, Node* node)
+{
+	Object* current = variable->getBinding();
+	if(current != 0)
+	{
+		unsigned char type = current->getType();
+		if(type == OBJ_PROCEDURE || type == OBJ_FUNCTION)
+			throw InvalidAssignmentException(node->getLineNumber(), node->getColumnNumber(), variable->getIdentifier(), "Cannot overwrite a procedure or function!");
+	}
 
-	VariableManager manager;
 	try
 	{
-		manager.setObject(target->getIdentifier(), expr->evaluate());
+		variable->setBindingValue(value);
 	}
 	catch(InvalidAssignmentException& e)
 	{
-		throw InvalidAssignmentException(getLineNumber(), getColumnNumber(), e.getIdentifier(), e.getInformation());
+		throw InvalidAssignmentException(node->getLineNumber(), node->getColumnNumber(), e.getIdentifier(), e.getInformation());
 	}
-	return Outcome(S_SUCCESS);
+}
+
+/*** Compile this node into bytecode ***/
+void Assign::compileExecute(Compiler& compiler)
+{
+	expr->compileEvaluate(compiler);
+	compiler.emit(BC_STORE, 0, this);
 }
 
 /*** Destructor ***/
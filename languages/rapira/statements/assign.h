@@ -42,6 +42,15 @@ class Assign : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Assign an evaluated value to the target, the value is taken over ***/
+		void store(Value& value);
+
+		/*** Assign an evaluated value to a variable, the value is taken over ***/
+		static void store(Variable* variable, Value& value, Node* node);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Assign* clone() const
 		{
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "case.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Case::Case()
@@ -51,12 +52,12 @@ Outcome Case::execute()
 	{
 		for(unsigned int i = 0; i < whenStmts.size(); i++)
 		{
-			std::auto_ptr<Object> whenVal(whenStmts.at(i).first->evaluate());
+			Value whenVal(whenStmts.at(i).first->evaluateValue());
 
-			if(whenVal->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, whenVal->getType());
+			if(whenVal.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, whenVal.getType());
 
-			bool execWhen = static_cast<Logical*>(whenVal.get())->getValue();
+			bool execWhen = whenVal.getLogical();
 
 			if(execWhen)
 				return whenStmts.at(i).second->execute();
@@ -70,16 +71,15 @@ Outcome Case::execute()
 	}
 
 	// If a condition is specified
-	std::auto_ptr<Object> condVal(condition->evaluate());
+	Value condVal(condition->evaluateValue());
 
 	// Begin looking through the list of when conditions/statements
 	for(unsigned int i = 0; i < whenStmts.size(); i++)
 	{
 		// Look for an equal condition
-		std::auto_ptr<Object> whenVal(whenStmts.at(i).first->evaluate());
+		Value whenVal(whenStmts.at(i).first->evaluateValue());
 
-		std::auto_ptr<Object> equOperation(Equal(whenVal.release(), condVal->clone()).evaluate());
-		bool execWhen = static_cast<Logical*>(equOperation.get())->getValue();
+		bool execWhen = matcher.apply(whenVal, condVal).getLogical();
 
 		if(execWhen)
 			return whenStmts.at(i).second->execute();
@@ -92,6 +92,61 @@ Outcome Case::execute()
 	return Outcome(S_SUCCESS);
 }
 
+/*** Compile this node into bytecode ***/
+void Case::compileExecute(Compiler& compiler)
+{
+	unsigned int endLabel = compiler.newLabel();
+
+	// If no condition is specified
+	if(condition == 0)
+	{
+		for(unsigned int i = 0; i < whenStmts.size(); i++)
+		{
+			unsigned int nextLabel = compiler.newLabel();
+
+			whenStmts.at(i).first->compileEvaluate(compiler);
+			compiler.emitJump(BC_JUMPFALSE, nextLabel, this);
+			if(whenStmts.at(i).second != 0)
+				whenStmts.at(i).second->compileExecute(compiler);
+			compiler.emitJump(BC_JUMP, endLabel, this);
+			compiler.setLabel(nextLabel);
+		}
+
+		if(elseStmts != 0)
+			elseStmts->compileExecute(compiler);
+
+		compiler.setLabel(endLabel);
+		return;
+	}
+
+	// The condition value stays on the stack while
+	// looking for a when, and is dropped before its statements
+	matcher.setLineNumber(getLineNumber());
+	matcher.setColumnNumber(getColumnNumber());
+	condition->compileEvaluate(compiler);
+
+	for(unsigned int i = 0; i < whenStmts.size(); i++)
+	{
+		unsigned int nextLabel = compiler.newLabel();
+
+		whenStmts.at(i).first->compileEvaluate(compiler);
+		compiler.emit(BC_OVER, 0, this);
+		compiler.emit(BC_EQUAL, 0, &matcher);
+		compiler.emitJump(BC_JUMPFALSE, nextLabel, this);
+		compiler.emit(BC_POP, 0, this);
+		if(whenStmts.at(i).second != 0)
+			whenStmts.at(i).second->compileExecute(compiler);
+		compiler.emitJump(BC_JUMP, endLabel, this);
+		compiler.setLabel(nextLabel);
+	}
+
+	compiler.emit(BC_POP, 0, this);
+	if(elseStmts != 0)
+		elseStmts->compileExecute(compiler);
+
+	compiler.setLabel(endLabel);
+}
+
 /*** Destructor ***/
 Case::~Case()
 {
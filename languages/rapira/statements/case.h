@@ -44,6 +44,9 @@ class Case : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Case* clone() const
 		{
@@ -72,6 +75,9 @@ class Case : public Node
 
 		/*** The else NodeList ***/
 		NodeList* elseStmts;
+
+		/*** The comparison of a when value with the condition ***/
+		Equal matcher;
 };
 
 #endif
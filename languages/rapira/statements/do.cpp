@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "do.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Do::Do()
@@ -69,12 +70,12 @@ Outcome Do::execute()
 		// Check if an until condition needs to be checked
 		if(until != 0)
 		{
-			std::auto_ptr<Object> untilEval(until->evaluate());
+			Value untilEval(until->evaluateValue());
 
-			if(untilEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, untilEval->getType());
+			if(untilEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, untilEval.getType());
 
-			bool untilResult = static_cast<Logical*>(untilEval.get())->getValue();
+			bool untilResult = untilEval.getLogical();
 
 			if(untilResult)
 				break;
@@ -88,6 +89,36 @@ Outcome Do::execute()
 	return result;
 }
 
+/*** Compile this node into bytecode ***/
+void Do::compileExecute(Compiler& compiler)
+{
+	unsigned int topLabel = compiler.newLabel();
+	unsigned int exitLabel = compiler.newLabel();
+	unsigned int endLabel = compiler.newLabel();
+
+	compiler.setLabel(topLabel);
+	compiler.pushExit(exitLabel);
+	list->compileExecute(compiler);
+	compiler.popExit();
+
+	if(until != 0)
+	{
+		until->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, this);
+	}
+	compiler.emitJump(BC_JUMP, topLabel, this);
+
+	// An exit still evaluates the until condition
+	compiler.setLabel(exitLabel);
+	if(until != 0)
+	{
+		until->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, this);
+	}
+
+	compiler.setLabel(endLabel);
+}
+
 /*** Destructor ***/
 Do::~Do()
 {
@@ -49,6 +49,9 @@ class Do : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Do* clone() const
 		{
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "end.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 End::End()
@@ -29,6 +30,12 @@ Outcome End::execute()
 	return Outcome(S_END);
 }
 
+/*** Compile this node into bytecode ***/
+void End::compileExecute(Compiler& compiler)
+{
+	compiler.emit(BC_LEAVE, S_END, this);
+}
+
 /*** Destructor ***/
 End::~End()
 {
@@ -32,6 +32,9 @@ class End : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		End* clone() const
 		{
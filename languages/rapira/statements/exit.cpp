@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "exit.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Exit::Exit()
@@ -29,6 +30,12 @@ Outcome Exit::execute()
 	return Outcome(S_EXIT);
 }
 
+/*** Compile this node into bytecode ***/
+void Exit::compileExecute(Compiler& compiler)
+{
+	compiler.emitExit(this);
+}
+
 /*** Destructor ***/
 Exit::~Exit()
 {
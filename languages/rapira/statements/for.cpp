@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "for.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 For::For()
@@ -82,20 +83,9 @@ Outcome For::execute()
 	if(forValue->getType() != OP_VARIABLE)
 		throw Excep(getLineNumber(), getColumnNumber(), "For loop must be given a valid variable.");
 
-	// Store the for value variable
-	Variable* forVar = static_cast<Variable*>(forValue);
-
 	// If a from value was given, set the counter to this initial value
-	if(from != 0)
-	{
-		// Evaluate the 
-		std::auto_ptr<Object> fromEval(from->evaluate());
-		if(fromEval->getType() != OBJ_INTEGER && fromEval->getType() != OBJ_REAL)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, fromEval->getType());
-		Assign(forVar->clone(), fromEval.release()).execute();
-	}
-	else
-		Assign(forVar->clone(), new Integer(1)).execute();
+	Value fromEval(from != 0 ? from->evaluateValue() : Value::makeInteger(1));
+	start(fromEval);
 
 	// Create an Outcome object to store the result
 	Outcome result(S_SUCCESS);
@@ -105,52 +95,23 @@ Outcome For::execute()
 		// Check the while condition, if present
 		if(whileCond != 0)
 		{
-			std::auto_ptr<Object> whileCondEval(whileCond->evaluate());
-			if(whileCondEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, whileCondEval->getType());
-			bool whileCondResult = static_cast<Logical*>(whileCondEval.get())->getValue();
+			Value whileCondEval(whileCond->evaluateValue());
+			if(whileCondEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, whileCondEval.getType());
 
-			if(!whileCondResult)
+			if(!whileCondEval.getLogical())
 				break;
 		}
 
 		// Check the to value
 		if(to != 0)
 		{
-			std::auto_ptr<Object> toEval(to->evaluate());
+			Value toEval(to->evaluateValue());
 
 			// Store the step value evaluated
-			std::auto_ptr<Object> stepEval;
-			if(step == 0)
-				stepEval.reset(new Integer(1));
-			else
-				stepEval.reset(step->evaluate());
-
-			// Confirm that the step is an integer
-			if(stepEval->getType() != OBJ_INTEGER && stepEval->getType() != OBJ_REAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, stepEval->getType());
-
-			std::auto_ptr<Real> castStep;
-			// Cast the step value to a real
-			if(stepEval->getType() == OBJ_INTEGER)
-				castStep.reset(new Real(static_cast<Integer*>(stepEval.get())->getValue()));
-			else
-				castStep.reset(static_cast<Real*>(stepEval.release()));
-
-			bool toCondition = false;
-
-			if(castStep->getValue() > 0)
-			{
-				std::auto_ptr<Object> operation(Greater(forVar->clone(), toEval.release()).evaluate());
-				toCondition = static_cast<Logical*>(operation.get())->getValue();
-			}
-			if(castStep->getValue() < 0)
-			{
-				std::auto_ptr<Object> operation(Less(forVar->clone(), toEval.release()).evaluate());
-				toCondition = static_cast<Logical*>(operation.get())->getValue();
-			}
-
-			if(toCondition)
+			Value stepEval(step != 0 ? step->evaluateValue() : Value::makeInteger(1));
+
+			if(isFinished(toEval, stepEval))
 				break;
 		}
 
@@ -158,29 +119,17 @@ Outcome For::execute()
 		result = list->execute();
 
 		// Modify forVar based on step
-		if(step == 0)
-		{
-			std::auto_ptr<Object> addOperation(Add(forVar->clone(), new Integer(1)).evaluate());
-			Assign(forVar->clone(), addOperation.release()).execute();
-		}
-		else
-		{
-			std::auto_ptr<Object> stepEval(step->evaluate());
-			if(stepEval->getType() != OBJ_INTEGER && stepEval->getType() != OBJ_REAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, stepEval->getType());
-			std::auto_ptr<Object> addOperation(Add(forVar->clone(), stepEval.release()).evaluate());
-			Assign(forVar->clone(), addOperation.release()).execute();
-		}
+		Value stepEval(step != 0 ? step->evaluateValue() : Value::makeInteger(1));
+		advance(stepEval);
 
 		// Check the until condition, if present
 		if(untilCond != 0)
 		{
-			std::auto_ptr<Object> untilEval(untilCond->evaluate());
-			if(untilEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, untilEval->getType());
-			bool untilResult = static_cast<Logical*>(untilEval.get())->getValue();
+			Value untilEval(untilCond->evaluateValue());
+			if(untilEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_LOGICAL, untilEval.getType());
 
-			if(untilResult)
+			if(untilEval.getLogical())
 				break;
 		}
 	}
@@ -189,6 +138,126 @@ Outcome For::execute()
 	return result;
 }
 
+/*** Set the counter to an evaluated initial value ***/
+void For::start(Value& fromEval)
+{
+	if(fromEval.getType() != OBJ_INTEGER && fromEval.getType() != OBJ_REAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, fromEval.getType());
+	Assign::store(static_cast<Variable*>(forValue), fromEval, this);
+}
+
+/*** If the counter has passed the evaluated to value ***/
+bool For::isFinished(const Value& toEval, const Value& stepEval)
+{
+	// Confirm that the step is a number
+	if(stepEval.getType() != OBJ_INTEGER && stepEval.getType() != OBJ_REAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, stepEval.getType());
+
+	double stepValue;
+	if(stepEval.getType() == OBJ_INTEGER)
+		stepValue = stepEval.getInteger();
+	else
+		stepValue = stepEval.getReal();
+
+	Value forEval(forValue->evaluateValue());
+
+	if(stepValue > 0)
+	{
+		Greater greater;
+		return greater.apply(forEval, toEval).getLogical();
+	}
+	if(stepValue < 0)
+	{
+		Less less;
+		return less.apply(forEval, toEval).getLogical();
+	}
+	return false;
+}
+
+/*** Advance the counter by an evaluated step ***/
+void For::advance(const Value& stepEval)
+{
+	if(stepEval.getType() != OBJ_INTEGER && stepEval.getType() != OBJ_REAL)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL, stepEval.getType());
+
+	Value forEval(forValue->evaluateValue());
+	Add add;
+	Value sum(add.apply(forEval, stepEval));
+	Assign::store(static_cast<Variable*>(forValue), sum, this);
+}
+
+/*** Compile the evaluation of the step ***/
+static void compileStep(Compiler& compiler, Object* step, Node* node)
+{
+	if(step == 0)
+		compiler.emitConstant(new Integer(1), node);
+	else
+		step->compileEvaluate(compiler);
+}
+
+/*** Compile this node into bytecode ***/
+void For::compileExecute(Compiler& compiler)
+{
+	// Let the tree report a missing or invalid variable
+	if(forValue == 0 || forValue->getType() != OP_VARIABLE)
+	{
+		Node::compileExecute(compiler);
+		return;
+	}
+
+	unsigned int topLabel = compiler.newLabel();
+	unsigned int exitLabel = compiler.newLabel();
+	unsigned int skipLabel = compiler.newLabel();
+	unsigned int endLabel = compiler.newLabel();
+
+	if(from != 0)
+		from->compileEvaluate(compiler);
+	else
+		compiler.emitConstant(new Integer(1), this);
+	compiler.emit(BC_FORINIT, 0, this);
+
+	compiler.setLabel(topLabel);
+	if(whileCond != 0)
+	{
+		whileCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPFALSE, endLabel, this);
+	}
+	if(to != 0)
+	{
+		to->compileEvaluate(compiler);
+		compileStep(compiler, step, this);
+		compiler.emitJump(BC_FORTEST, endLabel, this);
+	}
+
+	compiler.pushExit(exitLabel);
+	list->compileExecute(compiler);
+	compiler.popExit();
+
+	compileStep(compiler, step, this);
+	compiler.emit(BC_FORSTEP, 0, this);
+	if(untilCond != 0)
+	{
+		untilCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, this);
+	}
+	compiler.emitJump(BC_JUMP, topLabel, this);
+
+	// An exit still advances the counter and then leaves
+	// the enclosing loop too, as the tree walker does
+	compiler.setLabel(exitLabel);
+	compileStep(compiler, step, this);
+	compiler.emit(BC_FORSTEP, 0, this);
+	if(untilCond != 0)
+	{
+		untilCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, skipLabel, this);
+		compiler.setLabel(skipLabel);
+	}
+	compiler.emitExit(this);
+
+	compiler.setLabel(endLabel);
+}
+
 /*** Destructor ***/
 For::~For()
 {
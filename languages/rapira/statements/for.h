@@ -61,6 +61,18 @@ class For : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Set the counter to an evaluated initial value ***/
+		void start(Value& fromEval);
+
+		/*** If the counter has passed the evaluated to value ***/
+		bool isFinished(const Value& toEval, const Value& stepEval);
+
+		/*** Advance the counter by an evaluated step ***/
+		void advance(const Value& stepEval);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		For* clone() const
 		{
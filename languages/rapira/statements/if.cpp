@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "if.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 If::If()
@@ -47,18 +48,15 @@ void If::setElseStatements(NodeList* pElseStmts)
 /*** Execute this node ***/
 Outcome If::execute()
 {
-	std::auto_ptr<Object> ifEval(ifExpr->evaluate());
+	Value ifEval(ifExpr->evaluateValue());
 
-	if(ifEval->getType() != OBJ_LOGICAL)
-		throw InvalidTypeException(ifExpr->getLineNumber(), ifExpr->getColumnNumber(), OBJ_LOGICAL, ifEval->getType());
-
-	// Cast the if evaluation to a logical object
-	Logical* ifResult = static_cast<Logical*>(ifEval.get());
+	if(ifEval.getType() != OBJ_LOGICAL)
+		throw InvalidTypeException(ifExpr->getLineNumber(), ifExpr->getColumnNumber(), OBJ_LOGICAL, ifEval.getType());
 
 	Outcome result(S_SUCCESS);
 
 	// Execute the if block
-	if(ifResult->getValue() == true)
+	if(ifEval.getLogical() == true)
 		result = ifStmts->execute();
 
 	// Execute an else block, if necessary
@@ -68,6 +66,28 @@ Outcome If::execute()
 	return result;
 }
 
+/*** Compile this node into bytecode ***/
+void If::compileExecute(Compiler& compiler)
+{
+	unsigned int elseLabel = compiler.newLabel();
+	unsigned int endLabel = compiler.newLabel();
+
+	ifExpr->compileEvaluate(compiler);
+	compiler.emitJump(BC_JUMPFALSE, elseLabel, ifExpr);
+	ifStmts->compileExecute(compiler);
+
+	if(elseStmts != 0 && elseStmts->getLength() != 0)
+	{
+		compiler.emitJump(BC_JUMP, endLabel, this);
+		compiler.setLabel(elseLabel);
+		elseStmts->compileExecute(compiler);
+	}
+	else
+		compiler.setLabel(elseLabel);
+
+	compiler.setLabel(endLabel);
+}
+
 /*** Destructor ***/
 If::~If()
 {
@@ -43,6 +43,9 @@ class If : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		If* clone() const
 		{
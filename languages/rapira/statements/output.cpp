@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "output.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Output::Output()
@@ -49,48 +50,8 @@ Outcome Output::execute()
 	for(unsigned int i = 0; i < exprs.size(); i++)
 	{
 		// Evaluate the current expression
-		std::auto_ptr<Object> val(exprs.at(i)->evaluate());
-
-		if(val->getType() == OBJ_EMPTY)
-			std::cout << "empty";
-		else if(val->getType() == OBJ_INTEGER)
-		{
-			Integer* cast = static_cast<Integer*>(val.get());
-			std::cout << cast->getValue();
-		}
-		else if(val->getType() == OBJ_REAL)
-		{
-			Real* cast = static_cast<Real*>(val.get());
-			std::cout << cast->getValue();
-		}
-		else if(val->getType() == OBJ_TEXT)
-		{
-			Text* cast = static_cast<Text*>(val.get());
-			std::cout << cast->getValue();
-		}
-		else if(val->getType() == OBJ_LOGICAL)
-		{
-			Logical* cast = static_cast<Logical*>(val.get());
-			if(cast->getValue() == true)
-				std::cout << "yes";
-			else
-				std::cout << "no";
-		}
-		else if(val->getType() == OBJ_SEQUENCE)
-		{
-			Sequence* seq = static_cast<Sequence*>(val.get());
-			std::cout << "<* ";
-			for(unsigned int i = 0; i < seq->getLength(); i++)
-			{
-				Output outElement(seq->getObject(i)->clone(), false);
-				outElement.execute();
-				if(i != seq->getLength() - 1)
-					std::cout << ", ";
-			}
-			std::cout << " *>";
-		}
-		else
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_LOGICAL | OBJ_SEQUENCE, val->getType(), i + 1);
+		Value val(exprs.at(i)->evaluateValue());
+		print(val, i + 1);
 	}
 
 	if(newline)
@@ -99,6 +60,57 @@ Outcome Output::execute()
 	return Outcome(S_SUCCESS);
 }
 
+/*** Print an evaluated value ***/
+void Output::print(const Value& val, unsigned int number)
+{
+	if(val.getType() == OBJ_EMPTY)
+		std::cout << "empty";
+	else if(val.getType() == OBJ_INTEGER)
+		std::cout << val.getInteger();
+	else if(val.getType() == OBJ_REAL)
+		std::cout << val.getReal();
+	else if(val.getType() == OBJ_TEXT)
+	{
+		Text* cast = static_cast<Text*>(val.getObject());
+		std::cout << cast->getValue();
+	}
+	else if(val.getType() == OBJ_LOGICAL)
+	{
+		if(val.getLogical() == true)
+			std::cout << "yes";
+		else
+			std::cout << "no";
+	}
+	else if(val.getType() == OBJ_SEQUENCE)
+	{
+		Sequence* seq = static_cast<Sequence*>(val.getObject());
+		std::cout << "<* ";
+		for(unsigned int i = 0; i < seq->getLength(); i++)
+		{
+			Output outElement(seq->getObject(i)->clone(), false);
+			outElement.execute();
+			if(i != seq->getLength() - 1)
+				std::cout << ", ";
+		}
+		std::cout << " *>";
+	}
+	else
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER | OBJ_REAL | OBJ_TEXT | OBJ_LOGICAL | OBJ_SEQUENCE, val.getType(), number);
+}
+
+/*** Compile this node into bytecode ***/
+void Output::compileExecute(Compiler& compiler)
+{
+	for(unsigned int i = 0; i < exprs.size(); i++)
+	{
+		exprs.at(i)->compileEvaluate(compiler);
+		compiler.emit(BC_OUTPUT, i + 1, this);
+	}
+
+	if(newline)
+		compiler.emit(BC_NEWLINE, 0, this);
+}
+
 /*** Destructor ***/
 Output::~Output()
 {
@@ -49,6 +49,12 @@ class Output : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Print an evaluated value ***/
+		void print(const Value& val, unsigned int number);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Output* clone() const
 		{
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "repeat.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Repeat::Repeat()
@@ -54,15 +55,8 @@ void Repeat::setStatements(NodeList* pList)
 /*** Execute this node ***/
 Outcome Repeat::execute()
 {
-	// Make sure that the counter evaluates to a number
-	std::auto_ptr<Object> countEval(counter->evaluate());
-	if(countEval->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(counter->getLineNumber(), counter->getColumnNumber(), OBJ_INTEGER, countEval->getType());
-	long loopNum = static_cast<Integer*>(countEval.get())->getValue();
-
-	// Make sure loopNum is not less than zero
-	if(loopNum < 0)
-		throw NegativeValueException(getLineNumber(), getColumnNumber(), loopNum);
+	Value countEval(counter->evaluateValue());
+	long loopNum = checkCounter(countEval);
 
 	// Create an Outcome object to store the result
 	Outcome result(S_SUCCESS);
@@ -72,10 +66,10 @@ Outcome Repeat::execute()
 		// Check the while condition, if present
 		if(whileCond != 0)
 		{
-			std::auto_ptr<Object> whileCondEval(whileCond->evaluate());
-			if(whileCondEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(whileCond->getLineNumber(), whileCond->getColumnNumber(), OBJ_LOGICAL, whileCondEval->getType());
-			bool whileCondResult = static_cast<Logical*>(whileCondEval.get())->getValue();
+			Value whileCondEval(whileCond->evaluateValue());
+			if(whileCondEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(whileCond->getLineNumber(), whileCond->getColumnNumber(), OBJ_LOGICAL, whileCondEval.getType());
+			bool whileCondResult = whileCondEval.getLogical();
 
 			if(!whileCondResult)
 				break;
@@ -87,12 +81,12 @@ Outcome Repeat::execute()
 		// Evaluate the until condition, if present
 		if(untilCond != 0)
 		{
-			std::auto_ptr<Object> untilEval(untilCond->evaluate());
+			Value untilEval(untilCond->evaluateValue());
 
-			if(untilEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(untilCond->getLineNumber(), untilCond->getColumnNumber(), OBJ_LOGICAL, untilEval->getType());
+			if(untilEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(untilCond->getLineNumber(), untilCond->getColumnNumber(), OBJ_LOGICAL, untilEval.getType());
 
-			bool untilResult = static_cast<Logical*>(untilEval.get())->getValue();
+			bool untilResult = untilEval.getLogical();
 
 			if(untilResult)
 				break;
@@ -107,6 +101,64 @@ Outcome Repeat::execute()
 	return result;
 }
 
+/*** Check the evaluated counter, return the number of iterations ***/
+long Repeat::checkCounter(const Value& countEval)
+{
+	// Make sure that the counter evaluates to a number
+	if(countEval.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(counter->getLineNumber(), counter->getColumnNumber(), OBJ_INTEGER, countEval.getType());
+	long loopNum = countEval.getInteger();
+
+	// Make sure loopNum is not less than zero
+	if(loopNum < 0)
+		throw NegativeValueException(getLineNumber(), getColumnNumber(), loopNum);
+
+	return loopNum;
+}
+
+/*** Compile this node into bytecode ***/
+void Repeat::compileExecute(Compiler& compiler)
+{
+	unsigned int topLabel = compiler.newLabel();
+	unsigned int exitLabel = compiler.newLabel();
+	unsigned int endLabel = compiler.newLabel();
+
+	// The remaining number of iterations is kept on the stack
+	counter->compileEvaluate(compiler);
+	compiler.emit(BC_REPEATINIT, 0, this);
+
+	compiler.setLabel(topLabel);
+	compiler.emitJump(BC_REPEATTEST, endLabel, this);
+	if(whileCond != 0)
+	{
+		whileCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPFALSE, endLabel, whileCond);
+	}
+
+	compiler.pushExit(exitLabel);
+	list->compileExecute(compiler);
+	compiler.popExit();
+
+	if(untilCond != 0)
+	{
+		untilCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, untilCond);
+	}
+	compiler.emit(BC_REPEATSTEP, 0, this);
+	compiler.emitJump(BC_JUMP, topLabel, this);
+
+	// An exit still evaluates the until condition
+	compiler.setLabel(exitLabel);
+	if(untilCond != 0)
+	{
+		untilCond->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, untilCond);
+	}
+
+	compiler.setLabel(endLabel);
+	compiler.emit(BC_POP, 0, this);
+}
+
 /*** Destructor ***/
 Repeat::~Repeat()
 {
@@ -48,6 +48,12 @@ class Repeat : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Check the evaluated counter, return the number of iterations ***/
+		long checkCounter(const Value& countEval);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		Repeat* clone() const
 		{
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "return.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 Return::Return()
@@ -51,6 +52,19 @@ Outcome Return::execute()
 	return retVal;
 }
 
+/*** Compile this node into bytecode ***/
+void Return::compileExecute(Compiler& compiler)
+{
+	if(expr == 0)
+	{
+		compiler.emit(BC_LEAVE, S_RETURN, this);
+		return;
+	}
+
+	expr->compileEvaluate(compiler);
+	compiler.emit(BC_RETURN, 0, this);
+}
+
 /*** Destructor ***/
 Return::~Return()
 {
@@ -41,6 +41,9 @@ class Return : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this node ***/
 		Return* clone() const
 		{
@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "selectassign.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 SelectAssign::SelectAssign()
@@ -55,29 +56,38 @@ void SelectAssign::setExpression(Object* pExpr)
 /*** Execute this node ***/
 Outcome SelectAssign::execute()
 {
-	std::auto_ptr<Object> indexObject(index->evaluate());
+	Value indexObject(index->evaluateValue());
+	Value obj2(expr->evaluateValue());
 
+	store(indexObject, obj2);
+	return Outcome(S_SUCCESS);
+}
+
+/*** Assign an evaluated value at an evaluated index ***/
+void SelectAssign::store(const Value& indexObject, const Value& obj2)
+{
 	// Confirm that the index given is an integer
-	if(indexObject->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, indexObject->getType());
+	if(indexObject.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, indexObject.getType());
 
-	long numIndex = static_cast<Integer*>(indexObject.get())->getValue();
+	long numIndex = indexObject.getInteger();
 
 	// Confirm that numIndex is greater than zero
 	if(numIndex <= 0)
 		throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex);
 
-	// Store the evaluated target and expr
-	std::auto_ptr<Object> obj1(target->evaluate());
-	std::auto_ptr<Object> obj2(expr->evaluate());
+	// Look at the target in place, a sequence is only
+	// copied when its objects are shared with another
+	Object* obj1 = target->getBinding();
+	unsigned char type = (obj1 != 0 ? obj1->getType() : OBJ_EMPTY);
 
-	if(obj1->getType() == OBJ_TEXT)
+	if(type == OBJ_TEXT)
 	{
-		if(obj2->getType() != OBJ_TEXT)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, obj2->getType());
+		if(obj2.getType() != OBJ_TEXT)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, obj2.getType());
 
-		Text* cast1 = static_cast<Text*>(obj1.get());
-		Text* cast2 = static_cast<Text*>(obj2.get());
+		Text* cast1 = static_cast<Text*>(obj1);
+		Text* cast2 = static_cast<Text*>(obj2.getObject());
 
 		if(numIndex > (int) cast1->getLength())
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex);
@@ -89,23 +99,30 @@ Outcome SelectAssign::execute()
 		modified.replace(numIndex - 1, 1, cast2->getValue());
 
 		Text* modText = new Text(modified);
-		return Assign(target->clone(), modText).execute();
+		Assign(target->clone(), modText).execute();
+		return;
 	}
 
-	if(obj1->getType() == OBJ_SEQUENCE)
+	if(type == OBJ_SEQUENCE)
 	{
-		Sequence* cast = static_cast<Sequence*>(obj1.get());
+		Sequence* cast = static_cast<Sequence*>(obj1);
 
 		if(numIndex > (int) cast->getLength())
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex);
 
-		std::auto_ptr<Sequence> seqClone(cast->clone());
-		seqClone->setObject(numIndex - 1, obj2->clone());
-		return Assign(target->clone(), seqClone.release()).execute();
+		cast->setObject(numIndex - 1, obj2.toObject());
+		return;
 	}
 
-	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE | OBJ_TEXT, obj1->getType());
-	return 0;
+	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE | OBJ_TEXT, type);
+}
+
+/*** Compile this node into bytecode ***/
+void SelectAssign::compileExecute(Compiler& compiler)
+{
+	index->compileEvaluate(compiler);
+	expr->compileEvaluate(compiler);
+	compiler.emit(BC_SELECTASSIGN, 0, this);
 }
 
 /*** Destructor ***/
@@ -50,6 +50,12 @@ class SelectAssign : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Assign an evaluated value at an evaluated index ***/
+		void store(const Value& indexObject, const Value& obj2);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		SelectAssign* clone() const
 		{
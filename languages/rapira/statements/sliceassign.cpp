@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "sliceassign.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 SliceAssign::SliceAssign()
@@ -63,17 +64,25 @@ void SliceAssign::setExpression(Object* pExpr)
 /*** Execute this node ***/
 Outcome SliceAssign::execute()
 {
-	std::auto_ptr<Object> evalIndex1(index1->evaluate());
-	std::auto_ptr<Object> evalIndex2(index2->evaluate());
+	Value evalIndex1(index1->evaluateValue());
+	Value evalIndex2(index2->evaluateValue());
+	Value evalExpr(expr->evaluateValue());
 
+	store(evalIndex1, evalIndex2, evalExpr);
+	return Outcome(S_SUCCESS);
+}
+
+/*** Assign an evaluated value between evaluated indices ***/
+void SliceAssign::store(const Value& evalIndex1, const Value& evalIndex2, const Value& evalExpr)
+{
 	// Confirm that the indices given are integers
-	if(evalIndex1->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, evalIndex1->getType());
-	if(evalIndex2->getType() != OBJ_INTEGER)
-		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, evalIndex2->getType());
+	if(evalIndex1.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, evalIndex1.getType());
+	if(evalIndex2.getType() != OBJ_INTEGER)
+		throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_INTEGER, evalIndex2.getType());
 
-	long numIndex1 = static_cast<Integer*>(evalIndex1.get())->getValue();
-	long numIndex2 = static_cast<Integer*>(evalIndex2.get())->getValue();
+	long numIndex1 = evalIndex1.getInteger();
+	long numIndex2 = evalIndex2.getInteger();
 
 	// Confirm that numIndex is greater than zero
 	if(numIndex1 <= 0)
@@ -82,15 +91,14 @@ Outcome SliceAssign::execute()
 		throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex2);
 
 	std::auto_ptr<Object> evalTarget(target->evaluate());
-	std::auto_ptr<Object> evalExpr(expr->evaluate());
 
 	if(evalTarget->getType() == OBJ_TEXT)
 	{
-		if(evalExpr->getType() != OBJ_TEXT)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, evalExpr->getType());
+		if(evalExpr.getType() != OBJ_TEXT)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_TEXT, evalExpr.getType());
 
 		Text* cast1 = static_cast<Text*>(evalTarget.get());
-		Text* cast2 = static_cast<Text*>(evalExpr.get());
+		Text* cast2 = static_cast<Text*>(evalExpr.getObject());
 
 		if(numIndex1 > (int) cast1->getLength() || numIndex1 > numIndex2)
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex1);
@@ -102,16 +110,17 @@ Outcome SliceAssign::execute()
 		modified.append(cast2->getValue());
 		modified.append(cast1->getValue().substr(numIndex2, cast1->getLength() - numIndex2));
 
-		return Assign(target->clone(), new Text(modified)).execute();
+		Assign(target->clone(), new Text(modified)).execute();
+		return;
 	}
 
 	if(evalTarget->getType() == OBJ_SEQUENCE)
 	{
-		if(evalExpr->getType() != OBJ_SEQUENCE)
-			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, evalExpr->getType());
+		if(evalExpr.getType() != OBJ_SEQUENCE)
+			throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE, evalExpr.getType());
 
 		Sequence* cast1 = static_cast<Sequence*>(evalTarget.get());
-		Sequence* cast2 = static_cast<Sequence*>(evalExpr.get());
+		Sequence* cast2 = static_cast<Sequence*>(evalExpr.getObject());
 
 		if(numIndex1 > (int) cast1->getLength() || numIndex1 > numIndex2)
 			throw InvalidIndexException(getLineNumber(), getColumnNumber(), numIndex1);
@@ -126,11 +135,20 @@ Outcome SliceAssign::execute()
 		for(unsigned int k = numIndex2; k < cast1->getLength(); k++)
 			seqResult->pushObject(cast1->getObject(k)->clone());
 
-		return Assign(target->clone(), seqResult).execute();
+		Assign(target->clone(), seqResult).execute();
+		return;
 	}
 
 	throw InvalidTypeException(getLineNumber(), getColumnNumber(), OBJ_SEQUENCE | OBJ_TEXT, evalTarget->getType());
-	return 0;
+}
+
+/*** Compile this node into bytecode ***/
+void SliceAssign::compileExecute(Compiler& compiler)
+{
+	index1->compileEvaluate(compiler);
+	index2->compileEvaluate(compiler);
+	expr->compileEvaluate(compiler);
+	compiler.emit(BC_SLICEASSIGN, 0, this);
 }
 
 /*** Destructor ***/
@@ -48,6 +48,12 @@ class SliceAssign : public Node
 		/*** Execute this node ***/
 		Outcome execute();
 
+		/*** Assign an evaluated value between evaluated indices ***/
+		void store(const Value& evalIndex1, const Value& evalIndex2, const Value& evalExpr);
+
+		/*** Compile this node into bytecode ***/
+		void compileExecute(Compiler& compiler);
+
 		/*** Clone this object ***/
 		SliceAssign* clone() const
 		{
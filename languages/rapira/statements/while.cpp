@@ -17,6 +17,7 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "while.h"
+#include "../compiler.h"
 
 /*** Constructor ***/
 While::While()
@@ -68,10 +69,10 @@ Outcome While::execute()
 	do
 	{
 		// Check the condition
-		std::auto_ptr<Object> condEval(cond->evaluate());
-		if(condEval->getType() != OBJ_LOGICAL)
-			throw InvalidTypeException(cond->getLineNumber(), cond->getColumnNumber(), OBJ_LOGICAL, condEval->getType());
-		bool condResult = dynamic_cast<Logical*>(condEval.get())->getValue();
+		Value condEval(cond->evaluateValue());
+		if(condEval.getType() != OBJ_LOGICAL)
+			throw InvalidTypeException(cond->getLineNumber(), cond->getColumnNumber(), OBJ_LOGICAL, condEval.getType());
+		bool condResult = condEval.getLogical();
 
 		if(!condResult)
 			break;
@@ -81,11 +82,11 @@ Outcome While::execute()
 		// Evaluate the until condition, if present
 		if(until != 0)
 		{
-			std::auto_ptr<Object> untilEval(until->evaluate());
+			Value untilEval(until->evaluateValue());
 
-			if(untilEval->getType() != OBJ_LOGICAL)
-				throw InvalidTypeException(until->getLineNumber(), until->getColumnNumber(), OBJ_LOGICAL, untilEval->getType());
-			bool untilResult = static_cast<Logical*>(untilEval.get())->getValue();
+			if(untilEval.getType() != OBJ_LOGICAL)
+				throw InvalidTypeException(until->getLineNumber(), until->getColumnNumber(), OBJ_LOGICAL, untilEval.getType());
+			bool untilResult = untilEval.getLogical();
 
 			if(untilResult)
 				break;
@@ -99,6 +100,39 @@ Outcome While::execute()
 	return result;
 }
 
+/*** Compile this node into bytecode ***/
+void While::compileExecute(Compiler& compiler)
+{
+	unsigned int topLabel = compiler.newLabel();
+	unsigned int exitLabel = compiler.newLabel();
+	unsigned int endLabel = compiler.newLabel();
+
+	compiler.setLabel(topLabel);
+	cond->compileEvaluate(compiler);
+	compiler.emitJump(BC_JUMPFALSE, endLabel, cond);
+
+	compiler.pushExit(exitLabel);
+	list->compileExecute(compiler);
+	compiler.popExit();
+
+	if(until != 0)
+	{
+		until->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, until);
+	}
+	compiler.emitJump(BC_JUMP, topLabel, this);
+
+	// An exit still evaluates the until condition
+	compiler.setLabel(exitLabel);
+	if(until != 0)
+	{
+		until->compileEvaluate(compiler);
+		compiler.emitJump(BC_JUMPTRUE, endLabel, until);
+	}
+
+	compiler.setLabel(endLabel);
+}
+
 /*** Destructor ***/
 While::~While()
 {
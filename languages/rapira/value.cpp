@@ -0,0 +1,186 @@
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "value.h"
+#include "primitives/integer.h"
+#include "primitives/real.h"
+#include "primitives/logical.h"
+
+/*** Constructor, an empty value ***/
+Value::Value()
+{
+	type = OBJ_EMPTY;
+	data.object = 0;
+}
+
+/*** Constructor, takes over an evaluated object ***/
+Value::Value(Object* pObj)
+{
+	type = OBJ_EMPTY;
+	data.object = 0;
+	if(pObj == 0)
+		return;
+
+	switch(pObj->getType())
+	{
+		case OBJ_EMPTY:
+			break;
+		case OBJ_INTEGER:
+			type = OBJ_INTEGER;
+			data.integer = static_cast<Integer*>(pObj)->getValue();
+			break;
+		case OBJ_REAL:
+			type = OBJ_REAL;
+			data.real = static_cast<Real*>(pObj)->getValue();
+			break;
+		case OBJ_LOGICAL:
+			type = OBJ_LOGICAL;
+			data.logical = static_cast<Logical*>(pObj)->getValue();
+			break;
+		default:
+			type = pObj->getType();
+			data.object = pObj;
+			return;
+	}
+	delete pObj;
+}
+
+/*** Copy constructor ***/
+Value::Value(const Value& other)
+{
+	type = other.type;
+	data = other.data;
+	if(isBoxed())
+		data.object = other.data.object->clone();
+}
+
+/*** Assignment ***/
+Value& Value::operator=(const Value& other)
+{
+	Value temp(other);
+	swap(temp);
+	return *this;
+}
+
+/*** Create an integer value ***/
+Value Value::makeInteger(long pValue)
+{
+	Value result;
+	result.type = OBJ_INTEGER;
+	result.data.integer = pValue;
+	return result;
+}
+
+/*** Create a real value ***/
+Value Value::makeReal(double pValue)
+{
+	Value result;
+	result.type = OBJ_REAL;
+	result.data.real = pValue;
+	return result;
+}
+
+/*** Create a logical value ***/
+Value Value::makeLogical(bool pValue)
+{
+	Value result;
+	result.type = OBJ_LOGICAL;
+	result.data.logical = pValue;
+	return result;
+}
+
+/*** Create a value from an object which is not taken over ***/
+Value Value::copy(Object* obj)
+{
+	switch(obj->getType())
+	{
+		case OBJ_EMPTY:
+			return Value();
+		case OBJ_INTEGER:
+			return makeInteger(static_cast<Integer*>(obj)->getValue());
+		case OBJ_REAL:
+			return makeReal(static_cast<Real*>(obj)->getValue());
+		case OBJ_LOGICAL:
+			return makeLogical(static_cast<Logical*>(obj)->getValue());
+	}
+	return Value(obj->clone());
+}
+
+/*** Get the object of a value kept on the heap, or null ***/
+Object* Value::getObject() const
+{
+	if(isBoxed())
+		return data.object;
+	return 0;
+}
+
+/*** Create an object holding a copy of this value ***/
+Object* Value::toObject() const
+{
+	switch(type)
+	{
+		case OBJ_EMPTY:
+			return new Object();
+		case OBJ_INTEGER:
+			return new Integer(data.integer);
+		case OBJ_REAL:
+			return new Real(data.real);
+		case OBJ_LOGICAL:
+			return new Logical(data.logical);
+	}
+	return data.object->clone();
+}
+
+/*** Give up the contents as an object, leaving this value empty ***/
+Object* Value::release()
+{
+	Object* result;
+	if(isBoxed())
+		result = data.object;
+	else
+		result = toObject();
+
+	type = OBJ_EMPTY;
+	data.object = 0;
+	return result;
+}
+
+/*** Exchange the contents of two values ***/
+void Value::swap(Value& other)
+{
+	unsigned char tempType = type;
+	type = other.type;
+	other.type = tempType;
+
+	Data tempData = data;
+	data = other.data;
+	other.data = tempData;
+}
+
+/*** If the value is kept on the heap ***/
+bool Value::isBoxed() const
+{
+	return type != OBJ_EMPTY && type != OBJ_INTEGER && type != OBJ_REAL && type != OBJ_LOGICAL;
+}
+
+/*** Destructor ***/
+Value::~Value()
+{
+	if(isBoxed())
+		delete data.object;
+}
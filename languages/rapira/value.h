@@ -0,0 +1,116 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+class Object;
+
+/*** The result of an evaluation.  Integers, reals and logicals ***/
+/*** are held inline, any other object is kept on the heap.     ***/
+class Value
+{
+
+	public:
+
+		/*** Constructor, an empty value ***/
+		Value();
+
+		/*** Constructor, takes over an evaluated object ***/
+		explicit Value(Object* pObj);
+
+		/*** Copy constructor ***/
+		Value(const Value& other);
+
+		/*** Assignment ***/
+		Value& operator=(const Value& other);
+
+		/*** Create an integer value ***/
+		static Value makeInteger(long pValue);
+
+		/*** Create a real value ***/
+		static Value makeReal(double pValue);
+
+		/*** Create a logical value ***/
+		static Value makeLogical(bool pValue);
+
+		/*** Create a value from an object which is not taken over ***/
+		static Value copy(Object* obj);
+
+		/*** Get the type of this value ***/
+		unsigned char getType() const
+		{
+			return type;
+		}
+
+		/*** Get the value of an integer ***/
+		long getInteger() const
+		{
+			return data.integer;
+		}
+
+		/*** Get the value of a real ***/
+		double getReal() const
+		{
+			return data.real;
+		}
+
+		/*** Get the value of a logical ***/
+		bool getLogical() const
+		{
+			return data.logical;
+		}
+
+		/*** Get the object of a value kept on the heap, or null ***/
+		Object* getObject() const;
+
+		/*** Create an object holding a copy of this value ***/
+		Object* toObject() const;
+
+		/*** Give up the contents as an object, leaving this value empty ***/
+		Object* release();
+
+		/*** Exchange the contents of two values ***/
+		void swap(Value& other);
+
+		/*** Destructor ***/
+		~Value();
+
+	private:
+
+		/*** If the value is kept on the heap ***/
+		bool isBoxed() const;
+
+		/*** The type of this value, one of the OBJ_ types ***/
+		unsigned char type;
+
+		/*** The storage for the contents ***/
+		union Data
+		{
+			long integer;
+			double real;
+			bool logical;
+			Object* object;
+		};
+
+		/*** The contents of this value ***/
+		Data data;
+
+};
+
+#endif
@@ -17,15 +17,17 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "varmanager.h"
+#include "primitives/integer.h"
+#include "primitives/logical.h"
 
 /*** The entry of special values ***/
 std::map<std::string, Object*> VariableManager::special;
 
-/*** The stack of entries ***/
-std::stack< std::map<std::string, Object*> > VariableManager::stack;
+/*** The entries, the ones above the depth are kept for reuse ***/
+std::vector<VariableManager::Entry> VariableManager::stack;
 
-/*** The current entry ***/
-std::map<std::string, Object*> VariableManager::entry;
+/*** The number of entries in use, the last is the current entry ***/
+unsigned int VariableManager::depth = 0;
 
 /*** Constructor ***/
 VariableManager::VariableManager()
@@ -65,7 +67,7 @@ VariableManager::VariableManager()
 /*** If an object exists in the current entry ***/
 bool VariableManager::hasObject(std::string id)
 {
-	return (special.count(id) != 0 || entry.count(id) != 0);
+	return (special.count(id) != 0 || getObject(id) != 0);
 }
 
 /*** Set the object to which a variable refers ***/
@@ -76,57 +78,131 @@ void VariableManager::setObject(std::string id, Object* obj)
 		delete obj;
 		throw InvalidAssignmentException(id, "Cannot assign value to a special variable.");
 	}
-	if(entry.count(id) != 0)
-		delete entry[id];
-	entry[id] = obj;
+	Entry& current = stack[depth - 1];
+	store(current, current.scope->resolve(id), obj);
 }
 
 /*** Get the object to which a variable refers ***/
 Object* VariableManager::getObject(std::string id)
 {
-	if(special.count(id) != 0)
-		return special[id];
-	return entry[id];
+	std::map<std::string, Object*>::iterator it = special.find(id);
+	if(it != special.end())
+		return it->second;
+
+	int slot = stack[depth - 1].scope->find(id);
+	if(slot < 0)
+		return 0;
+	return getObject((unsigned int) slot);
+}
+
+/*** If an identifier names a special value ***/
+bool VariableManager::isSpecial(std::string id)
+{
+	return (special.count(id) != 0);
+}
+
+/*** Get the object in a slot of the current entry, or null ***/
+Object* VariableManager::getObject(unsigned int slot)
+{
+	// The scope may have grown since the entry was pushed
+	std::vector<Object*>& slots = stack[depth - 1].slots;
+	if(slot >= slots.size())
+		return 0;
+	return slots[slot];
 }
-		
-/*** Push the current entry onto the manager ***/
-void VariableManager::pushEntry()
+
+/*** Set the object in a slot of the current entry ***/
+void VariableManager::setObject(unsigned int slot, Object* obj)
 {
-	stack.push(entry);
-	entry.clear();
+	store(stack[depth - 1], slot, obj);
+}
+
+/*** Set a slot of the current entry to a value, which is taken over ***/
+void VariableManager::setValue(unsigned int slot, Value& value)
+{
+	// A number or logical overwrites an object of the same type in place
+	Object* current = getObject(slot);
+	if(current != 0 && current->getType() == value.getType())
+	{
+		switch(value.getType())
+		{
+			case OBJ_INTEGER:
+				static_cast<Integer*>(current)->setValue(value.getInteger());
+				return;
+			case OBJ_REAL:
+				static_cast<Real*>(current)->setValue(value.getReal());
+				return;
+			case OBJ_LOGICAL:
+				static_cast<Logical*>(current)->setValue(value.getLogical());
+				return;
+		}
+	}
+	setObject(slot, value.release());
+}
+
+/*** Set the object in a slot of an entry ***/
+void VariableManager::store(Entry& target, unsigned int slot, Object* obj)
+{
+	if(slot >= target.slots.size())
+		target.slots.resize(target.scope->getSize(), 0);
+	delete target.slots[slot];
+	target.slots[slot] = obj;
+}
+
+/*** Push an entry for a scope onto the manager ***/
+void VariableManager::pushEntry(Scope* scope)
+{
+	// Entries are reused so that a call does not allocate
+	if(depth == stack.size())
+		stack.push_back(Entry());
+
+	Entry& current = stack[depth++];
+	current.scope = scope;
+	current.slots.assign(scope->getSize(), 0);
 }
 
 /*** Pop an entry off the manager ***/
 void VariableManager::popEntry()
 {
-	// Clear all items from the current entry
-	for(std::map<std::string, Object*>::iterator it = entry.begin(); it != entry.end(); it++)
-		delete it->second;
-	entry.clear();
-
-	if(stack.empty())
+	if(depth == 0)
 		return;
 
-	entry = stack.top();
-	stack.pop();
+	// Clear all items from the current entry
+	std::vector<Object*>& slots = stack[--depth].slots;
+	for(unsigned int i = 0; i < slots.size(); i++)
+		delete slots[i];
+	slots.clear();
 }
 
 /*** Get an object on the top entry ***/
 Object* VariableManager::getTopLevelObject(std::string id)
 {
-	if(stack.top().count(id) == 0)
+	if(depth < 2)
 		return 0;
-	return stack.top()[id];
+
+	Entry& top = stack[depth - 2];
+	int slot = top.scope->find(id);
+	if(slot < 0 || (unsigned int) slot >= top.slots.size())
+		return 0;
+	return top.slots[slot];
 }
 
 /*** Set an object on the top entry ***/
 void VariableManager::setTopLevelObject(std::string id, Object* obj)
 {
 	if(special.count(id) != 0)
+	{
+		delete obj;
 		throw InvalidAssignmentException(id, "Cannot assign value to a special variable.");
-	if(stack.top().count(id) != 0)
-		delete stack.top()[id];
-	stack.top()[id] = obj;
+	}
+	Entry& top = stack[depth - 2];
+	store(top, top.scope->resolve(id), obj);
+}
+
+/*** Set the object in a slot of the top entry ***/
+void VariableManager::setTopLevelObject(unsigned int slot, Object* obj)
+{
+	store(stack[depth - 2], slot, obj);
 }
 
 /*** Empty the manager ***/
@@ -137,16 +213,15 @@ void VariableManager::empty()
 		delete it->second;
 	special.clear();
 	// Clear all entries from the stack
-	while(!stack.empty())
+	while(depth > 0)
 		popEntry();
-	// Clear the last entry, not stored on the stack
-	popEntry();
 }
 
 /*** Return the size of the stack ***/
 unsigned int VariableManager::getStackSize()
 {
-	return stack.size();
+	// The current entry is not counted
+	return (depth > 0 ? depth - 1 : 0);
 }
 
 /*** Destructor ***/
@@ -20,7 +20,8 @@
 // along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <map>
-#include <stack>
+#include <vector>
+#include "scope.h"
 #include "primitives/real.h"
 #include "primitives/text.h"
 #include "primitives/variable.h"
@@ -43,9 +44,21 @@ class VariableManager
 
 		/*** Get the object to which a variable refers ***/
 		Object* getObject(std::string id);
-		
-		/*** Push the current entry onto the manager ***/
-		void pushEntry();
+
+		/*** If an identifier names a special value ***/
+		bool isSpecial(std::string id);
+
+		/*** Get the object in a slot of the current entry, or null ***/
+		Object* getObject(unsigned int slot);
+
+		/*** Set the object in a slot of the current entry ***/
+		void setObject(unsigned int slot, Object* obj);
+
+		/*** Set a slot of the current entry to a value, which is taken over ***/
+		void setValue(unsigned int slot, Value& value);
+
+		/*** Push an entry for a scope onto the manager ***/
+		void pushEntry(Scope* scope);
 
 		/*** Pop an entry off the manager ***/
 		void popEntry();
@@ -56,6 +69,9 @@ class VariableManager
 		/*** Set an object on the top entry ***/
 		void setTopLevelObject(std::string id, Object* obj);
 
+		/*** Set the object in a slot of the top entry ***/
+		void setTopLevelObject(unsigned int slot, Object* obj);
+
 		/*** Empty the manager ***/
 		void empty();
 
@@ -67,14 +83,27 @@ class VariableManager
 
 	private:
 
+		/*** The variables of one procedure call or of the main program ***/
+		struct Entry
+		{
+			/*** The scope which gives the slots ***/
+			Scope* scope;
+
+			/*** The object in each slot, null when not set ***/
+			std::vector<Object*> slots;
+		};
+
+		/*** Set the object in a slot of an entry ***/
+		void store(Entry& target, unsigned int slot, Object* obj);
+
 		/*** The entry of special values ***/
 		static std::map<std::string, Object*> special;
 
-		/*** The stack of entries ***/
-		static std::stack< std::map<std::string, Object*> > stack;
+		/*** The entries, the ones above the depth are kept for reuse ***/
+		static std::vector<Entry> stack;
 
-		/*** The current entry ***/
-		static std::map<std::string, Object*> entry;
+		/*** The number of entries in use, the last is the current entry ***/
+		static unsigned int depth;
 
 };
 
@@ -0,0 +1,393 @@
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "vm.h"
+#include "operations/add.h"
+#include "operations/and.h"
+#include "operations/call.h"
+#include "operations/divide.h"
+#include "operations/equal.h"
+#include "operations/exponent.h"
+#include "operations/greater.h"
+#include "operations/greateq.h"
+#include "operations/intdivide.h"
+#include "operations/length.h"
+#include "operations/less.h"
+#include "operations/lesseq.h"
+#include "operations/multiply.h"
+#include "operations/negate.h"
+#include "operations/not.h"
+#include "operations/or.h"
+#include "operations/remainder.h"
+#include "operations/select.h"
+#include "operations/slice.h"
+#include "operations/subtract.h"
+#include "operations/unequal.h"
+#include "statements/assign.h"
+#include "statements/for.h"
+#include "statements/output.h"
+#include "statements/repeat.h"
+#include "statements/selectassign.h"
+#include "statements/sliceassign.h"
+
+// With GCC the instructions are dispatched through a table of label
+// addresses, every handler jumps straight to the next one.  Other
+// compilers fall back to a switch statement inside a loop.  A computed
+// goto does not run destructors, so a handler keeps its locals in an
+// inner block which is closed before dispatching.
+#if defined(__GNUC__)
+#define VM_CASE(op)		L_##op
+#define VM_NEXT()		goto *dispatch[ip->op]
+#else
+#define VM_CASE(op)		case op
+#define VM_NEXT()		continue
+#endif
+
+/*** Replace the top two values by the result of operation BC_<op> ***/
+#define VM_BINARY(op, type) \
+	VM_CASE(BC_##op): \
+		{ \
+			Value result(static_cast<type*>(ip->node)->apply(stack[stack.size() - 2], stack.back())); \
+			stack.pop_back(); \
+			stack.back().swap(result); \
+		} \
+		ip++; \
+		VM_NEXT();
+
+/*** Replace the top value by the result of operation BC_<op> ***/
+#define VM_UNARY(op, type) \
+	VM_CASE(BC_##op): \
+		{ \
+			Value result(static_cast<type*>(ip->node)->apply(stack.back())); \
+			stack.back().swap(result); \
+		} \
+		ip++; \
+		VM_NEXT();
+
+std::vector<Value> VirtualMachine::stack;
+
+/*** Constructor ***/
+VirtualMachine::VirtualMachine()
+{
+	// Most programs never grow the stack past its first allocation
+	if(stack.capacity() == 0)
+		stack.reserve(1024);
+}
+
+/*** Run compiled code ***/
+Outcome VirtualMachine::run(Bytecode* code)
+{
+	unsigned int depth = stack.size();
+	try
+	{
+		Outcome result = execute(code);
+		unwind(depth);
+		return result;
+	}
+	catch(...)
+	{
+		unwind(depth);
+		throw;
+	}
+}
+
+/*** Delete the values above a stack depth ***/
+void VirtualMachine::unwind(unsigned int depth)
+{
+	while(stack.size() > depth)
+		stack.pop_back();
+}
+
+/*** Push a value, which is taken over ***/
+void VirtualMachine::push(Value& value)
+{
+	stack.push_back(Value());
+	stack.back().swap(value);
+}
+
+/*** Execute the instructions ***/
+Outcome VirtualMachine::execute(Bytecode* code)
+{
+	Instruction* start = code->getStart();
+	Instruction* ip = start;
+
+#if defined(__GNUC__)
+	static void* dispatch[BC_COUNT] = {
+		&&L_BC_NOP, &&L_BC_CONST, &&L_BC_LOAD, &&L_BC_STORE, &&L_BC_POP,
+		&&L_BC_OVER, &&L_BC_JUMP, &&L_BC_JUMPFALSE, &&L_BC_JUMPTRUE,
+		&&L_BC_ADD, &&L_BC_SUBTRACT, &&L_BC_MULTIPLY, &&L_BC_DIVIDE,
+		&&L_BC_INTDIVIDE, &&L_BC_REMAINDER, &&L_BC_EXPONENT, &&L_BC_EQUAL,
+		&&L_BC_UNEQUAL, &&L_BC_GREATER, &&L_BC_LESS, &&L_BC_GREATEQ,
+		&&L_BC_LESSEQ, &&L_BC_AND, &&L_BC_OR, &&L_BC_NEGATE, &&L_BC_NOT,
+		&&L_BC_LENGTH, &&L_BC_SELECT, &&L_BC_SLICE, &&L_BC_SEQUENCE,
+		&&L_BC_CALL, &&L_BC_OUTPUT, &&L_BC_NEWLINE, &&L_BC_SELECTASSIGN,
+		&&L_BC_SLICEASSIGN, &&L_BC_FORINIT, &&L_BC_FORTEST, &&L_BC_FORSTEP,
+		&&L_BC_REPEATINIT, &&L_BC_REPEATTEST, &&L_BC_REPEATSTEP,
+		&&L_BC_RETURN, &&L_BC_LEAVE, &&L_BC_EXECUTE, &&L_BC_EVALUATE
+	};
+
+	VM_NEXT();
+#else
+	for(;;)
+	switch(ip->op)
+	{
+#endif
+
+	VM_CASE(BC_NOP):
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_CONST):
+		{
+			Value value(Value::copy(code->getConstant(ip->arg)));
+			push(value);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_LOAD):
+		{
+			Value value(static_cast<Object*>(ip->node)->evaluateValue());
+			push(value);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_STORE):
+		static_cast<Assign*>(ip->node)->store(stack.back());
+		stack.pop_back();
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_POP):
+		stack.pop_back();
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_OVER):
+		{
+			Value value(stack[stack.size() - 2]);
+			push(value);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_JUMP):
+		ip = start + ip->arg;
+		VM_NEXT();
+
+	VM_CASE(BC_JUMPFALSE):
+	VM_CASE(BC_JUMPTRUE):
+	{
+		const Value& cond = stack.back();
+		if(cond.getType() != OBJ_LOGICAL)
+			throw InvalidTypeException(ip->node->getLineNumber(), ip->node->getColumnNumber(), OBJ_LOGICAL, cond.getType());
+		bool value = cond.getLogical();
+		stack.pop_back();
+
+		if(value == (ip->op == BC_JUMPTRUE))
+			ip = start + ip->arg;
+		else
+			ip++;
+		VM_NEXT();
+	}
+
+	VM_BINARY(ADD, Add)
+	VM_BINARY(SUBTRACT, Subtract)
+	VM_BINARY(MULTIPLY, Multiply)
+	VM_BINARY(DIVIDE, Divide)
+	VM_BINARY(INTDIVIDE, IntDivide)
+	VM_BINARY(REMAINDER, Remainder)
+	VM_BINARY(EXPONENT, Exponent)
+	VM_BINARY(EQUAL, Equal)
+	VM_BINARY(UNEQUAL, Unequal)
+	VM_BINARY(GREATER, Greater)
+	VM_BINARY(LESS, Less)
+	VM_BINARY(GREATEQ, GreatEq)
+	VM_BINARY(LESSEQ, LessEq)
+	VM_BINARY(AND, And)
+	VM_BINARY(OR, Or)
+	VM_UNARY(NEGATE, Negate)
+	VM_UNARY(NOT, Not)
+	VM_UNARY(LENGTH, Length)
+	VM_BINARY(SELECT, Select)
+
+	VM_CASE(BC_SLICE):
+		{
+			// The indices which were given are above the operand
+			unsigned int count = 1 + (ip->arg & 1) + ((ip->arg & 2) >> 1);
+			unsigned int base = stack.size() - count;
+			const Value* obj2 = (ip->arg & 1) ? &stack[base + 1] : 0;
+			const Value* obj3 = (ip->arg & 2) ? &stack.back() : 0;
+			Value result(static_cast<Slice*>(ip->node)->apply(stack[base], obj2, obj3));
+			unwind(base + 1);
+			stack.back().swap(result);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_SEQUENCE):
+		{
+			Sequence* seq = new Sequence();
+			unsigned int base = stack.size() - ip->arg;
+			for(unsigned int i = base; i < stack.size(); i++)
+				seq->pushObject(stack[i].release());
+			unwind(base);
+			Value value(seq);
+			push(value);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_CALL):
+		{
+			// The call takes over the argument values it binds
+			unsigned int base = stack.size() - ip->arg;
+			std::vector<Object*> values;
+			values.reserve(ip->arg);
+			for(unsigned int i = base; i < stack.size(); i++)
+				values.push_back(stack[i].release());
+			unwind(base);
+
+			Object* result;
+			try
+			{
+				std::auto_ptr<Object> idenEval(stack.back().release());
+				result = static_cast<Call*>(ip->node)->apply(idenEval.get(), values);
+			}
+			catch(...)
+			{
+				for(unsigned int i = 0; i < values.size(); i++)
+					delete values.at(i);
+				throw;
+			}
+			for(unsigned int i = 0; i < values.size(); i++)
+				delete values.at(i);
+
+			// A procedure without a return value gives an empty object
+			Value value(result);
+			stack.back().swap(value);
+		}
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_OUTPUT):
+		static_cast<Output*>(ip->node)->print(stack.back(), ip->arg);
+		stack.pop_back();
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_NEWLINE):
+		std::cout << std::endl;
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_SELECTASSIGN):
+		static_cast<SelectAssign*>(ip->node)->store(stack[stack.size() - 2], stack.back());
+		unwind(stack.size() - 2);
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_SLICEASSIGN):
+		static_cast<SliceAssign*>(ip->node)->store(stack[stack.size() - 3], stack[stack.size() - 2], stack.back());
+		unwind(stack.size() - 3);
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_FORINIT):
+		static_cast<For*>(ip->node)->start(stack.back());
+		stack.pop_back();
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_FORTEST):
+	{
+		bool finished = static_cast<For*>(ip->node)->isFinished(stack[stack.size() - 2], stack.back());
+		unwind(stack.size() - 2);
+		if(finished)
+			ip = start + ip->arg;
+		else
+			ip++;
+		VM_NEXT();
+	}
+
+	VM_CASE(BC_FORSTEP):
+		static_cast<For*>(ip->node)->advance(stack.back());
+		stack.pop_back();
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_REPEATINIT):
+		static_cast<Repeat*>(ip->node)->checkCounter(stack.back());
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_REPEATTEST):
+		if(stack.back().getInteger() <= 0)
+			ip = start + ip->arg;
+		else
+			ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_REPEATSTEP):
+		stack.back() = Value::makeInteger(stack.back().getInteger() - 1);
+		ip++;
+		VM_NEXT();
+
+	VM_CASE(BC_RETURN):
+	{
+		Outcome result(S_RETURN);
+		result.setObject(stack.back().release());
+		stack.pop_back();
+		return result;
+	}
+
+	VM_CASE(BC_LEAVE):
+		return Outcome(ip->arg);
+
+	VM_CASE(BC_EXECUTE):
+	{
+		Outcome result = ip->node->execute();
+		if(result.getStatus() == S_SUCCESS)
+			ip++;
+		else if(result.getStatus() == S_EXIT && ip->arg >= 0)
+			ip = start + ip->arg;
+		else
+			return result;
+		VM_NEXT();
+	}
+
+	VM_CASE(BC_EVALUATE):
+		{
+			Value value(static_cast<Object*>(ip->node)->evaluateValue());
+			push(value);
+		}
+		ip++;
+		VM_NEXT();
+
+#if !defined(__GNUC__)
+	default:
+		return Outcome(S_SUCCESS);
+	}
+#endif
+}
+
+/*** Destructor ***/
+VirtualMachine::~VirtualMachine()
+{
+}
@@ -0,0 +1,57 @@
+#ifndef VM_H
+#define VM_H
+
+// ReRap Version 0.9
+// Copyright 2011 Matthew Mikolay.
+//
+// This file is part of ReRap.
+//
+// ReRap is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ReRap is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ReRap.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include "bytecode.h"
+#include "outcome.h"
+#include "value.h"
+
+class VirtualMachine
+{
+
+	public:
+
+		/*** Constructor ***/
+		VirtualMachine();
+
+		/*** Run compiled code ***/
+		Outcome run(Bytecode* code);
+
+		/*** Destructor ***/
+		~VirtualMachine();
+
+	private:
+
+		/*** Execute the instructions ***/
+		Outcome execute(Bytecode* code);
+
+		/*** Delete the values above a stack depth ***/
+		void unwind(unsigned int depth);
+
+		/*** Push a value, which is taken over ***/
+		void push(Value& value);
+
+		/*** The stack of values, shared by nested runs ***/
+		static std::vector<Value> stack;
+
+};
+
+#endif
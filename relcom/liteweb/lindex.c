@@ -13,6 +13,9 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/wait.h>
+
+#include "tindex.h"
 
 #define LINESZ 512
 #define MAXEXLEN 256
@@ -23,6 +26,8 @@ char *prefix;
 int verbose;
 int debug;
 int offset;
+int notrigram;
+int sortpid;
 
 #ifdef ONEPASS
 #include "vdbm.h"
@@ -59,10 +64,11 @@ void usage ()
 	fprintf (stderr, "KINDEX - file archive index builder, version %s\n",
 		version);
 	fprintf (stderr, "%s\n\n", copyright);
-	fprintf (stderr, "Usage:\n\t%s [-v] [-D] [-d prefix] [-x exclude] [dirname...]\n", progname);
+	fprintf (stderr, "Usage:\n\t%s [-v] [-D] [-n] [-d prefix] [-x exclude] [dirname...]\n", progname);
 	fprintf (stderr, "Options:\n");
 	fprintf (stderr, "\t-v\tverbose mode\n");
 	fprintf (stderr, "\t-D\tdebug mode\n");
+	fprintf (stderr, "\t-n\tdon't build the trigram index\n");
 	fprintf (stderr, "\t-d #\tthe directory name prefix to remove\n");
 	fprintf (stderr, "\t-x #\tdon't follow the symlink given\n");
 	quit ();
@@ -74,7 +80,7 @@ int main (int argc, char **argv)
 	if (! progname)
 		progname = *argv;
 	for (;;) {
-		switch (getopt (argc, argv, "vDd:x:")) {
+		switch (getopt (argc, argv, "vDnd:x:")) {
 		case EOF:
 			break;
 		case 'v':
@@ -83,6 +89,9 @@ int main (int argc, char **argv)
 		case 'D':
 			++debug;
 			continue;
+		case 'n':
+			++notrigram;
+			continue;
 		case 'd':
 			prefix = optarg;
 			continue;
@@ -149,11 +158,14 @@ int runsort (char *dir)
 	close (pd[0]);
 	close (pd[1]);
 
+	sortpid = pid;
 	return (0);
 }
 
 int kindex (char *dir)
 {
+	char *root = dir;
+
 	if (runsort (dir) < 0)
 		return (-1);
 
@@ -169,6 +181,14 @@ int kindex (char *dir)
 	}
 
 	fclose (stdout);
+
+	/* Wait for the sorted .index and build its trigram index. */
+	waitpid (sortpid, 0, 0);
+	if (! notrigram && tindex_build (root) < 0) {
+		fprintf (stderr, "%s: cannot build the trigram index for %s\n",
+			progname, root);
+		return (-1);
+	}
 	return (0);
 }
 
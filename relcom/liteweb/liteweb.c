@@ -11,6 +11,8 @@
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
+#include <setjmp.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <dirent.h>
 #include <time.h>
@@ -19,18 +21,28 @@
 #include <ndbm.h>
 #include <libutil.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
 #include <sys/param.h>
 #include <sys/wait.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#endif
 
 #include "reg.h"
 #include "map.h"
+#include "tindex.h"
+#include "tcode.h"
 
 #define LINESZ          512                     /* maximum input line length */
 #define STACKSZ         10                      /* depth of if/endif */
 #define TIMEOUT         60                      /* keepalive connection timeout */
+#define STIMEOUT        5                       /* server: client takes no reply */
 #define ROOTDIR         "/pub"                  /* default root directory */
 #define DBNAME          "/var/db/liteweb/user"    /* user database file name */
 #define CONTENTS        "index.html"            /* directory contents file */
@@ -101,6 +113,8 @@ struct hometab {
 	unsigned long ipaddr;
 	char *hostname;
 	char *homedir;
+	struct auth *authlist;          /* preloaded tables, server mode */
+	struct forward *forwlist;
 } homelist;
 
 struct {
@@ -331,6 +345,9 @@ int keepalive;                          /* keep the connection alive */
 struct stat filestat;
 time_t now;                             /* time stamp of the request */
 time_t langstamp;                       /* last language change */
+int port;                               /* server port, 0 - inetd mode */
+sigjmp_buf connjmp;                     /* abort the current connection */
+FILE *input;                            /* request input stream */
 FILE *reply;
 
 int translate;				/* charset translation flag */
@@ -440,6 +457,8 @@ extern int getpeername (int, struct sockaddr *, int *);
 extern time_t getdate (char *ctim);
 
 void error (int c, char *m, ...);
+void endconn (int code);
+void putdata (char *data, unsigned long len);
 int fgetinfo (char *info, int maxlen, char *rinfo, int rmaxlen,
 	long *date, FILE *fd);
 
@@ -909,52 +928,244 @@ void preprocess (FILE *from, FILE *to, char *myname)
 	}
 }
 
+/*
+ * Write the block to the file.  In the server mode large blocks
+ * of the reply go past the stdio buffer, see putdata(); small
+ * ones stay with the headers, to leave in one segment.
+ */
+void putblock (unsigned char *data, unsigned long len, FILE *to)
+{
+	if (port && to == stdout && len >= 4096)
+		putdata ((char*) data, len);
+	else
+		fwrite (data, 1, len, to);
+}
+
 void copy (FILE *from, FILE *to, unsigned long len, int transflag)
 {
 	unsigned char *tab = 0;
+	unsigned char ibuf [8192], obuf [8192];
+	unsigned long n, done, olen;
+	int left;
 
 	if (transflag > 0)
 		tab = touser;
 	else if (transflag < 0)
 		tab = fromuser;
 	fseek (from, 0L, 0);
-	while (len-- > 0) {
-		int c = getc (from);
-		if (c < 0)
+	left = 0;
+	while (len > 0) {
+		n = sizeof (ibuf) - left;
+		if (n > len)
+			n = len;
+		n = fread (ibuf + left, 1, n, from);
+		len -= n;
+		if (n == 0)
+			len = 0;
+		n += left;
+		if (! tab) {
+			putblock (ibuf, n, to);
+			continue;
+		}
+		done = transcode (obuf, ibuf, n, tab, len == 0, &olen);
+		putblock (obuf, olen, to);
+		left = n - done;
+		memmove (ibuf, ibuf + done, left);
+	}
+}
+
+/*
+ * In the server mode the data bypassing the stdio buffer are
+ * written without blocking, so that a client which takes nothing
+ * for STIMEOUT seconds can be dropped.  Return the old flags.
+ */
+int sendbegin ()
+{
+	int flags;
+
+	fflush (stdout);
+	flags = fcntl (1, F_GETFL);
+	if (port && flags >= 0)
+		fcntl (1, F_SETFL, flags | O_NONBLOCK);
+	return (flags);
+}
+
+void sendend (int flags)
+{
+	if (port && flags >= 0)
+		fcntl (1, F_SETFL, flags);
+}
+
+/*
+ * Wait until the client can take more of the reply.
+ */
+void sendwait ()
+{
+	struct pollfd pfd;
+
+	pfd.fd = 1;
+	pfd.events = POLLOUT;
+	if (poll (&pfd, 1, STIMEOUT * 1000) <= 0)
+		endconn (0);            /* client does not read */
+}
+
+/*
+ * Write the data to stdout, bypassing the stdio buffer.
+ */
+void putdata (char *data, unsigned long len)
+{
+	long n;
+	int flags;
+
+	flags = sendbegin ();
+	while (len > 0) {
+		n = write (1, data, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			sendwait ();
+			continue;
+		}
+		if (n <= 0)
+			break;          /* client is gone */
+		data += n;
+		len -= n;
+	}
+	sendend (flags);
+}
+
+/*
+ * Send the file contents without translation.
+ * The data go directly from the file to the socket.
+ */
+void sendraw (FILE *fd, unsigned long len)
+{
+	char *data;
+#ifdef __linux__
+	off_t off = 0;
+	long n;
+	int flags;
+
+	flags = sendbegin ();
+	while (len > 0) {
+		n = sendfile (1, fileno (fd), &off, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && off == 0 && (errno == EINVAL || errno == ENOSYS))
+			break;          /* not supported here, use mmap */
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			sendwait ();
+			continue;
+		}
+		if (n <= 0) {
+			len = 0;        /* client is gone */
 			break;
-		if (tab) {
-			if (c == '%') {
-				if (len-- <= 0)
-					break;
-				c = getc (from);
-				if (c < 0)
-					break;
-				putc ('%', to);
-				if ((c >= 'A' && c <= 'F') ||
-				    (c >= 'a' && c <= 'f') ||
-				    (c >= '0' && c <= '9')) {
-					int d;
-					if (len-- <= 0)
-						break;
-					d = getc (from);
-					if (d < 0)
-						break;
-					if      (c >= 'A' && c <= 'F') c -= 'A' - 10;
-					else if (c >= 'a' && c <= 'f') c -= 'f' - 10;
-					else                           c &= 0x0f;
-					if      (d >= 'A' && d <= 'F') d -= 'A' - 10;
-					else if (d >= 'a' && d <= 'f') d -= 'f' - 10;
-					else                           d &= 0x0f;
-					c = tab [c<<4 | d];
-					putc ("0123456789ABCDEF" [c>>4], to);
-					putc ("0123456789ABCDEF" [c&15], to);
-					continue;
-				}
-			}
-			c = tab[c];
 		}
-		putc (c, to);
+		len -= n;
+	}
+	sendend (flags);
+	if (len == 0)
+		return;
+#endif
+	data = mmap (0, len, PROT_READ, MAP_SHARED, fileno (fd), 0);
+	if (data == (char*) MAP_FAILED) {
+		copy (fd, stdout, len, 0);
+		return;
+	}
+	putdata (data, len);
+	munmap (data, len);
+}
+
+/*
+ * Cache of the translated text files, used in the server mode.
+ * Keyed by the file name, modification time and user charset;
+ * the least recently used entries are dropped first.
+ */
+#define TCACHESZ        64                      /* entries in text cache */
+#define TCACHEMEM       (16*1024*1024L)         /* bytes in text cache */
+#define TCACHEMAX       (TCACHEMEM/4)           /* max cached file size */
+
+struct tcache {
+	char *path;                     /* file name, 0 for free entry */
+	time_t mtime;                   /* file modification time */
+	unsigned long size;             /* file size */
+	int lang;                       /* user charset */
+	char *data;                     /* translated contents */
+	unsigned long len;              /* length of the data */
+	unsigned long used;             /* LRU stamp */
+} tcache [TCACHESZ];
+
+unsigned long tcachemem;                /* bytes used by the cache */
+unsigned long tcacheclock;              /* LRU clock */
+
+void tcachefree (struct tcache *t)
+{
+	tcachemem -= t->len;
+	free (t->path);
+	free (t->data);
+	t->path = 0;
+}
+
+/*
+ * Find the translated contents of the file,
+ * translating and storing it in the cache when needed.
+ * Return 0 when the file cannot be cached.
+ */
+struct tcache *tcachefind (FILE *fd, char *path, unsigned long size)
+{
+	struct tcache *t, *victim;
+	unsigned char *src, *data;
+	unsigned long len;
+
+	victim = tcache;
+	for (t=tcache; t<tcache+TCACHESZ; ++t) {
+		if (t->path && t->mtime == filestat.st_mtime &&
+		    t->size == size && t->lang == lang &&
+		    strcmp (t->path, path) == 0) {
+			t->used = ++tcacheclock;
+			return (t);
+		}
+		if (! t->path || (victim->path && t->used < victim->used))
+			victim = t;
+	}
+	if (size == 0 || size > TCACHEMAX)
+		return (0);
+
+	src = mmap (0, size, PROT_READ, MAP_SHARED, fileno (fd), 0);
+	if (src == (unsigned char*) MAP_FAILED)
+		return (0);
+	data = (unsigned char*) malloc (size);
+	if (! data) {
+		munmap (src, size);
+		return (0);
+	}
+	transcode (data, src, size, touser, 1, &len);
+	munmap (src, size);
+
+	/* Make room: drop the least recently used entries. */
+	if (victim->path)
+		tcachefree (victim);
+	while (tcachemem + len > TCACHEMEM) {
+		struct tcache *old = 0;
+
+		for (t=tcache; t<tcache+TCACHESZ; ++t)
+			if (t->path && (! old || t->used < old->used))
+				old = t;
+		tcachefree (old);
+	}
+	victim->path = strdup (path);
+	if (! victim->path) {
+		free (data);
+		return (0);
 	}
+	victim->mtime = filestat.st_mtime;
+	victim->size = size;
+	victim->lang = lang;
+	victim->data = (char*) data;
+	victim->len = len;
+	victim->used = ++tcacheclock;
+	tcachemem += len;
+	return (victim);
 }
 
 /*
@@ -1016,6 +1227,17 @@ void put_reply ()
 	copy (reply, stdout, len, translate);
 }
 
+/*
+ * Terminate the current connection: in the inetd mode
+ * exit, in the server mode return to the worker loop.
+ */
+void endconn (int code)
+{
+	if (port)
+		siglongjmp (connjmp, 1);
+	exit (code);
+}
+
 void fatal (int code, char *msg)
 {
 	char header[256];
@@ -1037,7 +1259,7 @@ void fatal (int code, char *msg)
 	fputs (msg, stdout);
 	fputs (footer, stdout);
 	fflush (stdout);
-	exit (-1);
+	endconn (-1);
 }
 
 void error (int c, char *m, ...)
@@ -1293,11 +1515,16 @@ not_modified:   printf ("%s 304 Document not modified\r\n", HTTPVERSION);
 	if (proto == PROTO_0_9 && strcmp (url.ext, ".txt") == 0)
 		printf ("<PLAINTEXT>\r\n");
 
-	if (! textual)
-		copy (fd, stdout, size, 0);
-	else if (strcmp (url.ext, ".html") != 0)
-		copy (fd, stdout, size, translate);
-	else
+	if (! textual || (! translate && strcmp (url.ext, ".html") != 0))
+		sendraw (fd, size);
+	else if (strcmp (url.ext, ".html") != 0) {
+		struct tcache *t = port ? tcachefind (fd, url.filepath, size) : 0;
+
+		if (t)
+			putdata (t->data, t->len);
+		else
+			copy (fd, stdout, size, translate);
+	} else
 		copy (reply, stdout, size, translate);
 
 	fclose (fd);
@@ -1342,17 +1569,106 @@ int putsection (FILE *reply, char *filename)
 	return (1);
 }
 
-void searchfile ()
+/*
+ * Match the line of the .index file against the pattern,
+ * and output it when matched.  The name of the current section
+ * is kept in sect.  Return 1 when the line is output.
+ */
+int searchline (char *info, REGEXP reg, char *sect, int first)
 {
-	char info [LINESZ], descr [LINESZ], file [LINESZ];
-	char sect [LINESZ], newsect [LINESZ], *s;
-	char *search, *path, *p, *f;
+	char descr [LINESZ], file [LINESZ], newsect [LINESZ], *s;
+	char *path, *p, *f;
 	struct tm *ptm;
 	struct stat st;
+	long size;
+	int dirflag;
+
+	p = info + strlen (info);
+	while (p>info && (p[-1]=='\n' || p[-1]=='\r'))
+		*--p = 0;
+
+	path = info;
+	p = strchr (info, ' ');
+	if (p) {
+		*p++ = 0;
+		p = strchr (p, ' ');
+	}
+	if (! p)
+		p = "";
+
+	f = strrchr (path, '/');
+	dirflag = 0;
+	if (! f)                /* base file name */
+		f = path;
+	else if (! f[1]) {      /* directory */
+		dirflag = 1;
+		while (f>path && *f=='/')
+			*f-- = 0;
+		while (f>path && f[-1]!='/')
+			--f;
+	} else                  /* file path */
+		++f;
+
+	strcpy (file, f);
+	strcpy (descr, p);
+	strlower (file);
+	strlower (descr);
+	if (!REGEXEC (reg, file) &&
+	    (!*descr || !REGEXEC (reg, descr)))
+		return (0);
+
+	strcpy (file, url.filepath);
+	strcat (file, "/");
+	strcat (file, path);
+	if (stat (file, &st) >= 0 &&
+	    (st.st_mode & S_IFMT) == S_IFREG)
+		size = st.st_size;
+	else
+		size = -1;
+
+	if (first)
+		fprintf (reply, "<hr>\r\n");
+
+	/* Get section name. */
+	s = path;
+	while (strncmp (s, "../", 3) == 0)
+		s += 3;
+	s = strchr (s, '/');
+	if (! s)
+		s = path + strlen (path);
+	strncpy (newsect, path, s-path);
+	newsect[s-path] = 0;
+	if (strcmp (sect, newsect) != 0) {
+		strcpy (sect, newsect);
+		fprintf (reply, "</dl><h3>%s</h3><dl compact>\r\n",
+			sect);
+	}
+
+	if (dirflag)
+		strcat (path, "/");
+	fprintf (reply, "<dt><a href=\"%s\">%s</a>", path, path);
+	if (size >= 0) {
+		ptm = localtime (&st.st_mtime);
+		fprintf (reply, " -- %ld bytes, %ld", size,
+			ptm->tm_year * 10000L + (ptm->tm_mon + 1) * 100 +
+			ptm->tm_mday);
+	}
+	fprintf (reply, "\r\n");
+	if (*p)
+		fprintf (reply, "<dd>%s\r\n", p);
+	return (1);
+}
+
+void searchfile ()
+{
+	char info [LINESZ], sect [LINESZ], *search;
+	unsigned int *offs;
+	struct tm *ptm;
 	REGEXP reg;
+	TINDEX *t;
 	FILE *fd;
-	long size;
-	int i, dirflag;
+	long ncand, k;
+	int i;
 
 	search = url.search;
 	if (strncmp (search, "search=", 7) == 0)
@@ -1404,82 +1720,23 @@ void searchfile ()
 
 	i = 0;
 	*sect = 0;
-	while (fgets (info, sizeof (info), fd)) {
-		p = info + strlen (info);
-		while (p>info && (p[-1]=='\n' || p[-1]=='\r'))
-			*--p = 0;
-
-		path = info;
-		p = strchr (info, ' ');
-		if (p) {
-			*p++ = 0;
-			p = strchr (p, ' ');
-		}
-		if (! p)
-			p = "";
-
-		f = strrchr (path, '/');
-		dirflag = 0;
-		if (! f)                /* base file name */
-			f = path;
-		else if (! f[1]) {      /* directory */
-			dirflag = 1;
-			while (f>path && *f=='/')
-				*f-- = 0;
-			while (f>path && f[-1]!='/')
-				--f;
-		} else                  /* file path */
-			++f;
-
-		strcpy (file, f);
-		strcpy (descr, p);
-		strlower (file);
-		strlower (descr);
-		if (!REGEXEC (reg, file) &&
-		    (!*descr || !REGEXEC (reg, descr)))
-			continue;
-
-		strcpy (file, url.filepath);
-		strcat (file, "/");
-		strcat (file, path);
-		if (stat (file, &st) >= 0 &&
-		    (st.st_mode & S_IFMT) == S_IFREG)
-			size = st.st_size;
-		else
-			size = -1;
-
-		if (i == 0)
-			fprintf (reply, "<hr>\r\n");
-
-		/* Get section name. */
-		s = path;
-		while (strncmp (s, "../", 3) == 0)
-			s += 3;
-		s = strchr (s, '/');
-		if (! s)
-			s = path + strlen (path);
-		strncpy (newsect, path, s-path);
-		newsect[s-path] = 0;
-		if (strcmp (sect, newsect) != 0) {
-			strcpy (sect, newsect);
-			fprintf (reply, "</dl><h3>%s</h3><dl compact>\r\n",
-				sect);
-		}
-
-		if (dirflag)
-			strcat (path, "/");
-		fprintf (reply, "<dt><a href=\"%s\">%s</a>", path, path);
-		if (size >= 0) {
-			ptm = localtime (&st.st_mtime);
-			fprintf (reply, " -- %ld bytes, %ld", size,
-				ptm->tm_year * 10000L + (ptm->tm_mon + 1) * 100 +
-				ptm->tm_mday);
+	/* Select the candidate lines by the trigram index,
+	 * or scan the whole file when it cannot help. */
+	t = tindex_open (url.filepath);
+	ncand = t ? tindex_search (t, search, &offs) : -1;
+	if (ncand < 0) {
+		while (fgets (info, sizeof (info), fd))
+			i += searchline (info, reg, sect, i == 0);
+	} else {
+		for (k=0; k<ncand; ++k) {
+			fseek (fd, offs[k], 0);
+			if (fgets (info, sizeof (info), fd))
+				i += searchline (info, reg, sect, i == 0);
 		}
-		fprintf (reply, "\r\n");
-		if (*p)
-			fprintf (reply, "<dd>%s\r\n", p);
-		++i;
+		free (offs);
 	}
+	if (t)
+		tindex_close (t);
 	fclose (fd);
 	fprintf (reply, "</dl>\r\n");
 	if (i)
@@ -2172,7 +2429,9 @@ void sendexec (char *arg)
 
 	if (pipe (pout) < 0 || pipe (pin) < 0)
 		error (HS_InternalServerError, "cannot create pipe");
-	pid = debug < 2 ? vfork () : 0;
+	/* The server process lives on, so the child
+	 * must not modify its environment: no vfork(). */
+	pid = debug >= 2 ? 0 : port ? fork () : vfork ();
 	if (pid < 0)
 		error (HS_InternalServerError, "cannot create process");
 
@@ -2303,6 +2562,8 @@ void sendexec (char *arg)
 		}
 		fclose (fin);
 		close (pout[0]);
+		if (port)
+			waitpid (pid, &status, 0);
 		goto done;
 	}
 
@@ -2670,7 +2931,7 @@ void check_auth ()
 	syslog (LOG_INFO, "[%s] sent auth request for %s",
 		peername, url.filepath + strlen(rootdir));
 	fflush (stdout);
-	exit (-1);
+	endconn (-1);
 }
 
 void sendforward (struct forward *f)
@@ -2845,154 +3106,97 @@ void sendforward (struct forward *f)
 		peername, url.filepath + strlen(rootdir), h_blen, status);
 }
 
-void main (int argc, char **argv)
+/*
+ * Get the addresses of the connection on stdin,
+ * find the root directory and the peer name.
+ */
+void getpeer ()
 {
-	int addrlen, keepopt;
+	int addrlen;
 	struct hostent *h;
-	struct linger linger;
-	struct forward *f;
-	char *arg;
-
-	progname = *argv;
-	for (;;) {
-		switch (getopt (argc, argv, "vDrd:l:")) {
-		case EOF:
-			break;
-		case 'v':
-			++verbose;
-			continue;
-		case 'D':
-			++debug;
-			continue;
-		case 'r':
-			++rusflag;
-			continue;
-		case 'd':
-			if (strchr (optarg, ':'))
-				addhome (optarg);
-			else
-				rootdir = optarg;
-			continue;
-		case 'l':
-			if (*optarg == 0)
-				lang = L_ENG;           /* english language */
-			else if (strcasecmp (optarg, "unix") == 0)
-				lang = L_KOI8;          /* russian koi8-r */
-			else if (strcasecmp (optarg, "win") == 0)
-				lang = L_WIN;           /* russian ms windows */
-			else if (strcasecmp (optarg, "dos") == 0)
-				lang = L_DOS;           /* russian ms dos */
-			else if (strcasecmp (optarg, "mac") == 0)
-				lang = L_MAC;           /* russian macintosh */
-			else
-				lang = L_ENG;           /* english by default */
-			continue;
-		}
-		break;
-	}
-	argc -= optind;
-	argv += optind;
 
-	/* On exit, wait 5 minutes for output to drain. */
-	linger.l_onoff = 1;
-	linger.l_linger = 5*60;
-	setsockopt (0, SOL_SOCKET, SO_LINGER, &linger, sizeof (linger));
-
-	keepopt = 1;
-	setsockopt (0, SOL_SOCKET, SO_KEEPALIVE, &keepopt, sizeof (keepopt));
-
-	openlog ("liteweb", LOG_PID, LOG_DAEMON);
-
-	if (argc != 0)
-		error (HS_InternalServerError, "invalid argument `%s'",
-			argv[0]);
-
-	if (gethostname (hostname, sizeof (hostname)) < 0)
+	addrlen = sizeof (my);
+	if (getsockname (0, (struct sockaddr *) &my, &addrlen) < 0)
 		error (HS_InternalServerError,
-			"cannot determine my host name: %s", strerror (errno));
-
-	memset (&my, 0, sizeof (my));
-	memset (&peer, 0, sizeof (peer));
-	if (! debug) {
-		addrlen = sizeof (my);
-		if (getsockname (0, (struct sockaddr *) &my, &addrlen) < 0)
-			error (HS_InternalServerError,
-				"cannot determine my address: %s",
-				strerror (errno));
-
-		if (! rootdir)
-			rootdir = findhome ();
+			"cannot determine my address: %s",
+			strerror (errno));
 
-		addrlen = sizeof (peer);
-		if (getpeername (0, (struct sockaddr *) &peer, &addrlen) < 0)
-			error (HS_InternalServerError,
-				"cannot determine peer address: %s",
-				strerror (errno));
+	if (! rootdir)
+		rootdir = findhome ();
 
-		h = gethostbyaddr ((char *) &peer.sin_addr, sizeof (peer.sin_addr), AF_INET);
-		if (h)
-			strcpy (peername, h->h_name);
-		else
-			strcpy (peername, inet_ntoa (peer.sin_addr));
-		syslog (LOG_INFO, "[%s] connection from %s port %d",
-			peername, inet_ntoa (peer.sin_addr),
-			ntohs (my.sin_port));
+	addrlen = sizeof (peer);
+	if (getpeername (0, (struct sockaddr *) &peer, &addrlen) < 0)
+		error (HS_InternalServerError,
+			"cannot determine peer address: %s",
+			strerror (errno));
+
+	/* A worker of the server must not wait for DNS:
+	 * it has other connections to serve. */
+	h = port ? 0 :
+		gethostbyaddr ((char *) &peer.sin_addr, sizeof (peer.sin_addr), AF_INET);
+	if (h)
+		strcpy (peername, h->h_name);
+	else
+		strcpy (peername, inet_ntoa (peer.sin_addr));
+	syslog (LOG_INFO, "[%s] connection from %s port %d",
+		peername, inet_ntoa (peer.sin_addr),
+		ntohs (my.sin_port));
 #ifdef sun
-		if (my.sin_addr.s_addr != 0x90ce880a)
-			exit (0);
+	if (my.sin_addr.s_addr != 0x90ce880a)
+		endconn (0);
 #endif
-	} else if (! rootdir)
-		rootdir = ROOTDIR;
-
-	signal (SIGINT, interrupt);
-	signal (SIGQUIT, interrupt);
-	signal (SIGTERM, interrupt);
+}
 
-	/*
-	 * Load the forward table.
-	 */
-	{
+/*
+ * Load the forward and authentication tables
+ * of the root directory.
+ */
+void loadtabs (char *dir)
+{
 	FILE *fd;
 
-	strcpy (line, rootdir);
+	forwlist = 0;
+	strcpy (line, dir);
 	strcat (line, "/.forward");
 	fd = fopen (line, "r");
 	if (fd) {
 		loadfwtab (fd);
 		fclose (fd);
 	}
-	}
 
-	/*
-	 * Load the authentication table.
-	 */
-	{
-	FILE *fd;
-
-	strcpy (line, rootdir);
+	authlist = 0;
+	strcpy (line, dir);
 	strcat (line, "/.auth");
 	fd = fopen (line, "r");
 	if (fd) {
 		loadauthtab (fd);
 		fclose (fd);
 	}
-	}
+}
+
+/*
+ * Read and process one request from the input stream.
+ * Return 0 when the connection should be closed.
+ */
+int request ()
+{
+	struct forward *f;
+	char *arg;
 
-again:
 	time (&now);
 	++reqcnt;
 
 	/* Break a connection when the client goes sleeping. */
 	alarm (TIMEOUT);
-	if (! getstr (stdin, line, sizeof (line)))
+	if (! getstr (input, line, sizeof (line)))
 		/* Broken connection - no need to log it. */
-		exit (0);
+		return (0);
 	alarm (0);
 
 	inputptr = line;
 	arg = getarg ();
 	if (! arg)
-		goto again;             /* empty command */
+		return (1);             /* empty command */
 
 	if (strcasecmp (arg, "GET") == 0)
 		method = M_GET;
@@ -3020,7 +3224,7 @@ again:
 
 	if (proto != PROTO_0_9) {
 		/* get request headers and body */
-		getreq (stdin, 0);
+		getreq (input, 0);
 		keepalive = h_connection &&
 			strcasecmp (h_connection, "keep-alive") == 0;
 		if (verbose) {
@@ -3177,12 +3381,626 @@ again:
 	}
 
 	fflush (stdout);
-	if (keepalive) {
-		freereq ();
-		setproctitle ("%s - %s", peername, url.locator);
-		goto again;
+	if (! keepalive)
+		return (0);
+	freereq ();
+	setproctitle ("%s - %s", peername, url.locator);
+	return (1);
+}
+
+/*
+ * Standalone server mode (-p port).
+ *
+ * The master process binds the port and keeps NWORKERS
+ * worker processes running.  Each worker waits on the listening
+ * socket and on its idle keep-alive connections with epoll(2)
+ * (poll(2) on other systems), and processes a request in place
+ * when its connection becomes readable.  The configuration tables
+ * are loaded once, before the workers are started.
+ * The input of a connection is collected without blocking, until
+ * the whole request (headers and body) has arrived; a client
+ * which does not complete the request in RTIMEOUT seconds is
+ * disconnected.  Then the request is processed as in the inetd
+ * mode, read from memory, with the connection placed on stdout.
+ * A client which accepts no part of the reply for STIMEOUT
+ * seconds is disconnected too.  Peer addresses are not resolved
+ * to names in this mode, since DNS would hold up the worker.
+ */
+#define MAXCONN         256                     /* connections per worker */
+#define NWORKERS        4                       /* default worker count */
+#define RTIMEOUT        20                      /* time to receive a request */
+#define CONNBUF         4096                    /* initial input buffer size */
+#define MAXREQ          (1024*1024)             /* maximum request size */
+
+struct conn {
+	int fd;                         /* socket, -1 when the slot is free */
+	time_t stamp;                   /* time of the last request */
+	time_t rstamp;                  /* arrival of the pending request */
+	char *ibuf;                     /* input received so far */
+	int ilen;                       /* ...its length */
+	int isize;                      /* ...buffer size */
+	struct sockaddr_in my, peer;    /* saved connection state... */
+	char peername [40];
+	char hostname [40];
+	char *rootdir;
+	int reqcnt;
+	int html;
+	int lang;
+	int os;
+	time_t langstamp;
+} *conntab;
+
+struct hometab defhome;                 /* root for the unlisted addresses */
+char myhostname [40];                   /* hostname from gethostname() */
+char *optroot;                          /* root directory from -d */
+int deflang;                            /* language from -l */
+int nworkers = NWORKERS;
+int workers [64];                       /* pids of worker processes */
+int listenfd;                           /* server socket */
+int nullfd;                             /* /dev/null */
+
+/*
+ * glibc and 4.4BSD stdio: discard the buffered data.
+ */
+#ifdef __GLIBC__
+#include <stdio_ext.h>
+#define PURGE(f)                __fpurge (f)
+#else
+#define PURGE(f)                fpurge (f)
+#endif
+
+void timeout ()
+{
+	endconn (0);
+}
+
+void saveconn (struct conn *c)
+{
+	c->my = my;
+	c->peer = peer;
+	strcpy (c->peername, peername);
+	strcpy (c->hostname, hostname);
+	c->rootdir = rootdir;
+	c->reqcnt = reqcnt;
+	c->html = html;
+	c->lang = lang;
+	c->os = os;
+	c->langstamp = langstamp;
+}
+
+void loadconn (struct conn *c)
+{
+	struct hometab *h;
+
+	my = c->my;
+	peer = c->peer;
+	strcpy (peername, c->peername);
+	strcpy (hostname, c->hostname);
+	rootdir = c->rootdir;
+	reqcnt = c->reqcnt;
+	html = c->html;
+	lang = c->lang;
+	os = c->os;
+	langstamp = c->langstamp;
+
+	/* Select the preloaded tables of the root directory. */
+	for (h= &homelist; h; h=h->next)
+		if (h->homedir && strcmp (h->homedir, rootdir) == 0)
+			break;
+	if (! h)
+		h = &defhome;
+	authlist = h->authlist;
+	forwlist = h->forwlist;
+}
+
+#ifdef __linux__
+int epfd;
+
+void evinit ()
+{
+	struct epoll_event ev;
+
+	epfd = epoll_create (MAXCONN + 1);
+	if (epfd < 0) {
+		syslog (LOG_ERR, "epoll_create: %s", strerror (errno));
+		exit (-1);
+	}
+	fcntl (epfd, F_SETFD, FD_CLOEXEC);
+	ev.events = EPOLLIN;
+	ev.data.ptr = 0;
+	epoll_ctl (epfd, EPOLL_CTL_ADD, listenfd, &ev);
+}
+
+void evadd (struct conn *c)
+{
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.ptr = c;
+	epoll_ctl (epfd, EPOLL_CTL_ADD, c->fd, &ev);
+}
+
+void evdel (struct conn *c)
+{
+	struct epoll_event ev;
+
+	epoll_ctl (epfd, EPOLL_CTL_DEL, c->fd, &ev);
+}
+
+/*
+ * Wait for events, store the ready connections into tab[]
+ * (0 for the listening socket).  Return the count.
+ */
+int evwait (struct conn **tab, int maxn, int msec)
+{
+	struct epoll_event ev [64];
+	int n, i;
+
+	if (maxn > 64)
+		maxn = 64;
+	n = epoll_wait (epfd, ev, maxn, msec);
+	for (i=0; i<n; ++i)
+		tab[i] = (struct conn*) ev[i].data.ptr;
+	return (n);
+}
+#else
+void evinit () {}
+void evadd (struct conn *c) {}
+void evdel (struct conn *c) {}
+
+int evwait (struct conn **tab, int maxn, int msec)
+{
+	struct pollfd pfd [MAXCONN+1];
+	struct conn *c, *ctab [MAXCONN+1];
+	int n, i, k;
+
+	pfd[0].fd = listenfd;
+	pfd[0].events = POLLIN;
+	ctab[0] = 0;
+	n = 1;
+	for (c=conntab; c<conntab+MAXCONN; ++c)
+		if (c->fd >= 0) {
+			pfd[n].fd = c->fd;
+			pfd[n].events = POLLIN;
+			ctab[n++] = c;
+		}
+	if (poll (pfd, n, msec) <= 0)
+		return (0);
+	for (i=k=0; i<n && k<maxn; ++i)
+		if (pfd[i].revents)
+			tab[k++] = ctab[i];
+	return (k);
+}
+#endif
+
+void closeconn (struct conn *c)
+{
+	evdel (c);
+	close (c->fd);
+	c->fd = -1;
+	free (c->ibuf);
+	c->ibuf = 0;
+	c->ilen = c->isize = 0;
+}
+
+/*
+ * Accept a new connection.
+ */
+void acceptconn ()
+{
+	struct conn *c;
+	struct timeval sndtimeo;
+	int fd, keepopt;
+
+	fd = accept (listenfd, 0, 0);
+	if (fd < 0)
+		return;                 /* taken by another worker */
+	for (c=conntab; c<conntab+MAXCONN; ++c)
+		if (c->fd < 0)
+			break;
+	if (c >= conntab+MAXCONN) {
+		syslog (LOG_ERR, "too many connections");
+		close (fd);
+		return;
+	}
+	c->ibuf = malloc (CONNBUF);
+	if (! c->ibuf) {
+		syslog (LOG_ERR, "no memory for connection");
+		close (fd);
+		return;
+	}
+	c->isize = CONNBUF;
+	c->ilen = 0;
+	fcntl (fd, F_SETFD, FD_CLOEXEC);
+	keepopt = 1;
+	setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &keepopt, sizeof (keepopt));
+
+	/* A client which stops reading the reply gets dropped,
+	 * rather than blocking the worker for long. */
+	sndtimeo.tv_sec = STIMEOUT;
+	sndtimeo.tv_usec = 0;
+	setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &sndtimeo, sizeof (sndtimeo));
+	c->fd = fd;
+	time (&c->stamp);
+
+	/* Fresh per-connection state. */
+	dup2 (fd, 0);
+	rootdir = optroot;
+	strcpy (hostname, myhostname);
+	reqcnt = 0;
+	html = 0;
+	lang = deflang;
+	os = 0;
+	langstamp = 0;
+	if (sigsetjmp (connjmp, 1)) {
+		dup2 (nullfd, 0);
+		dup2 (nullfd, 1);
+		c->fd = -1;
+		close (fd);
+		free (c->ibuf);
+		c->ibuf = 0;
+		c->isize = 0;
+		return;
+	}
+	getpeer ();
+	dup2 (nullfd, 0);
+	saveconn (c);
+	evadd (c);
+}
+
+/*
+ * Find the complete request at the start of the input buffer:
+ * the request line, the headers up to the empty line and
+ * the body of Content-Length bytes.  A line without the protocol
+ * version is an HTTP/0.9 request by itself.  Return the length
+ * of the request, 0 when it is not complete yet, or -1 when
+ * it is too large.
+ */
+int reqlen (struct conn *c)
+{
+	char *p, *q, *end = c->ibuf + c->ilen;
+	long blen = 0;
+	int nwords = 0;
+
+	q = memchr (c->ibuf, '\n', c->ilen);
+	if (! q)
+		return (0);
+	for (p=c->ibuf; p<q; ) {
+		while (p<q && (*p==' ' || *p=='\t' || *p=='\r'))
+			++p;
+		if (p >= q)
+			break;
+		++nwords;
+		while (p<q && *p!=' ' && *p!='\t' && *p!='\r')
+			++p;
+	}
+	if (nwords < 3)
+		return (q+1 - c->ibuf);
+
+	for (;;) {
+		p = q+1;
+		q = memchr (p, '\n', end - p);
+		if (! q)
+			return (0);
+		if (q == p || (q == p+1 && *p == '\r'))
+			break;                  /* end of headers */
+		if (strncasecmp (p, "Content-Length:", 15) == 0)
+			blen = atol (p+15);
+	}
+	if (blen < 0)
+		blen = 0;
+	if (q+1 - c->ibuf + blen > MAXREQ)
+		return (-1);
+	if (q+1 - c->ibuf + blen > c->ilen)
+		return (0);
+	return (q+1 - c->ibuf + blen);
+}
+
+/*
+ * Receive the data which arrived on the connection,
+ * and process the requests which are complete.
+ */
+void serveconn (struct conn *c)
+{
+	int n, len;
+	char *p;
+
+	if (c->ilen >= c->isize) {
+		p = c->isize < MAXREQ ? realloc (c->ibuf, 2 * c->isize) : 0;
+		if (! p) {
+			syslog (LOG_ERR, "[%s] request too large", c->peername);
+			closeconn (c);
+			return;
+		}
+		c->ibuf = p;
+		c->isize *= 2;
+	}
+	n = recv (c->fd, c->ibuf + c->ilen, c->isize - c->ilen, MSG_DONTWAIT);
+	if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		return;
+	if (n <= 0) {
+		closeconn (c);
+		return;
+	}
+	if (c->ilen == 0)
+		time (&c->rstamp);
+	c->ilen += n;
+
+	input = 0;
+	dup2 (c->fd, 1);
+	clearerr (stdout);
+	loadconn (c);
+	if (sigsetjmp (connjmp, 1)) {
+		alarm (0);
+		goto close;
+	}
+	for (;;) {
+		len = reqlen (c);
+		if (len < 0) {
+			syslog (LOG_ERR, "[%s] request too large", peername);
+			goto close;
+		}
+		if (len == 0)
+			break;
+		input = fmemopen (c->ibuf, len, "r");
+		if (! input)
+			goto close;
+		n = request ();
+		fclose (input);
+		input = 0;
+
+		/* Requests sent ahead stay in the buffer. */
+		c->ilen -= len;
+		memmove (c->ibuf, c->ibuf + len, c->ilen);
+		if (c->ilen > 0)
+			time (&c->rstamp);
+		if (! n)
+			goto close;
+	}
+	saveconn (c);
+	time (&c->stamp);
+	dup2 (nullfd, 1);
+	return;
+close:
+	if (input)
+		fclose (input);
+	input = 0;
+	PURGE (stdout);
+	freereq ();
+	dup2 (nullfd, 1);
+	closeconn (c);
+}
+
+/*
+ * Worker process: serve the connections until killed.
+ */
+void worker ()
+{
+	struct conn *c, *ready [64];
+	int n, i;
+	time_t t;
+
+	signal (SIGINT, SIG_DFL);
+	signal (SIGQUIT, SIG_DFL);
+	signal (SIGTERM, SIG_DFL);
+	signal (SIGALRM, timeout);
+	conntab = (struct conn*) calloc (MAXCONN, sizeof (struct conn));
+	if (! conntab) {
+		syslog (LOG_ERR, "no memory for connection table");
+		exit (-1);
+	}
+	for (c=conntab; c<conntab+MAXCONN; ++c)
+		c->fd = -1;
+	evinit ();
+	for (;;) {
+		n = evwait (ready, 64, 1000);
+		for (i=0; i<n; ++i)
+			if (! ready[i])
+				acceptconn ();
+			else if (ready[i]->fd >= 0)
+				serveconn (ready[i]);
+
+		/* Close the connections idle for too long,
+		 * and the clients too slow to send a request. */
+		time (&t);
+		for (c=conntab; c<conntab+MAXCONN; ++c)
+			if (c->fd >= 0 && (c->ilen > 0 ?
+			    t - c->rstamp > RTIMEOUT : t - c->stamp > TIMEOUT))
+				closeconn (c);
+	}
+}
+
+int startworker ()
+{
+	int pid;
+
+	pid = fork ();
+	if (pid == 0) {
+		worker ();
+		exit (0);
+	}
+	if (pid < 0)
+		syslog (LOG_ERR, "cannot fork worker: %s", strerror (errno));
+	return (pid);
+}
+
+void stopserver ()
+{
+	int i;
+
+	for (i=0; i<nworkers; ++i)
+		if (workers[i] > 0)
+			kill (workers[i], SIGTERM);
+	exit (0);
+}
+
+/*
+ * Master process: open the server socket, preload the
+ * configuration and keep the workers running.
+ */
+void server ()
+{
+	struct sockaddr_in sa;
+	struct hometab *h;
+	int i, pid, status, opt;
+
+	listenfd = socket (AF_INET, SOCK_STREAM, 0);
+	if (listenfd < 0) {
+		syslog (LOG_ERR, "socket: %s", strerror (errno));
+		exit (-1);
+	}
+	opt = 1;
+	setsockopt (listenfd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof (opt));
+	memset (&sa, 0, sizeof (sa));
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl (INADDR_ANY);
+	sa.sin_port = htons (port);
+	if (bind (listenfd, (struct sockaddr*) &sa, sizeof (sa)) < 0 ||
+	    listen (listenfd, 128) < 0) {
+		syslog (LOG_ERR, "cannot listen on port %d: %s", port,
+			strerror (errno));
+		exit (-1);
+	}
+	fcntl (listenfd, F_SETFL, O_NONBLOCK);
+	fcntl (listenfd, F_SETFD, FD_CLOEXEC);
+	nullfd = open ("/dev/null", O_RDWR);
+	dup2 (nullfd, 0);
+	dup2 (nullfd, 1);
+
+	/* Load the tables of all root directories. */
+	for (h= &homelist; h; h=h->next)
+		if (h->homedir) {
+			loadtabs (h->homedir);
+			h->authlist = authlist;
+			h->forwlist = forwlist;
+		}
+	defhome.homedir = optroot ? optroot : ROOTDIR;
+	loadtabs (defhome.homedir);
+	defhome.authlist = authlist;
+	defhome.forwlist = forwlist;
+
+	/* Dead clients should not kill the workers. */
+	signal (SIGPIPE, SIG_IGN);
+	signal (SIGINT, stopserver);
+	signal (SIGQUIT, stopserver);
+	signal (SIGTERM, stopserver);
+
+	if (nworkers < 1)
+		nworkers = 1;
+	if (nworkers > sizeof(workers)/sizeof(workers[0]))
+		nworkers = sizeof(workers)/sizeof(workers[0]);
+	syslog (LOG_INFO, "listening on port %d, %d workers", port, nworkers);
+	for (i=0; i<nworkers; ++i)
+		workers[i] = startworker ();
+	for (;;) {
+		pid = wait (&status);
+		if (pid < 0) {
+			if (errno == EINTR)
+				continue;
+			sleep (1);
+		}
+		for (i=0; i<nworkers; ++i)
+			if (workers[i] == pid || workers[i] < 0) {
+				if (pid > 0)
+					syslog (LOG_ERR, "worker %d died, status 0x%x",
+						pid, status);
+				workers[i] = startworker ();
+			}
+	}
+}
+
+void main (int argc, char **argv)
+{
+	int keepopt;
+	struct linger linger;
+
+	progname = *argv;
+	for (;;) {
+		switch (getopt (argc, argv, "vDrd:l:p:w:")) {
+		case EOF:
+			break;
+		case 'v':
+			++verbose;
+			continue;
+		case 'D':
+			++debug;
+			continue;
+		case 'r':
+			++rusflag;
+			continue;
+		case 'd':
+			if (strchr (optarg, ':'))
+				addhome (optarg);
+			else
+				rootdir = optarg;
+			continue;
+		case 'l':
+			if (*optarg == 0)
+				lang = L_ENG;           /* english language */
+			else if (strcasecmp (optarg, "unix") == 0)
+				lang = L_KOI8;          /* russian koi8-r */
+			else if (strcasecmp (optarg, "win") == 0)
+				lang = L_WIN;           /* russian ms windows */
+			else if (strcasecmp (optarg, "dos") == 0)
+				lang = L_DOS;           /* russian ms dos */
+			else if (strcasecmp (optarg, "mac") == 0)
+				lang = L_MAC;           /* russian macintosh */
+			else
+				lang = L_ENG;           /* english by default */
+			continue;
+		case 'p':
+			port = atoi (optarg);
+			continue;
+		case 'w':
+			nworkers = atoi (optarg);
+			continue;
+		}
+		break;
+	}
+	argc -= optind;
+	argv += optind;
+
+	openlog ("liteweb", LOG_PID, LOG_DAEMON);
+
+	if (argc != 0)
+		error (HS_InternalServerError, "invalid argument `%s'",
+			argv[0]);
+
+	if (gethostname (hostname, sizeof (hostname)) < 0)
+		error (HS_InternalServerError,
+			"cannot determine my host name: %s", strerror (errno));
+
+	memset (&my, 0, sizeof (my));
+	memset (&peer, 0, sizeof (peer));
+	if (port && ! debug) {
+		strcpy (myhostname, hostname);
+		optroot = rootdir;
+		deflang = lang;
+		server ();
 	}
 
+	/* On exit, wait 5 minutes for output to drain. */
+	linger.l_onoff = 1;
+	linger.l_linger = 5*60;
+	setsockopt (0, SOL_SOCKET, SO_LINGER, &linger, sizeof (linger));
+
+	keepopt = 1;
+	setsockopt (0, SOL_SOCKET, SO_KEEPALIVE, &keepopt, sizeof (keepopt));
+
+	if (! debug)
+		getpeer ();
+	else if (! rootdir)
+		rootdir = ROOTDIR;
+
+	signal (SIGINT, interrupt);
+	signal (SIGQUIT, interrupt);
+	signal (SIGTERM, interrupt);
+
+	loadtabs (rootdir);
+
+	input = stdin;
+	while (request ())
+		continue;
 	exit (0);
 }
 
@@ -0,0 +1,206 @@
+/*
+ * Lite HTTPD load generator.
+ *
+ * Usage:
+ *      lwbench [-k] [-c clients] [-n requests] host port path
+ *
+ * Starts the given number of client processes, each sending
+ * its share of requests one after another, and prints
+ * the request rate.  With -k all requests of a client go
+ * through a single keep-alive connection.
+ *
+ * Copyright (C) 1994-1997 Cronyx Ltd.
+ * Author: Serge Vakulenko, <vak@cronyx.ru>
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <netdb.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+struct sockaddr_in server;
+char *path;
+int keepalive;
+char buf [65536];
+
+extern char *optarg;
+extern int optind;
+
+int connectserver ()
+{
+	int s;
+
+	s = socket (AF_INET, SOCK_STREAM, 0);
+	if (s < 0) {
+		perror ("socket");
+		exit (1);
+	}
+	if (connect (s, (struct sockaddr*) &server, sizeof (server)) < 0) {
+		perror ("connect");
+		exit (1);
+	}
+	return (s);
+}
+
+/*
+ * Send a request and read the reply.
+ * Return 0 when the server closed the connection.
+ */
+int get (int s)
+{
+	char *p, *body;
+	int n, len, clen;
+
+	if (keepalive)
+		sprintf (buf, "GET %s HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", path);
+	else
+		sprintf (buf, "GET %s HTTP/1.0\r\n\r\n", path);
+	if (write (s, buf, strlen (buf)) < 0) {
+		perror ("write");
+		exit (1);
+	}
+
+	/* Read the header. */
+	len = 0;
+	body = 0;
+	while (! body) {
+		if (len >= sizeof (buf) - 1) {
+			fprintf (stderr, "header too long\n");
+			exit (1);
+		}
+		n = read (s, buf + len, sizeof (buf) - 1 - len);
+		if (n <= 0) {
+			fprintf (stderr, "unexpected end of reply\n");
+			exit (1);
+		}
+		len += n;
+		buf[len] = 0;
+		body = strstr (buf, "\r\n\r\n");
+	}
+	body += 4;
+	if (strncmp (buf, "HTTP/1.0 200", 12) != 0) {
+		p = strchr (buf, '\r');
+		*p = 0;
+		fprintf (stderr, "bad reply: %s\n", buf);
+		exit (1);
+	}
+
+	/* Read the body. */
+	p = strstr (buf, "\r\nContent-Length:");
+	if (! keepalive || ! p || ! strstr (buf, "\r\nConnection: Keep-Alive")) {
+		while (read (s, buf, sizeof (buf)) > 0)
+			continue;
+		return (0);
+	}
+	clen = atoi (p + 17) - (buf + len - body);
+	while (clen > 0) {
+		n = read (s, buf, clen < sizeof (buf) ? clen : sizeof (buf));
+		if (n <= 0) {
+			fprintf (stderr, "unexpected end of body\n");
+			exit (1);
+		}
+		clen -= n;
+	}
+	return (1);
+}
+
+void client (int nreq)
+{
+	int s = -1;
+
+	while (nreq-- > 0) {
+		if (s < 0)
+			s = connectserver ();
+		if (! get (s)) {
+			close (s);
+			s = -1;
+		}
+	}
+	if (s >= 0)
+		close (s);
+}
+
+void usage ()
+{
+	fprintf (stderr, "Usage: lwbench [-k] [-c clients] [-n requests] host port path\n");
+	exit (1);
+}
+
+int main (int argc, char **argv)
+{
+	struct timeval t0, t1;
+	struct hostent *h;
+	int nclients = 10, nreq = 1000;
+	int i, status, failed;
+	double sec;
+
+	for (;;) {
+		switch (getopt (argc, argv, "kc:n:")) {
+		case EOF:
+			break;
+		case 'k':
+			++keepalive;
+			continue;
+		case 'c':
+			nclients = atoi (optarg);
+			continue;
+		case 'n':
+			nreq = atoi (optarg);
+			continue;
+		default:
+			usage ();
+		}
+		break;
+	}
+	argc -= optind;
+	argv += optind;
+	if (argc != 3 || nclients < 1 || nreq < nclients)
+		usage ();
+
+	memset (&server, 0, sizeof (server));
+	server.sin_family = AF_INET;
+	server.sin_port = htons (atoi (argv[1]));
+	server.sin_addr.s_addr = inet_addr (argv[0]);
+	if (server.sin_addr.s_addr == INADDR_NONE) {
+		h = gethostbyname (argv[0]);
+		if (! h) {
+			fprintf (stderr, "%s: unknown host\n", argv[0]);
+			exit (1);
+		}
+		memcpy (&server.sin_addr, h->h_addr, sizeof (server.sin_addr));
+	}
+	path = argv[2];
+
+	gettimeofday (&t0, 0);
+	for (i=0; i<nclients; ++i) {
+		switch (fork ()) {
+		case -1:
+			perror ("fork");
+			exit (1);
+		case 0:
+			client (nreq / nclients + (i < nreq % nclients));
+			exit (0);
+		}
+	}
+	failed = 0;
+	while (wait (&status) > 0)
+		if (status)
+			++failed;
+	gettimeofday (&t1, 0);
+
+	sec = t1.tv_sec - t0.tv_sec + (t1.tv_usec - t0.tv_usec) / 1e6;
+	printf ("%d requests, %d clients%s: %.3f sec, %.0f req/sec\n",
+		nreq, nclients, keepalive ? ", keep-alive" : "",
+		sec, nreq / sec);
+	if (failed) {
+		printf ("%d clients failed\n", failed);
+		return (1);
+	}
+	return (0);
+}
@@ -0,0 +1,82 @@
+/*
+ * Translation of text by the coding table.
+ * See tcode.h for the description.
+ *
+ * Copyright (C) 1994-1997 Cronyx Ltd.
+ * Author: Serge Vakulenko, <vak@cronyx.ru>
+ */
+#include <string.h>
+#include "tcode.h"
+
+#define ISDIGIT(c)	((c) >= '0' && (c) <= '9')
+#define HEXVAL(c)       ((c) >= 'A' && (c) <= 'F' ? (c) - 'A' + 10 : \
+			 (c) >= 'a' && (c) <= 'f' ? (c) - 'f' + 10 : (c) & 0x0f)
+#define ISXDIGIT(c)     (((c) >= 'A' && (c) <= 'F') || \
+			 ((c) >= 'a' && (c) <= 'f') || ISDIGIT (c))
+
+/*
+ * Translate the block of text by the coding table.
+ * Characters of %XX escapes are translated as a whole.
+ * Return the number of input bytes processed: an escape
+ * split at the end of block is left for the next call,
+ * unless it is the end of data (eof).  The output length
+ * is stored into *outlen.
+ */
+unsigned long transcode (unsigned char *to, unsigned char *from,
+	unsigned long len, unsigned char *tab, int eof, unsigned long *outlen)
+{
+	unsigned char *p = from, *end = from + len, *q = to;
+	int c, d;
+
+	for (;;) {
+		/* Fast path: 8 bytes of ASCII without '%' are copied as is,
+		 * since the tables do not change the lower half. */
+		while (end - p >= 8) {
+			unsigned long long w;
+
+			memcpy (&w, p, 8);
+			if ((w & 0x8080808080808080ULL) ||
+			    (((w ^ 0x2525252525252525ULL) - 0x0101010101010101ULL) &
+			    ~(w ^ 0x2525252525252525ULL) & 0x8080808080808080ULL))
+				break;
+			memcpy (q, &w, 8);
+			p += 8;
+			q += 8;
+		}
+		if (p >= end)
+			break;
+		c = *p;
+		if (c != '%') {
+			*q++ = tab[c];
+			++p;
+			continue;
+		}
+		if (end - p < 3) {
+			if (! eof)
+				break;
+			/* Truncated escape: '%' and the next byte,
+			 * unless it starts a hex pair, as copy() did. */
+			if (end - p == 2) {
+				*q++ = '%';
+				if (! ISXDIGIT (p[1]))
+					*q++ = tab[p[1]];
+			}
+			p = end;
+			break;
+		}
+		*q++ = '%';
+		c = p[1];
+		if (! ISXDIGIT (c)) {
+			*q++ = tab[c];
+			p += 2;
+			continue;
+		}
+		d = p[2];
+		c = tab [HEXVAL (c) << 4 | HEXVAL (d)];
+		*q++ = "0123456789ABCDEF" [c>>4];
+		*q++ = "0123456789ABCDEF" [c&15];
+		p += 3;
+	}
+	*outlen = q - to;
+	return (p - from);
+}
@@ -0,0 +1,14 @@
+/*
+ * Translation of text by the coding table.
+ *
+ * unsigned long transcode (unsigned char *to, unsigned char *from,
+ *      unsigned long len, unsigned char *tab, int eof,
+ *      unsigned long *outlen)
+ *      Translate len bytes from `from' into `to' by the table,
+ *      keeping the %XX escapes in hex.  The output is never
+ *      longer than the input.  Return the number of input bytes
+ *      processed; with eof == 0 an escape split at the end
+ *      is left for the next call.
+ */
+unsigned long transcode (unsigned char *to, unsigned char *from,
+	unsigned long len, unsigned char *tab, int eof, unsigned long *outlen);
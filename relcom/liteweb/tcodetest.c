@@ -0,0 +1,173 @@
+/*
+ * Test of transcode() against the byte-by-byte copy()
+ * of the earlier liteweb versions.
+ *
+ * Usage:
+ *      tcodetest [count]
+ *
+ * Short buffers, and buffers ending in "%", "%x", "%%" and "%a",
+ * are translated as a whole (as the text cache does) and
+ * in small blocks (as copy() does), and both results are
+ * compared with the reference.
+ *
+ * Copyright (C) 1994-1997 Cronyx Ltd.
+ * Author: Serge Vakulenko, <vak@cronyx.ru>
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "tcode.h"
+
+unsigned char tab [256];
+int nfail;
+
+/*
+ * The old copy(), on the translation path.
+ */
+void oldcopy (FILE *from, FILE *to, unsigned long len)
+{
+	fseek (from, 0L, 0);
+	while (len-- > 0) {
+		int c = getc (from);
+		if (c < 0)
+			break;
+		if (c == '%') {
+			if (len-- <= 0)
+				break;
+			c = getc (from);
+			if (c < 0)
+				break;
+			putc ('%', to);
+			if ((c >= 'A' && c <= 'F') ||
+			    (c >= 'a' && c <= 'f') ||
+			    (c >= '0' && c <= '9')) {
+				int d;
+				if (len-- <= 0)
+					break;
+				d = getc (from);
+				if (d < 0)
+					break;
+				if      (c >= 'A' && c <= 'F') c -= 'A' - 10;
+				else if (c >= 'a' && c <= 'f') c -= 'f' - 10;
+				else                           c &= 0x0f;
+				if      (d >= 'A' && d <= 'F') d -= 'A' - 10;
+				else if (d >= 'a' && d <= 'f') d -= 'f' - 10;
+				else                           d &= 0x0f;
+				c = tab [c<<4 | d];
+				putc ("0123456789ABCDEF" [c>>4], to);
+				putc ("0123456789ABCDEF" [c&15], to);
+				continue;
+			}
+		}
+		c = tab[c];
+		putc (c, to);
+	}
+}
+
+/*
+ * Translate by the reference copy, through temporary files.
+ */
+unsigned long reference (unsigned char *out, unsigned char *in, unsigned long len)
+{
+	FILE *from, *to;
+	unsigned long n;
+
+	from = tmpfile ();
+	to = tmpfile ();
+	if (! from || ! to) {
+		perror ("tmpfile");
+		exit (2);
+	}
+	fwrite (in, 1, len, from);
+	oldcopy (from, to, len);
+	n = ftell (to);
+	rewind (to);
+	if (fread (out, 1, n, to) != n)
+		n = 0;
+	fclose (from);
+	fclose (to);
+	return (n);
+}
+
+/*
+ * Translate in blocks of the given size, carrying split
+ * escapes over to the next block, the way copy() does.
+ */
+unsigned long blocks (unsigned char *out, unsigned char *in, unsigned long len,
+	unsigned long bsize)
+{
+	unsigned char ibuf [64];
+	unsigned long n, done, olen, total = 0;
+	int left = 0;
+
+	while (len > 0) {
+		n = bsize - left;
+		if (n > len)
+			n = len;
+		memcpy (ibuf + left, in, n);
+		in += n;
+		len -= n;
+		n += left;
+		done = transcode (out + total, ibuf, n, tab, len == 0, &olen);
+		total += olen;
+		left = n - done;
+		memmove (ibuf, ibuf + done, left);
+	}
+	return (total);
+}
+
+void check (unsigned char *in, unsigned long len)
+{
+	unsigned char want [256], got [256];
+	unsigned long nwant, ngot, bsize;
+
+	nwant = reference (want, in, len);
+	transcode (got, in, len, tab, 1, &ngot);
+	if (ngot != nwant || memcmp (got, want, ngot) != 0) {
+		printf ("whole: '%.*s' gives %lu bytes, expected %lu\n",
+			(int) len, in, ngot, nwant);
+		++nfail;
+	}
+	for (bsize=3; bsize<=17; ++bsize) {
+		ngot = blocks (got, in, len, bsize);
+		if (ngot != nwant || memcmp (got, want, ngot) != 0) {
+			printf ("blocks of %lu: '%.*s' gives %lu bytes, expected %lu\n",
+				bsize, (int) len, in, ngot, nwant);
+			++nfail;
+			break;
+		}
+	}
+}
+
+int main (int argc, char **argv)
+{
+	static char *tails [] = { "%", "%x", "%%", "%a", "%4", "%4a", "%\n", };
+	static char alpha [] = "%%%%aF4x \n\r\200\301\377";
+	unsigned char buf [128];
+	int count, i, k, len, t;
+
+	count = argc > 1 ? atoi (argv[1]) : 20000;
+
+	/* A table which keeps the lower half, like the coding tables. */
+	for (i=0; i<256; ++i)
+		tab[i] = i < 0200 ? i : 0200 | ((i * 7 + 3) & 0177);
+
+	srand (1);
+	for (k=0; k<count; ++k) {
+		len = rand () % 40;
+		for (i=0; i<len; ++i)
+			buf[i] = rand () % 4 ? alpha [rand () % (sizeof (alpha) - 1)] :
+				"100 percent of text"[i % 19];
+		check (buf, len);
+		for (t=0; t<sizeof (tails) / sizeof (tails[0]); ++t) {
+			strcpy ((char*) buf + len, tails[t]);
+			check (buf, len + strlen (tails[t]));
+		}
+	}
+	if (nfail) {
+		printf ("%d failures\n", nfail);
+		return (1);
+	}
+	printf ("transcode: %d buffers ok\n", count);
+	return (0);
+}
@@ -0,0 +1,535 @@
+/*
+ * Trigram index of the archive index file.
+ * See tindex.h for the description.
+ *
+ * Copyright (C) 1994-1997 Cronyx Ltd.
+ * Author: Serge Vakulenko, <vak@cronyx.ru>
+ */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "tindex.h"
+
+#define LINESZ          512             /* must be the same as in liteweb */
+#define MAXKEYS         64              /* trigrams used for a search */
+
+struct tpost {
+	unsigned char *buf;             /* encoded list, 0 - free slot */
+	unsigned int len;               /* length of the list */
+	unsigned int cap;               /* allocated length */
+	unsigned int tri;               /* trigram */
+	unsigned int cnt;               /* number of lines */
+	long last;                      /* last line number added */
+};
+
+static struct tpost *ptab;              /* hash table of trigram lists */
+static unsigned long psize;             /* size of ptab, power of two */
+static unsigned long pcount;            /* used slots of ptab */
+
+/*
+ * Must be the same as lower() in liteweb.
+ */
+static unsigned char tlower (unsigned char c)
+{
+	if (c>='A' && c<='Z')
+		return (c + 'a' - 'A');
+	if (c>=0340 && c<=0377)
+		return (c - 040);
+	if (c==0263)
+		return (0243);
+	return (c);
+}
+
+static int tricmp (const void *a, const void *b)
+{
+	unsigned int x = *(unsigned int*) a, y = *(unsigned int*) b;
+
+	return (x < y ? -1 : x > y);
+}
+
+/*
+ * Add the trigrams of the string to the table,
+ * skipping the repeated ones when uniq is set.
+ * Return the new count.
+ */
+static int addtri (unsigned char *s, int n, unsigned int *tab, int cnt,
+	int max, int uniq)
+{
+	unsigned int t;
+	int i, k;
+
+	for (i=0; i+3<=n && cnt<max; ++i) {
+		t = s[i] << 16 | s[i+1] << 8 | s[i+2];
+		if (uniq) {
+			for (k=0; k<cnt; ++k)
+				if (tab[k] == t)
+					break;
+			if (k < cnt)
+				continue;
+		}
+		tab[cnt++] = t;
+	}
+	return (cnt);
+}
+
+/*
+ * Split the .index line into the file name and description
+ * and lowercase them, in the same way as searchfile() in liteweb.
+ */
+static void splitrec (char *info, char *file, char *descr)
+{
+	char *path, *p, *f;
+
+	p = info + strlen (info);
+	while (p>info && (p[-1]=='\n' || p[-1]=='\r'))
+		*--p = 0;
+
+	path = info;
+	p = strchr (info, ' ');
+	if (p) {
+		*p++ = 0;
+		p = strchr (p, ' ');
+	}
+	if (! p)
+		p = "";
+
+	f = strrchr (path, '/');
+	if (! f)                /* base file name */
+		f = path;
+	else if (! f[1]) {      /* directory */
+		while (f>path && *f=='/')
+			*f-- = 0;
+		while (f>path && f[-1]!='/')
+			--f;
+	} else                  /* file path */
+		++f;
+
+	for (; *f; ++f)
+		*file++ = tlower (*f);
+	*file = 0;
+	for (; *p; ++p)
+		*descr++ = tlower (*p);
+	*descr = 0;
+}
+
+/*
+ * Get the trigrams which must be present in any line
+ * matching the pattern.  Return the count, or -1 when the
+ * pattern cannot be used for the index search.
+ */
+static int patkeys (unsigned char *pat, unsigned int *keys)
+{
+	unsigned char run [LINESZ];
+	int n = 0, nkeys = 0, c;
+
+#if USE_REGEXP
+	int depth = 0;
+
+	if (strchr ((char*) pat, '|'))
+		return (-1);            /* alternatives */
+	for (;; ++pat) {
+		c = *pat;
+		if (c && ! strchr (".[]()*+?{}\\^$", c)) {
+			if (n < LINESZ)
+				run[n++] = c;
+			continue;
+		}
+		if (n > 0 && (c == '*' || c == '?' || c == '{'))
+			--n;            /* the last char is optional */
+		if (! depth)            /* a group can be optional as a whole */
+			nkeys = addtri (run, n, keys, nkeys, MAXKEYS, 1);
+		n = 0;
+		if (! c)
+			break;
+		if (c == '\\')
+			return (-1);
+		if (c == '(')
+			++depth;
+		else if (c == ')' && depth > 0)
+			--depth;
+		if (c == '[') {
+			++pat;
+			if (*pat == '^')
+				++pat;
+			if (*pat == ']')
+				++pat;
+			pat = (unsigned char*) strchr ((char*) pat, ']');
+			if (! pat)
+				return (-1);
+		}
+	}
+#else
+	/* Syntax of match(): the literal substrings are delimited
+	 * by wildcards, nothing after '$' is compared. */
+	if (*pat == '!')
+		return (-1);            /* negation */
+	if (*pat == '^')
+		++pat;
+	for (;; ++pat) {
+		c = *pat;
+		if (c && c != '*' && c != '?' && c != '[' && c != '$') {
+			if (n < LINESZ)
+				run[n++] = c;
+			continue;
+		}
+		nkeys = addtri (run, n, keys, nkeys, MAXKEYS, 1);
+		n = 0;
+		if (! c || c == '$')
+			break;
+		if (c == '[') {
+			++pat;
+			if (*pat == '^' || *pat == '!')
+				++pat;
+			for (;;) {
+				c = *pat++;
+				if (c == ']')
+					break;
+				if (! c)
+					return (-1);
+				if (*pat == '-') {
+					if (! pat[1])
+						return (-1);
+					pat += 2;
+				}
+			}
+			--pat;
+		}
+	}
+#endif
+	return (nkeys);
+}
+
+TINDEX *tindex_open (char *dir)
+{
+	char name [LINESZ];
+	struct stat st, ist;
+	struct tihead *h;
+	TINDEX *t;
+	int fd;
+
+	if (strlen (dir) + sizeof (TINDEX_NAME) + 1 > sizeof (name))
+		return (0);
+	sprintf (name, "%s/.index", dir);
+	if (stat (name, &ist) < 0)
+		return (0);
+	sprintf (name, "%s/%s", dir, TINDEX_NAME);
+	fd = open (name, O_RDONLY);
+	if (fd < 0)
+		return (0);
+	if (fstat (fd, &st) < 0 || st.st_size < sizeof (struct tihead)) {
+		close (fd);
+		return (0);
+	}
+	t = (TINDEX*) malloc (sizeof (TINDEX));
+	if (! t) {
+		close (fd);
+		return (0);
+	}
+	t->size = st.st_size;
+	t->base = mmap (0, t->size, PROT_READ, MAP_SHARED, fd, 0);
+	close (fd);
+	if (t->base == (char*) MAP_FAILED) {
+		free (t);
+		return (0);
+	}
+
+	/* The index must describe this very .index file. */
+	h = t->head = (struct tihead*) t->base;
+	if (h->magic != TINDEX_MAGIC || h->isize != ist.st_size ||
+	    h->imtime != (unsigned int) ist.st_mtime ||
+	    sizeof (*h) + h->nrec * 4UL + h->ntri * sizeof (struct tientry) >
+	    t->size) {
+		tindex_close (t);
+		return (0);
+	}
+	t->recoff = (unsigned int*) (h + 1);
+	t->tab = (struct tientry*) (t->recoff + h->nrec);
+	t->postings = (unsigned char*) (t->tab + h->ntri);
+	return (t);
+}
+
+void tindex_close (TINDEX *t)
+{
+	munmap (t->base, t->size);
+	free (t);
+}
+
+static struct tientry *tfind (TINDEX *t, unsigned int tri)
+{
+	struct tientry *e;
+	unsigned int lo = 0, hi = t->head->ntri;
+
+	while (lo < hi) {
+		e = t->tab + (lo + hi) / 2;
+		if (e->tri == tri)
+			return (e);
+		if (e->tri < tri)
+			lo = e - t->tab + 1;
+		else
+			hi = e - t->tab;
+	}
+	return (0);
+}
+
+static int cntcmp (const void *a, const void *b)
+{
+	const struct tientry *x = *(struct tientry**) a;
+	const struct tientry *y = *(struct tientry**) b;
+
+	return (x->cnt < y->cnt ? -1 : x->cnt > y->cnt);
+}
+
+long tindex_search (TINDEX *t, char *pattern, unsigned int **offs)
+{
+	unsigned int keys [MAXKEYS], *cand;
+	struct tientry *etab [MAXKEYS];
+	unsigned char *p, *end;
+	unsigned long rec, v;
+	long ncand, i, k;
+	int nkeys, n, shift;
+
+	nkeys = patkeys ((unsigned char*) pattern, keys);
+	if (nkeys <= 0)
+		return (-1);
+	for (n=0; n<nkeys; ++n) {
+		etab[n] = tfind (t, keys[n]);
+		if (! etab[n]) {
+			*offs = 0;
+			return (0);     /* nothing can match */
+		}
+	}
+
+	/* Start from the shortest list. */
+	qsort (etab, nkeys, sizeof (etab[0]), cntcmp);
+	cand = (unsigned int*) malloc ((etab[0]->cnt + 1) * sizeof (*cand));
+	if (! cand)
+		return (-1);
+	ncand = 0;
+	for (n=0; n<nkeys && (n==0 || ncand>0); ++n) {
+		p = t->postings + etab[n]->off;
+		end = (unsigned char*) t->base + t->size;
+		rec = (unsigned long) -1;
+		k = 0;
+		for (i=0; i<etab[n]->cnt && p<end; ++i) {
+			v = 0;
+			shift = 0;
+			while (p < end && (*p & 0x80)) {
+				v |= (unsigned long) (*p++ & 0x7f) << shift;
+				shift += 7;
+			}
+			if (p < end)
+				v |= (unsigned long) *p++ << shift;
+			rec += v + 1;
+			if (n == 0) {
+				cand[ncand++] = rec;
+				continue;
+			}
+			/* Intersect with the candidates. */
+			while (k < ncand && cand[k] < rec)
+				cand[k++] = ~0;
+			if (k < ncand && cand[k] == rec)
+				++k;
+		}
+		if (n > 0) {
+			while (k < ncand)
+				cand[k++] = ~0;
+			for (i=k=0; i<ncand; ++i)
+				if (cand[i] != ~0)
+					cand[k++] = cand[i];
+			ncand = k;
+		}
+	}
+
+	/* Line numbers to offsets. */
+	for (i=k=0; i<ncand; ++i)
+		if (cand[i] < t->head->nrec)
+			cand[k++] = t->recoff [cand[i]];
+	*offs = cand;
+	return (k);
+}
+
+static struct tpost *pfind (unsigned int tri)
+{
+	struct tpost *p;
+	unsigned long i;
+
+	i = (tri * 2654435761U) & (psize - 1);
+	for (;;) {
+		p = ptab + i;
+		if (! p->buf || p->tri == tri)
+			return (p);
+		i = (i + 1) & (psize - 1);
+	}
+}
+
+static int pgrow ()
+{
+	struct tpost *old = ptab, *p, *q;
+	unsigned long oldsize = psize;
+
+	psize = psize ? psize * 2 : 4096;
+	ptab = (struct tpost*) calloc (psize, sizeof (struct tpost));
+	if (! ptab)
+		return (-1);
+	for (p=old; p<old+oldsize; ++p)
+		if (p->buf) {
+			q = pfind (p->tri);
+			*q = *p;
+		}
+	free (old);
+	return (0);
+}
+
+/*
+ * Append the line number to the list of the trigram.
+ */
+static int addpost (unsigned int tri, unsigned long rec)
+{
+	struct tpost *p;
+	unsigned long v;
+
+	if (pcount * 2 >= psize && pgrow () < 0)
+		return (-1);
+	p = pfind (tri);
+	if (! p->buf) {
+		p->cap = 16;
+		p->buf = (unsigned char*) malloc (p->cap);
+		if (! p->buf)
+			return (-1);
+		p->tri = tri;
+		p->last = -1;
+		++pcount;
+	}
+	if (p->len + 10 > p->cap) {
+		p->cap *= 2;
+		p->buf = (unsigned char*) realloc (p->buf, p->cap);
+		if (! p->buf)
+			return (-1);
+	}
+	v = rec - p->last - 1;
+	while (v >= 0x80) {
+		p->buf[p->len++] = v | 0x80;
+		v >>= 7;
+	}
+	p->buf[p->len++] = v;
+	p->last = rec;
+	++p->cnt;
+	return (0);
+}
+
+static void pfree ()
+{
+	struct tpost *p;
+
+	for (p=ptab; p<ptab+psize; ++p)
+		if (p->buf)
+			free (p->buf);
+	free (ptab);
+	ptab = 0;
+	psize = pcount = 0;
+}
+
+static int postcmp (const void *a, const void *b)
+{
+	const struct tpost *x = a, *y = b;
+
+	/* Free slots go to the end. */
+	if (! x->buf || ! y->buf)
+		return (! x->buf) - (! y->buf);
+	return (x->tri < y->tri ? -1 : x->tri > y->tri);
+}
+
+int tindex_build (char *dir)
+{
+	char name [LINESZ], tmpname [LINESZ+1];
+	char info [LINESZ], file [LINESZ], descr [LINESZ];
+	unsigned int tri [2*LINESZ], *recoff = 0;
+	unsigned long nrec = 0, reclen = 0, off, i;
+	struct tihead h;
+	struct tientry e;
+	struct stat st;
+	FILE *fd, *out;
+	int n;
+
+	if (strlen (dir) + sizeof (TINDEX_NAME) + 5 > sizeof (name))
+		return (-1);
+	sprintf (name, "%s/.index", dir);
+	fd = fopen (name, "r");
+	if (! fd)
+		return (-1);
+
+	for (;;) {
+		off = ftell (fd);
+		if (! fgets (info, sizeof (info), fd))
+			break;
+		if (nrec >= reclen) {
+			reclen = reclen ? reclen * 2 : 1024;
+			recoff = (unsigned int*) realloc (recoff,
+				reclen * sizeof (*recoff));
+			if (! recoff)
+				goto nomem;
+		}
+		recoff[nrec] = off;
+
+		splitrec (info, file, descr);
+		n = addtri ((unsigned char*) file, strlen (file), tri, 0,
+			2*LINESZ, 0);
+		n = addtri ((unsigned char*) descr, strlen (descr), tri, n,
+			2*LINESZ, 0);
+		qsort (tri, n, sizeof (tri[0]), tricmp);
+		for (i=0; i<n; ++i)
+			if ((i == 0 || tri[i] != tri[i-1]) &&
+			    addpost (tri[i], nrec) < 0)
+				goto nomem;
+		++nrec;
+	}
+	fstat (fileno (fd), &st);
+	fclose (fd);
+
+	/* Sort the lists by trigram. */
+	qsort (ptab, psize, sizeof (struct tpost), postcmp);
+
+	sprintf (name, "%s/%s", dir, TINDEX_NAME);
+	sprintf (tmpname, "%s~", name);
+	out = fopen (tmpname, "w");
+	if (! out) {
+		free (recoff);
+		pfree ();
+		return (-1);
+	}
+	h.magic = TINDEX_MAGIC;
+	h.nrec = nrec;
+	h.ntri = pcount;
+	h.isize = st.st_size;
+	h.imtime = st.st_mtime;
+	fwrite (&h, sizeof (h), 1, out);
+	fwrite (recoff, sizeof (*recoff), nrec, out);
+	off = 0;
+	for (i=0; i<pcount; ++i) {
+		e.tri = ptab[i].tri;
+		e.off = off;
+		e.cnt = ptab[i].cnt;
+		fwrite (&e, sizeof (e), 1, out);
+		off += ptab[i].len;
+	}
+	for (i=0; i<pcount; ++i)
+		fwrite (ptab[i].buf, 1, ptab[i].len, out);
+	free (recoff);
+	pfree ();
+	if (fclose (out) != 0 || rename (tmpname, name) < 0) {
+		unlink (tmpname);
+		return (-1);
+	}
+	return (0);
+nomem:
+	fclose (fd);
+	free (recoff);
+	pfree ();
+	return (-1);
+}
@@ -0,0 +1,69 @@
+/*
+ * Trigram index of the archive index file.
+ *
+ * For every line of the directory .index file, lindex collects
+ * the three-byte substrings (trigrams) of the lowercased file name
+ * and description, and writes the lists of the lines containing
+ * each trigram into the .index.tri file.  A search pattern contains
+ * literal substrings which must be present in any matching line;
+ * their trigrams select the candidate lines, which are then
+ * checked by the usual pattern match.
+ *
+ * The file is written in the host byte order:
+ *      struct tihead                   header
+ *      unsigned int recoff [nrec]      offsets of lines in .index
+ *      struct tientry [ntri]           trigrams in ascending order
+ *      unsigned char postings []       lists of line numbers
+ * Each list is a sequence of line number increments,
+ * minus one, in 7-bit variable-length encoding.
+ *
+ * TINDEX *tindex_open (char *dir)
+ *      Open the trigram index of the directory.  Return 0 when it
+ *      is absent or does not correspond to the .index file.
+ *
+ * void tindex_close (TINDEX *t)
+ *
+ * long tindex_search (TINDEX *t, char *pattern, unsigned int **offs)
+ *      Find the lines which can match the (lowercased) pattern.
+ *      Store the malloc'ed array of their offsets in .index into
+ *      *offs, in file order, and return the count.  Return -1 when
+ *      the pattern gives no key for the search and all lines
+ *      must be scanned.
+ *
+ * int tindex_build (char *dir)
+ *      Create the trigram index for the .index file of the directory.
+ *      Return -1 on error.
+ *
+ * Copyright (C) 1994-1997 Cronyx Ltd.
+ * Author: Serge Vakulenko, <vak@cronyx.ru>
+ */
+#define TINDEX_NAME     ".index.tri"
+#define TINDEX_MAGIC    0x31495254              /* "TRI1" */
+
+struct tihead {
+	unsigned int magic;             /* TINDEX_MAGIC */
+	unsigned int nrec;              /* number of lines */
+	unsigned int ntri;              /* number of trigrams */
+	unsigned int isize;             /* size of .index */
+	unsigned int imtime;            /* modification time of .index */
+};
+
+struct tientry {
+	unsigned int tri;               /* trigram, first byte is high */
+	unsigned int off;               /* offset of list in postings */
+	unsigned int cnt;               /* number of lines in list */
+};
+
+typedef struct {
+	char *base;                     /* mapped file */
+	unsigned long size;             /* length of the file */
+	struct tihead *head;
+	unsigned int *recoff;
+	struct tientry *tab;
+	unsigned char *postings;
+} TINDEX;
+
+TINDEX *tindex_open (char *dir);
+void tindex_close (TINDEX *t);
+long tindex_search (TINDEX *t, char *pattern, unsigned int **offs);
+int tindex_build (char *dir);
@@ -5,6 +5,13 @@
  * Количество записей не ограничено, таблица растет
  * по мере заполнения и уменьшается по мере удаления записей.
  *
+ * Таблица - массив слотов с открытой адресацией (Robin Hood):
+ * слот хранит полный хэш ключа и указатель на элемент, так что
+ * при поиске к элементу обращаемся только при совпадении хэша.
+ * Элементы (ключ и данные подряд) выделяются из арены и не
+ * перемещаются при росте таблицы; память удаленных и замененных
+ * элементов возвращается только при vdbm_close.
+ *
  * Автор Сергей Вакуленко, <vak@kiae.su>.
  */
 
@@ -33,17 +40,29 @@ typedef struct {
 } vdatum;
 
 typedef struct _elem {
-	short keysize;                  /* длина ключа */
-	short valsize;                  /* длина данных */
+	int keysize;                    /* длина ключа */
+	int valsize;                    /* длина данных */
 	/* char key [keysize]; */       /* ключ */
 	/* char val [valsize]; */       /* данные */
 } velem;
 
+typedef struct {
+	unsigned long hash;     /* хэш ключа, 0 - свободный слот */
+	velem *elem;            /* элемент (лежит в арене) */
+} vslot;
+
+typedef struct _vchunk {
+	struct _vchunk *next;   /* следующий блок арены */
+	int size;               /* размер блока */
+	int used;               /* занято байтов */
+} vchunk;
+
 typedef struct {
 	int size;       /* длина таблицы tab, обязательно степень двойки */
-	int cnt;        /* количество элементов в tab, не больше 70% от size */
+	int cnt;        /* количество элементов в tab, не больше 75% от size */
 	int nextindex;  /* следующий индекс в tab для перебора */
-	velem **tab;    /* таблица элементов */
+	vslot *tab;     /* таблица слотов, открытая адресация */
+	vchunk *arena;  /* блоки памяти, из которых берутся элементы */
 } VDBM;
 
 extern VDBM     *vdbm_open ();
@@ -42,6 +42,7 @@ static char sccsid[] = "@(#)mpool.c	8.1 (Berkeley) 6/6/93";
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
 #include "db.h"
 #define __MPOOLINTERFACE_PRIVATE
@@ -49,6 +50,7 @@ static char sccsid[] = "@(#)mpool.c	8.1 (Berkeley) 6/6/93";
 
 static BKT *mpool_bkt ();
 static BKT *mpool_look ();
+static void *mpool_read ();
 static int  mpool_write ();
 #ifdef DEBUG
 static void __mpoolerr ();
@@ -74,7 +76,7 @@ mpool_open(key, fd, pagesize, maxcache)
 {
 	struct stat sb;
 	MPOOL *mp;
-	int entry;
+	pgno_t entry, hsize;
 
 	if (fstat(fd, &sb))
 		return (0);
@@ -88,12 +90,21 @@ mpool_open(key, fd, pagesize, maxcache)
 		return (0);
 	}
 
+	for (hsize = HASHSIZE; hsize < maxcache; hsize <<= 1)
+		continue;
 	mp = (MPOOL*) malloc(sizeof(MPOOL));
 	if (! mp)
 		return (0);
+	mp->hashtable = (BKTHDR*) malloc(hsize * sizeof(BKTHDR));
+	if (! mp->hashtable) {
+		free((void*) mp);
+		return (0);
+	}
+	mp->hashmask = hsize - 1;
 	mp->free.cnext = mp->free.cprev = (BKT *)&mp->free;
 	mp->lru.cnext = mp->lru.cprev = (BKT *)&mp->lru;
-	for (entry = 0; entry < HASHSIZE; ++entry)
+	mp->hand = (BKT *)&mp->lru;
+	for (entry = 0; entry < hsize; ++entry)
 		mp->hashtable[entry].hnext = mp->hashtable[entry].hprev = 
 		    mp->hashtable[entry].cnext = mp->hashtable[entry].cprev =
 		    (BKT *)&mp->hashtable[entry];
@@ -104,12 +115,8 @@ mpool_open(key, fd, pagesize, maxcache)
 	mp->fd = fd;
 	mp->pgcookie = 0;
 	mp->pgin = mp->pgout = 0;
-
-#ifdef STATISTICS
-	mp->cachehit = mp->cachemiss = mp->pagealloc = mp->pageflush = 
-	    mp->pageget = mp->pagenew = mp->pageput = mp->pageread = 
-	    mp->pagewrite = 0;
-#endif
+	mp->ranext = 0;
+	memset(&mp->stat, 0, sizeof(mp->stat));
 	return (mp);
 }
 
@@ -150,19 +157,17 @@ mpool_new(mp, pgnoaddr)
 	BKT *b;
 	BKTHDR *hp;
 
-#ifdef STATISTICS
-	++mp->pagenew;
-#endif
+	++mp->stat.pagenew;
 	/*
 	 * Get a BKT from the cache.  Assign a new page number, attach it to
-	 * the hash and lru chains and return.
+	 * the hash chain and the clock ring and return.
 	 */
 	if (! (b = mpool_bkt(mp)))
 		return (0);
 	*pgnoaddr = b->pgno = mp->npages++;
-	b->flags = MPOOL_PINNED;
+	b->flags = MPOOL_PINNED | MPOOL_REF;
 	inshash(b, b->pgno);
-	inschain(b, &mp->lru);
+	inschain(b, mp->hand);
 	return (b->page);
 }
 
@@ -172,7 +177,7 @@ mpool_new(mp, pgnoaddr)
  * Parameters:
  *	mp:	mpool cookie
  *	pgno:	page number
- *	flags:	not used
+ *	flags:	MPOOL_SEQ if the caller is walking the file a page at a time
  *
  * Returns:
  *	RET_ERROR, RET_SUCCESS
@@ -181,12 +186,21 @@ void *
 mpool_get(mp, pgno, flags)
 	MPOOL *mp;
 	pgno_t pgno;
-	unsigned int flags;            /* XXX not used? */
+	unsigned int flags;
 {
 	BKT *b;
-	BKTHDR *hp;
-	off_t off;
-	int nr;
+	pgno_t n;
+	int seq;
+
+	/*
+	 * A scan that asks for the page right after the one it asked for
+	 * last is reading the file in order; remember where it is going.
+	 */
+	seq = 0;
+	if (flags & MPOOL_SEQ) {
+		seq = pgno == mp->ranext;
+		mp->ranext = pgno + 1;
+	}
 
 	/*
 	 * If asking for a specific page that is already in the cache, find
@@ -194,19 +208,21 @@ mpool_get(mp, pgno, flags)
 	 */
 	b = mpool_look(mp, pgno);
 	if (b) {
-#ifdef STATISTICS
-		++mp->pageget;
-#endif
+		++mp->stat.cachehit;
+		++mp->stat.pageget;
 #ifdef DEBUG
 		if (b->flags & MPOOL_PINNED)
 			__mpoolerr("mpool_get: page %d already pinned",
 			    b->pgno);
 #endif
-		rmchain(b);
-		inschain(b, &mp->lru);
-		b->flags |= MPOOL_PINNED;
+		if (b->flags & MPOOL_RAHEAD) {
+			++mp->stat.rahit;
+			b->flags &= ~MPOOL_RAHEAD;
+		}
+		b->flags |= MPOOL_PINNED | MPOOL_REF;
 		return (b->page);
 	}
+	++mp->stat.cachemiss;
 
 	/* Not allowed to retrieve a non-existent page. */
 	if (pgno >= mp->npages) {
@@ -214,33 +230,18 @@ mpool_get(mp, pgno, flags)
 		return (0);
 	}
 
-	/* Get a page from the cache. */
-	if (! (b = mpool_bkt(mp)))
-		return (0);
-	b->pgno = pgno;
-	b->flags = MPOOL_PINNED;
-
-#ifdef STATISTICS
-	++mp->pageread;
-#endif
-	/* Read in the contents. */
-	off = mp->pagesize * pgno;
-	if (lseek(mp->fd, off, SEEK_SET) != off)
-		return (0);
-	if ((nr = read(mp->fd, b->page, mp->pagesize)) != mp->pagesize) {
-		if (nr >= 0)
-			errno = EINVAL;
-		return (0);
+	/*
+	 * On a sequential miss, read the following pages too, up to the
+	 * first one that is already cached.  Keep the run to a quarter of
+	 * the cache so that a long scan doesn't flush everything else.
+	 */
+	n = 1;
+	if (seq) {
+		while (n < MPOOL_RAMAX && n < mp->maxcache / 4 &&
+		    pgno + n < mp->npages && ! mpool_look(mp, pgno + n))
+			++n;
 	}
-	if (mp->pgin)
-		(mp->pgin)(mp->pgcookie, b->pgno, b->page);
-
-	inshash(b, b->pgno);
-	inschain(b, &mp->lru);
-#ifdef STATISTICS
-	++mp->pageget;
-#endif
-	return (b->page);
+	return (mpool_read(mp, pgno, n));
 }
 
 /*
@@ -265,9 +266,7 @@ mpool_put(mp, page, flags)
 	BKT *b;
 #endif
 
-#ifdef STATISTICS
-	++mp->pageput;
-#endif
+	++mp->stat.pageput;
 	baddr = (BKT *)((char *)page - sizeof(BKT));
 #ifdef DEBUG
 	if (!(baddr->flags & MPOOL_PINNED))
@@ -299,11 +298,16 @@ mpool_close(mp)
 {
 	BKT *b, *next;
 
-	/* Free up any space allocated to the lru pages. */
+	/* Free up any space allocated to the cached and free pages. */
 	for (b = mp->lru.cprev; b != (BKT *)&mp->lru; b = next) {
 		next = b->cprev;
 		free((void*) b);
 	}
+	for (b = mp->free.cprev; b != (BKT *)&mp->free; b = next) {
+		next = b->cprev;
+		free((void*) b);
+	}
+	free((void*) mp->hashtable);
 	free((void*) mp);
 	return (RET_SUCCESS);
 }
@@ -329,6 +333,79 @@ mpool_sync(mp)
 	return (RET_SUCCESS);
 }
 
+/*
+ * MPOOL_READ -- read a run of pages into the cache
+ *
+ * Parameters:
+ *	mp:	mpool cookie
+ *	pgno:	first page number
+ *	n:	number of pages, none of them cached
+ *
+ * Returns:
+ *	NULL on failure and a pointer to the first page, pinned, on success.
+ *	The rest of the run is left unpinned and unreferenced, so that the
+ *	clock takes it back first if the scan never gets there.
+ */
+static void *
+mpool_read(mp, pgno, n)
+	MPOOL *mp;
+	pgno_t pgno, n;
+{
+	BKT *b, *bl[MPOOL_RAMAX];
+	BKTHDR *hp;
+	struct iovec iov[MPOOL_RAMAX];
+	off_t off;
+	pgno_t i, got;
+	int nr;
+
+	/* Get the pages from the cache, settling for fewer if need be. */
+	for (i = 0; i < n; ++i) {
+		if (! (b = mpool_bkt(mp)))
+			break;
+		bl[i] = b;
+		iov[i].iov_base = b->page;
+		iov[i].iov_len = mp->pagesize;
+	}
+	if (i == 0)
+		return (0);
+	n = i;
+
+	/* Read in the contents; a short read keeps the whole pages. */
+	off = mp->pagesize * pgno;
+	if (lseek(mp->fd, off, SEEK_SET) != off)
+		nr = -1;
+	else if (n == 1)
+		nr = read(mp->fd, bl[0]->page, mp->pagesize);
+	else
+		nr = readv(mp->fd, iov, (int)n);
+	got = nr < 0 ? 0 : nr / mp->pagesize;
+	if (got == 0 && nr >= 0)
+		errno = EINVAL;
+
+	/* Hash the pages that came in, give the rest back. */
+	for (i = 0; i < n; ++i) {
+		b = bl[i];
+		if (i >= got) {
+			inschain(b, &mp->free);
+			continue;
+		}
+		b->pgno = pgno + i;
+		if (i == 0) {
+			b->flags = MPOOL_PINNED | MPOOL_REF;
+			++mp->stat.pageread;
+			++mp->stat.pageget;
+		} else {
+			b->flags = MPOOL_RAHEAD;
+			++mp->stat.rahead;
+		}
+		if (mp->pgin)
+			(mp->pgin)(mp->pgcookie, b->pgno, b->page);
+		inshash(b, b->pgno);
+		inschain(b, mp->hand);
+	}
+	return (got ? bl[0]->page : 0);
+}
+
 /*
  * MPOOL_BKT -- get/create a BKT from the cache
  *
@@ -343,43 +420,56 @@ mpool_bkt(mp)
 	MPOOL *mp;
 {
 	BKT *b;
+	pgno_t cnt;
+
+	/* Reuse a bucket given back after a short read. */
+	if (mp->free.cnext != (BKT *)&mp->free) {
+		b = mp->free.cnext;
+		rmchain(b);
+		return (b);
+	}
 
 	if (mp->curcache < mp->maxcache)
 		goto new;
 
 	/*
-	 * If the cache is maxxed out, search the lru list for a buffer we
-	 * can flush.  If we find one, write it if necessary and take it off
-	 * any lists.  If we don't find anything we grow the cache anyway.
-	 * The cache never shrinks.
+	 * If the cache is maxxed out, sweep the clock for a buffer we can
+	 * flush: unpinned pages referenced since the hand last passed get
+	 * their reference bit cleared and a second chance.  Two turns of
+	 * the hand are enough to clear every bit.  If we find one, write it
+	 * if necessary and take it off any lists.  If we don't find anything
+	 * we grow the cache anyway.  The cache never shrinks.
 	 */
-	for (b = mp->lru.cprev; b != (BKT *)&mp->lru; b = b->cprev)
-		if (!(b->flags & MPOOL_PINNED)) {
-			if (b->flags & MPOOL_DIRTY &&
-			    mpool_write(mp, b) == RET_ERROR)
-				return (0);
-			rmhash(b);
-			rmchain(b);
-#ifdef STATISTICS
-			++mp->pageflush;
-#endif
+	for (cnt = 2 * (mp->curcache + 1); cnt > 0; --cnt) {
+		b = mp->hand = mp->hand->cprev;
+		if (b == (BKT *)&mp->lru || b->flags & MPOOL_PINNED)
+			continue;
+		if (b->flags & MPOOL_REF) {
+			b->flags &= ~MPOOL_REF;
+			continue;
+		}
+		if (b->flags & MPOOL_DIRTY &&
+		    mpool_write(mp, b) == RET_ERROR)
+			return (0);
+		mp->hand = b->cnext;
+		rmhash(b);
+		rmchain(b);
+		++mp->stat.pageflush;
 #ifdef DEBUG
-			{
-				void *spage;
-				spage = b->page;
-				memset(b, 0xff, sizeof(BKT) + mp->pagesize);
-				b->page = spage;
-			}
-#endif
-			return (b);
+		{
+			void *spage;
+			spage = b->page;
+			memset(b, 0xff, sizeof(BKT) + mp->pagesize);
+			b->page = spage;
 		}
+#endif
+		return (b);
+	}
 
 new:    b = (BKT*) malloc(sizeof(BKT) + mp->pagesize);
 	if (! b)
 		return (0);
-#ifdef STATISTICS
-	++mp->pagealloc;
-#endif
+	++mp->stat.pagealloc;
 #ifdef DEBUG
 	memset(b, 0xff, sizeof(BKT) + mp->pagesize);
 #endif
@@ -407,9 +497,7 @@ mpool_write(mp, b)
 	if (mp->pgout)
 		(mp->pgout)(mp->pgcookie, b->pgno, b->page);
 
-#ifdef STATISTICS
-	++mp->pagewrite;
-#endif
+	++mp->stat.pagewrite;
 	off = mp->pagesize * b->pgno;
 	if (lseek(mp->fd, off, SEEK_SET) != off)
 		return (RET_ERROR);
@@ -437,25 +525,31 @@ mpool_look(mp, pgno)
 	register BKT *b;
 	register BKTHDR *tb;
 
-	/* XXX
-	 * If find the buffer, put it first on the hash chain so can
-	 * find it again quickly.
-	 */
-	tb = &mp->hashtable[HASHKEY(pgno)];
+	tb = &mp->hashtable[HASHKEY(mp, pgno)];
 	for (b = tb->hnext; b != (BKT *)tb; b = b->hnext)
-		if (b->pgno == pgno) {
-#ifdef STATISTICS
-			++mp->cachehit;
-#endif
+		if (b->pgno == pgno)
 			return (b);
-		}
-#ifdef STATISTICS
-	++mp->cachemiss;
-#endif
 	return (0);
 }
 
-#ifdef STATISTICS
+/*
+ * MPOOL_GETSTAT -- return the cache statistics
+ *
+ * Parameters:
+ *	mp:	mpool cookie
+ *	sp:	where to put them
+ */
+void
+mpool_getstat(mp, sp)
+	MPOOL *mp;
+	MPOOLSTAT *sp;
+{
+	*sp = mp->stat;
+	sp->curcache = mp->curcache;
+	sp->maxcache = mp->maxcache;
+	sp->hashsize = mp->hashmask + 1;
+}
+
 /*
  * MPOOL_STAT -- cache statistics
  *
@@ -475,25 +569,30 @@ mpool_stat(mp)
 	    "page size %lu, cacheing %lu pages of %lu page max cache\n",
 	    mp->pagesize, mp->curcache, mp->maxcache);
 	(void)fprintf(stderr, "%lu page puts, %lu page gets, %lu page new\n",
-	    mp->pageput, mp->pageget, mp->pagenew);
+	    mp->stat.pageput, mp->stat.pageget, mp->stat.pagenew);
 	(void)fprintf(stderr, "%lu page allocs, %lu page flushes\n",
-	    mp->pagealloc, mp->pageflush);
-	if (mp->cachehit + mp->cachemiss)
+	    mp->stat.pagealloc, mp->stat.pageflush);
+	if (mp->stat.cachehit + mp->stat.cachemiss)
 		(void)fprintf(stderr,
 		    "%.0f%% cache hit rate (%lu hits, %lu misses)\n", 
-		    ((double)mp->cachehit / (mp->cachehit + mp->cachemiss))
-		    * 100, mp->cachehit, mp->cachemiss);
+		    ((double)mp->stat.cachehit / (mp->stat.cachehit + mp->stat.cachemiss))
+		    * 100, mp->stat.cachehit, mp->stat.cachemiss);
 	(void)fprintf(stderr, "%lu page reads, %lu page writes\n",
-	    mp->pageread, mp->pagewrite);
+	    mp->stat.pageread, mp->stat.pagewrite);
+	(void)fprintf(stderr, "%lu pages read ahead, %lu of them used\n",
+	    mp->stat.rahead, mp->stat.rahit);
+	(void)fprintf(stderr, "%lu hash buckets\n", mp->hashmask + 1);
 
 	sep = "";
 	cnt = 0;
 	for (b = mp->lru.cnext; b != (BKT *)&mp->lru; b = b->cnext) {
-		(void)fprintf(stderr, "%s%d", sep, b->pgno);
+		(void)fprintf(stderr, "%s%lu", sep, b->pgno);
 		if (b->flags & MPOOL_DIRTY)
 			(void)fprintf(stderr, "d");
 		if (b->flags & MPOOL_PINNED)
 			(void)fprintf(stderr, "P");
+		if (b->flags & MPOOL_RAHEAD)
+			(void)fprintf(stderr, "R");
 		if (++cnt == 10) {
 			sep = "\n";
 			cnt = 0;
@@ -503,7 +602,6 @@ mpool_stat(mp)
 	}
 	(void)fprintf(stderr, "\n");
 }
-#endif
 
 #ifdef DEBUG
 #if __STDC__
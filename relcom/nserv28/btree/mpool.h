@@ -36,59 +36,86 @@
 /*
  * The memory pool scheme is a simple one.  Each in memory page is referenced
  * by a bucket which is threaded in three ways.  All active pages are threaded
- * on a hash chain (hashed by the page number) and an lru chain.  Inactive
+ * on a hash chain (hashed by the page number) and on the clock ring.  Inactive
  * pages are threaded on a free chain.  Each reference to a memory pool is
  * handed an MPOOL which is the opaque cookie passed to all of the memory
  * routines.
+ *
+ * Replacement is CLOCK rather than strict LRU: a cache hit only sets the
+ * reference bit, and the clock hand sweeps the ring clearing reference bits
+ * until it finds an unpinned page that has not been touched since the last
+ * sweep.  New pages are put just behind the hand, so they are the last ones
+ * it looks at.
+ *
+ * The hash table is sized at open time to the first power of two not below
+ * the maximum cache size, so chains stay short however large the cache is.
  */
-#define	HASHSIZE	128
-#define	HASHKEY(pgno)	((pgno - 1) % HASHSIZE)
+#define	HASHSIZE	128		/* minimum hash table size */
+#define	HASHKEY(mp, pgno)	((pgno - 1) & (mp)->hashmask)
+
+#define	MPOOL_RAMAX	16		/* max pages to read ahead */
 
 /* The BKT structures are the elements of the lists. */
 typedef struct BKT {
 	struct BKT	*hnext;		/* next hash bucket */
 	struct BKT	*hprev;		/* previous hash bucket */
-	struct BKT	*cnext;		/* next free/lru bucket */
-	struct BKT	*cprev;		/* previous free/lru bucket */
+	struct BKT	*cnext;		/* next free/clock bucket */
+	struct BKT	*cprev;		/* previous free/clock bucket */
 	void		*page;		/* page */
 	pgno_t		pgno;		/* page number */
 
 #define	MPOOL_DIRTY	0x01		/* page needs to be written */
 #define	MPOOL_PINNED	0x02		/* page is pinned into memory */
+#define	MPOOL_REF	0x04		/* page referenced since last sweep */
+#define	MPOOL_RAHEAD	0x08		/* page read ahead, not yet used */
 	unsigned long	flags;		/* flags */
 } BKT;
 
+/* Flags for mpool_get. */
+#define	MPOOL_SEQ	0x01		/* sequential scan, read ahead */
+
 /* The BKTHDR structures are the heads of the lists. */
 typedef struct BKTHDR {
 	struct BKT	*hnext;		/* next hash bucket */
 	struct BKT	*hprev;		/* previous hash bucket */
-	struct BKT	*cnext;		/* next free/lru bucket */
-	struct BKT	*cprev;		/* previous free/lru bucket */
+	struct BKT	*cnext;		/* next free/clock bucket */
+	struct BKT	*cprev;		/* previous free/clock bucket */
 } BKTHDR;
 
+/* Cache statistics, as returned by mpool_getstat. */
+typedef struct MPOOLSTAT {
+	unsigned long	cachehit;	/* lookups found in the cache */
+	unsigned long	cachemiss;	/* lookups not found */
+	unsigned long	pagealloc;	/* buckets allocated */
+	unsigned long	pageflush;	/* pages evicted */
+	unsigned long	pageget;	/* mpool_get calls satisfied */
+	unsigned long	pagenew;	/* mpool_new calls */
+	unsigned long	pageput;	/* mpool_put calls */
+	unsigned long	pageread;	/* pages read on demand */
+	unsigned long	pagewrite;	/* pages written */
+	unsigned long	rahead;		/* pages read ahead */
+	unsigned long	rahit;		/* read ahead pages later used */
+	unsigned long	curcache;	/* current number of cached pages */
+	unsigned long	maxcache;	/* max number of cached pages */
+	unsigned long	hashsize;	/* hash table size */
+} MPOOLSTAT;
+
 typedef struct MPOOL {
 	BKTHDR	free;			/* The free list. */
-	BKTHDR	lru;			/* The LRU list. */
-	BKTHDR	hashtable[HASHSIZE];	/* Hashed list by page number. */
+	BKTHDR	lru;			/* The clock ring. */
+	BKT	*hand;			/* The clock hand. */
+	BKTHDR	*hashtable;		/* Hashed list by page number. */
+	pgno_t	hashmask;		/* Hash table size - 1. */
 	pgno_t	curcache;		/* Current number of cached pages. */
 	pgno_t	maxcache;		/* Max number of cached pages. */
 	pgno_t	npages;			/* Number of pages in the file. */
+	pgno_t	ranext;			/* Page a sequential scan wants next. */
 	unsigned long pagesize;         /* File page size. */
 	int	fd;			/* File descriptor. */
 	void    (*pgin) ();             /* Page in conversion routine. */
 	void    (*pgout) ();            /* Page out conversion routine. */
 	void	*pgcookie;		/* Cookie for page in/out routines. */
-#ifdef STATISTICS
-	unsigned long	cachehit;
-	unsigned long	cachemiss;
-	unsigned long	pagealloc;
-	unsigned long	pageflush;
-	unsigned long	pageget;
-	unsigned long	pagenew;
-	unsigned long	pageput;
-	unsigned long	pageread;
-	unsigned long	pagewrite;
-#endif
+	MPOOLSTAT stat;			/* Statistics. */
 } MPOOL;
 
 #ifdef __MPOOLINTERFACE_PRIVATE
@@ -98,14 +125,14 @@ typedef struct MPOOL {
         (bp)->hnext->hprev = (bp)->hprev; \
 }
 #define inshash(bp, pg) { \
-	hp = &mp->hashtable[HASHKEY(pg)]; \
+	hp = &mp->hashtable[HASHKEY(mp, pg)]; \
         (bp)->hnext = hp->hnext; \
         (bp)->hprev = (struct BKT *)hp; \
         hp->hnext->hprev = (bp); \
         hp->hnext = (bp); \
 }
 
-/* Macros to insert/delete into/from lru and free chains. */
+/* Macros to insert/delete into/from clock and free chains. */
 #define	rmchain(bp) { \
         (bp)->cprev->cnext = (bp)->cnext; \
         (bp)->cnext->cprev = (bp)->cprev; \
@@ -127,9 +154,8 @@ void    *mpool_get (MPOOL *, pgno_t, unsigned int);
 int      mpool_put (MPOOL *, void *, unsigned int);
 int      mpool_sync (MPOOL *);
 int      mpool_close (MPOOL *);
-#ifdef STATISTICS
+void     mpool_getstat (MPOOL *, MPOOLSTAT *);
 void     mpool_stat (MPOOL *);
-#endif
 #else
 MPOOL   *mpool_open ();
 void     mpool_filter ();
@@ -138,7 +164,6 @@ void    *mpool_get ();
 int      mpool_put ();
 int      mpool_sync ();
 int      mpool_close ();
-#ifdef STATISTICS
+void     mpool_getstat ();
 void     mpool_stat ();
 #endif
-#endif
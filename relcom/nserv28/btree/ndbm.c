@@ -106,12 +106,18 @@ dbm_fetch(db, key)
 	datum key;
 {
 	datum retval;
+	DBT k, v;
 	int status;
 
-	status = (db->get)(db, (DBT *)&key, (DBT *)&retval, 0);
+	k.data = key.dptr;
+	k.size = key.dsize;
+	status = (db->get)(db, &k, &v, 0);
 	if (status) {
 		retval.dptr = 0;
 		retval.dsize = 0;
+	} else {
+		retval.dptr = v.data;
+		retval.dsize = v.size;
 	}
 	return (retval);
 }
@@ -126,11 +132,17 @@ dbm_firstkey(db)
 	DBM *db;
 {
 	int status;
-	datum retdata, retkey;
+	datum retkey;
+	DBT k, v;
 
-	status = (db->seq)(db, (DBT *)&retkey, (DBT *)&retdata, R_FIRST);
-	if (status)
+	status = (db->seq)(db, &k, &v, R_FIRST);
+	if (status) {
 		retkey.dptr = 0;
+		retkey.dsize = 0;
+	} else {
+		retkey.dptr = k.data;
+		retkey.dsize = k.size;
+	}
 	return (retkey);
 }
 
@@ -144,11 +156,17 @@ dbm_nextkey(db)
 	DBM *db;
 {
 	int status;
-	datum retdata, retkey;
+	datum retkey;
+	DBT k, v;
 
-	status = (db->seq)(db, (DBT *)&retkey, (DBT *)&retdata, R_NEXT);
-	if (status)
+	status = (db->seq)(db, &k, &v, R_NEXT);
+	if (status) {
 		retkey.dptr = 0;
+		retkey.dsize = 0;
+	} else {
+		retkey.dptr = k.data;
+		retkey.dsize = k.size;
+	}
 	return (retkey);
 }
 /*
@@ -161,9 +179,12 @@ dbm_delete(db, key)
 	DBM *db;
 	datum key;
 {
+	DBT k;
 	int status;
 
-	status = (db->del)(db, (DBT *)&key, 0);
+	k.data = key.dptr;
+	k.size = key.dsize;
+	status = (db->del)(db, &k, 0);
 	if (status)
 		return (-1);
 	else
@@ -182,6 +203,12 @@ dbm_store(db, key, content, flags)
 	datum key, content;
 	int flags;
 {
-	return ((db->put)(db, (DBT *)&key, (DBT *)&content,
+	DBT k, v;
+
+	k.data = key.dptr;
+	k.size = key.dsize;
+	v.data = content.dptr;
+	v.size = content.dsize;
+	return ((db->put)(db, &k, &v,
 	    (flags == DBM_INSERT) ? R_NOOVERWRITE : 0));
 }
@@ -311,7 +311,7 @@ bt_seqadv(t, e, flags)
 				mpool_put(t->bt_mp, h, 0);
 				if (pg == P_INVALID)
 					return (RET_SPECIAL);
-				if (! (h = mpool_get(t->bt_mp, pg, 0)))
+				if (! (h = mpool_get(t->bt_mp, pg, MPOOL_SEQ)))
 					return (RET_ERROR);
 			} while (NEXTINDEX(h) == 0);
 			index = 0;
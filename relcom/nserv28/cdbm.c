@@ -14,6 +14,12 @@
  * состоянии и будет потеряна только та информация,
  * которая еще не была занесена в файл изменений.
  *
+ * Основной массив хранится в формате, пригодном для отображения
+ * в память (mmap): заголовок, единая хэш-таблица смещений
+ * и сами записи подряд.  Поиск идет прямо по отображению,
+ * без чтения файла.  Старые базы в формате DBM читаются
+ * и при первой же переписи переводятся в новый формат.
+ *
  * Автор Сергей Вакуленко, <vak@kiae.su>.
  */
 
@@ -39,7 +45,10 @@
  */
 # include <sys/types.h>
 # include <sys/stat.h>
+# include <sys/mman.h>
 # include <fcntl.h>
+# include <unistd.h>
+# include <stdio.h>
 
 # include "ndbm.h"
 
@@ -85,20 +94,63 @@ struct cdbm_elem {
 
 typedef struct cdbm_elem celem;
 
+/*
+ * Формат файла базы:
+ *      заголовок cmaphdr,
+ *      хэш-таблица из nslots элементов cmapslot,
+ *      записи: celem, ключ, данные, каждое выровнено как в памяти.
+ * Таблица - открытая адресация с линейным пробированием,
+ * заполнена не более чем наполовину.  Пустой элемент имеет off == 0.
+ * Все числа - в порядке байтов машины.
+ */
+# define CMAGIC         0x434d4150L     /* "CMAP" */
+# define CVERSION       1
+
+struct cmaphdr {
+	long magic;                     /* CMAGIC */
+	long version;                   /* CVERSION */
+	long nslots;                    /* длина таблицы, степень двойки */
+	long nrec;                      /* количество записей */
+	long size;                      /* длина файла */
+};
+
+struct cmapslot {
+	long hash;                      /* полное хэш-значение ключа */
+	long off;                       /* смещение записи от начала файла */
+};
+
+# define CMAPHDR(db)    ((struct cmaphdr *) (db)->map)
+# define CMAPSLOT(db)   ((struct cmapslot *) ((db)->map + ALIGN (sizeof (struct cmaphdr))))
+# define CMAPREC(db,s)  ((celem *) ((db)->map + (s)->off))
+
+/* Буфер записи нового файла базы */
+# define CBUFSZ         (16*1024)
+
+struct cmapbuf {
+	int fd;                         /* дескриптор файла */
+	long off;                       /* смещение начала буфера в файле */
+	int len;                        /* заполнено байт */
+	char buf [CBUFSZ];
+};
+
 static short hash;
 static long  db_mtime;
 int  UPDATETIME;
 
 static celem **cfind ();
-static short chash ();
+static long chash ();
 static int crehash ();
 static int cload (), cupdate ();
+static int cmopen (), cmwrite ();
+static long cmslot ();
+static void cmclose ();
+static celem *cmfind ();
 static void cappend ();
 extern long time();
 
 extern int errno;
 
-extern char *memcpy (), *malloc (), *calloc (), *strdup (), *realloc ();
+extern char *memcpy (), *memset (), *malloc (), *calloc (), *strdup (), *realloc ();
 extern char *strcpy ();
 extern void free ();
 extern int memcmp ();
@@ -218,12 +270,14 @@ int flags, mode;
 	flags &= O_RDONLY | O_RDWR | O_CREAT;
 	db->readonly = (flags == O_RDONLY);
 
+	db->dbm = 0;
+	db->map = 0;
+	db->mapsize = 0;
 	if (access (db->basefile, 0) != 0) {
 		if (flags != (O_RDWR | O_CREAT))
 			goto err1;
-		/* Нет такого файла, создаем новый DBM-файл */
-		db->dbm = dbm_open (db->basefile, O_RDWR | O_CREAT, db->mode);
-		if (! db->dbm) {
+		/* Нет такого файла, создаем пустую базу */
+		if (cmwrite (db, db->basefile) < 0) {
 err1:                   close (db->fd);
 			free ((char *) db->tab);
 			free (db->basefile);
@@ -231,17 +285,24 @@ err1:                   close (db->fd);
 			free ((char *) db);
 			return (0);
 		}
-		dbm_close (db->dbm);
 	}
 
 	/*
-	 * Открываем DBM на запись с целью заблокировать
-	 * дальнейшие обращения.  На самом деле
+	 * Отображаем базу в память.  Если это база старого
+	 * формата, открываем ее как DBM на запись с целью
+	 * заблокировать дальнейшие обращения.  На самом деле
 	 * писать туда не будем.
 	 */
 	cdbm_error = 7;
-	db->dbm = dbm_open (db->basefile, O_RDWR, db->mode);
-	if (! db->dbm) {
+	switch (cmopen (db)) {
+	case 1:
+		break;
+	case 0:
+		db->dbm = dbm_open (db->basefile, O_RDWR, db->mode);
+		if (db->dbm)
+			break;
+		/* fall through */
+	default:
 		close (db->fd);
 		free ((char *) db->tab);
 		free (db->basefile);
@@ -254,7 +315,9 @@ err1:                   close (db->fd);
 	cdbm_error = 8;
 
 	if (! cload (db)) {
-		dbm_close (db->dbm);
+		cmclose (db);
+		if (db->dbm)
+			dbm_close (db->dbm);
 		close (db->fd);
 		free ((char *) db->tab);
 		free (db->basefile);
@@ -262,6 +325,14 @@ err1:                   close (db->fd);
 		free ((char *) db);
 		return (0);
 	}
+
+	/*
+	 * Если файл изменений уже слишком велик, сразу вносим
+	 * его в базу, чтобы следующие открытия его не читали.
+	 */
+	if (! db->readonly && db->cnt &&
+	    lseek (db->fd, 0L, 1) > db->updatelimit * 1024L)
+		cdbm_sync (db);
 	return (db);
 }
 
@@ -271,7 +342,9 @@ register CDBM *db;
 	int i;
 
 	close (db->fd);
-	dbm_close (db->dbm);
+	cmclose (db);
+	if (db->dbm)
+		dbm_close (db->dbm);
 	for (i=0; i<db->size; ++i)
 		if (db->tab [i])
 			free ((char *) db->tab [i]);
@@ -301,6 +374,32 @@ register celem **p;
 	return (key);
 }
 
+/*
+ * Перебор отображенной базы начиная с элемента таблицы slot.
+ * Записи, измененные или удаленные, пропускаются.
+ */
+static datum cnextmap (db, slot)
+register CDBM *db;
+long slot;
+{
+	register struct cmapslot *s;
+	register celem *r;
+	datum key;
+
+	for (s=CMAPSLOT(db)+slot; s<CMAPSLOT(db)+CMAPHDR(db)->nslots; ++s) {
+		if (! s->off)
+			continue;
+		r = CMAPREC (db, s);
+		if (! *cfind (db, KEYDATA (r), r->keysize)) {
+			key.dptr = KEYDATA (r);
+			key.dsize = r->keysize;
+			return (key);
+		}
+	}
+	/* Записи в базе кончились, переходим к таблице изменений */
+	return (cnextmem (db, db->tab));
+}
+
 datum cdbm_firstkey (db)
 register CDBM *db;
 {
@@ -311,6 +410,8 @@ register CDBM *db;
 	 * Но приходится проверять в таблице изменений,
 	 * а вдруг запись уже удалена или изменилась.
 	 */
+	if (db->map)
+		return (cnextmap (db, 0L));
 	key = dbm_firstkey (db->dbm);
 	while (key.dptr) {
 		if (! *cfind (db, key.dptr, key.dsize))
@@ -326,8 +427,19 @@ register CDBM *db;
 datum key;
 {
 	register celem **p;
+	long slot;
 
 	p = cfind (db, key.dptr, key.dsize);
+	if (! *p && db->map) {
+		slot = cmslot (db, key.dptr, key.dsize);
+		if (slot < 0) {
+			/* Такого ключа нет ни в базе, ни в изменениях */
+			key.dptr = 0;
+			key.dsize = 0;
+			return (key);
+		}
+		return (cnextmap (db, slot + 1));
+	}
 	if (! *p) {
 		/* Перебираем записи в базе. */
 		for (;;) {
@@ -363,6 +475,16 @@ datum key;
 		val.dsize = (*p)->valsize;
 		return (val);
 	}
+	if (db->map) {
+		register celem *r;
+
+		r = cmfind (db, key.dptr, key.dsize);
+		if (r) {
+			val.dptr = VALDATA (r);
+			val.dsize = r->valsize;
+		}
+		return (val);
+	}
 	val = dbm_fetch (db->dbm, key);
 	return (val);
 }
@@ -459,6 +581,9 @@ datum key;
 			return (0);
 		--db->cnt;
 		free ((char *) *p);
+	} else if (db->map) {
+		if (! cmfind (db, key.dptr, key.dsize))
+			return (-1);
 	} else {
 		val = dbm_fetch (db->dbm, key);
 		if (! val.dptr)
@@ -474,9 +599,11 @@ char *k;
 int sz;
 {
 	register celem **p;
+	long h;
 
-	hash = chash (k, sz);
-	p = db->tab + hash % db->size;
+	h = chash (k, sz);
+	hash = h & 0x7fff;
+	p = db->tab + (h & (db->size - 1));
 	while (*p) {
 		if ((*p)->hash == hash && (*p)->keysize == sz &&
 		    ! memcmp (KEYDATA (*p), k, sz))
@@ -488,7 +615,12 @@ int sz;
 	return (p);
 }
 
-static short chash (p, sz)
+/*
+ * Хэш-функция.  В записи файла изменений хранится
+ * только младшие 15 бит, полное значение используется
+ * для выбора места в таблицах.
+ */
+static long chash (p, sz)
 register char *p;
 register sz;
 {
@@ -508,7 +640,7 @@ register sz;
 	while (sz--)
 		v = *p++ + 65599 * v;
 #endif
-	return (v & 0x7fff);
+	return (v & 0x7fffffff);
 }
 
 static int crehash (db, newsz)
@@ -552,80 +684,369 @@ register CDBM *db;
 	/* Я тут проправил все места так, что если файл недописан,
 	 * ничего страшного не происходит - просто последняя запись не читается
 	 */
+	/* Файл читается целиком, одним вызовом read, и разбирается
+	 * в памяти.  Указатель файла ставится за последней целой
+	 * записью, чтобы новые записи шли сразу за ней.
+	 */
+	struct stat st;
 	celem h, *p, **q;
+	char *buf, *cp, *end;
+	long len;
 	int sz, rez;
 	int _nrec=0;
 
-	for (;;) {
-		rez = read (db->fd, (char *) &h, sizeof (celem));
-		_nrec++;
-		cdbm_error = 101;
-		if (rez < 0)
+	cdbm_error = 101;
+	if (fstat (db->fd, &st) < 0)
+		return (0);
+	if (st.st_size == 0)
+		return (1);
+	buf = malloc ((unsigned) st.st_size);
+	if (! buf)
+		return (0);
+	for (len=0; len<st.st_size; len+=rez) {
+		rez = read (db->fd, buf + len, (unsigned) (st.st_size - len));
+		if (rez < 0) {
+			free (buf);
 			return (0);
+		}
 		if (rez == 0)
-			return (1);
-		if (rez != sizeof (celem))
-			return (1);
+			break;
+	}
+	end = buf + len;
+	rez = 1;
+	for (cp=buf; cp+sizeof (celem) <= end; cp+=sz) {
+		_nrec++;
+		memcpy ((char *) &h, cp, sizeof (celem));
 		if (h.keysize < 0 || h.keysize > MAX_KEYSIZE) {
 		       error("Bad groups+: NREC=%d",_nrec);
-		       error("... shift=%ld", lseek(db->fd,0l,1) - rez);
+		       error("... shift=%ld", (long) (cp - buf));
 		       error("Bad groups+: key_size = %d (reading + aborted)",h.keysize);
-		       return(1);
+		       break;
 		}
 		if ( h.valsize < -1 || h.valsize >= MAX_VALSIZE) {
 		       error("Bad groups+: NREC=%d",_nrec);
-		       error("... shift=%ld", lseek(db->fd,0l,1) - rez);
+		       error("... shift=%ld", (long) (cp - buf));
 		       error("Bad groups+: val_size = %d (reading + aborted)",h.valsize);
-		       return(1);
+		       break;
 		}
-		sz = ALIGN (sizeof (celem)) + ALIGN (h.keysize);
-		if (h.valsize != -1)
+		sz = sizeof (celem) + h.keysize;
+		if (h.valsize > 0)
 			sz += h.valsize;
-		p = (celem *) malloc (sz);
-		if (! p)
-			return (0);
-		*p = h;
-		if (p->keysize) {
-			if (read (db->fd, KEYDATA (p), p->keysize) != p->keysize)
-				return (1);
-		}
-		if (p->valsize > 0 ) {
-			if (read (db->fd, VALDATA (p), p->valsize) != p->valsize)
-				return (1);
+		if (cp + sz > end)
+			break;
+		p = (celem *) malloc (ALIGN (sizeof (celem)) + ALIGN (h.keysize) +
+			(h.valsize > 0 ? h.valsize : 0));
+		if (! p) {
+			rez = 0;
+			break;
 		}
-		q = db->tab + p->hash % db->size;
-		while (*q) {
-			if ((*q)->hash == p->hash &&
-			    (*q)->keysize == p->keysize &&
-			    ! memcmp (KEYDATA (*q), KEYDATA (p), p->keysize))
-				break;
-			++q;
-			if (q >= db->tab + db->size)
-				q = db->tab;
+		*p = h;
+		if (p->keysize)
+			memcpy (KEYDATA (p), cp + sizeof (celem), p->keysize);
+		if (p->valsize > 0)
+			memcpy (VALDATA (p), cp + sizeof (celem) + p->keysize,
+				p->valsize);
+
+		q = cfind (db, KEYDATA (p), p->keysize);
+		if (*q) {
+			free ((char *) *q);
+			--db->cnt;
 		}
 		*q = p;
 
 		++db->cnt;
 		if (db->cnt > db->size*3/4)
-			if (crehash (db, db->size * 2) < 0)
-				return (-1);
+			if (crehash (db, db->size * 2) < 0) {
+				rez = 0;
+				break;
+			}
+	}
+	lseek (db->fd, (long) (cp - buf), 0);
+	free (buf);
+	return (rez);
+}
+
+/*
+ * Отображение файла базы в память.
+ * Возвращает 1, если база в новом формате и отображена,
+ * 0, если это база старого формата (DBM), -1 при ошибке.
+ */
+static int cmopen (db)
+register CDBM *db;
+{
+	struct cmaphdr h;
+	struct stat st;
+	char *map;
+	int fd;
+
+	fd = open (db->basefile, O_RDONLY);
+	if (fd < 0)
+		return (-1);
+	if (fstat (fd, &st) < 0) {
+		close (fd);
+		return (-1);
+	}
+	if (st.st_size < sizeof (h) ||
+	    read (fd, (char *) &h, sizeof (h)) != sizeof (h) ||
+	    h.magic != CMAGIC) {
+		close (fd);
+		return (0);
+	}
+	if (h.version != CVERSION || h.size != st.st_size ||
+	    h.nslots <= 0 || (h.nslots & (h.nslots - 1)) ||
+	    ALIGN (sizeof (h)) + h.nslots * sizeof (struct cmapslot) > h.size) {
+		error ("%s: bad database header", db->basefile);
+		close (fd);
+		return (-1);
+	}
+	map = (char *) mmap ((void *) 0, (size_t) st.st_size, PROT_READ,
+		MAP_SHARED, fd, (off_t) 0);
+	close (fd);
+	if (map == (char *) MAP_FAILED)
+		return (-1);
+	db->map = map;
+	db->mapsize = st.st_size;
+	return (1);
+}
+
+static void cmclose (db)
+register CDBM *db;
+{
+	if (db->map)
+		munmap ((void *) db->map, (size_t) db->mapsize);
+	db->map = 0;
+	db->mapsize = 0;
+}
+
+/*
+ * Поиск ключа в отображенной базе.  Возвращает номер
+ * элемента таблицы или -1, если такого ключа нет.
+ */
+static long cmslot (db, k, sz)
+register CDBM *db;
+char *k;
+int sz;
+{
+	register struct cmapslot *s, *tab;
+	register celem *r;
+	long h, mask;
+
+	h = chash (k, sz);
+	mask = CMAPHDR(db)->nslots - 1;
+	tab = CMAPSLOT (db);
+	for (s=tab+(h&mask); s->off; s=tab+((s-tab+1)&mask)) {
+		if (s->hash != h)
+			continue;
+		r = CMAPREC (db, s);
+		if (r->keysize == sz && ! memcmp (KEYDATA (r), k, sz))
+			return (s - tab);
 	}
+	return (-1);
+}
+
+static celem *cmfind (db, k, sz)
+register CDBM *db;
+char *k;
+int sz;
+{
+	long i;
+
+	i = cmslot (db, k, sz);
+	return (i < 0 ? (celem *) 0 : CMAPREC (db, CMAPSLOT (db) + i));
 }
 
+/*
+ * Буферизованная запись в новый файл базы.
+ */
+static int cmflush (b)
+register struct cmapbuf *b;
+{
+	if (b->len && write (b->fd, b->buf, b->len) != b->len)
+		return (-1);
+	b->off += b->len;
+	b->len = 0;
+	return (0);
+}
+
+static int cmputs (b, p, sz)
+register struct cmapbuf *b;
+char *p;
+int sz;
+{
+	int n;
+
+	while (sz > 0) {
+		if (b->len == CBUFSZ && cmflush (b) < 0)
+			return (-1);
+		n = CBUFSZ - b->len;
+		if (n > sz)
+			n = sz;
+		if (p)
+			memcpy (b->buf + b->len, p, n);
+		else
+			memset (b->buf + b->len, 0, n);
+		b->len += n;
+		if (p)
+			p += n;
+		sz -= n;
+	}
+	return (0);
+}
+
+/*
+ * Запись одной записи в новый файл базы и в его таблицу.
+ */
+static int cmput (b, tab, mask, k, ksz, v, vsz)
+register struct cmapbuf *b;
+struct cmapslot *tab;
+long mask;
+char *k, *v;
+int ksz, vsz;
+{
+	register struct cmapslot *s;
+	celem h;
+	long hv;
+
+	hv = chash (k, ksz);
+	h.keysize = ksz;
+	h.valsize = vsz;
+	h.hash = hv & 0x7fff;
+	for (s=tab+(hv&mask); s->off; s=tab+((s-tab+1)&mask))
+		continue;
+	s->hash = hv;
+	s->off = b->off + b->len;
+	if (cmputs (b, (char *) &h, sizeof (celem)) < 0 ||
+	    cmputs (b, (char *) 0, ALIGN (sizeof (celem)) - sizeof (celem)) < 0 ||
+	    cmputs (b, k, ksz) < 0 ||
+	    cmputs (b, (char *) 0, ALIGN (ksz) - ksz) < 0 ||
+	    cmputs (b, v, vsz) < 0 ||
+	    cmputs (b, (char *) 0, ALIGN (vsz) - vsz) < 0)
+		return (-1);
+	return (0);
+}
+
+/*
+ * Запись в файл name новой базы: все записи текущей базы,
+ * кроме измененных и удаленных, и все записи таблицы изменений.
+ * Файл пишется подряд, от начала до конца, таблица -
+ * в последнюю очередь.
+ */
+static int cmwrite (db, name)
+register CDBM *db;
+char *name;
+{
+	struct cmapbuf *b;
+	struct cmaphdr h;
+	struct cmapslot *tab, *s;
+	register celem *r, **p;
+	datum key, val;
+	long nslots, nrec, n;
+
+	/* Оценка сверху числа записей */
+	n = db->cnt;
+	if (db->map)
+		n += CMAPHDR(db)->nrec;
+	else if (db->dbm)
+		for (key=dbm_firstkey (db->dbm); key.dptr; key=dbm_nextkey (db->dbm))
+			++n;
+	for (nslots=INITSZ; nslots < 2*n; nslots <<= 1)
+		continue;
+
+	tab = (struct cmapslot *) calloc ((unsigned) nslots, sizeof (struct cmapslot));
+	b = (struct cmapbuf *) malloc (sizeof (struct cmapbuf));
+	if (! tab || ! b) {
+		if (tab)
+			free ((char *) tab);
+		return (-1);
+	}
+	b->fd = open (name, O_WRONLY | O_CREAT | O_TRUNC, db->mode);
+	if (b->fd < 0) {
+		free ((char *) tab);
+		free ((char *) b);
+		return (-1);
+	}
+	b->off = ALIGN (sizeof (h)) + nslots * sizeof (struct cmapslot);
+	b->len = 0;
+	if (lseek (b->fd, b->off, 0) != b->off)
+		goto err;
+
+	/* Переписываем неизмененные записи базы */
+	nrec = 0;
+	if (db->map) {
+		for (s=CMAPSLOT(db); s<CMAPSLOT(db)+CMAPHDR(db)->nslots; ++s) {
+			if (! s->off)
+				continue;
+			r = CMAPREC (db, s);
+			if (*cfind (db, KEYDATA (r), r->keysize))
+				continue;
+			if (cmput (b, tab, nslots-1, KEYDATA (r), r->keysize,
+			    VALDATA (r), r->valsize) < 0)
+				goto err;
+			++nrec;
+		}
+	} else if (db->dbm) {
+		for (key=dbm_firstkey (db->dbm); key.dptr; key=dbm_nextkey (db->dbm)) {
+			if (*cfind (db, key.dptr, key.dsize))
+				continue;
+			val = dbm_fetch (db->dbm, key);
+			if (! val.dptr)
+				continue;
+			if (cmput (b, tab, nslots-1, key.dptr, key.dsize,
+			    val.dptr, val.dsize) < 0)
+				goto err;
+			++nrec;
+		}
+	}
+
+	/* Вносим изменения */
+	for (p=db->tab; p<db->tab+db->size; ++p) {
+		if (! *p || (*p)->valsize == -1)
+			continue;
+		if (cmput (b, tab, nslots-1, KEYDATA (*p), (*p)->keysize,
+		    VALDATA (*p), (*p)->valsize) < 0)
+			goto err;
+		++nrec;
+	}
+	if (cmflush (b) < 0)
+		goto err;
+
+	/* Заголовок и таблица */
+	h.magic = CMAGIC;
+	h.version = CVERSION;
+	h.nslots = nslots;
+	h.nrec = nrec;
+	h.size = b->off;
+	if (lseek (b->fd, 0L, 0) != 0 ||
+	    cmputs (b, (char *) &h, sizeof (h)) < 0 ||
+	    cmputs (b, (char *) 0, ALIGN (sizeof (h)) - sizeof (h)) < 0 ||
+	    cmputs (b, (char *) tab, (int) (nslots * sizeof (struct cmapslot))) < 0 ||
+	    cmflush (b) < 0 || fsync (b->fd) < 0)
+		goto err;
+	close (b->fd);
+	free ((char *) tab);
+	free ((char *) b);
+	return (0);
+err:
+	close (b->fd);
+	free ((char *) tab);
+	free ((char *) b);
+	return (-1);
+}
 
 void cdbm_sync (db)
 register CDBM *db;
 {
-	/* Перепись базы данных с внесением изменений */
+	/*
+	 * Перепись базы данных с внесением изменений.
+	 * Новая база пишется целиком в database#, после чего
+	 * одним вызовом rename становится на место старой.
+	 */
 	char *newname, *oldname, *oldoldname;
 	int len;
-	DBM *newdbm;
-	datum key, val;
 	register celem **p;
 
 	if (db->cnt == 0)
 		return;
-	newdbm = 0;
 
 	/* Заводим имена database~~, database~, database# */
 	len = strlen (db->basefile);
@@ -646,66 +1067,31 @@ register CDBM *db;
 	oldoldname [len+2] = 0;
 
 	/* Создаем новую базу данных */
-	newdbm = dbm_open (newname, O_RDWR | O_CREAT, db->mode);
-	if (! newdbm)
+	if (cmwrite (db, newname) < 0) {
+		unlink (newname);
 		goto ret;
-
-	/* Переписываем базу на новое место */
-	key = dbm_firstkey (db->dbm);
-	while (key.dptr) {
-		val = dbm_fetch (db->dbm, key);
-		if (val.dptr)
-			if (dbm_store (newdbm, key, val, 0))
-				goto ret;
-		key = dbm_nextkey (db->dbm);
 	}
 
-	/* Вносим изменения */
-	for (p=db->tab; p<db->tab+db->size; ++p) {
-		if (! *p)
-			continue;
-		if ((*p)->valsize == -1) {
-			key.dptr = KEYDATA (*p);
-			key.dsize = (*p)->keysize;
-			dbm_delete (newdbm, key);
-			continue;
-		}
-		key.dptr = KEYDATA (*p);
-		key.dsize = (*p)->keysize;
-		val.dptr = VALDATA (*p);
-		val.dsize = (*p)->valsize;
-		if (dbm_store (newdbm, key, val, 1))
-			goto ret;
-	}
-
-	/* Закрываем новую базу */
-	dbm_close (newdbm);
-	newdbm = 0;
-
 	/*
-	 * Переименовываем базу :
+	 * Сохраняем копии:
 	 * database~ -> database~~
 	 * database  -> database~
-	 * database# -> database
 	 */
 	unlink (oldoldname);                    /* Удаляем database~~ */
 	link (oldname, oldoldname);             /* database~ -> database~~ */
 	unlink (oldname);                       /* Удаляем database~ */
-	if (link (db->basefile, oldname) < 0)   /* database -> database~ */
-		goto ret;
-	unlink (db->basefile);                  /* Удаляем database */
+	link (db->basefile, oldname);           /* database -> database~ */
+
 	/*
-	 * Самое тонкое место.
-	 * Если в этот момент машина упадет,
-	 * база данных будет испорчена!
-	 * Вот если бы можно было переименовывать
-	 * два файла одновременно, за один системный вызов...
+	 * database# -> database.  Переименование атомарно: в любой
+	 * момент на месте database лежит либо старая, либо новая
+	 * база целиком.  Если машина упадет до очистки списка
+	 * изменений, он будет внесен повторно, что ничего не меняет.
 	 */
-	if (link (newname, db->basefile) < 0) { /* database# -> database */
-		link (oldname, db->basefile);
+	if (rename (newname, db->basefile) < 0) {
+		unlink (newname);
 		goto ret;
 	}
-	unlink (newname);                       /* Удаляем database# */
 
 	/* Удаляем список изменений */
 	close (db->fd);
@@ -725,29 +1111,23 @@ register CDBM *db;
 	if (! db->tab || db->fd < 0)    /* Этого не может быть! */
 		abort ();
 
-	/* Переоткрываем новую базу */
-	dbm_close (db->dbm);
-	/*
-	 * Открываем DBM на запись с целью заблокировать
-	 * дальнейшие обращения.  На самом деле
-	 * писать туда не будем.
-	 */
-	db->dbm = dbm_open (db->basefile, O_RDWR, db->mode);
-	if (! db->dbm)
+	/* Отображаем новую базу */
+	cmclose (db);
+	if (db->dbm) {
+		dbm_close (db->dbm);
+		db->dbm = 0;
+	}
+	if (cmopen (db) != 1)
 		abort ();
 ret:
 	free (newname);
 	free (oldname);
 	free (oldoldname);
-	if (newdbm)
-		dbm_close (newdbm);
 	db_mtime = time((long *)0);
 	return;
 }
 
 # ifdef TESTCDBM
-# include <stdio.h>
-
 main ()
 {
 	CDBM *db;
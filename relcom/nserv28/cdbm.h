@@ -48,7 +48,9 @@ struct cdbm_elem;
 typedef struct {
 	char *basefile;         /* имя файла базы данных */
 	char *updatefile;       /* имя файла изменений */
-	void *dbm;              /* база данных */
+	void *dbm;              /* база данных старого формата (DBM) */
+	char *map;              /* отображенный в память файл базы */
+	long mapsize;           /* длина отображения */
 	struct cdbm_elem **tab; /* таблица элементов */
 	int mode;               /* режим доступа к базе */
 	int fd;                 /* дескриптор файла изменений */
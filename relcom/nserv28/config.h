@@ -25,6 +25,7 @@ extern int LISTSIZE;        /* Макс. размер листа - килоба
 extern int FEEDLIMIT;       /* Макс. размер статьи, которую можно слать по FEED */
 extern int TIMEOFLIFE;       /* (дней) Макс. время жизни одного подписчика, если он ничего не шлет */
 extern int UPDATETIME;       /* Макс. время между сбросами groups+ файла (изменений) */
+extern int FEEDWORKERS;      /* Число процессов рассылки в newnews, 0 - по-старому, одним процессом */
 
 extern char *MAILBOX, *SERVDIR, *CONFIGFILE, *NEWSLIBDIR, *NEWSSPOOLDIR,
 	*LOGFILE, *DBZNAME, *MAILCMD, *MYADDRESS, *INEWSNAME, *CONFIGFILE,
@@ -67,6 +68,7 @@ int LISTSIZE            = 50;
 int FEEDLIMIT           = 120;
 int TIMEOFLIFE          = 28;
 int UPDATETIME          = 120; /* минут */
+int FEEDWORKERS         = 0;
 
 
 struct {
@@ -84,6 +86,7 @@ struct {
 	"listsize",             &LISTSIZE,
 	"timeoflife",           &TIMEOFLIFE,
 	"updatetime",           &UPDATETIME,
+	"feedworkers",          &FEEDWORKERS,
 	0,                      0,
 };
 
@@ -70,12 +70,25 @@ struct feedtab *gpacktab;       /* Таблица групповой упак. 
 int ngpack;
 int gpacktablen;
 
+struct feedtab *subtab;         /* Таблица notify (конвейерный режим) */
+int nsub;
+int subtablen;
+
+struct artref {                 /* Где лежит строка пары (user, msgid) */
+	int mode;
+	int index;
+};
+
 int debug;
+int nworkers;                   /* Число процессов рассылки, 0 - без конвейера */
+int worker = -1;                /* Номер процесса рассылки, -1 - основной */
 char tmpname[] = TMPFNAME;
 
 VDBM *userdb;
+VDBM *artdb;                    /* Пары (user, msgid) в конвейерном режиме */
 
 extern char *bsearch (), *strcopy (), *malloc (), *realloc (), *strcpy ();
+extern char *calloc (), *memcpy ();
 extern char *getsendername (), *ctime (), *groupclass (), *groupiclass ();
 extern char *mktemp (), *strncpy (), *strchr ();
 extern long filesize (), time ();
@@ -180,6 +193,11 @@ char **argv;
 				setbuf(stdout, (char *)0);
 				++debug;
 				break;
+			case 'j':
+				nworkers = atoi (p+1);
+				while (p[1])
+					++p;
+				break;
 			default:
 				goto usage;
 			}
@@ -190,7 +208,7 @@ char **argv;
 
 	timeinit ();
 	if (argc > 2) {
-usage:          fprintf (stderr, "usage: %s [config]\n", argv [0]);
+usage:          fprintf (stderr, "usage: %s [-d] [-jN] [config]\n", argv [0]);
 		exit (-1);
 	}
 	if (! config (argv [1])) {
@@ -198,6 +216,8 @@ usage:          fprintf (stderr, "usage: %s [config]\n", argv [0]);
 		exit (-1);
 	}
 	mktemp (tmpname);
+	if (! nworkers)
+		nworkers = FEEDWORKERS;
 
 	setlang (sudomain (MYDOMAIN) ? 'r' : 'l');
 
@@ -269,6 +289,15 @@ usage:          fprintf (stderr, "usage: %s [config]\n", argv [0]);
 	npack = 0;
 	ngpack = 0;
 
+	if (nworkers > 0) {
+		pipeline ();
+		if (debug)
+			printf ("Saving groups file\n");
+		savegroups ();
+		messg ("newnews finished");
+		return (0);
+	}
+
 	/* Make global table of new articles */
 	if (debug)
 		printf ("Creating table of new articles\n");
@@ -285,7 +314,7 @@ usage:          fprintf (stderr, "usage: %s [config]\n", argv [0]);
 	/* Update /usr/spool/newsserv/newarticles - list of arrived articles */
 	if (debug)
 		printf ("Appending list of new articles\n");
-	updatenewarts ();
+	updatenewarts (arttab, nart);
 	messg ("list of new articles updated");
 
 	/* Split arttab into feedtab, packtab, gpacktab */
@@ -298,10 +327,12 @@ usage:          fprintf (stderr, "usage: %s [config]\n", argv [0]);
 	/* Sort articles by (1) group, (2) issue, (3) user. */
 	if (ngpack)
 		qsort ((char *) gpacktab, ngpack, sizeof (struct feedtab), cmpfeedtab);
+	splitgpack ();
 	if (debug)
 		printf ("Sending %d gpacked articles to subscribers\n", ngpack);
 	sendgpack ();   /* упакованная погрупповая рассылка */
 
+	splitpack ();
 	if (debug)
 		printf ("Sending %d packed articles to subscribers\n", npack);
 	sendpack ();    /* упакованная постатейная рассылка */
@@ -351,6 +382,8 @@ locknewnews ()
 
 quit ()
 {
+	if (worker >= 0)
+		exit (-1);      /* база групп принадлежит основному процессу */
 	savegroups ();
 	exit (-1);
 }
@@ -557,7 +590,7 @@ mknewarticles ()
 		if (debug)
 			printf ("Group %s %d..%d x%d\n", groupname (g),
 				olast+1, last, ns);
-		for (n=olast+1; n<=last && nart<MAXARTS; ++n, ++nused)
+		for (n=olast+1; n<=last && (artdb || nart<MAXARTS); ++n, ++nused)
 			storeinfo (g, n, s, ns);
 		setgrouplast (g, n-1);
 		free ((char *) s);
@@ -593,14 +626,16 @@ nocrosspost ()
 		printf ("Detected %d unique message-ids\n", nart);
 }
 
-updatenewarts ()
+updatenewarts (tab, ntab)
+struct feedtab *tab;
+int ntab;
 {
 	FILE *fd [FILEMASK+1];
 	char artfname [16];
 	register struct feedtab *p, *q;
 	int n;
 
-	if (! nart)
+	if (! ntab)
 		return;
 	new_lock();
 	for (n=0; n<=FILEMASK; ++n) {
@@ -612,8 +647,8 @@ updatenewarts ()
 			quit ();
 		}
 	}
-	for (p=arttab; p<arttab+nart && p->mode==MSUBS; p=q) {
-		for (q=p+1; q<arttab+nart && q->mode==MSUBS &&
+	for (p=tab; p<tab+ntab && p->mode==MSUBS; p=q) {
+		for (q=p+1; q<tab+ntab && q->mode==MSUBS &&
 			p->group==q->group && p->issue==q->issue; ++q);
 		storeart (p->group, p->issue, p, q, fd);
 	}
@@ -629,10 +664,27 @@ updatenewarts ()
 	new_unlock();
 }
 
+/*
+ * Добавляет строку в таблицу режима mode.
+ * Возвращает индекс строки в таблице или -1.
+ */
 addtab (p, mode)
 struct feedtab *p;
 {
 	switch (mode) {
+	case MSUBS:
+		if (nsub >= subtablen) {
+			subtablen += 64;
+			subtab = (struct feedtab *) realloc ((char *) subtab,
+				(unsigned) (subtablen * sizeof (struct feedtab)));
+			if (! subtab) {
+				error ("out of memory in addtab (subs)");
+				return (-1);
+			}
+		}
+		subtab[nsub] = *p;
+		subtab[nsub].mode = mode;
+		return (nsub++);
 	case MFEED:
 		if (nfeed >= feedtablen) {
 			feedtablen += 64;
@@ -640,12 +692,12 @@ struct feedtab *p;
 				(unsigned) (feedtablen * sizeof (struct feedtab)));
 			if (! feedtab) {
 				error ("out of memory in splittab (feed)");
-				return;
+				return (-1);
 			}
 		}
 		feedtab[nfeed] = *p;
-		feedtab[nfeed++].mode = mode;
-		break;
+		feedtab[nfeed].mode = mode;
+		return (nfeed++);
 	case MPACK:
 		if (npack >= packtablen) {
 			packtablen += 64;
@@ -653,12 +705,12 @@ struct feedtab *p;
 				(unsigned) (packtablen * sizeof (struct feedtab)));
 			if (! packtab) {
 				error ("out of memory in splittab (pack)");
-				return;
+				return (-1);
 			}
 		}
 		packtab[npack] = *p;
-		packtab[npack++].mode = mode;
-		break;
+		packtab[npack].mode = mode;
+		return (npack++);
 	case MGPACK:
 		if (ngpack >= gpacktablen) {
 			gpacktablen += 64;
@@ -666,13 +718,14 @@ struct feedtab *p;
 				(unsigned) (gpacktablen * sizeof (struct feedtab)));
 			if (! gpacktab) {
 				error ("out of memory in splittab (gpack)");
-				return;
+				return (-1);
 			}
 		}
 		gpacktab[ngpack] = *p;
-		gpacktab[ngpack++].mode = mode;
-		break;
+		gpacktab[ngpack].mode = mode;
+		return (ngpack++);
 	}
+	return (-1);
 }
 
 splittab ()
@@ -689,6 +742,274 @@ splittab ()
 		}
 }
 
+/*
+ * Таблица строк режима mode.
+ */
+struct feedtab *modetab (mode)
+{
+	switch (mode) {
+	case MSUBS:     return (subtab);
+	case MFEED:     return (feedtab);
+	case MPACK:     return (packtab);
+	case MGPACK:    return (gpacktab);
+	}
+	return (0);
+}
+
+/*
+ * Конвейерный режим: строка подписки сразу попадает в таблицу
+ * своего режима.  Кросс-постинги отсеиваются по паре (user, msgid),
+ * остается строка с большим режимом - как в nocrosspost.
+ * Вытесненная строка помечается нулевым режимом.
+ */
+joinrow (r)
+register struct feedtab *r;
+{
+	static char *buf;
+	static int buflen;
+	vdatum key, val;
+	struct artref ref;
+	int len;
+
+	len = strlen (r->msgid);
+	if (sizeof (long) + len > buflen) {
+		buflen = sizeof (long) + len + 64;
+		buf = buf ? realloc (buf, (unsigned) buflen) :
+			malloc ((unsigned) buflen);
+		if (! buf) {
+			error ("out of memory in joinrow");
+			quit ();
+		}
+	}
+	memcpy (buf, (char *) &r->user, sizeof (long));
+	memcpy (buf + sizeof (long), r->msgid, len);
+	key.dptr = buf;
+	key.dsize = sizeof (long) + len;
+	val = vdbm_fetch (artdb, key);
+	if (val.dptr) {
+		memcpy ((char *) &ref, val.dptr, sizeof (ref));
+		if (ref.mode >= r->mode)
+			return;
+		modetab (ref.mode) [ref.index].mode = 0;
+	}
+	ref.mode = r->mode;
+	ref.index = addtab (r, r->mode);
+	if (ref.index < 0)
+		return;
+	val.dptr = (char *) &ref;
+	val.dsize = sizeof (ref);
+	if (vdbm_store (artdb, key, val, VDBM_REPLACE) < 0)
+		error ("out of memory in joinrow");
+}
+
+/*
+ * Удаляет из таблицы вытесненные строки.
+ * Возвращает новую длину таблицы.
+ */
+droprows (tab, n)
+struct feedtab *tab;
+int n;
+{
+	register struct feedtab *p, *q;
+
+	for (p=q=tab; p<tab+n; ++p)
+		if (p->mode)
+			*q++ = *p;
+	return (q - tab);
+}
+
+/*
+ * Ключи деления строк между процессами рассылки.
+ */
+unsigned long userkey (p)
+struct feedtab *p;
+{
+	return ((unsigned long) p->user);
+}
+
+unsigned long groupkey (p)
+struct feedtab *p;
+{
+	return ((unsigned long) p->group);
+}
+
+unsigned long artkey (p)
+struct feedtab *p;
+{
+	return ((unsigned long) p->group * 31 + (unsigned long) p->issue);
+}
+
+/*
+ * Выбирает из таблицы строки k-го процесса рассылки
+ * по ключу key.  Порядок строк сохраняется.
+ */
+struct feedtab *shard (tab, n, k, cnt, len, key)
+struct feedtab *tab;
+int n, k, *cnt, *len;
+unsigned long (*key) ();
+{
+	register struct feedtab *p, *q, *s;
+
+	s = (struct feedtab *) malloc ((n+1) * sizeof (struct feedtab));
+	if (! s) {
+		error ("out of memory in shard");
+		quit ();
+	}
+	for (p=tab, q=s; p<tab+n; ++p)
+		if ((*key) (p) % nworkers == k)
+			*q++ = *p;
+	*cnt = q - s;
+	*len = n + 1;
+	return (s);
+}
+
+/*
+ * Рассылка k-го процесса.  Пакеты групповой рассылки делятся
+ * по группам, отдельные статьи - по статьям, пакеты постатейной
+ * рассылки - по подписчикам.  Поэтому каждый пакет и каждая
+ * статья собираются и отправляются ровно один раз, так же,
+ * как при рассылке одним процессом.
+ */
+sendshard (k)
+{
+	struct feedtab *ofeed, *opack, *ogpack;
+	int onfeed, onpack, ongpack;
+	int ofeedlen, opacklen, ogpacklen;
+
+	ofeed = feedtab;
+	opack = packtab;
+	ogpack = gpacktab;
+	onfeed = nfeed;
+	onpack = npack;
+	ongpack = ngpack;
+	ofeedlen = feedtablen;
+	opacklen = packtablen;
+	ogpacklen = gpacktablen;
+	feedtab = shard (ofeed, onfeed, k, &nfeed, &feedtablen, artkey);
+	packtab = shard (opack, onpack, k, &npack, &packtablen, userkey);
+	gpacktab = shard (ogpack, ongpack, k, &ngpack, &gpacktablen, groupkey);
+
+	if (debug)
+		printf ("Worker %d: sending %d gpacked articles to subscribers\n",
+			k, ngpack);
+	sendgpack ();
+	if (debug)
+		printf ("Worker %d: sending %d packed articles to subscribers\n",
+			k, npack);
+	sendpack ();
+	if (nfeed)
+		qsort ((char *) feedtab, nfeed, sizeof (struct feedtab), cmpfeedtab);
+	if (debug)
+		printf ("Worker %d: sending %d articles to subscribers\n",
+			k, nfeed);
+	sendfeed ();
+
+	free ((char *) feedtab);
+	free ((char *) packtab);
+	free ((char *) gpacktab);
+	feedtab = ofeed;
+	packtab = opack;
+	gpacktab = ogpack;
+	nfeed = onfeed;
+	npack = onpack;
+	ngpack = ongpack;
+	feedtablen = ofeedlen;
+	packtablen = opacklen;
+	gpacktablen = ogpacklen;
+}
+
+/*
+ * Конвейерный режим рассылки (feedworkers > 0).  Общая таблица
+ * статей не строится: mknewarticles раскладывает строки подписки
+ * сразу по таблицам режимов, без ограничения maxarticles.
+ * Рассылку ведут nworkers процессов, каждый для своей
+ * части подписчиков.
+ */
+pipeline ()
+{
+	int k, pid, status, nrun;
+	char *failed;
+
+	artdb = vdbm_open (0);
+	subtab = (struct feedtab *) malloc (sizeof (struct feedtab));
+	failed = calloc (nworkers, 1);
+	if (! artdb || ! subtab || ! failed) {
+		error ("out of memory in pipeline");
+		return;
+	}
+	subtablen = 1;
+	nsub = 0;
+
+	if (debug)
+		printf ("Joining subscriptions with new articles\n");
+	mknewarticles ();
+	vdbm_close (artdb);
+	artdb = 0;
+	nsub = droprows (subtab, nsub);
+	nfeed = droprows (feedtab, nfeed);
+	npack = droprows (packtab, npack);
+	ngpack = droprows (gpacktab, ngpack);
+	messg ("%d new article deliveries, crossposts removed",
+		nsub + nfeed + npack + ngpack);
+
+	/* Sort notify articles by (1) group, (2) issue, (3) user. */
+	if (nsub)
+		qsort ((char *) subtab, nsub, sizeof (struct feedtab), cmpfeedtab);
+	if (debug)
+		printf ("Appending list of new articles\n");
+	updatenewarts (subtab, nsub);
+	messg ("list of new articles updated");
+	free ((char *) subtab);
+	subtab = 0;
+	nsub = 0;
+
+	/*
+	 * Решения о групповой рассылке и о переводе одиночных
+	 * статей в режим FEED принимаются здесь, по всем подписчикам.
+	 */
+	if (ngpack)
+		qsort ((char *) gpacktab, ngpack, sizeof (struct feedtab), cmpfeedtab);
+	splitgpack ();
+	splitpack ();
+
+	/*
+	 * Процессы рассылки только читают базу групп.
+	 * Сбрасываем в нее изменения, чтобы они читали
+	 * отображенный в память файл и не делили
+	 * с нами позицию в файле журнала.
+	 */
+	groupssync ();
+	fflush (stdout);
+
+	nrun = 0;
+	for (k=0; k<nworkers; ++k) {
+		pid = fork ();
+		if (pid == 0) {
+			worker = k;
+			strcpy (tmpname, TMPFNAME);
+			mktemp (tmpname);
+			sendshard (k);
+			exit (0);
+		}
+		if (pid < 0) {
+			error ("cannot fork worker %d, sending in place", k);
+			failed [k] = 1;
+			continue;
+		}
+		++nrun;
+	}
+	while (nrun > 0 && wait (&status) > 0) {
+		--nrun;
+		if (status)
+			error ("worker exited with status 0x%x", status);
+	}
+	for (k=0; k<nworkers; ++k)
+		if (failed [k])
+			sendshard (k);
+	free (failed);
+	messg ("%d workers finished", nworkers);
+}
+
 storeart (g, n, p, q, fd)
 long g, n;
 struct feedtab *p, *q;
@@ -742,23 +1063,38 @@ FILE **fd;
 	free (fromaddr);
 }
 
-sendgpack ()
+/*
+ * Если статей группы много, шлем их в групповом режиме
+ * (один пакет на группу).  Если мало, переводим
+ * в негрупповой режим.  В gpacktab остаются только
+ * группы для групповой рассылки.
+ */
+splitgpack ()
 {
-	register struct feedtab *p, *q;
+	register struct feedtab *p, *q, *r;
 
 	/* Articles are already sorted by (1) group, (2) issue, (3) user. */
+	r = gpacktab;
 	for (p=gpacktab; p<gpacktab+ngpack; p=q) {
 		for (q=p+1; q<gpacktab+ngpack && p->group==q->group; ++q);
-		/*
-		 * Если статей много, шлем в групповом режиме
-		 * (один пакет на группу).  Если мало, переходим
-		 * в негрупповой режим.
-		 */
 		if (q-p > 10)
-			send1gpack (p, q);
+			while (p < q)
+				*r++ = *p++;
 		else while (p < q)
 			addtab (p++, MPACK);
 	}
+	ngpack = r - gpacktab;
+}
+
+sendgpack ()
+{
+	register struct feedtab *p, *q;
+
+	/* Articles are already sorted by (1) group, (2) issue, (3) user. */
+	for (p=gpacktab; p<gpacktab+ngpack; p=q) {
+		for (q=p+1; q<gpacktab+ngpack && p->group==q->group; ++q);
+		send1gpack (p, q);
+	}
 }
 
 send1gpack (p, q)
@@ -852,9 +1188,14 @@ register struct feedtab *p, *q;
 	free (gname);
 }
 
-sendpack ()
+/*
+ * Раскладывает статьи по подписчикам и классам групп.
+ * Если у подписчика в классе всего одна статья, переводим
+ * ее в режим FEED.  В packtab остаются только пакеты.
+ */
+splitpack ()
 {
-	register struct feedtab *p, *q;
+	register struct feedtab *p, *q, *r;
 
 	if (! npack)
 		return;
@@ -864,15 +1205,30 @@ sendpack ()
 	/* Sort articles by (1) user, (2) class, (3) group, (4) issue. */
 	qsort ((char *) packtab, npack, sizeof (struct feedtab), cmppacktab);
 
+	r = packtab;
 	for (p=packtab; p<packtab+npack; p=q) {
 		for (q=p+1; q<packtab+npack && p->user==q->user &&
 			p->mode==q->mode; ++q);
 		/* Если всего одна статья - шлем в режиме FEED */
 		if (q-p > 1)
-			send1pack (p->user, p, q, groupiclass (p->mode));
+			while (p < q)
+				*r++ = *p++;
 		else
 			addtab (p, MFEED);
 	}
+	npack = r - packtab;
+}
+
+sendpack ()
+{
+	register struct feedtab *p, *q;
+
+	/* Articles are already sorted by (1) user, (2) class, (3) group, (4) issue. */
+	for (p=packtab; p<packtab+npack; p=q) {
+		for (q=p+1; q<packtab+npack && p->user==q->user &&
+			p->mode==q->mode; ++q);
+		send1pack (p->user, p, q, groupiclass (p->mode));
+	}
 }
 
 send1pack (u, p, q, gclass)
@@ -963,6 +1319,7 @@ int ns;
 	int feedlimit, n;
 	char msgid [256], *msgidptr;
 	long size;
+	struct feedtab row;
 
 	if (! ns)
 		return;
@@ -997,15 +1354,6 @@ int ns;
 		case 'f':       feedlimit = FEEDLIMIT;  break;
 		case 's':       feedlimit = 0;          break;
 		}
-		if (nart >= arttablen) {
-			arttablen += 64;
-			arttab = (struct feedtab *) realloc ((char *) arttab,
-				(unsigned) (arttablen * sizeof (struct feedtab)));
-			if (! arttab) {
-				error ("out of memory in storeinfo");
-				return;
-			}
-		}
 		/*
 		 * 1) ИД
 		 * 2) Номер пользователя
@@ -1013,18 +1361,33 @@ int ns;
 		 * 4) Номер статьи
 		 * 5) Режим подписки
 		 */
-		arttab[nart].msgid = msgidptr;
-		arttab[nart].user = s->tag;
-		arttab[nart].group = g;
-		arttab[nart].issue = artnum;
+		row.msgid = msgidptr;
+		row.user = s->tag;
+		row.group = g;
+		row.issue = artnum;
 		if (size >= feedlimit*1024)
-			arttab[nart].mode = MSUBS;
+			row.mode = MSUBS;
 		else if (! (userflags (s->tag) & UFLAGPACK))
-			arttab[nart].mode = MFEED;
+			row.mode = MFEED;
 		else if (s->mode == 'f')
-			arttab[nart].mode = MGPACK;
+			row.mode = MGPACK;
 		else
-			arttab[nart].mode = MPACK;
+			row.mode = MPACK;
+		if (artdb) {
+			joinrow (&row);
+			++nart;
+			continue;
+		}
+		if (nart >= arttablen) {
+			arttablen += 64;
+			arttab = (struct feedtab *) realloc ((char *) arttab,
+				(unsigned) (arttablen * sizeof (struct feedtab)));
+			if (! arttab) {
+				error ("out of memory in storeinfo");
+				return;
+			}
+		}
+		arttab[nart] = row;
 		++nart;
 	}
 }
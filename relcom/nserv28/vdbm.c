@@ -11,10 +11,16 @@
 # include "vdbm.h"
 
 # define INITSZ 64
+# define CHUNKSZ (16*1024)
+# define ALIGN(n) (((n) + sizeof (long) - 1) & ~(sizeof (long) - 1))
 # define KEYDATA(p) ((char *) ((p)+1))
 # define VALDATA(p) ((char *) ((p)+1) + (p)->keysize)
+# define VHASH(k,sz) (vhash (k, sz) | 0x80000000L)
+# define DIST(db,i,h) (((i) - (h)) & ((db)->size - 1))
 
-static velem **vfind ();
+static vslot *vfind ();
+static void vinsert ();
+static velem *vnewelem ();
 static long vhash ();
 static int vrehash ();
 
@@ -27,31 +33,34 @@ VDBM *vdbm_open (sz)
 int sz;
 {
 	register VDBM *h;
+	int n;
 
 	h = (VDBM *) malloc (sizeof (VDBM));
 	if (! h)
 		return (0);
-	if (sz < INITSZ)
-		sz = INITSZ;
-	h->tab = (velem **) calloc (sz, sizeof (velem *));
+	for (n=INITSZ; n<sz; n*=2)
+		continue;
+	h->tab = (vslot *) calloc (n, sizeof (vslot));
 	if (! h->tab) {
 		free ((char *) h);
 		return (0);
 	}
-	h->size = sz;
+	h->size = n;
 	h->cnt = 0;
 	h->nextindex = 0;
+	h->arena = 0;
 	return (h);
 }
 
 void vdbm_close (db)
 register VDBM *db;
 {
-	int i;
+	register vchunk *c, *next;
 
-	for (i=0; i<db->size; ++i)
-		if (db->tab [i])
-			free ((char *) db->tab [i]);
+	for (c=db->arena; c; c=next) {
+		next = c->next;
+		free ((char *) c);
+	}
 	free ((char *) db->tab);
 	free ((char *) db);
 }
@@ -70,20 +79,20 @@ vdatum vdbm_nextkey (db, key)
 register VDBM *db;
 vdatum key;
 {
-	register velem **p;
+	register vslot *p;
 
 	if (! key.dptr)
 		p = db->tab;
 	else {
-		p = vfind (db, key.dptr, key.dsize);
-		if (! *p)
+		p = vfind (db, key.dptr, key.dsize, VHASH (key.dptr, key.dsize));
+		if (! p)
 			goto notfound;
 		++p;
 	}
 	for (; p<db->tab+db->size; ++p)
-		if (*p) {
-			key.dptr = KEYDATA (*p);
-			key.dsize = (*p)->keysize;
+		if (p->hash) {
+			key.dptr = KEYDATA (p->elem);
+			key.dsize = p->elem->keysize;
 			return (key);
 		}
 notfound:
@@ -97,15 +106,15 @@ register VDBM *db;
 vdatum key;
 {
 	vdatum val;
-	register velem **p;
+	register vslot *p;
 
-	p = vfind (db, key.dptr, key.dsize);
-	if (! *p) {
+	p = vfind (db, key.dptr, key.dsize, VHASH (key.dptr, key.dsize));
+	if (! p) {
 		val.dptr = 0;
 		val.dsize = 0;
 	} else {
-		val.dptr = VALDATA (*p);
-		val.dsize = (*p)->valsize;
+		val.dptr = VALDATA (p->elem);
+		val.dsize = p->elem->valsize;
 	}
 	return (val);
 }
@@ -115,28 +124,42 @@ register VDBM *db;
 vdatum key, val;
 int flag;
 {
-	register velem **p;
+	register vslot *p;
+	register velem *e;
+	unsigned long h;
 
-	p = vfind (db, key.dptr, key.dsize);
-	if (*p) {
+	h = VHASH (key.dptr, key.dsize);
+	p = vfind (db, key.dptr, key.dsize, h);
+	if (p) {
 		if (! flag)
 			return (1);
-		--db->cnt;
-		free ((char *) *p);
+		e = p->elem;
+		if (val.dsize <= e->valsize) {
+			/* новые данные помещаются на место старых */
+			e->valsize = val.dsize;
+			if (val.dsize)
+				memcpy (VALDATA (e), val.dptr, val.dsize);
+			return (0);
+		}
 	}
-	*p = (velem *) malloc (sizeof (velem) + key.dsize + val.dsize);
-	if (! *p)
+	e = vnewelem (db, sizeof (velem) + key.dsize + val.dsize);
+	if (! e)
 		return (-1);
-	(*p)->keysize = key.dsize;
-	(*p)->valsize = val.dsize;
+	e->keysize = key.dsize;
+	e->valsize = val.dsize;
 	if (key.dsize)
-		memcpy (KEYDATA (*p), key.dptr, key.dsize);
+		memcpy (KEYDATA (e), key.dptr, key.dsize);
 	if (val.dsize)
-		memcpy (VALDATA (*p), val.dptr, val.dsize);
-	++db->cnt;
-	if (db->cnt > db->size*3/4)
+		memcpy (VALDATA (e), val.dptr, val.dsize);
+	if (p) {
+		p->elem = e;
+		return (0);
+	}
+	if (db->cnt+1 > db->size*3/4)
 		if (vrehash (db, db->size * 2) < 0)
 			return (-1);
+	vinsert (db, h, e);
+	++db->cnt;
 	return (0);
 }
 
@@ -144,36 +167,136 @@ int vdbm_delete (db, key)
 register VDBM *db;
 vdatum key;
 {
-	register velem **p;
+	register vslot *p, *q;
+	int i, mask;
 
-	p = vfind (db, key.dptr, key.dsize);
-	if (! *p)
+	p = vfind (db, key.dptr, key.dsize, VHASH (key.dptr, key.dsize));
+	if (! p)
 		return (-1);
-	free ((char *) *p);
-	*p = 0;
+
+	/* Сдвигаем хвост цепочки назад на место удаленного слота,
+	 * чтобы не оставлять "дыр" в последовательностях проб. */
+	mask = db->size - 1;
+	i = p - db->tab;
+	for (;;) {
+		q = db->tab + ((i + 1) & mask);
+		if (! q->hash || DIST (db, q - db->tab, q->hash) == 0)
+			break;
+		*p = *q;
+		p = q;
+		i = p - db->tab;
+	}
+	p->hash = 0;
+	p->elem = 0;
 	--db->cnt;
 	if (db->cnt < db->size/4 && db->size > INITSZ)
 		vrehash (db, db->size / 2);
 	return (0);
 }
 
-static velem **vfind (db, k, sz)
+/*
+ * Поиск слота с заданным ключом.  Если ключа нет, возвращает 0.
+ * Элементы цепочки упорядочены по удаленности от своего начального
+ * слота (Robin Hood), поэтому поиск прекращается, как только
+ * встретится элемент ближе к своему месту, чем искомый.
+ */
+static vslot *vfind (db, k, sz, h)
 register VDBM *db;
 char *k;
 int sz;
+unsigned long h;
 {
-	register velem **p;
+	register vslot *p;
+	register int i, mask, dist;
 
-	p = db->tab + vhash (k, sz) % db->size;
-	while (*p) {
-		if ((*p)->keysize == sz &&
-		    ! memcmp (KEYDATA (*p), k, sz))
-			break;
-		++p;
-		if (p >= db->tab + db->size)
-			p = db->tab;
+	mask = db->size - 1;
+	i = h & mask;
+	for (dist=0; ; ++dist) {
+		p = db->tab + i;
+		if (! p->hash || DIST (db, i, p->hash) < dist)
+			return (0);
+		if (p->hash == h && p->elem->keysize == sz &&
+		    ! memcmp (KEYDATA (p->elem), k, sz))
+			return (p);
+		i = (i + 1) & mask;
 	}
-	return (p);
+}
+
+/*
+ * Вставка элемента, которого заведомо нет в таблице.
+ * Элемент, дальше ушедший от своего места, вытесняет
+ * более близкий, и вставка продолжается для вытесненного.
+ */
+static void vinsert (db, h, e)
+register VDBM *db;
+unsigned long h;
+velem *e;
+{
+	register vslot *p;
+	register int i, mask, dist, d;
+	vslot t;
+
+	mask = db->size - 1;
+	i = h & mask;
+	for (dist=0; ; ++dist) {
+		p = db->tab + i;
+		if (! p->hash) {
+			p->hash = h;
+			p->elem = e;
+			return;
+		}
+		d = DIST (db, i, p->hash);
+		if (d < dist) {
+			t = *p;
+			p->hash = h;
+			p->elem = e;
+			h = t.hash;
+			e = t.elem;
+			dist = d;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+/*
+ * Выделение памяти под элемент из арены.  Крупные элементы
+ * получают отдельный блок, чтобы не бросать остаток текущего.
+ */
+static velem *vnewelem (db, n)
+register VDBM *db;
+int n;
+{
+	register vchunk *c;
+	int hdr;
+
+	hdr = ALIGN (sizeof (vchunk));
+	n = ALIGN (n);
+	c = db->arena;
+	if (! c || c->used + n > c->size) {
+		if (n > CHUNKSZ / 4) {
+			c = (vchunk *) malloc (hdr + n);
+			if (! c)
+				return (0);
+			c->size = c->used = n;
+			if (db->arena) {
+				c->next = db->arena->next;
+				db->arena->next = c;
+			} else {
+				c->next = 0;
+				db->arena = c;
+			}
+			return ((velem *) ((char *) c + hdr));
+		}
+		c = (vchunk *) malloc (CHUNKSZ);
+		if (! c)
+			return (0);
+		c->size = CHUNKSZ - hdr;
+		c->used = 0;
+		c->next = db->arena;
+		db->arena = c;
+	}
+	c->used += n;
+	return ((velem *) ((char *) c + hdr + c->used - n));
 }
 
 static long vhash (p, sz)
@@ -199,25 +322,29 @@ register sz;
 	return (v & 0x7fffffff);
 }
 
+/*
+ * Перестройка таблицы слотов.  Хэши хранятся в слотах,
+ * поэтому ключи заново не хэшируются, а элементы остаются на месте.
+ */
 static int vrehash (db, newsz)
 register VDBM *db;
 int newsz;
 {
-	VDBM *newdb;
-	velem **p, **q;
+	vslot *oldtab, *q;
+	int oldsz;
 
-	newdb = vdbm_open (newsz);
-	if (! newdb)
+	oldtab = db->tab;
+	oldsz = db->size;
+	db->tab = (vslot *) calloc (newsz, sizeof (vslot));
+	if (! db->tab) {
+		db->tab = oldtab;
 		return (-1);
-	for (q=db->tab; q<db->tab+db->size; ++q)
-		if (*q) {
-			p = vfind (newdb, KEYDATA (*q), (*q)->keysize);
-			*p = *q;
-		}
-	newdb->cnt = db->cnt;
-	free ((char *) db->tab);
-	*db = *newdb;
-	free ((char *) newdb);
+	}
+	db->size = newsz;
+	for (q=oldtab; q<oldtab+oldsz; ++q)
+		if (q->hash)
+			vinsert (db, q->hash, q->elem);
+	free ((char *) oldtab);
 	return (0);
 }
 